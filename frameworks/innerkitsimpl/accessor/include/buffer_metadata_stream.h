@@ -172,6 +172,15 @@ public:
      */
     virtual ssize_t GetSize() override;
 
+    /* *
+     * Cut the BufferMetadataStream back to the given size. The memory is kept
+     * for later writes.
+     *
+     * @param size The new size, it must not exceed the current size.
+     * @return Returns true if the size is changed, false otherwise.
+     */
+    virtual bool Truncate(size_t size) override;
+
     /* *
      * Release the managed memory to the external.
      *
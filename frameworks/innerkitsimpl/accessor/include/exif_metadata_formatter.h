@@ -48,6 +48,7 @@ private:
     void InitValueRangeValidateConfig();
     void InitValueFormatConvertConfig();
     void InitValueTemplateConfig();
+    void PrecompileRegexes();
 
     static int32_t ValidateValueRange(const std::string &keyName, const std::string &value);
     static void ConvertRangeValue(const std::string &keyName, std::string &value);
@@ -78,8 +79,6 @@ private:
     static bool ValidRegexWithChannelFormat(std::string &value, const std::string &regex);
     static bool ValidRegexWithDoubleFormat(std::string &value, const std::string &regex);
     static bool ValidRegexWithIntFormat(std::string &value, const std::string &regex);
-    static void ReplaceAsSpace(std::string &value, const std::string &regex);
-    static void ReplaceAsContent(std::string &value, const std::string &regex, const std::string &content);
     static void RationalFormat(std::string &value);
     static std::string GetFractionFromStr(const std::string &decimal, bool &isOutRange);
     static bool ValidDecimalRationalFormat(std::string &value);
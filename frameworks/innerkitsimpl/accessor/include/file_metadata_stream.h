@@ -187,6 +187,13 @@ public:
      */
     ssize_t GetSize() override;
 
+    /* *
+     * @brief Flushes the FileMetadataStream and cuts the file back to the given size.
+     * @param size The new size, it must not exceed the current size.
+     * @return true if the file has the new size, false otherwise.
+     */
+    bool Truncate(size_t size) override;
+
 private:
     /* *
      * @brief Closes the FileMetadataStream.
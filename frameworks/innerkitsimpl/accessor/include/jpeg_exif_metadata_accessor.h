@@ -48,6 +48,10 @@ private:
     bool CopyRestData(BufferMetadataStream &bufStream);
     bool WriteData(BufferMetadataStream &bufStream, uint8_t *dataBlob, uint32_t size);
     bool UpdateExifMetadata(BufferMetadataStream &tempStream, uint8_t *dataBlob, uint32_t size);
+    bool FindExifSegment(long &segmentPos, long &segmentRoom);
+    bool GrowStream(long delta);
+    bool ShiftTail(long tailPos, long streamSize, long delta);
+    uint32_t UpdateExifInPlace(uint8_t *dataBlob, uint32_t size);
     uint32_t UpdateData(uint8_t *dataBlob, uint32_t size);
 };
 } // namespace Media
@@ -173,6 +173,17 @@ public:
      */
     virtual ssize_t GetSize() = 0;
 
+    /* *
+     * Cut the MetadataStream back to the given size. The current position is
+     * moved to the new end if it lies behind it.
+     * @param size The new size, it must not exceed the current size
+     * @return true if the MetadataStream has the new size, false otherwise
+     */
+    virtual bool Truncate(size_t size)
+    {
+        return false;
+    }
+
     /* *
      * Get the size of the original file
      * @return The size of the original file
@@ -315,6 +315,16 @@ ssize_t BufferMetadataStream::GetSize()
     return bufferSize_;
 }
 
+bool BufferMetadataStream::Truncate(size_t size)
+{
+    CHECK_ERROR_RETURN_RET_LOG(size > static_cast<size_t>(bufferSize_), false,
+        "BufferMetadataStream::Truncate failed, size exceeds buffer size, size:%{public}zu, bufferSize:%{public}ld",
+        size, bufferSize_);
+    bufferSize_ = static_cast<long>(size);
+    currentOffset_ = std::min(currentOffset_, bufferSize_);
+    return true;
+}
+
 byte *BufferMetadataStream::Release()
 {
     byte *ret = buffer_;
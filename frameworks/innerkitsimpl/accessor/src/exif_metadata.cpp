@@ -15,6 +15,7 @@
 
 #include <iostream>
 #include <map>
+#include <mutex>
 #include <numeric>
 #include <ostream>
 #include <set>
@@ -22,6 +23,7 @@
 #include <vector>
 #include <string_view>
 #include <charconv>
+#include <unordered_map>
 
 #include "exif_metadata.h"
 #include "exif_metadata_formatter.h"
@@ -108,6 +110,18 @@ static const std::vector<std::string> GPS_EXIF_KEYS = {
 
 static const int GET_SUPPORT_MAKERNOTE_COUNT = 1;
 static const int INIT_HW_DATA_HEAD_LENGTH = 8;
+static const unsigned char EXIF_HEADER[EXIF_HEAD_SIZE] = { 'E', 'x', 'i', 'f', '\0', '\0' };
+static const uint32_t LAZY_EXIF_MAX_SIZE = 0xfffe;
+static const uint32_t TIFF_HEADER_SIZE = 8;
+static const uint32_t TIFF_IFD0_OFFSET_POS = 4;
+static const uint32_t IFD_COUNT_SIZE = 2;
+static const uint32_t IFD_ENTRY_SIZE = 12;
+static const uint32_t IFD_ENTRY_FORMAT_POS = 2;
+static const uint32_t IFD_ENTRY_COMPONENTS_POS = 4;
+static const uint32_t IFD_ENTRY_VALUE_POS = 8;
+static const uint32_t IFD_ENTRY_INLINE_SIZE = 4;
+static const uint32_t IFD_NEXT_OFFSET_SIZE = 4;
+static const uint32_t LAZY_KEY_IFD_SHIFT = 16;
 
 const std::map<std::string, PropertyValueType>& ExifMetadata::GetExifMetadataMap()
 {
@@ -890,10 +904,318 @@ std::istream &operator >> (std::istream &is, ExifSRational &r)
 
 std::set<ExifTag> UndefinedByte = { EXIF_TAG_SCENE_TYPE, EXIF_TAG_COMPONENTS_CONFIGURATION, EXIF_TAG_FILE_SOURCE };
 
+// Raw APP1 payload of a lazily parsed ExifMetadata together with the offsets of its IFD entries.
+// Entries are turned into ExifEntry objects one tag at a time; the full libexif tree is only loaded on demand.
+struct ExifLazyIndex {
+    std::mutex mutex;
+    std::vector<unsigned char> blob;
+    ExifByteOrder order = EXIF_BYTE_ORDER_MOTOROLA;
+    std::unordered_map<uint32_t, uint32_t> entryOffsets;
+    std::unordered_map<uint32_t, ExifEntry *> resolved;
+    uint32_t indexedIfds = 0;
+    uint32_t thumbnailOffset = 0;
+    uint32_t thumbnailLength = 0;
+    bool hasThumbnail = false;
+    bool hasMakerNote = false;
+    ExifData *entries = nullptr;
+
+    ~ExifLazyIndex()
+    {
+        if (entries != nullptr) {
+            exif_data_unref(entries);
+            entries = nullptr;
+        }
+    }
+
+    const unsigned char *Tiff() const
+    {
+        return blob.data() + EXIF_HEAD_SIZE;
+    }
+
+    uint32_t TiffSize() const
+    {
+        return static_cast<uint32_t>(blob.size()) - EXIF_HEAD_SIZE;
+    }
+};
+
+static inline uint32_t LazyEntryKey(ExifIfd ifd, ExifTag tag)
+{
+    return (static_cast<uint32_t>(ifd) << LAZY_KEY_IFD_SHIFT) | static_cast<uint32_t>(tag);
+}
+
+static bool IndexLazyIfd(ExifLazyIndex &index, ExifIfd ifd, uint32_t offset);
+
+static bool IsLazyPointerTag(ExifTag tag)
+{
+    return tag == EXIF_TAG_EXIF_IFD_POINTER || tag == EXIF_TAG_GPS_INFO_IFD_POINTER ||
+        tag == EXIF_TAG_INTEROPERABILITY_IFD_POINTER || tag == EXIF_TAG_JPEG_INTERCHANGE_FORMAT ||
+        tag == EXIF_TAG_JPEG_INTERCHANGE_FORMAT_LENGTH;
+}
+
+// Sub-IFD and thumbnail pointers are followed like exif_data_load_data() does; anything it would only
+// tolerate with a warning (recursion, out of range offsets) makes the caller fall back to a full load.
+static bool IndexLazyPointer(ExifLazyIndex &index, ExifIfd ifd, ExifTag tag, uint32_t value)
+{
+    CHECK_ERROR_RETURN_RET(value >= index.TiffSize(), false);
+    ExifIfd target = EXIF_IFD_COUNT;
+    switch (tag) {
+        case EXIF_TAG_EXIF_IFD_POINTER:
+            target = EXIF_IFD_EXIF;
+            break;
+        case EXIF_TAG_GPS_INFO_IFD_POINTER:
+            target = EXIF_IFD_GPS;
+            break;
+        case EXIF_TAG_INTEROPERABILITY_IFD_POINTER:
+            target = EXIF_IFD_INTEROPERABILITY;
+            break;
+        case EXIF_TAG_JPEG_INTERCHANGE_FORMAT:
+            CHECK_ERROR_RETURN_RET(index.thumbnailOffset != 0, false);
+            index.thumbnailOffset = value;
+            return true;
+        case EXIF_TAG_JPEG_INTERCHANGE_FORMAT_LENGTH:
+            CHECK_ERROR_RETURN_RET(index.thumbnailLength != 0, false);
+            index.thumbnailLength = value;
+            return true;
+        default:
+            return false;
+    }
+    CHECK_ERROR_RETURN_RET(target == ifd || (index.indexedIfds & (1u << target)) != 0, false);
+    return IndexLazyIfd(index, target, value);
+}
+
+static bool IndexLazyEntry(ExifLazyIndex &index, ExifIfd ifd, uint32_t entryOffset)
+{
+    const unsigned char *raw = index.Tiff() + entryOffset;
+    ExifTag tag = static_cast<ExifTag>(exif_get_short(raw, index.order));
+    // libexif skips unknown entries whose tag and format are both zero
+    if (exif_tag_get_name_in_ifd(tag, ifd) == nullptr && exif_get_long(raw, index.order) == 0) {
+        return true;
+    }
+    ExifFormat format = static_cast<ExifFormat>(exif_get_short(raw + IFD_ENTRY_FORMAT_POS, index.order));
+    uint64_t size = static_cast<uint64_t>(exif_format_get_size(format)) *
+        exif_get_long(raw + IFD_ENTRY_COMPONENTS_POS, index.order);
+    CHECK_ERROR_RETURN_RET(size > UINT32_MAX, false);
+    CHECK_DEBUG_RETURN_RET_LOG(size == 0, true, "Skip empty exif entry 0x%{public}x", tag);
+    uint32_t dataOffset = size > IFD_ENTRY_INLINE_SIZE ?
+        exif_get_long(raw + IFD_ENTRY_VALUE_POS, index.order) : entryOffset + IFD_ENTRY_VALUE_POS;
+    CHECK_DEBUG_RETURN_RET_LOG(dataOffset >= index.TiffSize() || size > index.TiffSize() - dataOffset, true,
+        "Skip exif entry 0x%{public}x with data past end of buffer", tag);
+    index.entryOffsets.emplace(LazyEntryKey(ifd, tag), entryOffset);
+    index.hasMakerNote = index.hasMakerNote || tag == EXIF_TAG_MAKER_NOTE;
+    return true;
+}
+
+static bool IndexLazyIfd(ExifLazyIndex &index, ExifIfd ifd, uint32_t offset)
+{
+    const uint32_t tiffSize = index.TiffSize();
+    CHECK_ERROR_RETURN_RET(offset >= tiffSize || tiffSize - offset < IFD_COUNT_SIZE, false);
+    index.indexedIfds |= 1u << ifd;
+    uint32_t count = exif_get_short(index.Tiff() + offset, index.order);
+    offset += IFD_COUNT_SIZE;
+    CHECK_ERROR_RETURN_RET(static_cast<uint64_t>(count) * IFD_ENTRY_SIZE > tiffSize - offset, false);
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t entryOffset = offset + i * IFD_ENTRY_SIZE;
+        const unsigned char *raw = index.Tiff() + entryOffset;
+        ExifTag tag = static_cast<ExifTag>(exif_get_short(raw, index.order));
+        bool indexed = IsLazyPointerTag(tag) ?
+            IndexLazyPointer(index, ifd, tag, exif_get_long(raw + IFD_ENTRY_VALUE_POS, index.order)) :
+            IndexLazyEntry(index, ifd, entryOffset);
+        CHECK_ERROR_RETURN_RET(!indexed, false);
+    }
+    return true;
+}
+
+static bool BuildLazyIndex(ExifLazyIndex &index)
+{
+    const unsigned char *tiff = index.Tiff();
+    if (tiff[0] == 'I' && tiff[1] == 'I') {
+        index.order = EXIF_BYTE_ORDER_INTEL;
+    } else if (tiff[0] == 'M' && tiff[1] == 'M') {
+        index.order = EXIF_BYTE_ORDER_MOTOROLA;
+    } else {
+        return false;
+    }
+    const uint32_t tiffSize = index.TiffSize();
+    uint32_t ifd0Offset = exif_get_long(tiff + TIFF_IFD0_OFFSET_POS, index.order);
+    CHECK_ERROR_RETURN_RET(!IndexLazyIfd(index, EXIF_IFD_0, ifd0Offset), false);
+    uint64_t nextOffsetPos = static_cast<uint64_t>(ifd0Offset) + IFD_COUNT_SIZE +
+        static_cast<uint64_t>(exif_get_short(tiff + ifd0Offset, index.order)) * IFD_ENTRY_SIZE;
+    CHECK_ERROR_RETURN_RET(nextOffsetPos + IFD_NEXT_OFFSET_SIZE > tiffSize, false);
+    uint32_t ifd1Offset = exif_get_long(tiff + nextOffsetPos, index.order);
+    if (ifd1Offset != 0) {
+        CHECK_ERROR_RETURN_RET(!IndexLazyIfd(index, EXIF_IFD_1, ifd1Offset), false);
+    }
+    index.hasThumbnail = index.thumbnailOffset != 0 && index.thumbnailLength != 0 &&
+        static_cast<uint64_t>(index.thumbnailOffset) + index.thumbnailLength <= tiffSize;
+    return true;
+}
+
+static ExifEntry *LoadLazyEntry(ExifLazyIndex &index, ExifContent *content, ExifTag tag, uint32_t entryOffset)
+{
+    const unsigned char *raw = index.Tiff() + entryOffset;
+    ExifFormat format = static_cast<ExifFormat>(exif_get_short(raw + IFD_ENTRY_FORMAT_POS, index.order));
+    unsigned long components = exif_get_long(raw + IFD_ENTRY_COMPONENTS_POS, index.order);
+    uint32_t size = exif_format_get_size(format) * components;
+    uint32_t dataOffset = size > IFD_ENTRY_INLINE_SIZE ?
+        exif_get_long(raw + IFD_ENTRY_VALUE_POS, index.order) : entryOffset + IFD_ENTRY_VALUE_POS;
+
+    ExifMem *exifMem = exif_mem_new_default();
+    CHECK_ERROR_RETURN_RET_LOG(exifMem == nullptr, nullptr, "Failed to create memory allocator for ExifEntry.");
+    ExifEntry *entry = exif_entry_new_mem(exifMem);
+    void *buffer = entry == nullptr ? nullptr : exif_mem_alloc(exifMem, size);
+    if (buffer == nullptr || memcpy_s(buffer, size, index.Tiff() + dataOffset, size) != EOK) {
+        IMAGE_LOGE("Failed to load exif entry 0x%{public}x, size: %{public}u", tag, size);
+        exif_mem_free(exifMem, buffer);
+        if (entry != nullptr) {
+            exif_entry_unref(entry);
+        }
+        exif_mem_unref(exifMem);
+        return nullptr;
+    }
+    entry->tag = tag;
+    entry->format = format;
+    entry->components = components;
+    entry->data = static_cast<unsigned char *>(buffer);
+    entry->size = size;
+    exif_content_add_entry(content, entry);
+    exif_entry_unref(entry);
+    exif_mem_unref(exifMem);
+    return entry;
+}
+
+// Produces the entry exif_data_fix() would leave in this IFD after a full load: recorded entries are fixed,
+// entries the specification does not record are dropped and missing mandatory ones get their defaults.
+static ExifEntry *ResolveLazyEntry(ExifLazyIndex &index, ExifTag tag, ExifIfd ifd)
+{
+    const uint32_t key = LazyEntryKey(ifd, tag);
+    auto cached = index.resolved.find(key);
+    if (cached != index.resolved.end()) {
+        return cached->second;
+    }
+    ExifEntry *entry = nullptr;
+    ExifContent *content = index.entries->ifd[ifd];
+    ExifSupportLevel level = exif_tag_get_support_level_in_ifd(tag, ifd, exif_data_get_data_type(index.entries));
+    auto offset = index.entryOffsets.find(key);
+    if (ifd == EXIF_IFD_1 && !index.hasThumbnail) {
+        entry = nullptr;
+    } else if (offset != index.entryOffsets.end()) {
+        if (level != EXIF_SUPPORT_LEVEL_NOT_RECORDED) {
+            entry = LoadLazyEntry(index, content, tag, offset->second);
+        }
+        if (entry != nullptr) {
+            exif_entry_fix(entry);
+        }
+    } else if (level == EXIF_SUPPORT_LEVEL_MUST_BE_RECORDED) {
+        entry = exif_entry_new();
+        if (entry != nullptr) {
+            exif_content_add_entry(content, entry);
+            exif_entry_initialize(entry, tag);
+            exif_entry_unref(entry);
+        }
+    }
+    index.resolved.emplace(key, entry);
+    return entry;
+}
+
+// Same lookup order as exif_data_get_entry()
+static ExifEntry *FindLazyEntry(ExifLazyIndex &index, ExifTag tag)
+{
+    static const ExifIfd searchOrder[] = {
+        EXIF_IFD_0, EXIF_IFD_EXIF, EXIF_IFD_GPS, EXIF_IFD_INTEROPERABILITY, EXIF_IFD_1
+    };
+    for (ExifIfd ifd : searchOrder) {
+        ExifEntry *entry = ResolveLazyEntry(index, tag, ifd);
+        if (entry != nullptr) {
+            return entry;
+        }
+    }
+    return nullptr;
+}
+
 ExifMetadata::ExifMetadata() : exifData_(nullptr) {}
 
 ExifMetadata::ExifMetadata(ExifData *exifData) : exifData_(exifData) {}
 
+std::shared_ptr<ExifMetadata> ExifMetadata::CreateLazy(const unsigned char *data, uint32_t size)
+{
+    bool cond = data == nullptr || size < EXIF_HEAD_SIZE + TIFF_HEADER_SIZE || size > LAZY_EXIF_MAX_SIZE ||
+        memcmp(data, EXIF_HEADER, EXIF_HEAD_SIZE) != 0;
+    CHECK_DEBUG_RETURN_RET_LOG(cond, nullptr, "%{public}s: not an APP1 exif payload", __func__);
+    auto index = std::make_unique<ExifLazyIndex>();
+    index->blob.assign(data, data + size);
+    CHECK_DEBUG_RETURN_RET_LOG(!BuildLazyIndex(*index), nullptr,
+        "%{public}s: exif layout needs a full load, size: %{public}u", __func__, size);
+    index->entries = exif_data_new();
+    CHECK_ERROR_RETURN_RET_LOG(index->entries == nullptr, nullptr, "%{public}s: exif_data_new failed", __func__);
+    exif_data_set_byte_order(index->entries, index->order);
+    auto metadata = std::make_shared<ExifMetadata>();
+    metadata->lazyIndex_ = std::move(index);
+    IMAGE_LOGD("%{public}s: indexed %{public}zu exif entries", __func__, metadata->lazyIndex_->entryOffsets.size());
+    return metadata;
+}
+
+ExifData *ExifMetadata::EnsureExifData() const
+{
+    if (lazyIndex_ == nullptr) {
+        return exifData_;
+    }
+    std::lock_guard<std::mutex> lock(lazyIndex_->mutex);
+    if (exifData_ == nullptr && !lazyIndex_->blob.empty()) {
+        uint32_t size = static_cast<uint32_t>(lazyIndex_->blob.size());
+        TiffParser::DecodeJpegExif(lazyIndex_->blob.data(), size, &exifData_);
+        CHECK_ERROR_RETURN_RET_LOG(exifData_ == nullptr, nullptr, "%{public}s: DecodeJpegExif failed", __func__);
+        // Entries handed out earlier stay owned by lazyIndex_->entries, only the raw copy is released.
+        std::vector<unsigned char>().swap(lazyIndex_->blob);
+        IMAGE_LOGD("%{public}s: loaded full exif tree", __func__);
+    }
+    return exifData_;
+}
+
+// exifData_ of lazily indexed data is set by EnsureExifData under the index lock, so it is only read under it.
+bool ExifMetadata::HasExifData() const
+{
+    if (lazyIndex_ == nullptr) {
+        return exifData_ != nullptr;
+    }
+    std::lock_guard<std::mutex> lock(lazyIndex_->mutex);
+    return exifData_ != nullptr || !lazyIndex_->blob.empty();
+}
+
+// Without a MakerNote entry libexif has nothing to interpret, so there is no need to load the tree.
+bool ExifMetadata::IsLazyWithoutMakerNote() const
+{
+    if (lazyIndex_ == nullptr) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(lazyIndex_->mutex);
+    return exifData_ == nullptr && !lazyIndex_->hasMakerNote;
+}
+
+bool ExifMetadata::GetLazyEntry(const std::string &key, ExifTag tag, ExifEntry *&entry) const
+{
+    if (lazyIndex_ == nullptr) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(lazyIndex_->mutex);
+    if (exifData_ != nullptr || lazyIndex_->blob.empty()) {
+        return false;
+    }
+    if (tag == 0x0001 || tag == 0x0002) {
+        ExifIfd ifd = exif_ifd_from_name(key.c_str());
+        entry = ifd < EXIF_IFD_COUNT ? ResolveLazyEntry(*lazyIndex_, tag, ifd) : nullptr;
+    } else {
+        entry = FindLazyEntry(*lazyIndex_, tag);
+    }
+    return true;
+}
+
+ExifMnoteData *ExifMetadata::GetMnoteData() const
+{
+    CHECK_DEBUG_RETURN_RET_LOG(IsLazyWithoutMakerNote(), nullptr, "Lazy exif data has no maker note.");
+    ExifData *exifData = EnsureExifData();
+    return exifData == nullptr ? nullptr : exif_data_get_mnote_data(exifData);
+}
+
 ExifMetadata::~ExifMetadata()
 {
     if (exifData_ != nullptr) {
@@ -911,7 +1233,7 @@ int ExifMetadata::GetValue(const std::string &key, std::string &value, std::stri
 {
     value.clear();
     IMAGE_LOGD("Retrieving value for key: %{public}s", key.c_str());
-    bool cond = exifData_ == nullptr;
+    bool cond = !HasExifData();
     CHECK_ERROR_RETURN_RET_LOG(cond, ERR_IMAGE_DECODE_EXIF_UNSUPPORT,
                                "Exif data is null for key: %{public}s", key.c_str());
     bool isUnsupportedKey = !ExifMetadatFormatter::IsKeySupported(key);
@@ -1189,7 +1511,7 @@ static int GetHwEntryCount(ExifMnoteData *md, MnoteHuaweiEntryCount **ec)
 int ExifMetadata::HandleHwMnoteByType(const std::string &key, MetadataValue &result) const
 {
     MetadataValue tmpResult;
-    ExifMnoteData *md = exif_data_get_mnote_data(exifData_);
+    ExifMnoteData *md = GetMnoteData();
     CHECK_ERROR_RETURN_RET_LOG(md == nullptr, ERR_IMAGE_DECODE_EXIF_UNSUPPORT, "Exif mnote data null");
     MnoteHuaweiEntryCount *ec = nullptr;
     int retCode = GetHwEntryCount(md, &ec);
@@ -1212,7 +1534,7 @@ int ExifMetadata::GetValueByType(const std::string &key, MetadataValue &value) c
 {
     IMAGE_LOGD("Retrieving value for key: %{public}s", key.c_str());
     MetadataValue tmpValue;
-    bool cond = exifData_ == nullptr;
+    bool cond = !HasExifData();
     CHECK_ERROR_RETURN_RET_LOG(cond, ERR_IMAGE_DECODE_EXIF_UNSUPPORT,
         "Exif data is null for key: %{public}s", key.c_str());
     CHECK_DEBUG_RETURN_RET_LOG(!ExifMetadatFormatter::IsKeySupported(key), ERR_IMAGE_DECODE_EXIF_UNSUPPORT,
@@ -1296,6 +1618,10 @@ std::shared_ptr<ImageMetadata> ExifMetadata::CloneMetadata()
 int ExifMetadata::HandleMakerNote(std::string &value) const
 {
     value.clear();
+    // Loaded data without a MakerNote entry ends in GetUserMakerNote with the same result
+    CHECK_DEBUG_RETURN_RET_LOG(IsLazyWithoutMakerNote(), ERR_IMAGE_DECODE_EXIF_UNSUPPORT,
+        "Lazy exif data has no maker note.");
+    CHECK_ERROR_RETURN_RET(EnsureExifData() == nullptr, ERR_IMAGE_DECODE_EXIF_UNSUPPORT);
     std::vector<char> tagValueChar(TAG_VALUE_SIZE, 0);
     ExifMnoteData *md = exif_data_get_mnote_data(exifData_);
     bool cond = false;
@@ -1338,14 +1664,20 @@ int ExifMetadata::HandleHwMnote(const std::string &key, std::string &value) cons
     value = DEFAULT_EXIF_VALUE;
     char tagValueChar[TAG_VALUE_SIZE];
     if (key == HW_FOCUS_MODE_EXIF) {
+        value.clear();
+        CHECK_DEBUG_RETURN_RET_LOG(IsLazyWithoutMakerNote(), ERR_IMAGE_DECODE_EXIF_UNSUPPORT,
+            "Lazy exif data has no maker note.");
+        CHECK_ERROR_RETURN_RET(EnsureExifData() == nullptr, ERR_IMAGE_DECODE_EXIF_UNSUPPORT);
         auto entry = exif_data_get_entry_ext(exifData_, EXIF_TAG_MAKER_NOTE);
+        // exif_entry_get_value leaves the buffer untouched for a missing entry
+        CHECK_ERROR_RETURN_RET(entry == nullptr, ERR_IMAGE_DECODE_EXIF_UNSUPPORT);
         exif_entry_get_value(entry, tagValueChar, sizeof(tagValueChar));
         value = tagValueChar;
         bool cond = value.empty();
         CHECK_ERROR_RETURN_RET(cond, ERR_IMAGE_DECODE_EXIF_UNSUPPORT);
         return SUCCESS;
     }
-    ExifMnoteData *md = exif_data_get_mnote_data(exifData_);
+    ExifMnoteData *md = GetMnoteData();
     bool cond = false;
     cond = md == nullptr;
     CHECK_DEBUG_RETURN_RET_LOG(cond, SUCCESS, "Exif data mnote data md is nullptr");
@@ -1372,7 +1704,7 @@ int ExifMetadata::HandleHwMnote(const std::string &key, std::string &value) cons
 
 ExifData *ExifMetadata::GetExifData()
 {
-    return exifData_;
+    return EnsureExifData();
 }
 
 bool ExifMetadata::CreateExifdata()
@@ -1409,6 +1741,12 @@ bool ExifMetadata::CreateExifdata()
 
 std::shared_ptr<ExifMetadata> ExifMetadata::Clone()
 {
+    if (lazyIndex_ != nullptr) {
+        std::lock_guard<std::mutex> lock(lazyIndex_->mutex);
+        if (exifData_ == nullptr && !lazyIndex_->blob.empty()) {
+            return CreateLazy(lazyIndex_->blob.data(), static_cast<uint32_t>(lazyIndex_->blob.size()));
+        }
+    }
     ExifData *exifData = this->GetExifData();
 
     unsigned char *dataBlob = nullptr;
@@ -1435,7 +1773,7 @@ std::shared_ptr<ExifMetadata> ExifMetadata::Clone()
 
 bool ExifMetadata::GetDataSize(uint32_t &size, bool withThumbnail, bool isJpeg)
 {
-    CHECK_ERROR_RETURN_RET_LOG(exifData_ == nullptr, false, "%{public}s: exifData_ is nullptr", __func__);
+    CHECK_ERROR_RETURN_RET_LOG(EnsureExifData() == nullptr, false, "%{public}s: exifData_ is nullptr", __func__);
 
     ScopeRestorer<unsigned char *> thumbDataRestorer(exifData_->data);
     ScopeRestorer<unsigned int> thumbSizeRestorer(exifData_->size);
@@ -1469,13 +1807,13 @@ bool ExifMetadata::GetDataSize(uint32_t &size, bool withThumbnail, bool isJpeg)
 
 bool ExifMetadata::HasThumbnail()
 {
-    CHECK_ERROR_RETURN_RET_LOG(exifData_ == nullptr, false, "%{public}s: exifData_ is nullptr", __func__);
+    CHECK_ERROR_RETURN_RET_LOG(EnsureExifData() == nullptr, false, "%{public}s: exifData_ is nullptr", __func__);
     return exifData_->data != nullptr && exifData_->size != 0;
 }
 
 bool ExifMetadata::GetThumbnail(uint8_t *&data, uint32_t &size)
 {
-    CHECK_ERROR_RETURN_RET_LOG(exifData_ == nullptr, false, "%{public}s: exifData_ is nullptr", __func__);
+    CHECK_ERROR_RETURN_RET_LOG(EnsureExifData() == nullptr, false, "%{public}s: exifData_ is nullptr", __func__);
     data = reinterpret_cast<uint8_t *>(exifData_->data);
     size = static_cast<uint32_t>(exifData_->size);
     IMAGE_LOGD("%{public}s: size: %{public}u", __func__, size);
@@ -1485,7 +1823,7 @@ bool ExifMetadata::GetThumbnail(uint8_t *&data, uint32_t &size)
 
 bool ExifMetadata::SetThumbnail(uint8_t *data, const uint32_t &size)
 {
-    CHECK_ERROR_RETURN_RET_LOG(exifData_ == nullptr, false, "%{public}s: exifData_ is nullptr", __func__);
+    CHECK_ERROR_RETURN_RET_LOG(EnsureExifData() == nullptr, false, "%{public}s: exifData_ is nullptr", __func__);
     CHECK_ERROR_RETURN_RET_LOG(data == nullptr || size == 0, false, "%{public}s: data or size is invalid", __func__);
 
     // Free old thumbnail memory if it exists
@@ -1509,7 +1847,7 @@ bool ExifMetadata::SetThumbnail(uint8_t *data, const uint32_t &size)
 
 bool ExifMetadata::DropThumbnail()
 {
-    bool cond = exifData_ == nullptr;
+    bool cond = EnsureExifData() == nullptr;
     CHECK_ERROR_RETURN_RET_LOG(cond, false, "%{public}s: exifData_ is nullptr", __func__);
     CHECK_DEBUG_RETURN_RET_LOG(!HasThumbnail(), true, "%{public}s: No thumbnail to drop", __func__);
     ExifMem *mem = exif_data_get_priv_mem(exifData_);
@@ -1641,6 +1979,9 @@ ExifEntry *ExifMetadata::GetEntry(const std::string &key) const
     IMAGE_LOGD("GetEntry by key is %{public}s.", key.c_str());
     ExifTag tag = exif_tag_from_name(key.c_str());
     ExifEntry *entry = nullptr;
+    if (GetLazyEntry(key, tag, entry)) {
+        return entry;
+    }
     if (tag == 0x0001 || tag == 0x0002) {
         ExifIfd ifd = exif_ifd_from_name(key.c_str());
         entry = exif_content_get_entry(exifData_->ifd[ifd], tag);
@@ -1785,7 +2126,7 @@ bool ExifMetadata::SetMem(ExifEntry *ptrEntry, const std::string &value, const s
 
 bool ExifMetadata::SetValue(const std::string &key, const std::string &value)
 {
-    bool cond = exifData_ == nullptr;
+    bool cond = EnsureExifData() == nullptr;
     CHECK_ERROR_RETURN_RET_LOG(cond, false, "Exif data is null. Cannot set value for key: %{public}s", key.c_str());
     CHECK_ERROR_RETURN_RET_LOG(value.empty(), false, "Set empty value.");
     auto result = ExifMetadatFormatter::Format(key, value, isSystemApi_);
@@ -1942,6 +2283,8 @@ bool ExifMetadata::SetBlobValue(const MetadataValue &properties)
     std::string key = properties.key;
     const std::vector<uint8_t>& blobData = properties.bufferValue;
     size_t blobSize = blobData.size();
+    CHECK_ERROR_RETURN_RET_LOG(EnsureExifData() == nullptr, false, "Exif data is null for key: %{public}s",
+        key.c_str());
     ExifEntry* entry = GetEntry(key, blobSize);
     bool cond = entry == nullptr;
     CHECK_ERROR_RETURN_RET_LOG(cond, false, "Failed to get/create entry for key: %{public}s", key.c_str());
@@ -2013,7 +2356,7 @@ bool ExifMetadata::RemoveEntry(const std::string &key)
 {
     bool isSuccess = false;
     bool cond = false;
-    cond = !(exifData_ && ExifMetadatFormatter::IsModifyAllowed(key));
+    cond = !(ExifMetadatFormatter::IsModifyAllowed(key) && EnsureExifData() != nullptr);
     CHECK_DEBUG_RETURN_RET_LOG(cond, isSuccess,
                                "RemoveEntry failed, can not remove entry for key: %{public}s", key.c_str());
 
@@ -2060,7 +2403,7 @@ bool ExifMetadata::IsSpecialHwKey(const std::string &key) const
 void ExifMetadata::GetFilterArea(const std::vector<std::string> &exifKeys,
                                  std::vector<std::pair<uint32_t, uint32_t>> &ranges)
 {
-    CHECK_DEBUG_RETURN_LOG(exifData_ == nullptr, "Exif data is null");
+    CHECK_DEBUG_RETURN_LOG(EnsureExifData() == nullptr, "Exif data is null");
     auto size = exifKeys.size();
     for (unsigned long keySize = 0; keySize < size; keySize++) {
         ExifTag tag = exif_tag_from_name(exifKeys[keySize].c_str());
@@ -2107,7 +2450,7 @@ void ExifMetadata::FindRanges(const ExifTag &tag, std::vector<std::pair<uint32_t
 
 bool ExifMetadata::Marshalling(Parcel &parcel) const
 {
-    CHECK_ERROR_RETURN_RET(exifData_ == nullptr, false);
+    CHECK_ERROR_RETURN_RET(EnsureExifData() == nullptr, false);
 
     unsigned char *data = nullptr;
     unsigned int size = 0;
@@ -2167,7 +2510,7 @@ ExifMetadata *ExifMetadata::Unmarshalling(Parcel &parcel, PICTURE_ERR &error)
 
 bool ExifMetadata::RemoveExifThumbnail()
 {
-    bool cond = exifData_ == nullptr;
+    bool cond = EnsureExifData() == nullptr;
     CHECK_ERROR_RETURN_RET(cond, false);
     exifData_->remove_thumbnail = 1;
     IMAGE_LOGD("%{public}s set remove exif thumbnail flag", __func__);
@@ -2216,7 +2559,7 @@ bool ExifMetadata::ParseExifCoordinate(const std::string& fieldName, uint32_t& o
 
 bool ExifMetadata::ExtractXmageCoordinates(XmageCoordinateMetadata& coordMetadata) const
 {
-    CHECK_ERROR_RETURN_RET_LOG(exifData_ == nullptr, false,
+    CHECK_ERROR_RETURN_RET_LOG(!HasExifData(), false,
         "Exif_metadata:ExtractXMageCoordinates HDR-IMAGE Exif metadata is null, cannot read XMAGE coordinates");
     bool allParsedSuccessfully = ParseExifCoordinate("HwMnoteXmageLeft", coordMetadata.left) &&
         ParseExifCoordinate("HwMnoteXmageTop", coordMetadata.top) &&
@@ -2236,7 +2579,7 @@ bool ExifMetadata::ExtractXmageCoordinates(XmageCoordinateMetadata& coordMetadat
 
 uint32_t ExifMetadata::GetBlobSize()
 {
-    CHECK_ERROR_RETURN_RET_LOG(exifData_ == nullptr, 0, "Exif data is null");
+    CHECK_ERROR_RETURN_RET_LOG(EnsureExifData() == nullptr, 0, "Exif data is null");
     unsigned int size = 0;
     unsigned char* data = nullptr;
     exif_data_save_data(exifData_, &data, &size);
@@ -2248,7 +2591,7 @@ uint32_t ExifMetadata::GetBlobSize()
 
 uint32_t ExifMetadata::GetBlob(uint32_t bufferSize, uint8_t* dst)
 {
-    CHECK_ERROR_RETURN_RET_LOG(exifData_ == nullptr || dst == nullptr, ERR_IMAGE_INVALID_PARAMETER,
+    CHECK_ERROR_RETURN_RET_LOG(dst == nullptr || EnsureExifData() == nullptr, ERR_IMAGE_INVALID_PARAMETER,
         "GetBlob failed: exifData_ is null or dst is null");
     unsigned char* exifBlob = nullptr;
     unsigned int exifSize = 0;
@@ -2313,7 +2656,7 @@ std::shared_ptr<ExifMetadata> ExifMetadata::InitExifMetadata()
 
 bool ExifMetadata::RemoveGpsInfo()
 {
-    CHECK_DEBUG_RETURN_RET_LOG(exifData_ == nullptr, false, "RemoveGpsInfo: exifData_ is nullptr");
+    CHECK_DEBUG_RETURN_RET_LOG(EnsureExifData() == nullptr, false, "RemoveGpsInfo: exifData_ is nullptr");
 
     std::shared_ptr<ExifMetadata> backup = Clone();
     CHECK_ERROR_RETURN_RET_LOG(backup == nullptr, false, "RemoveGpsInfo: failed to clone exif metadata");
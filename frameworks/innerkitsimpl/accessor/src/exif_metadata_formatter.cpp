@@ -13,13 +13,18 @@
  * limitations under the License.
  */
 
+#include <algorithm>
+#include <cctype>
 #include <cmath>
 #include <iostream>
+#include <mutex>
 #include <regex>
+#include <shared_mutex>
 #include <string_view>
 #include <set>
 #include <string>
 #include <sstream>
+#include <unordered_map>
 #include <utility>
 #include <charconv>
 #include <system_error>
@@ -579,6 +584,7 @@ ExifMetadatFormatter::ExifMetadatFormatter()
     InitValueRangeValidateConfig();
     InitValueFormatConvertConfig();
     InitValueTemplateConfig();
+    PrecompileRegexes();
 }
 
 // configuration for value range validation. For example GPSLatitudeRef the value must be 'N' or 'S'.
@@ -889,7 +895,8 @@ void ExifMetadatFormatter::InitValueTemplateConfig()
 }
 
 const size_t DECIMAL_BASE = 10;
-const std::string COMMA_REGEX("\\,"), COLON_REGEX("\\:"), DOT_REGEX("\\.");
+const char DIGIT_CHARS[] = "0123456789";
+const char CHANNEL_CHARS[] = "-YCbCrRGB";
 const std::set<std::string> UINT16_KEYS = {
     "ImageLength", "ImageWidth", "ISOSpeedRatings", "ISOSpeedRatings",
     "FocalLengthIn35mmFilm", "SamplesPerPixel", "PhotographicSensitivity"
@@ -924,7 +931,7 @@ const auto DATETIME_REGEX =
 const auto DATE_REGEX = R"(^[0-9]{4}:(0[1-9]|1[012]):(0[1-9]|[12][0-9]|3[01])$)";
 const auto VERSION_REGEX = R"(^[0-9]+\.[0-9]+$)";
 const auto CHANNEL_REGEX = R"(^[-YCbCrRGB]+(\s[-YCbCrRGB]+)+$)";
-const auto SENSITIVE_REGEX = R"(gps|lati|longi)";
+const std::string_view SENSITIVE_KEY_PARTS[] = { "gps", "lati", "longi" };
 const auto FACE_INFO_REGEX = R"(^(\s*-?\d+(\.\d+)?)(\s*[\s,]\s*(-?\d+(\.\d+)?)){0,99}\s*$)";
 const auto FACE_BLUR_INFO_REGEX = R"(^\d+(?:(?:, ?| )\d+){0,9}$)";
 
@@ -944,27 +951,47 @@ bool ExifMetadatFormatter::IsValidValue(const TagDetails *array, const size_t &s
     return false;
 }
 
-// validate regex only
-bool ExifMetadatFormatter::ValidRegex(const std::string &value, const std::string &regex)
+// Patterns are compiled once per process, compiling dominated the cost of every validation.
+static const std::regex &GetCompiledRegex(const std::string &pattern)
 {
-    IMAGE_LOGD("Validating against regex: %{public}s", regex.c_str());
-    std::regex ratPattern(regex);
-    CHECK_DEBUG_RETURN_RET_LOG(!std::regex_match(value, ratPattern), false,
-        "Validation failed.Regex: %{public}s", regex.c_str());
-    return true;
+    static std::shared_mutex mutex;
+    static std::unordered_map<std::string, std::regex> compiled;
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        auto it = compiled.find(pattern);
+        if (it != compiled.end()) {
+            return it->second;
+        }
+    }
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    return compiled.try_emplace(pattern, pattern).first->second;
+}
+
+static bool IsDigitAt(const std::string &value, size_t pos)
+{
+    return pos < value.size() && std::isdigit(static_cast<unsigned char>(value[pos]));
 }
 
-// replace as space according to regex
-void ExifMetadatFormatter::ReplaceAsSpace(std::string &value, const std::string &regex)
+static size_t SkipDigits(const std::string &value, size_t pos)
 {
-    std::regex pattern(regex);
-    value = std::regex_replace(value, pattern, " ");
+    while (IsDigitAt(value, pos)) {
+        pos++;
+    }
+    return pos;
 }
 
-void ExifMetadatFormatter::ReplaceAsContent(std::string &value, const std::string &regex, const std::string &content)
+static void ReplaceChar(std::string &value, char from, char to)
+{
+    std::replace(value.begin(), value.end(), from, to);
+}
+
+// validate regex only
+bool ExifMetadatFormatter::ValidRegex(const std::string &value, const std::string &regex)
 {
-    std::regex pattern(regex);
-    value = std::regex_replace(value, pattern, content);
+    IMAGE_LOGD("Validating against regex: %{public}s", regex.c_str());
+    CHECK_DEBUG_RETURN_RET_LOG(!std::regex_match(value, GetCompiledRegex(regex)), false,
+        "Validation failed.Regex: %{public}s", regex.c_str());
+    return true;
 }
 
 // validate the regex & replace comma as space
@@ -972,26 +999,23 @@ bool ExifMetadatFormatter::ValidRegexWithComma(std::string &value, const std::st
 {
     IMAGE_LOGD("Validating comma against regex: %{public}s", regex.c_str());
     CHECK_ERROR_RETURN_RET(!ValidRegex(value, regex), false);
-    ReplaceAsSpace(value, COMMA_REGEX);
+    ReplaceChar(value, ',', ' ');
     return true;
 }
 
 // convert integer to rational format. For example 23 15 83 --> 23/1 15/1 83/1
 void ExifMetadatFormatter::RationalFormat(std::string &value)
 {
-    std::regex pattern("\\d+"); // regex for integer
     std::string result;
     int icount = 0;
-    while (std::regex_search(value, pattern)) {
-        std::smatch match;
-        if (!std::regex_search(value, match, pattern)) {
-            break; // break since there is no matched value
-        }
+    size_t pos = 0;
+    while ((pos = value.find_first_of(DIGIT_CHARS, pos)) != std::string::npos) {
+        size_t end = SkipDigits(value, pos);
         if (icount != 0) {
             result += " ";
         }
-        result += match.str() + "/1"; // appending '/1' to integer
-        value = match.suffix().str(); // skip handled value part
+        result.append(value, pos, end - pos).append("/1"); // appending '/1' to integer
+        pos = end;
         icount++;
     }
     value = result;
@@ -1048,27 +1072,30 @@ bool ExifMetadatFormatter::ValidDecimalRationalFormat(std::string &value)
 {
     std::string result;
     int icount = 0;
-    std::regex parPattern("(\\d+)(\\.\\d+)?");
+    size_t pos = 0;
 
-    // with partial regex For 2.5 26 1.2 to iterator each segment 2.5->5/2
-    for (std::sregex_iterator it = std::sregex_iterator(value.begin(), value.end(), parPattern);
-        it != std::sregex_iterator(); ++it) {
-        std::smatch match = *it;
+    // scan each segment of 2.5 26 1.2, a segment is digits with an optional fraction, 2.5->5/2
+    while ((pos = value.find_first_of(DIGIT_CHARS, pos)) != std::string::npos) {
+        size_t end = SkipDigits(value, pos);
+        bool isDecimal = end < value.size() && value[end] == '.' && IsDigitAt(value, end + 1);
+        if (isDecimal) {
+            end = SkipDigits(value, end + 1);
+        }
+        std::string segment = value.substr(pos, end - pos);
+        pos = end;
 
         // add a space at begin of each segment except the first segment
         if (icount != 0) {
             result += " ";
         }
 
-        // 1.if segment is integer type 123->123/1
-        if (ValidRegex(match[0], "\\d+")) {
+        if (!isDecimal) {
             // append '/1' to integer 23 -> 23/1
-            result += match.str() + "/1";
-        }
-        if (ValidRegex(match[0], "\\d+\\.\\d+")) {
+            result += segment + "/1";
+        } else {
             // segment is decimal call decimalToFraction 2.5 -> 5/2
             bool isOutRange = false;
-            auto tmpRes = GetFractionFromStr(match[0], isOutRange);
+            auto tmpRes = GetFractionFromStr(segment, isOutRange);
             CHECK_ERROR_RETURN_RET(isOutRange, false);
             result += tmpRes;
         }
@@ -1082,30 +1109,36 @@ bool ExifMetadatFormatter::ValidConvertRationalFormat(std::string &value)
 {
     std::string result;
     int icount = 0;
-    std::regex parPattern("\\d+(\\.\\d+)?(/\\d+)?");
+    size_t pos = 0;
 
-    // with partial regex For 2.5 26 1.2 to iterator each segment 2.5->5/2
-    for (std::sregex_iterator it = std::sregex_iterator(value.begin(), value.end(), parPattern);
-        it != std::sregex_iterator(); ++it) {
-        std::smatch match = *it;
+    // scan each segment of 2.5 26 1/2, digits with an optional fraction and an optional denominator
+    while ((pos = value.find_first_of(DIGIT_CHARS, pos)) != std::string::npos) {
+        size_t end = SkipDigits(value, pos);
+        bool isDecimal = end < value.size() && value[end] == '.' && IsDigitAt(value, end + 1);
+        if (isDecimal) {
+            end = SkipDigits(value, end + 1);
+        }
+        bool isRational = end < value.size() && value[end] == '/' && IsDigitAt(value, end + 1);
+        if (isRational) {
+            end = SkipDigits(value, end + 1);
+        }
+        std::string segment = value.substr(pos, end - pos);
+        pos = end;
 
         // add a space at begin of each segment except the first segment
         if (icount != 0) {
             result += " ";
         }
 
-        // 1.if segment is integer type 123->123/1
-        if (ValidRegex(match[0], "\\d+")) {
+        if (!isDecimal && !isRational) {
             // append '/1' to integer 23 -> 23/1
-            result += match.str() + "/1";
-        }
-        if (ValidRegex(match[0], "\\d+/\\d+")) {
-            result += match.str();
-        }
-        if (ValidRegex(match[0], "\\d+\\.\\d+")) {
+            result += segment + "/1";
+        } else if (!isDecimal) {
+            result += segment;
+        } else if (!isRational) {
             // segment is decimal call decimalToFraction 2.5 -> 5/2
             bool isOutRange = false;
-            auto tmpRes = GetFractionFromStr(match[0], isOutRange);
+            auto tmpRes = GetFractionFromStr(segment, isOutRange);
             CHECK_ERROR_RETURN_RET(isOutRange, false);
             result += tmpRes;
         }
@@ -1133,7 +1166,7 @@ bool ExifMetadatFormatter::ValidRegexWithCommaRationalFormat(std::string &value,
     CHECK_ERROR_RETURN_RET(!ValidRegex(value, regex), false);
 
     // 2.replace comma as a space
-    ReplaceAsSpace(value, COMMA_REGEX);
+    ReplaceChar(value, ',', ' ');
 
     // 3.convert integer to rational format. 9 9 9 -> 9/1 9/1 9/1
     RationalFormat(value);
@@ -1147,7 +1180,7 @@ bool ExifMetadatFormatter::ValidRegexWithColonRationalFormat(std::string &value,
     CHECK_ERROR_RETURN_RET(!ValidRegex(value, regex), false);
 
     // 2.replace colon as a space
-    ReplaceAsSpace(value, COLON_REGEX);
+    ReplaceChar(value, ':', ' ');
 
     // 3.convert integer to rational format. 9 9 9 -> 9/1 9/1 9/1
     RationalFormat(value);
@@ -1158,7 +1191,7 @@ bool ExifMetadatFormatter::ValidRegexWithColonRationalFormat(std::string &value,
 bool ExifMetadatFormatter::ValidRegexWithDot(std::string &value, const std::string &regex)
 {
     CHECK_ERROR_RETURN_RET(!ValidRegex(value, regex), false);
-    ReplaceAsContent(value, DOT_REGEX, "");
+    value.erase(std::remove(value.begin(), value.end(), '.'), value.end());
     return true;
 }
 
@@ -1168,7 +1201,7 @@ bool ExifMetadatFormatter::ValidRegxWithCommaDecimalRationalFormat(std::string &
     CHECK_ERROR_RETURN_RET(!ValidRegex(value, regex), false);
 
     // replace comma with a space 1.5,2.5.3 -> 1.5 2.5 3
-    ReplaceAsSpace(value, COMMA_REGEX);
+    ReplaceChar(value, ',', ' ');
 
     // convert decimal to rationl 2.5 -> 5/2
     return ValidDecimalRationalFormat(value);
@@ -1179,10 +1212,10 @@ bool ExifMetadatFormatter::ValidRegxAndConvertRationalFormat(std::string &value,
     CHECK_ERROR_RETURN_RET(!ValidRegex(value, regex), false);
 
     // replace comma with a space 1.5,2.5.3 -> 1.5 2.5 3
-    ReplaceAsSpace(value, COMMA_REGEX);
+    ReplaceChar(value, ',', ' ');
 
     // replace colon
-    ReplaceAsSpace(value, COLON_REGEX);
+    ReplaceChar(value, ':', ' ');
 
     return ValidConvertRationalFormat(value);
 }
@@ -1202,13 +1235,13 @@ bool ExifMetadatFormatter::ValidRegexWithVersionFormat(std::string &value, const
     CHECK_ERROR_RETURN_RET(!ValidRegex(value, regex), false);
 
     std::string result;
-    std::regex parPattern("[0-9]{1,2}");
-
     int icount = 0;
-    for (std::sregex_iterator it = std::sregex_iterator(value.begin(), value.end(), parPattern);
-        it != std::sregex_iterator(); ++it) {
-        std::smatch match = *it;
-        std::string tmp = match[0].str();
+    size_t pos = 0;
+    // every one or two digit run is a version component
+    while ((pos = value.find_first_of(DIGIT_CHARS, pos)) != std::string::npos) {
+        size_t length = IsDigitAt(value, pos + 1) ? CONSTANT_2 : CONSTANT_1;
+        std::string tmp = value.substr(pos, length);
+        pos += length;
         if (icount == 0 && tmp.length() == 1) {
             result += "0" + tmp;
         } else if (icount == 1 && tmp.length() == 1) {
@@ -1227,12 +1260,11 @@ bool ExifMetadatFormatter::ValidRegexWithChannelFormat(std::string &value, const
     CHECK_ERROR_RETURN_RET(!ValidRegex(value, regex), false);
 
     std::string result;
-    std::regex parPattern("[-YCbCrRGB]+");
-
-    for (std::sregex_iterator it = std::sregex_iterator(value.begin(), value.end(), parPattern);
-        it != std::sregex_iterator(); ++it) {
-        std::smatch match = *it;
-        std::string tmp = match[0].str();
+    size_t pos = 0;
+    while ((pos = value.find_first_of(CHANNEL_CHARS, pos)) != std::string::npos) {
+        size_t end = std::min(value.find_first_not_of(CHANNEL_CHARS, pos), value.size());
+        std::string tmp = value.substr(pos, end - pos);
+        pos = end;
         if (tmp == "-") {
             result += "0";
         } else if (tmp == "Y") {
@@ -1257,7 +1289,7 @@ bool ExifMetadatFormatter::ValidRegexWithDoubleFormat(std::string &value, const
 {
     CHECK_ERROR_RETURN_RET(!ValidRegex(value, regex), false);
 
-    ReplaceAsSpace(value, COMMA_REGEX);
+    ReplaceChar(value, ',', ' ');
     return true;
 }
 
@@ -1427,14 +1459,16 @@ int32_t ExifMetadatFormatter::ValidateValueRange(const std::string &keyName, con
     int32_t ivalue = -1;
 
     // validate value if integer or char 2.char ascii
-    std::regex regNum(R"(^[0-9]+$)");    // regex for integer value. For example WhiteBalance support 0 or 1
-    std::regex regChar(R"(^[a-zA-Z]$)"); // regex for char value. For example GPSLatitudeRef support N or S
-    if (std::regex_match(value, regNum)) {
+    // integer value. For example WhiteBalance support 0 or 1
+    bool isNumber = !value.empty() && value.find_first_not_of(DIGIT_CHARS) == std::string::npos;
+    // char value. For example GPSLatitudeRef support N or S
+    bool isChar = value.size() == 1 && std::isalpha(static_cast<unsigned char>(value[0]));
+    if (isNumber) {
         // convert string to integer such as "15" -> 15  and check ll out of range
         auto [p, ec] = std::from_chars(value.data(), value.data() + value.size(), ivalue);
         CHECK_ERROR_RETURN_RET(ec != std::errc(), Media::ERR_MEDIA_OUT_OF_RANGE);
     }
-    if (std::regex_match(value, regChar)) {
+    if (isChar) {
         // convert char to integer such as "N" -> 78
         ivalue = static_cast<int32_t>(value[0]);
     }
@@ -1480,14 +1514,27 @@ const std::set<std::string> FORBIDDEN_VALUE = {
 bool ExifMetadatFormatter::IsForbiddenValue(const std::string &value)
 {
     for (const auto &regex : FORBIDDEN_VALUE) {
-        std::regex ratPattern(regex);
-        if (std::regex_match(value, ratPattern)) {
+        if (std::regex_match(value, GetCompiledRegex(regex))) {
             return true;
         }
     }
     return false;
 }
 
+// Compiles every configured pattern up front, so validations only look them up.
+void ExifMetadatFormatter::PrecompileRegexes()
+{
+    for (const auto &[keyName, delegate] : valueFormatConvertConfig_) {
+        GetCompiledRegex(delegate.second);
+    }
+    for (const auto &[keyName, pattern] : valueTemplateConfig_) {
+        GetCompiledRegex(pattern);
+    }
+    for (const auto &pattern : FORBIDDEN_VALUE) {
+        GetCompiledRegex(pattern);
+    }
+}
+
 void ExifMetadatFormatter::ExtractValue(const std::string &keyName, std::string &value)
 {
     auto it = ExifMetadatFormatter::GetInstance().valueTemplateConfig_.find(keyName);
@@ -1495,7 +1542,7 @@ void ExifMetadatFormatter::ExtractValue(const std::string &keyName, std::string
     for (; it != ExifMetadatFormatter::GetInstance().valueTemplateConfig_.end() &&
         it != ExifMetadatFormatter::GetInstance().valueTemplateConfig_.upper_bound(keyName);
         it++) {
-        std::regex pattern(it->second);
+        const std::regex &pattern = GetCompiledRegex(it->second);
         for (std::sregex_iterator i = std::sregex_iterator(value.begin(), value.end(), pattern);
             i != std::sregex_iterator();
             ++i) {
@@ -1689,8 +1736,11 @@ int32_t ExifMetadatFormatter::Validate(const std::string &keyName, const std::st
 
 bool ExifMetadatFormatter::IsSensitiveInfo(const std::string &keyName)
 {
-    std::regex pattern(SENSITIVE_REGEX, std::regex::icase);
-    return std::regex_search(keyName, pattern);
+    std::string lowerKey = keyName;
+    std::transform(lowerKey.begin(), lowerKey.end(), lowerKey.begin(),
+        [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return std::any_of(std::begin(SENSITIVE_KEY_PARTS), std::end(SENSITIVE_KEY_PARTS),
+        [&lowerKey](std::string_view part) { return lowerKey.find(part) != std::string::npos; });
 }
 } // namespace Media
 } // namespace OHOS
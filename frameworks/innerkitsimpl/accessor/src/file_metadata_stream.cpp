@@ -511,5 +511,22 @@ ssize_t FileMetadataStream::GetSize()
     return fileSize;
 }
 
+bool FileMetadataStream::Truncate(size_t size)
+{
+    ssize_t fileSize = GetSize();
+    if (fileSize < 0 || size > static_cast<size_t>(fileSize) || !Flush()) {
+        return false;
+    }
+    int fileDescriptor = fileno(fp_);
+    if (ftruncate(fileDescriptor, size) == -1) {
+        HandleFileError("Truncate file", filePath_, fileDescriptor, -1, size);
+        return false;
+    }
+    if (Tell() > static_cast<long>(size)) {
+        Seek(static_cast<long>(size), SeekPos::BEGIN);
+    }
+    return true;
+}
+
 } // namespace Media
 } // namespace OHOS
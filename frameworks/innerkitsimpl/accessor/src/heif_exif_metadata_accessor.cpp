@@ -35,6 +35,47 @@ using namespace ImagePlugin;
 
 const auto EXIF_ID = "Exif\0\0";
 
+namespace {
+// Positioned reads on the metadata stream, so the box scan neither maps nor copies the file.
+class HeifMetadataInputStream : public HeifInputStream {
+public:
+    explicit HeifMetadataInputStream(const std::shared_ptr<MetadataStream> &stream)
+        : stream_(stream), size_(stream->GetSize())
+    {
+        stream_->Seek(0, SeekPos::BEGIN);
+    }
+
+    int64_t Tell() const override
+    {
+        return stream_->Tell();
+    }
+
+    bool CheckSize(size_t size, int64_t end) override
+    {
+        int64_t pos = Tell();
+        bool cond = pos < 0 || pos > size_ || size > static_cast<uint64_t>(size_ - pos);
+        CHECK_ERROR_RETURN_RET(cond, false);
+        return end < 0 || pos + static_cast<int64_t>(size) <= end;
+    }
+
+    bool Read(void *data, size_t size) override
+    {
+        CHECK_ERROR_RETURN_RET(data == nullptr || !CheckSize(size, -1), false);
+        return size == 0 || stream_->Read(static_cast<byte *>(data), size) == static_cast<ssize_t>(size);
+    }
+
+    bool Seek(int64_t position) override
+    {
+        CHECK_ERROR_RETURN_RET(position < 0 || position > size_, false);
+        return stream_->Seek(position, SeekPos::BEGIN) == position;
+    }
+
+private:
+    std::shared_ptr<MetadataStream> stream_;
+    int64_t size_;
+};
+} // namespace
+
 HeifExifMetadataAccessor::HeifExifMetadataAccessor(std::shared_ptr<MetadataStream> &stream)
     : AbstractExifMetadataAccessor(stream)
 {}
@@ -43,20 +84,23 @@ HeifExifMetadataAccessor::~HeifExifMetadataAccessor() {}
 
 uint32_t HeifExifMetadataAccessor::Read()
 {
-    std::shared_ptr<HeifParser> parser;
-    heif_error parseRet = HeifParser::MakeFromMemory(imageStream_->GetAddr(), imageStream_->GetSize(), false, &parser);
-    if (parseRet != heif_error_ok) {
-        if (ReadCr3() == SUCCESS) {
-            return SUCCESS;
+    DataBuf dataBuf;
+    if (!ScanExifItemData(dataBuf)) {
+        std::shared_ptr<HeifParser> parser;
+        heif_error parseRet = HeifParser::MakeFromMemory(imageStream_->GetAddr(), imageStream_->GetSize(), false,
+            &parser);
+        if (parseRet != heif_error_ok) {
+            if (ReadCr3() == SUCCESS) {
+                return SUCCESS;
+            }
+            IMAGE_LOGE("The image source data is incorrect.");
+            return ERR_IMAGE_SOURCE_DATA;
         }
-        IMAGE_LOGE("The image source data is incorrect.");
-        return ERR_IMAGE_SOURCE_DATA;
-    }
 
-    DataBuf dataBuf;
-    if (!GetExifItemData(parser, dataBuf)) {
-        IMAGE_LOGD("The EXIF value is invalid.");
-        return ERR_IMAGE_SOURCE_DATA;
+        if (!GetExifItemData(parser, dataBuf)) {
+            IMAGE_LOGD("The EXIF value is invalid.");
+            return ERR_IMAGE_SOURCE_DATA;
+        }
     }
 
     size_t byteOrderPos;
@@ -182,6 +226,40 @@ bool HeifExifMetadataAccessor::GetExifItemData(std::shared_ptr<HeifParser> &pars
     return true;
 }
 
+// Reads the Exif item straight from its extents. Files with several Exif items are left to the full parser,
+// which picks the one describing the primary image.
+bool HeifExifMetadataAccessor::ScanExifItemData(DataBuf &dataBuf)
+{
+    CHECK_ERROR_RETURN_RET(imageStream_ == nullptr || !imageStream_->IsOpen(), false);
+    auto stream = std::make_shared<HeifMetadataInputStream>(imageStream_);
+    std::vector<HeifMetadataLocation> locations;
+    CHECK_ERROR_RETURN_RET(HeifParser::ScanMetadataItems(stream, locations) != heif_error_ok, false);
+    const HeifMetadataLocation *exifLocation = nullptr;
+    for (const auto &location : locations) {
+        if (location.itemType != EXIF_ID) {
+            continue;
+        }
+        CHECK_ERROR_RETURN_RET(exifLocation != nullptr, false);
+        exifLocation = &location;
+    }
+    CHECK_ERROR_RETURN_RET(exifLocation == nullptr, false);
+    uint64_t totalSize = exifLocation->GetTotalSize();
+    CHECK_ERROR_RETURN_RET(totalSize == 0 || totalSize > static_cast<uint64_t>(imageStream_->GetSize()), false);
+
+    DataBuf itemData(static_cast<size_t>(totalSize));
+    size_t readSize = 0;
+    for (const auto &[offset, length] : exifLocation->extents) {
+        bool cond = !stream->Seek(static_cast<int64_t>(offset)) ||
+            !stream->Read(itemData.Data(readSize), static_cast<size_t>(length));
+        CHECK_ERROR_RETURN_RET_LOG(cond, false, "Failed to read heif exif extent, offset: %{public}llu",
+            static_cast<unsigned long long>(offset));
+        readSize += static_cast<size_t>(length);
+    }
+    tiffOffset_ = static_cast<long>(exifLocation->extents.front().first);
+    dataBuf = std::move(itemData);
+    return true;
+}
+
 bool HeifExifMetadataAccessor::GetExifItemIdByHeifParser(std::shared_ptr<ImagePlugin::HeifParser> &parser,
     ImagePlugin::heif_item_id &exifItemId)
 {
@@ -34,6 +34,7 @@ namespace {
 using uint_8 = byte;
 constexpr byte JPEG_MARKER_APP0 = 0xe0;
 constexpr byte JPEG_MARKER_APP1 = 0xe1;
+constexpr byte JPEG_MARKER_APP15 = 0xef;
 constexpr byte JPEG_MARKER_SOI = 0xd8;
 constexpr byte JPEG_MARKER_EOI = 0xd9;
 constexpr byte JPEG_MARKER_RST1 = 0xd0;
@@ -68,6 +69,13 @@ uint32_t JpegExifMetadataAccessor::Read()
         return ERR_IMAGE_SOURCE_DATA;
     }
 
+    // Readers usually ask for a handful of tags, so index the payload and decode tags on demand.
+    exifMetadata_ = ExifMetadata::CreateLazy(reinterpret_cast<const unsigned char *>(dataBuf.CData()),
+        static_cast<uint32_t>(dataBuf.Size()));
+    if (exifMetadata_ != nullptr) {
+        return SUCCESS;
+    }
+
     ExifData *exifData = nullptr;
     TiffParser::DecodeJpegExif(reinterpret_cast<const unsigned char *>(dataBuf.CData()), dataBuf.Size(), &exifData);
     CHECK_ERROR_RETURN_RET_LOG(exifData == nullptr, ERR_EXIF_DECODE_FAILED,
@@ -409,15 +417,145 @@ bool JpegExifMetadataAccessor::UpdateExifMetadata(BufferMetadataStream &bufStrea
     return CopyRestData(bufStream);
 }
 
+// Locates the Exif APP1 segment. Fill bytes behind it count as room too, the last one leads the next marker.
+// Without an Exif segment the position is behind the APPn segments that follow SOI (JFIF APP0 comes first), with
+// no room.
+bool JpegExifMetadataAccessor::FindExifSegment(long &segmentPos, long &segmentRoom)
+{
+    imageStream_->Seek(0, SeekPos::BEGIN);
+    bool cond = FindNextMarker() != JPEG_MARKER_SOI || imageStream_->Tell() != JPEG_HEADER_LENGTH;
+    CHECK_ERROR_RETURN_RET(cond, false);
+    segmentPos = JPEG_HEADER_LENGTH;
+    segmentRoom = 0;
+
+    bool leadingApp = true;
+    int marker = FindNextMarker();
+    while ((marker != EOF) && (marker != JPEG_MARKER_SOS) && (marker != JPEG_MARKER_EOI)) {
+        long markerPos = imageStream_->Tell() - SEGMENT_LENGTH_SIZE;
+        const auto [sizeBuf, size] = ReadSegmentLength(static_cast<byte>(marker));
+        CHECK_ERROR_RETURN_RET(HasLength(static_cast<byte>(marker)) && size < SEGMENT_LENGTH_SIZE, false);
+        long segmentEnd = markerPos + SEGMENT_LENGTH_SIZE + size;
+        if (marker == JPEG_MARKER_APP1 && size >= APP1_EXIF_LENGTH) {
+            std::array<byte, EXIF_ID_SIZE> exifId;
+            CHECK_ERROR_RETURN_RET(imageStream_->Read(exifId.data(), EXIF_ID_SIZE) != EXIF_ID_SIZE, false);
+            if (memcmp(exifId.data(), EXIF_ID, EXIF_ID_SIZE) == 0) {
+                imageStream_->Seek(segmentEnd, SeekPos::BEGIN);
+                long fillBytes = 0;
+                while (imageStream_->ReadByte() == JPEG_MARKER_HEADER) {
+                    ++fillBytes;
+                }
+                segmentPos = markerPos;
+                segmentRoom = segmentEnd - markerPos + std::max(fillBytes - 1, 0L);
+                return true;
+            }
+        }
+        leadingApp = leadingApp && marker >= JPEG_MARKER_APP0 && marker <= JPEG_MARKER_APP15;
+        if (leadingApp) {
+            segmentPos = segmentEnd;
+        }
+        imageStream_->Seek(segmentEnd, SeekPos::BEGIN);
+        marker = FindNextMarker();
+    }
+    return marker != EOF;
+}
+
+// Grows the stream by delta, a buffer stream cannot seek past its end. Existing data is left as is.
+bool JpegExifMetadataAccessor::GrowStream(long delta)
+{
+    DataBuf buf(std::min(delta, static_cast<long>(READ_WRITE_BLOCK_SIZE * READ_WRITE_BLOCK_SIZE_NUM)));
+    long blockSize = static_cast<long>(buf.Size());
+    imageStream_->Seek(0, SeekPos::END);
+    for (long grown = 0; grown < delta; grown += blockSize) {
+        ssize_t growSize = std::min(delta - grown, blockSize);
+        CHECK_ERROR_RETURN_RET_LOG(imageStream_->Write(buf.Data(), growSize) != growSize, false,
+            "Failed to grow image stream. Size: %{public}zd", growSize);
+    }
+    return true;
+}
+
+// Moves the data from tailPos to streamSize back by delta, last block first so nothing is overwritten unread.
+bool JpegExifMetadataAccessor::ShiftTail(long tailPos, long streamSize, long delta)
+{
+    DataBuf buf(READ_WRITE_BLOCK_SIZE * READ_WRITE_BLOCK_SIZE_NUM);
+    long blockSize = static_cast<long>(buf.Size());
+    for (long blockEnd = streamSize; blockEnd > tailPos;) {
+        ssize_t moveSize = std::min(blockEnd - tailPos, blockSize);
+        long blockPos = blockEnd - moveSize;
+        imageStream_->Seek(blockPos, SeekPos::BEGIN);
+        CHECK_ERROR_RETURN_RET(imageStream_->Read(buf.Data(), moveSize) != moveSize, false);
+        imageStream_->Seek(blockPos + delta, SeekPos::BEGIN);
+        CHECK_ERROR_RETURN_RET(imageStream_->Write(buf.Data(), moveSize) != moveSize, false);
+        blockEnd = blockPos;
+    }
+    return true;
+}
+
+// Patches the Exif segment where it is instead of rewriting the stream. A smaller segment keeps the length of
+// the room and zero pads its payload behind the TIFF data, a larger one moves only the data behind it by the
+// missing size. Fill bytes between markers are valid JPEG but are not kept, some readers stop at them.
+// Returns ERR_IMAGE_DATA_UNSUPPORT while the stream is still untouched, so the caller can rewrite it instead.
+uint32_t JpegExifMetadataAccessor::UpdateExifInPlace(uint8_t *dataBlob, uint32_t size)
+{
+    bool cond = dataBlob == nullptr || size > (JPEG_DATA_MAX_SIZE - APP1_EXIF_LENGTH);
+    CHECK_ERROR_RETURN_RET(cond, ERR_IMAGE_DATA_UNSUPPORT);
+    long segmentPos = 0;
+    long segmentRoom = 0;
+    CHECK_ERROR_RETURN_RET(!FindExifSegment(segmentPos, segmentRoom), ERR_IMAGE_DATA_UNSUPPORT);
+
+    // Same header layout as WriteData
+    bool addExifId = size >= EXIF_ID_SIZE && memcmp(dataBlob, EXIF_ID, EXIF_ID_SIZE) != 0;
+    long headerLength = addExifId ? APP1_HEADER_LENGTH : MARKER_LENGTH_SIZE;
+    long segmentSize = headerLength + static_cast<long>(size);
+    // Fill bytes found behind an older segment become padding, as long as the length field can still cover them
+    cond = segmentSize <= segmentRoom && segmentRoom - SEGMENT_LENGTH_SIZE > JPEG_DATA_MAX_SIZE;
+    CHECK_ERROR_RETURN_RET(cond, ERR_IMAGE_DATA_UNSUPPORT);
+    if (segmentSize > segmentRoom) {
+        long delta = segmentSize - segmentRoom;
+        long streamSize = static_cast<long>(imageStream_->GetSize());
+        CHECK_ERROR_RETURN_RET(streamSize < segmentPos + segmentRoom, ERR_IMAGE_DATA_UNSUPPORT);
+        if (!GrowStream(delta)) {
+            // The rewrite copies everything behind SOS, so the stream must be back at its original length
+            cond = imageStream_->GetSize() != streamSize && !imageStream_->Truncate(static_cast<size_t>(streamSize));
+            CHECK_ERROR_RETURN_RET_LOG(cond, ERROR,
+                "Failed to restore image stream size. Size: %{public}ld", streamSize);
+            return ERR_IMAGE_DATA_UNSUPPORT;
+        }
+        CHECK_ERROR_RETURN_RET_LOG(!ShiftTail(segmentPos + segmentRoom, streamSize, delta), ERROR,
+            "Failed to move image data behind EXIF segment. Delta: %{public}ld", delta);
+        segmentRoom += delta;
+    }
+
+    DataBuf segment(segmentRoom);
+    std::fill(segment.Begin(), segment.End(), 0);
+    segment.WriteUInt8(0, JPEG_MARKER_HEADER);
+    segment.WriteUInt8(1, JPEG_MARKER_APP1);
+    US2Data(segment.Data(EXIF_BLOB_OFFSET), static_cast<uint16_t>(segmentRoom - SEGMENT_LENGTH_SIZE), bigEndian);
+    if (addExifId) {
+        std::copy_n(EXIF_ID, EXIF_ID_SIZE, segment.Data(MARKER_LENGTH_SIZE));
+    }
+    std::copy_n(dataBlob, size, segment.Data(headerLength));
+
+    imageStream_->Seek(segmentPos, SeekPos::BEGIN);
+    cond = imageStream_->Write(segment.Data(), segment.Size()) != static_cast<ssize_t>(segment.Size());
+    CHECK_ERROR_RETURN_RET_LOG(cond, ERROR, "Failed to write EXIF segment in place. Size: %{public}zu",
+        segment.Size());
+    return imageStream_->Flush() ? SUCCESS : ERROR;
+}
+
 uint32_t JpegExifMetadataAccessor::UpdateData(uint8_t *dataBlob, uint32_t size)
 {
+    bool cond = imageStream_ == nullptr || !imageStream_->IsOpen();
+    CHECK_ERROR_RETURN_RET_LOG(cond, ERR_IMAGE_SOURCE_DATA, "The output image stream is not open");
+    uint32_t result = UpdateExifInPlace(dataBlob, size);
+    if (result != ERR_IMAGE_DATA_UNSUPPORT) {
+        return result;
+    }
+    IMAGE_LOGD("EXIF segment cannot be updated in place, rewriting image stream.");
+
     BufferMetadataStream tmpBufStream;
-    bool cond = !tmpBufStream.Open(OpenMode::ReadWrite);
+    cond = !tmpBufStream.Open(OpenMode::ReadWrite);
     CHECK_ERROR_RETURN_RET_LOG(cond, ERR_IMAGE_SOURCE_DATA, "Failed to open temporary image stream");
 
-    cond = imageStream_ == nullptr || !imageStream_->IsOpen();
-    CHECK_ERROR_RETURN_RET_LOG(cond, ERR_IMAGE_SOURCE_DATA, "The output image stream is not open");
-
     cond = !UpdateExifMetadata(tmpBufStream, dataBlob, size);
     CHECK_ERROR_RETURN_RET_LOG(cond, ERROR, "Failed to write to temporary image stream");
 
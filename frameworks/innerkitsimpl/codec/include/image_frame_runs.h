@@ -0,0 +1,43 @@
+/*
+ * Copyright (C) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FRAMEWORKS_INNERKITSIMPL_CODEC_INCLUDE_IMAGE_FRAME_RUNS_H
+#define FRAMEWORKS_INNERKITSIMPL_CODEC_INCLUDE_IMAGE_FRAME_RUNS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace OHOS {
+namespace Media {
+/*
+ * Splits the frames of an animated source into runs of consecutive frames that are decoded on separate
+ * workers, used by ImageSource::CreatePixelMapList.
+ */
+class ImageFrameRuns {
+public:
+    // Returns [begin, end) frame ranges. Boundaries are moved to cheap restart points of a GIF when disposal
+    // types are given, so there may be more runs than runNum.
+    static std::vector<std::pair<uint32_t, uint32_t>> Split(uint32_t frameCount, uint32_t runNum,
+        const std::vector<int32_t> &disposalTypes);
+    // Calls decodeRun for every run index with at most workerNum runs in flight. Run 0 stays on the calling thread.
+    static void Decode(size_t runCount, uint32_t workerNum, const std::function<void(size_t)> &decodeRun);
+};
+} // namespace Media
+} // namespace OHOS
+
+#endif // FRAMEWORKS_INNERKITSIMPL_CODEC_INCLUDE_IMAGE_FRAME_RUNS_H
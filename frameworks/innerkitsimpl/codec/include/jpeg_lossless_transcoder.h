@@ -0,0 +1,41 @@
+/*
+ * Copyright (C) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FRAMEWORKS_INNERKITSIMPL_CODEC_INCLUDE_JPEG_LOSSLESS_TRANSCODER_H
+#define FRAMEWORKS_INNERKITSIMPL_CODEC_INCLUDE_JPEG_LOSSLESS_TRANSCODER_H
+
+#include <cstdint>
+#include <vector>
+
+#include "image_packer.h"
+
+namespace OHOS {
+namespace Media {
+/*
+ * Repacks a JPEG in the DCT coefficient domain. Rotations, flips, MCU aligned crops and grayscale
+ * conversion move or drop coefficients, so nothing is decoded to pixels and no generation loss is added.
+ */
+class JpegLosslessTranscoder {
+public:
+    // Whether the pack options ask for nothing that needs the pixels, such as requantizing or resizing.
+    static bool CanTranscode(const PackOption &option);
+    // Returns ERR_IMAGE_DATA_UNSUPPORT when the edits do not fit the source's MCU grid, or when the source is
+    // coded unlike a quality 100 encode and keepSourceCoding is not set.
+    static uint32_t Transcode(const std::vector<uint8_t> &src, const PackOption &option, std::vector<uint8_t> &dst);
+};
+} // namespace Media
+} // namespace OHOS
+
+#endif // FRAMEWORKS_INNERKITSIMPL_CODEC_INCLUDE_JPEG_LOSSLESS_TRANSCODER_H
@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "image_frame_runs.h"
+
+#include <algorithm>
+#include <atomic>
+
+#if !defined(_WIN32) && !defined(_APPLE) && !defined(IOS_PLATFORM) && !defined(ANDROID_PLATFORM)
+#include "ffrt.h"
+#endif
+
+namespace OHOS {
+namespace Media {
+namespace {
+constexpr uint32_t MIN_FRAMES_PER_RUN = 2;
+constexpr uint32_t SNAP_WINDOW_DIVISOR = 2;
+constexpr int32_t GIF_DISPOSAL_RESTORE_BG_COLOR = 2;
+
+// A frame after a "restore to background" frame only builds on the canvas outside the disposed rect, and on none
+// of it when that frame covered the whole canvas. Starting a run there is a guess at a cheap restart point: the
+// worker source still composes whatever the frame needs, so a wrong guess only costs time.
+bool IsIndependentRunStart(uint32_t index, const std::vector<int32_t> &disposalTypes)
+{
+    return index > 0 && index <= disposalTypes.size() &&
+        disposalTypes[index - 1] == GIF_DISPOSAL_RESTORE_BG_COLOR;
+}
+
+uint32_t SnapRunBoundary(uint32_t boundary, uint32_t runStart, uint32_t frameCount, uint32_t window,
+    const std::vector<int32_t> &disposalTypes)
+{
+    for (uint32_t offset = 0; offset <= window; offset++) {
+        uint32_t after = boundary + offset;
+        if (after < frameCount && IsIndependentRunStart(after, disposalTypes)) {
+            return after;
+        }
+        if (boundary >= offset + MIN_FRAMES_PER_RUN + runStart &&
+            IsIndependentRunStart(boundary - offset, disposalTypes)) {
+            return boundary - offset;
+        }
+    }
+    return boundary;
+}
+} // namespace
+
+std::vector<std::pair<uint32_t, uint32_t>> ImageFrameRuns::Split(uint32_t frameCount, uint32_t runNum,
+    const std::vector<int32_t> &disposalTypes)
+{
+    std::vector<std::pair<uint32_t, uint32_t>> runs;
+    if (frameCount == 0 || runNum == 0) {
+        return runs;
+    }
+    uint32_t runLength = (frameCount + runNum - 1) / runNum;
+    uint32_t start = 0;
+    while (start < frameCount) {
+        uint32_t end = std::min(frameCount, start + runLength);
+        if (end < frameCount) {
+            end = SnapRunBoundary(end, start, frameCount, runLength / SNAP_WINDOW_DIVISOR, disposalTypes);
+        }
+        runs.emplace_back(start, end);
+        start = end;
+    }
+    return runs;
+}
+
+void ImageFrameRuns::Decode(size_t runCount, uint32_t workerNum, const std::function<void(size_t)> &decodeRun)
+{
+    if (runCount == 0) {
+        return;
+    }
+#if !defined(_WIN32) && !defined(_APPLE) && !defined(IOS_PLATFORM) && !defined(ANDROID_PLATFORM)
+    // Snapped runs can outnumber the workers; every worker claims the next run, so at most workerNum are in flight.
+    // Run 0 always stays on the calling thread because it decodes with the calling source.
+    std::atomic<size_t> nextRun(1);
+    auto claimRuns = [&nextRun, &decodeRun, runCount] {
+        for (size_t runIndex = nextRun.fetch_add(1); runIndex < runCount; runIndex = nextRun.fetch_add(1)) {
+            decodeRun(runIndex);
+        }
+    };
+    size_t helperNum = std::min(runCount, static_cast<size_t>(std::max(workerNum, 1u))) - 1;
+    std::vector<ffrt::dependence> handles;
+    for (size_t helper = 0; helper < helperNum; helper++) {
+        handles.emplace_back(ffrt::submit_h(claimRuns));
+    }
+    decodeRun(0);
+    claimRuns();
+    ffrt::wait(handles);
+#else
+    for (size_t runIndex = 0; runIndex < runCount; runIndex++) {
+        decodeRun(runIndex);
+    }
+#endif
+}
+} // namespace Media
+} // namespace OHOS
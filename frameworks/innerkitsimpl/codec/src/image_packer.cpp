@@ -22,6 +22,9 @@
 #include "image_mime_type.h"
 #include "image_trace.h"
 #include "image_utils.h"
+#if !defined(CROSS_PLATFORM)
+#include "jpeg_lossless_transcoder.h"
+#endif
 #include "media_errors.h"
 #include "ostream_packer_stream.h"
 #include "plugin_server.h"
@@ -54,6 +57,9 @@ static constexpr uint8_t QUALITY_MAX = 100;
 const static std::string EXTENDED_ENCODER = "image/jpeg,image/png,image/webp";
 static constexpr size_t SIZE_ZERO = 0;
 static constexpr uint8_t BITS_PER_BYTE = 8;
+static constexpr float DEGREES_90 = 90.0f;
+static constexpr float DEGREES_180 = 180.0f;
+static constexpr float DEGREES_270 = 270.0f;
 
 PluginServer &ImagePacker::pluginServer_ = ImageUtils::GetPluginServer();
 
@@ -138,6 +144,8 @@ uint32_t ImagePacker::StartPackingImpl(const PackOption &option)
         (option.format != IMAGE_JPEG_FORMAT && option.format != IMAGE_HEIF_FORMAT &&
             option.format != IMAGE_HEIC_FORMAT));
     format_ = option.format;
+    packOption_ = option;
+    losslessTranscoded_ = false;
     PlEncodeOptions plOpts;
     CopyOptionsToPlugin(option, plOpts);
     return DoEncodingFunc([this, &plOpts](ImagePlugin::AbsImageEncoder* encoder) {
@@ -253,7 +261,10 @@ uint32_t ImagePacker::AddImage(ImageSource &source, uint32_t index)
     decodeOpts.desiredDynamicRange = encodeToSdr_ ? DecodeDynamicRange::SDR : DecodeDynamicRange::AUTO;
     bool isHdr = source.IsDecodeHdrImage(decodeOpts);
 #if !defined(CROSS_PLATFORM)
-    if (isHdr && source.CheckHdrType() == ImageHdrType::HDR_VIVID_DUAL) {
+    if (!isHdr && TranscodeJpegLossless(source, index) == SUCCESS) {
+        return SUCCESS;
+    }
+    if (isHdr && !HasJpegEdits() && source.CheckHdrType() == ImageHdrType::HDR_VIVID_DUAL) {
         if (picture_ != nullptr) {
             picture_.reset();  // release old inner picture
         }
@@ -275,10 +286,84 @@ uint32_t ImagePacker::AddImage(ImageSource &source, uint32_t index)
         "image source create pixel map failed.");
     bool cond = pixelMap_ == nullptr || pixelMap_.get() == nullptr;
     CHECK_ERROR_RETURN_RET_LOG(cond, ERR_IMAGE_MALLOC_ABNORMAL, "create the pixel map unique_ptr fail.");
+    if (HasJpegEdits()) {
+        ret = ApplyJpegEdits(*pixelMap_.get());
+        CHECK_ERROR_RETURN_RET(ret != SUCCESS, ret);
+    }
 
     return AddImage(*pixelMap_.get());
 }
 
+bool ImagePacker::HasJpegEdits() const
+{
+    const PackingOptionsForJpeg &edits = packOption_.jpegPackingOption;
+    return format_ == IMAGE_JPEG_FORMAT && (edits.transform != JpegTransformType::NONE || edits.grayscale ||
+        (edits.cropRegion.width > 0 && edits.cropRegion.height > 0));
+}
+
+uint32_t ImagePacker::TranscodeJpegLossless(ImageSource &source, uint32_t index)
+{
+#if !defined(CROSS_PLATFORM)
+    bool cond = (index != 0) || (packerStream_ == nullptr) || !JpegLosslessTranscoder::CanTranscode(packOption_);
+    CHECK_ERROR_RETURN_RET(cond, ERR_IMAGE_DATA_UNSUPPORT);
+    ImageInfo imageInfo;
+    cond = (source.GetImageInfo(index, imageInfo) != SUCCESS) || (imageInfo.encodedFormat != IMAGE_JPEG_FORMAT);
+    CHECK_ERROR_RETURN_RET(cond, ERR_IMAGE_DATA_UNSUPPORT);
+    ImageTrace imageTrace("ImagePacker::TranscodeJpegLossless");
+    std::vector<uint8_t> srcData;
+    CHECK_ERROR_RETURN_RET(source.GetEncodedData(srcData) != SUCCESS, ERR_IMAGE_DATA_UNSUPPORT);
+    std::vector<uint8_t> dstData;
+    CHECK_ERROR_RETURN_RET(JpegLosslessTranscoder::Transcode(srcData, packOption_, dstData) != SUCCESS,
+        ERR_IMAGE_DATA_UNSUPPORT);
+    CHECK_ERROR_RETURN_RET_LOG(!packerStream_->Write(dstData.data(), static_cast<uint32_t>(dstData.size())),
+        ERR_IMAGE_ENCODE_FAILED, "write lossless jpeg failed.");
+    losslessTranscoded_ = true;
+    IMAGE_LOGD("packed jpeg without decoding, size %{public}zu.", dstData.size());
+    return SUCCESS;
+#else
+    return ERR_IMAGE_DATA_UNSUPPORT;
+#endif
+}
+
+// Pixel equivalent of the coefficient transforms, for sources the transcoder cannot take.
+uint32_t ImagePacker::ApplyJpegEdits(PixelMap &pixelMap)
+{
+    const PackingOptionsForJpeg &edits = packOption_.jpegPackingOption;
+    CHECK_ERROR_RETURN_RET_LOG(edits.grayscale, ERR_IMAGE_DATA_UNSUPPORT,
+        "grayscale packing needs a lossless jpeg transcode.");
+    switch (edits.transform) {
+        case JpegTransformType::FLIP_HORIZONTAL:
+            pixelMap.flip(true, false);
+            break;
+        case JpegTransformType::FLIP_VERTICAL:
+            pixelMap.flip(false, true);
+            break;
+        case JpegTransformType::TRANSPOSE:
+            pixelMap.rotate(DEGREES_90);
+            pixelMap.flip(true, false);
+            break;
+        case JpegTransformType::TRANSVERSE:
+            pixelMap.rotate(DEGREES_270);
+            pixelMap.flip(true, false);
+            break;
+        case JpegTransformType::ROTATE_90:
+            pixelMap.rotate(DEGREES_90);
+            break;
+        case JpegTransformType::ROTATE_180:
+            pixelMap.rotate(DEGREES_180);
+            break;
+        case JpegTransformType::ROTATE_270:
+            pixelMap.rotate(DEGREES_270);
+            break;
+        default:
+            break;
+    }
+    if (edits.cropRegion.width > 0 && edits.cropRegion.height > 0) {
+        return pixelMap.crop(edits.cropRegion);
+    }
+    return SUCCESS;
+}
+
 #if !defined(IOS_PLATFORM) && !defined(ANDROID_PLATFORM)
 uint32_t ImagePacker::AddPicture(Picture &picture)
 {
@@ -291,6 +376,9 @@ uint32_t ImagePacker::AddPicture(Picture &picture)
 
 uint32_t ImagePacker::FinalizePacking()
 {
+    if (losslessTranscoded_) {
+        return SUCCESS;
+    }
     return DoEncodingFunc([](ImagePlugin::AbsImageEncoder* encoder) {
         auto res = encoder->FinalizeEncode();
         if (res != SUCCESS) {
@@ -345,6 +433,7 @@ void ImagePacker::CopyOptionsToPlugin(const PackOption &opts, PlEncodeOptions &p
     plOpts.quality = opts.quality;
     plOpts.format = opts.format;
     plOpts.disposalTypes = opts.disposalTypes;
+    plOpts.ditherType = opts.ditherType;
     plOpts.needsPackProperties = opts.needsPackProperties;
     plOpts.needsPackDfxData = opts.needsPackDfxData;
     plOpts.desiredDynamicRange = opts.desiredDynamicRange;
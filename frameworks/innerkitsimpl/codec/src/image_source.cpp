@@ -19,6 +19,7 @@
 #endif
 
 #include <algorithm>
+#include <array>
 #include <cerrno>
 #include <charconv>
 #include <chrono>
@@ -27,6 +28,7 @@
 #include <filesystem>
 #include <mutex>
 #include <set>
+#include <thread>
 #include <vector>
 #include <functional>
 
@@ -53,6 +55,7 @@
 #include "image/abs_image_format_agent.h"
 #include "image/image_plugin_type.h"
 #include "image_format_convert.h"
+#include "image_frame_runs.h"
 #include "image_log.h"
 #include "image_packer.h"
 #include "image_system_properties.h"
@@ -146,6 +149,25 @@ const string EXTENDED_FORMAT = "image/x-skia";
 const string IMAGE_EXTENDED_CODEC = "image/jpeg,image/png,image/webp,image/x-icon,image/gif,image/bmp,image/wbmp";
 const string SVG_FORMAT = "image/svg+xml";
 } // namespace InnerFormat
+
+// Magic numbers of the formats the extended codec reports under the same mime type as the format agents,
+// bytes in [skipOffset, skipOffset + skipLength) are not compared.
+struct FormatSignature {
+    const char *format;
+    const char *magic;
+    uint32_t length;
+    uint32_t skipOffset;
+    uint32_t skipLength;
+};
+static const FormatSignature FORMAT_SIGNATURES[] = {
+    { "image/jpeg", "\xFF\xD8\xFF", 3, 0, 0 },
+    { "image/png", "\x89PNG\r\n\x1A\n", 8, 0, 0 },
+    { "image/gif", "GIF87a", 6, 0, 0 },
+    { "image/gif", "GIF89a", 6, 0, 0 },
+    { "image/webp", "RIFF\0\0\0\0WEBPVP", 14, 4, 4 },
+    { "image/bmp", "BM", 2, 0, 0 },
+};
+static constexpr uint32_t FORMAT_SNIFF_SIZE = 14;
 // BASE64 image prefix type data:image/<type>;base64,<data>
 static const std::string IMAGE_URL_PREFIX = "data:image/";
 static const std::string BASE64_URL_PREFIX = ";base64,";
@@ -176,6 +198,7 @@ static const uint8_t ASTC_HEADER_DIM_Y = 10;
 static const int IMAGE_HEADER_SIZE = 12;
 static const uint32_t MAX_SOURCE_SIZE = 300 * 1024 * 1024;
 static const uint32_t MAX_FRAME_COUNT = 1000;
+static const uint32_t PIXELMAP_LIST_MIN_FRAMES_PER_RUN = 2;
 constexpr uint8_t ASTC_EXTEND_INFO_TLV_NUM = 1; // curren only one group TLV
 constexpr uint8_t ASTC_EXTEND_INFO_TLV_NUM6 = 6; // curren only six group TLV
 constexpr uint32_t ASTC_EXTEND_INFO_SIZE_DEFINITION_LENGTH = 4; // 4 bytes to discripte for extend info summary bytes
@@ -699,6 +722,7 @@ void ImageSource::Reset()
     decodeState_ = SourceDecodingState::UNRESOLVED;
     sourceStreamPtr_->Seek(0);
     mainDecoder_ = nullptr;
+    useExtendedCodec_ = false;
 }
 
 unique_ptr<PixelMap> ImageSource::CreatePixelMapEx(uint32_t index, const DecodeOptions &opts, uint32_t &errorCode)
@@ -3206,6 +3230,54 @@ AbsImageDecoder *DoCreateDecoder(std::string codecFormat, PluginServer &pluginSe
     return decoder;
 }
 
+using FormatSignatureTable = array<vector<const FormatSignature *>, UINT8_MAX + 1>;
+
+static const FormatSignatureTable &GetFormatSignatureTable()
+{
+    static const FormatSignatureTable table = [] {
+        FormatSignatureTable result;
+        for (const auto &signature : FORMAT_SIGNATURES) {
+            result[static_cast<uint8_t>(signature.magic[0])].push_back(&signature);
+        }
+        return result;
+    }();
+    return table;
+}
+
+static bool MatchFormatSignature(const FormatSignature &signature, const uint8_t *data, uint32_t size)
+{
+    if (size < signature.length) {
+        return false;
+    }
+    for (uint32_t i = 0; i < signature.length; i++) {
+        if (i >= signature.skipOffset && i < signature.skipOffset + signature.skipLength) {
+            continue;
+        }
+        if (data[i] != static_cast<uint8_t>(signature.magic[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+uint32_t ImageSource::SniffEncodedFormat(string &format)
+{
+    CHECK_ERROR_RETURN_RET(isIncrementalSource_, ERR_IMAGE_MISMATCHED_FORMAT);
+    ImagePlugin::DataStreamBuffer outData;
+    CHECK_ERROR_RETURN_RET(GetData(outData, FORMAT_SNIFF_SIZE) != SUCCESS, ERR_IMAGE_MISMATCHED_FORMAT);
+    const uint8_t *data = outData.inputStreamBuffer;
+    for (const FormatSignature *signature : GetFormatSignatureTable()[data[0]]) {
+        if (MatchFormatSignature(*signature, data, outData.dataSize)) {
+            format = signature->format;
+            // The extended codec is created lazily in InitMainDecoder, as GetFormatExtended would have done.
+            useExtendedCodec_ = ImageSystemProperties::GetSkiaEnabled() || format == IMAGE_GIF_FORMAT;
+            IMAGE_LOGD("[ImageSource]sniffed format :%{public}s.", format.c_str());
+            return SUCCESS;
+        }
+    }
+    return ERR_IMAGE_MISMATCHED_FORMAT;
+}
+
 uint32_t ImageSource::GetFormatExtended(string &format) __attribute__((no_sanitize("cfi")))
 {
     if (mainDecoder_ != nullptr) {
@@ -3272,7 +3344,7 @@ uint32_t ImageSource::GetEncodedFormat(const string &formatHint, string &format)
         }
     }
 
-    if (GetFormatExtended(format) == SUCCESS) {
+    if (SniffEncodedFormat(format) == SUCCESS || GetFormatExtended(format) == SUCCESS) {
         return SUCCESS;
     }
 
@@ -3504,6 +3576,8 @@ AbsImageDecoder *ImageSource::CreateDecoder(uint32_t &errorCode)
     std::string encodedFormat = sourceInfo_.encodedFormat;
     if (opts_.sampleSize != 1) {
         encodedFormat = InnerFormat::EXTENDED_FORMAT;
+    } else if (useExtendedCodec_) {
+        encodedFormat = InnerFormat::IMAGE_EXTENDED_CODEC;
     }
     return DoCreateDecoder(encodedFormat, pluginServer_, *sourceStreamPtr_, errorCode);
 }
@@ -3629,6 +3703,7 @@ void ImageSource::CopyOptionsToPlugin(const DecodeOptions &opts, PixelDecodeOpti
     plOpts.plReusePixelmap = opts.reusePixelmap;
     plOpts.cropAndScaleStrategy = opts.cropAndScaleStrategy;
     plOpts.isAnimationDecode = opts.isAnimationDecode;
+    plOpts.animationCacheBudget = animationCacheBudget_;
 }
 
 void ImageSource::CopyOptionsToProcOpts(const DecodeOptions &opts, DecodeOptions &procOpts, PixelMap &pixelMap)
@@ -3742,6 +3817,16 @@ MemoryUsagePreference ImageSource::GetMemoryUsagePreference()
     return preference_;
 }
 
+void ImageSource::SetAnimationCacheBudget(uint64_t budget)
+{
+    animationCacheBudget_ = budget;
+}
+
+uint64_t ImageSource::GetAnimationCacheBudget()
+{
+    return animationCacheBudget_;
+}
+
 uint32_t ImageSource::GetFilterArea(const int &privacyType, std::vector<std::pair<uint32_t, uint32_t>> &ranges)
 {
     return E_NO_EXIF_TAG;
@@ -4666,6 +4751,101 @@ unique_ptr<vector<unique_ptr<PixelMap>>> ImageSource::CreatePixelMapList(const D
     return pixelMaps;
 }
 
+unique_ptr<vector<unique_ptr<PixelMap>>> ImageSource::CreatePixelMapList(const DecodeOptions &opts,
+    uint32_t maxConcurrency, uint32_t &errorCode)
+{
+    ImageDataStatistics imageDataStatistics("[ImageSource]CreatePixelMapList parallel.");
+    auto frameCount = GetFrameCount(errorCode);
+    if (errorCode != SUCCESS) {
+        IMAGE_LOGE("[ImageSource]CreatePixelMapList parallel get frame count error.");
+        return nullptr;
+    }
+    if (frameCount > MAX_FRAME_COUNT) {
+        IMAGE_LOGE("[ImageSource]CreatePixelMapList frame count %{public}u, exceeds max.", frameCount);
+        errorCode = ERR_IMAGE_SOURCE_DATA;
+        return nullptr;
+    }
+    uint32_t hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+    uint32_t runNum = std::min({maxConcurrency, hardwareThreads,
+        (frameCount + PIXELMAP_LIST_MIN_FRAMES_PER_RUN - 1) / PIXELMAP_LIST_MIN_FRAMES_PER_RUN});
+    bool canSplit = runNum > 1 && sourceStreamPtr_ != nullptr && !IsIncrementalSource();
+    uint8_t *data = canSplit ? sourceStreamPtr_->GetDataPtr() : nullptr;
+    uint32_t dataSize = canSplit ? static_cast<uint32_t>(sourceStreamPtr_->GetStreamSize()) : 0;
+    if (data == nullptr || dataSize == 0) {
+        return CreatePixelMapList(opts, errorCode);
+    }
+
+    std::vector<int32_t> disposalTypes;
+    if (sourceInfo_.encodedFormat == IMAGE_GIF_FORMAT) {
+        uint32_t disposalError = SUCCESS;
+        auto gifDisposalTypes = GetDisposalType(disposalError);
+        if (disposalError == SUCCESS && gifDisposalTypes != nullptr) {
+            disposalTypes = std::move(*gifDisposalTypes);
+        }
+    }
+    auto runs = ImageFrameRuns::Split(frameCount, runNum, disposalTypes);
+    IMAGE_LOGD("[ImageSource]CreatePixelMapList frames:%{public}u runs:%{public}zu", frameCount, runs.size());
+
+    auto pixelMaps = std::make_unique<vector<unique_ptr<PixelMap>>>(frameCount);
+    std::vector<uint32_t> runErrors(runs.size(), SUCCESS);
+    SourceOptions workerOpts;
+    workerOpts.formatHint = sourceInfo_.encodedFormat;
+    auto decodeRun = [this, &opts, &runs, &runErrors, &pixelMaps, &workerOpts, data, dataSize](size_t runIndex) {
+        ImageSource *source = this;
+        std::unique_ptr<ImageSource> workerSource;
+        if (runIndex != 0) {
+            workerSource = CreateImageSource(data, dataSize, workerOpts, runErrors[runIndex], true);
+            if (workerSource == nullptr) {
+                return;
+            }
+            source = workerSource.get();
+        }
+        for (uint32_t index = runs[runIndex].first; index < runs[runIndex].second; index++) {
+            (*pixelMaps)[index] = source->CreatePixelMap(index, opts, runErrors[runIndex]);
+            if (runErrors[runIndex] != SUCCESS) {
+                IMAGE_LOGE("[ImageSource]CreatePixelMapList create PixelMap error. index=%{public}u", index);
+                return;
+            }
+        }
+    };
+    ImageFrameRuns::Decode(runs.size(), runNum, decodeRun);
+    for (uint32_t runError : runErrors) {
+        if (runError != SUCCESS) {
+            errorCode = runError;
+            return nullptr;
+        }
+    }
+    errorCode = SUCCESS;
+    return pixelMaps;
+}
+
+unique_ptr<vector<unique_ptr<PixelMap>>> ImageSource::CreatePixelMapsForSizes(uint32_t index,
+    const DecodeOptions &opts, const vector<Size> &sizes, uint32_t &errorCode)
+{
+    ImageTrace imageTrace("ImageSource::CreatePixelMapsForSizes, count:%zu", sizes.size());
+    if (sizes.empty()) {
+        IMAGE_LOGE("[ImageSource]CreatePixelMapsForSizes no size requested.");
+        errorCode = ERR_IMAGE_INVALID_PARAMETER;
+        return nullptr;
+    }
+    // The decoder stays attached between the calls, so the svg decoder keeps its parsed DOM
+    auto pixelMaps = std::make_unique<vector<unique_ptr<PixelMap>>>();
+    pixelMaps->reserve(sizes.size());
+    DecodeOptions sizeOpts = opts;
+    for (const Size &size : sizes) {
+        sizeOpts.desiredSize = size;
+        auto pixelMap = CreatePixelMap(index, sizeOpts, errorCode);
+        if (pixelMap == nullptr || errorCode != SUCCESS) {
+            IMAGE_LOGE("[ImageSource]CreatePixelMapsForSizes failed at (%{public}d, %{public}d).",
+                size.width, size.height);
+            errorCode = errorCode == SUCCESS ? ERR_IMAGE_PIXELMAP_CREATE_FAILED : errorCode;
+            return nullptr;
+        }
+        pixelMaps->push_back(std::move(pixelMap));
+    }
+    return pixelMaps;
+}
+
 unique_ptr<vector<int32_t>> ImageSource::GetDelayTime(uint32_t &errorCode)
 {
     auto frameCount = GetFrameCount(errorCode);
@@ -7444,6 +7624,28 @@ uint32_t ImageSource::GetImageRawData(std::vector<uint8_t> &data, uint32_t &bits
     return SUCCESS;
 }
 
+uint32_t ImageSource::GetEncodedData(std::vector<uint8_t> &data)
+{
+    std::lock_guard<std::recursive_mutex> guard(decodingMutex_);
+    std::unique_lock<std::mutex> guardFile(fileMutex_);
+    CHECK_ERROR_RETURN_RET_LOG(sourceStreamPtr_ == nullptr, ERR_IMAGE_SOURCE_DATA,
+        "%{public}s sourceStreamPtr is nullptr", __func__);
+    size_t bufferSize = sourceStreamPtr_->GetStreamSize();
+    bool cond = (bufferSize == 0) || (bufferSize > MAX_SOURCE_SIZE);
+    CHECK_ERROR_RETURN_RET_LOG(cond, ERR_IMAGE_SOURCE_DATA,
+        "%{public}s invalid stream size: %{public}zu", __func__, bufferSize);
+    const uint8_t *bufferPtr = sourceStreamPtr_->GetDataPtr();
+    if (bufferPtr != nullptr) {
+        data.assign(bufferPtr, bufferPtr + bufferSize);
+        return SUCCESS;
+    }
+    uint32_t errorCode = ERR_IMAGE_SOURCE_DATA;
+    std::unique_ptr<uint8_t[]> tmpBuffer(ReadSourceBuffer(static_cast<uint32_t>(bufferSize), errorCode));
+    CHECK_ERROR_RETURN_RET_LOG(tmpBuffer == nullptr, errorCode, "%{public}s ReadSourceBuffer failed", __func__);
+    data.assign(tmpBuffer.get(), tmpBuffer.get() + bufferSize);
+    return SUCCESS;
+}
+
 #if !defined(CROSS_PLATFORM)
 bool ImageSource::CheckSupportedFormat(const std::string &encodedFormat, uint32_t &errorCode)
 {
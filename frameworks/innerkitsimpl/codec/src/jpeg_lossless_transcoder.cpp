@@ -0,0 +1,244 @@
+/*
+ * Copyright (C) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "jpeg_lossless_transcoder.h"
+
+#include <cstring>
+
+#include "image_log.h"
+#include "image_mime_type.h"
+#include "media_errors.h"
+#include "securec.h"
+#include "turbojpeg.h"
+
+#undef LOG_DOMAIN
+#define LOG_DOMAIN LOG_TAG_DOMAIN_ID_IMAGE
+
+#undef LOG_TAG
+#define LOG_TAG "JpegLosslessTranscoder"
+
+namespace OHOS {
+namespace Media {
+namespace {
+constexpr uint8_t QUALITY_MAX = 100;
+constexpr uint8_t MARKER_PREFIX = 0xFF;
+constexpr uint8_t MARKER_SOI = 0xD8;
+constexpr uint8_t MARKER_EOI = 0xD9;
+constexpr uint8_t MARKER_SOS = 0xDA;
+constexpr uint8_t MARKER_DQT = 0xDB;
+constexpr uint8_t MARKER_RST0 = 0xD0;
+constexpr uint8_t MARKER_APP0 = 0xE0;
+constexpr uint8_t MARKER_APP1 = 0xE1;
+constexpr uint8_t MARKER_APP2 = 0xE2;
+constexpr size_t MARKER_SIZE = 2;
+constexpr size_t SEGMENT_HEADER_SIZE = 4;
+constexpr uint32_t BYTE_BITS = 8;
+constexpr uint32_t NIBBLE_BITS = 4;
+constexpr size_t DQT_ENTRIES = 64;
+constexpr uint16_t QUANT_VALUE_QUALITY_MAX = 1;
+constexpr char ICC_SIGNATURE[] = "ICC_PROFILE";
+}
+
+struct JpegSegment {
+    size_t offset = 0;
+    size_t size = 0;
+    uint8_t marker = 0;
+};
+
+static int GetTransformOp(JpegTransformType transform)
+{
+    switch (transform) {
+        case JpegTransformType::FLIP_HORIZONTAL:
+            return TJXOP_HFLIP;
+        case JpegTransformType::FLIP_VERTICAL:
+            return TJXOP_VFLIP;
+        case JpegTransformType::TRANSPOSE:
+            return TJXOP_TRANSPOSE;
+        case JpegTransformType::TRANSVERSE:
+            return TJXOP_TRANSVERSE;
+        case JpegTransformType::ROTATE_90:
+            return TJXOP_ROT90;
+        case JpegTransformType::ROTATE_180:
+            return TJXOP_ROT180;
+        case JpegTransformType::ROTATE_270:
+            return TJXOP_ROT270;
+        default:
+            return TJXOP_NONE;
+    }
+}
+
+// Lists the marker segments in front of the first scan.
+static bool ListHeaderSegments(const uint8_t *data, size_t size, std::vector<JpegSegment> &segments)
+{
+    bool cond = (size < MARKER_SIZE) || (data[0] != MARKER_PREFIX) || (data[1] != MARKER_SOI);
+    CHECK_ERROR_RETURN_RET(cond, false);
+    size_t pos = MARKER_SIZE;
+    while (pos + SEGMENT_HEADER_SIZE <= size) {
+        CHECK_ERROR_RETURN_RET(data[pos] != MARKER_PREFIX, false);
+        uint8_t marker = data[pos + 1];
+        if (marker == MARKER_PREFIX) {
+            pos++;
+            continue;
+        }
+        CHECK_ERROR_RETURN_RET(marker >= MARKER_RST0 && marker <= MARKER_EOI, false);
+        size_t length = (static_cast<size_t>(data[pos + MARKER_SIZE]) << BYTE_BITS) | data[pos + MARKER_SIZE + 1];
+        cond = (length < MARKER_SIZE) || (pos + MARKER_SIZE + length > size);
+        CHECK_ERROR_RETURN_RET(cond, false);
+        if (marker == MARKER_SOS) {
+            return true;
+        }
+        segments.push_back({ pos, MARKER_SIZE + length, marker });
+        pos += MARKER_SIZE + length;
+    }
+    return false;
+}
+
+static bool IsIccSegment(const uint8_t *data, const JpegSegment &segment)
+{
+    return segment.marker == MARKER_APP2 && segment.size >= SEGMENT_HEADER_SIZE + sizeof(ICC_SIGNATURE) &&
+        memcmp(data + segment.offset + SEGMENT_HEADER_SIZE, ICC_SIGNATURE, sizeof(ICC_SIGNATURE)) == 0;
+}
+
+// Every entry of a quality 100 table is one. pos walks the DQT payload, which may hold several tables.
+static bool HasQualityMaxTables(const uint8_t *data, const JpegSegment &segment)
+{
+    size_t pos = segment.offset + SEGMENT_HEADER_SIZE;
+    size_t end = segment.offset + segment.size;
+    while (pos < end) {
+        size_t entryBytes = (data[pos] >> NIBBLE_BITS) == 0 ? 1 : MARKER_SIZE;
+        pos++;
+        CHECK_ERROR_RETURN_RET(pos + DQT_ENTRIES * entryBytes > end, false);
+        for (size_t i = 0; i < DQT_ENTRIES; i++, pos += entryBytes) {
+            uint16_t value = entryBytes == 1 ? data[pos] :
+                static_cast<uint16_t>((data[pos] << BYTE_BITS) | data[pos + 1]);
+            CHECK_ERROR_RETURN_RET(value != QUANT_VALUE_QUALITY_MAX, false);
+        }
+    }
+    return true;
+}
+
+// Whether a quality 100 encode of the decoded pixels would use the same quantization and subsampling.
+static bool MatchesQualityMaxEncode(tjhandle handle, const std::vector<uint8_t> &src)
+{
+    int width = 0;
+    int height = 0;
+    int subsamp = 0;
+    int colorspace = 0;
+    bool cond = tjDecompressHeader3(handle, src.data(), static_cast<unsigned long>(src.size()), &width, &height,
+        &subsamp, &colorspace) != 0 || subsamp != TJSAMP_420 || colorspace != TJCS_YCbCr;
+    CHECK_ERROR_RETURN_RET(cond, false);
+    std::vector<JpegSegment> segments;
+    CHECK_ERROR_RETURN_RET(!ListHeaderSegments(src.data(), src.size(), segments), false);
+    bool hasTables = false;
+    for (const JpegSegment &segment : segments) {
+        if (segment.marker == MARKER_DQT) {
+            CHECK_ERROR_RETURN_RET(!HasQualityMaxTables(src.data(), segment), false);
+            hasTables = true;
+        }
+    }
+    return hasTables;
+}
+
+// The transform writes no metadata, put back what the pixel path would have written.
+static bool SpliceMetadata(const std::vector<uint8_t> &src, const PackOption &option,
+    const uint8_t *transformed, size_t transformedSize, std::vector<uint8_t> &dst)
+{
+    std::vector<JpegSegment> srcSegments;
+    std::vector<JpegSegment> dstSegments;
+    bool cond = !ListHeaderSegments(src.data(), src.size(), srcSegments) ||
+        !ListHeaderSegments(transformed, transformedSize, dstSegments);
+    CHECK_ERROR_RETURN_RET(cond, false);
+    // Metadata goes after the JFIF segment, which has to stay first
+    size_t insertPos = MARKER_SIZE;
+    if (!dstSegments.empty() && dstSegments.front().marker == MARKER_APP0) {
+        insertPos = dstSegments.front().offset + dstSegments.front().size;
+    }
+    size_t metadataSize = 0;
+    std::vector<const JpegSegment *> kept;
+    for (const JpegSegment &segment : srcSegments) {
+        // A color profile does not describe a grayscale image
+        bool keep = (IsIccSegment(src.data(), segment) && !option.jpegPackingOption.grayscale) ||
+            (segment.marker == MARKER_APP1 && option.needsPackProperties);
+        if (keep) {
+            kept.push_back(&segment);
+            metadataSize += segment.size;
+        }
+    }
+    dst.clear();
+    dst.reserve(transformedSize + metadataSize);
+    dst.insert(dst.end(), transformed, transformed + insertPos);
+    for (const JpegSegment *segment : kept) {
+        dst.insert(dst.end(), src.begin() + segment->offset, src.begin() + segment->offset + segment->size);
+    }
+    dst.insert(dst.end(), transformed + insertPos, transformed + transformedSize);
+    return true;
+}
+
+bool JpegLosslessTranscoder::CanTranscode(const PackOption &option)
+{
+    bool cond = (option.format != IMAGE_JPEG_FORMAT) || (option.quality != QUALITY_MAX);
+    CHECK_ERROR_RETURN_RET(cond, false);
+    cond = (option.sizeLimit.maxSize.width > 0) || (option.sizeLimit.maxSize.height > 0);
+    CHECK_ERROR_RETURN_RET(cond, false);
+    // Dfx data and GPS removal are written by the encoder plugin
+    cond = option.needsPackDfxData || (option.needsPackProperties && !option.needsPackGPS);
+    return !cond;
+}
+
+uint32_t JpegLosslessTranscoder::Transcode(const std::vector<uint8_t> &src, const PackOption &option,
+    std::vector<uint8_t> &dst)
+{
+    CHECK_ERROR_RETURN_RET(src.empty(), ERR_IMAGE_DATA_UNSUPPORT);
+    const PackingOptionsForJpeg &edits = option.jpegPackingOption;
+    tjtransform transform;
+    CHECK_ERROR_RETURN_RET(memset_s(&transform, sizeof(transform), 0, sizeof(transform)) != EOK,
+        ERR_IMAGE_DATA_UNSUPPORT);
+    transform.op = GetTransformOp(edits.transform);
+    // Perfect refuses transforms that would have to drop partial edge MCUs
+    transform.options = TJXOPT_PERFECT | TJXOPT_COPYNONE;
+    if (edits.grayscale) {
+        transform.options |= TJXOPT_GRAY;
+    }
+    if (edits.cropRegion.width > 0 && edits.cropRegion.height > 0) {
+        transform.options |= TJXOPT_CROP;
+        transform.r = { edits.cropRegion.left, edits.cropRegion.top, edits.cropRegion.width,
+            edits.cropRegion.height };
+    }
+
+    tjhandle handle = tjInitTransform();
+    CHECK_ERROR_RETURN_RET_LOG(handle == nullptr, ERR_IMAGE_DATA_UNSUPPORT, "tjInitTransform failed");
+    if (!edits.keepSourceCoding && !MatchesQualityMaxEncode(handle, src)) {
+        IMAGE_LOGD("lossless jpeg transform skipped, source coding differs from a quality 100 encode");
+        tjDestroy(handle);
+        return ERR_IMAGE_DATA_UNSUPPORT;
+    }
+    unsigned char *transformed = nullptr;
+    unsigned long transformedSize = 0;
+    int ret = tjTransform(handle, src.data(), static_cast<unsigned long>(src.size()), 1, &transformed,
+        &transformedSize, &transform, 0);
+    if (ret != 0) {
+        IMAGE_LOGD("lossless jpeg transform fallback: %{public}s", tjGetErrorStr2(handle));
+        tjFree(transformed);
+        tjDestroy(handle);
+        return ERR_IMAGE_DATA_UNSUPPORT;
+    }
+    bool spliced = SpliceMetadata(src, option, transformed, transformedSize, dst);
+    tjFree(transformed);
+    tjDestroy(handle);
+    CHECK_ERROR_RETURN_RET_LOG(!spliced, ERR_IMAGE_DATA_UNSUPPORT, "lossless jpeg transform splice failed");
+    return SUCCESS;
+}
+} // namespace Media
+} // namespace OHOS
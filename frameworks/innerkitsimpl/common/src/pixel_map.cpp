@@ -4593,10 +4593,137 @@ static bool GenDstTransInfo(SkTransInfo &srcInfo, SkTransInfo &dstInfo, SkMatrix
     return AllocDstTransMemory(srcInfo, dstInfo, memoryInfo, usage);
 }
 
+struct TransClip {
+    SkRect rect;
+    SkMatrix matrix; // maps the clip rect into destination space
+};
+
 struct TransInfos {
     SkMatrix matrix;
+    // composed transforms carry their own destination size and clips, the matrix is not re-centered
+    bool isComposed = false;
+    Size dstSize;
+    std::vector<TransClip> clips;
 };
 
+static bool GenComposedDstTransInfo(SkTransInfo &srcInfo, SkTransInfo &dstInfo, const Size &dstSize,
+    TransMemoryInfo &memoryInfo, uint64_t usage)
+{
+    if (dstSize.width <= 0 || dstSize.height <= 0) {
+        IMAGE_LOGE("Composed image size must be positive");
+        return false;
+    }
+    dstInfo.r = SkRect::MakeIWH(dstSize.width, dstSize.height);
+    dstInfo.info = srcInfo.info.makeWH(dstSize.width, dstSize.height);
+    return AllocDstTransMemory(srcInfo, dstInfo, memoryInfo, usage);
+}
+
+static uint32_t ComposeBoundedStep(SkMatrix &step, SkMatrix &matrix, Size &size)
+{
+    SkRect mapped = step.mapRect(SkRect::MakeIWH(size.width, size.height));
+    int32_t width = 0;
+    int32_t height = 0;
+    if (!SafeRoundToInt32(mapped.width(), width) || !SafeRoundToInt32(mapped.height(), height) ||
+        width <= 0 || height <= 0) {
+        IMAGE_LOGE("ComposeTransform invalid transformed size");
+        return ERR_IMAGE_INVALID_PARAMETER;
+    }
+    step.postTranslate(-mapped.fLeft, -mapped.fTop);
+    matrix.postConcat(step);
+    size = {width, height};
+    return SUCCESS;
+}
+
+static uint32_t ComposeTranslate(const TransformOp &op, SkMatrix &matrix, Size &size,
+    std::vector<std::pair<SkRect, SkMatrix>> &clips)
+{
+    int32_t width = 0;
+    int32_t height = 0;
+    if (!SafeCastToInt32(static_cast<double>(size.width) + op.x, width) ||
+        !SafeCastToInt32(static_cast<double>(size.height) + op.y, height) || width <= 0 || height <= 0) {
+        IMAGE_LOGE("ComposeTransform invalid translated size");
+        return ERR_IMAGE_INVALID_PARAMETER;
+    }
+    matrix.postTranslate(op.x, op.y);
+    size = {width, height};
+    clips.emplace_back(SkRect::MakeIWH(width, height), matrix);
+    return SUCCESS;
+}
+
+static uint32_t ComposeCrop(const TransformOp &op, SkMatrix &matrix, Size &size,
+    std::vector<std::pair<SkRect, SkMatrix>> &clips)
+{
+    SkIRect cropRect = SkIRect::MakeXYWH(op.rect.left, op.rect.top, op.rect.width, op.rect.height);
+    if (cropRect.isEmpty() || !SkIRect::MakeWH(size.width, size.height).contains(cropRect)) {
+        IMAGE_LOGE("ComposeTransform invalid crop rect");
+        return ERR_IMAGE_INVALID_PARAMETER;
+    }
+    clips.emplace_back(SkRect::Make(cropRect), matrix);
+    matrix.postTranslate(-cropRect.fLeft, -cropRect.fTop);
+    size = {cropRect.width(), cropRect.height()};
+    return SUCCESS;
+}
+
+// Folds the operations into one source-to-destination matrix. Every crop and translate also leaves a clip,
+// expressed in the coordinates it was recorded in, so content cut by an early step stays cut after the
+// later ones.
+static uint32_t ComposeTransform(const std::vector<TransformOp> &ops, const Size &srcSize, TransInfos &infos)
+{
+    SkMatrix matrix;
+    Size size = srcSize;
+    std::vector<std::pair<SkRect, SkMatrix>> clips;
+    for (const auto &op : ops) {
+        uint32_t ret = SUCCESS;
+        SkMatrix step;
+        Size scaledSize;
+        switch (op.type) {
+            case TransformOpType::CROP:
+                ret = ComposeCrop(op, matrix, size, clips);
+                break;
+            case TransformOpType::TRANSLATE:
+                ret = ComposeTranslate(op, matrix, size, clips);
+                break;
+            case TransformOpType::SCALE:
+                if (!GetScaledSize(size, op.x, op.y, scaledSize)) {
+                    IMAGE_LOGE("ComposeTransform invalid scale ratio");
+                    return ERR_IMAGE_INVALID_PARAMETER;
+                }
+                step.setScale(op.x, op.y);
+                ret = ComposeBoundedStep(step, matrix, size);
+                break;
+            case TransformOpType::ROTATE:
+                if (!std::isfinite(op.x)) {
+                    IMAGE_LOGE("ComposeTransform invalid rotate degrees");
+                    return ERR_IMAGE_INVALID_PARAMETER;
+                }
+                step.setRotate(op.x);
+                ret = ComposeBoundedStep(step, matrix, size);
+                break;
+            case TransformOpType::FLIP:
+                step.setScale(op.x != 0.0f ? -1.0f : 1.0f, op.y != 0.0f ? -1.0f : 1.0f);
+                ret = ComposeBoundedStep(step, matrix, size);
+                break;
+            default:
+                return ERR_IMAGE_INVALID_PARAMETER;
+        }
+        if (ret != SUCCESS) {
+            return ret;
+        }
+    }
+    infos.matrix = matrix;
+    infos.dstSize = size;
+    infos.isComposed = true;
+    for (const auto &clip : clips) {
+        SkMatrix inverse;
+        if (!clip.second.invert(&inverse)) {
+            IMAGE_LOGE("ComposeTransform clip matrix is not invertible");
+            return ERR_IMAGE_TRANSFORM;
+        }
+        infos.clips.push_back({clip.first, SkMatrix::Concat(matrix, inverse)});
+    }
+    return SUCCESS;
+}
+
 SkSamplingOptions ToSkSamplingOption(const AntiAliasingOption &option)
 {
     switch (option) {
@@ -4656,12 +4783,21 @@ uint32_t PixelMap::ApplyAffineTransform(TransInfos &infos, AntiAliasingOption op
     }
 
     SkTransInfo dst;
-    if (!GenDstTransInfo(src, dst, infos.matrix, dstMemory, GetNoPaddingUsage())) {
+    bool genDst = infos.isComposed ?
+        GenComposedDstTransInfo(src, dst, infos.dstSize, dstMemory, GetNoPaddingUsage()) :
+        GenDstTransInfo(src, dst, infos.matrix, dstMemory, GetNoPaddingUsage());
+    if (!genDst) {
         IMAGE_LOGE("[ApplyAffineTransform] GenDstTransInfo dstMemory failed");
         return ERR_IMAGE_MALLOC_ABNORMAL;
     }
     SkCanvas canvas(dst.bitmap);
-    if (!infos.matrix.isTranslate() && (!EQUAL_TO_ZERO(dst.r.fLeft) || !EQUAL_TO_ZERO(dst.r.fTop))) {
+    if (infos.isComposed) {
+        for (const auto &clip : infos.clips) {
+            canvas.setMatrix(clip.matrix);
+            canvas.clipRect(clip.rect);
+        }
+        canvas.resetMatrix();
+    } else if (!infos.matrix.isTranslate() && (!EQUAL_TO_ZERO(dst.r.fLeft) || !EQUAL_TO_ZERO(dst.r.fTop))) {
         canvas.translate(-dst.r.fLeft, -dst.r.fTop);
     }
     canvas.concat(infos.matrix);
@@ -4913,6 +5049,67 @@ uint32_t PixelMap::Flip(bool xAxis, bool yAxis)
     return Scale(xAxis ? -1 : 1, yAxis ? -1 : 1, AntiAliasingOption::NONE);
 }
 
+uint32_t PixelMap::ApplyTransformSequentially(const std::vector<TransformOp> &ops, AntiAliasingOption option)
+{
+    for (const auto &op : ops) {
+        uint32_t errCode = ERR_IMAGE_INVALID_PARAMETER;
+        switch (op.type) {
+            case TransformOpType::CROP:
+                errCode = Crop(op.rect);
+                break;
+            case TransformOpType::SCALE:
+                errCode = Scale(op.x, op.y, option);
+                break;
+            case TransformOpType::ROTATE:
+                errCode = Rotate(op.x);
+                break;
+            case TransformOpType::FLIP:
+                errCode = Flip(op.x != 0.0f, op.y != 0.0f);
+                break;
+            case TransformOpType::TRANSLATE:
+                errCode = Translate(op.x, op.y);
+                break;
+            default:
+                break;
+        }
+        if (errCode != SUCCESS) {
+            return errCode;
+        }
+    }
+    return SUCCESS;
+}
+
+uint32_t PixelMap::ApplyTransform(const PixelMapTransform &transform, AntiAliasingOption option)
+{
+    const std::vector<TransformOp> &ops = transform.GetOps();
+    if (ops.empty()) {
+        return SUCCESS;
+    }
+    if (ops.size() == 1 || IsYUV(imageInfo_.pixelFormat)) {
+        return ApplyTransformSequentially(ops, option);
+    }
+    if (IsAstcOrY8Format()) {
+        IMAGE_LOGE("ApplyTransform does not support astc or Y8");
+        return ERR_IMAGE_DATA_UNSUPPORT;
+    }
+    if (option == AntiAliasingOption::SLR) {
+        option = AntiAliasingOption::HIGH;
+    }
+    ImageTrace imageTrace("PixelMap ApplyTransform ops = %zu, option = %d", ops.size(), option);
+    TransInfos infos;
+    uint32_t errCode = ComposeTransform(ops, imageInfo_.size, infos);
+    if (errCode != SUCCESS) {
+        return errCode;
+    }
+    errCode = ApplyAffineTransform(infos, option);
+    if (errCode != SUCCESS) {
+        IMAGE_LOGE("ApplyTransform failed");
+        return errCode;
+    }
+    ImageUtils::DumpPixelMapIfDumpEnabled(*this, __func__);
+    return SUCCESS;
+}
+
 void PixelMap::CopySurfaceBufferInfo(void *data)
 {
 #if !defined(_WIN32) && !defined(_APPLE) && !defined(IOS_PLATFORM) && !defined(ANDROID_PLATFORM)
@@ -40,6 +40,8 @@ static constexpr int32_t RGB888_BYTE = 3;
 namespace OHOS {
 namespace Media {
 struct BilinearPixelProcArgs;
+struct DrawPixelmapArgs;
+struct FixedSpan;
 
 static inline bool CheckOutOfRange(const Point &pt, const Size &size)
 {
@@ -168,10 +170,23 @@ private:
 
     bool DrawPixelmap(const PixmapInfo &pixmapInfo, const int32_t pixelBytes, const Size &size, uint8_t *data);
 
+    // Draw the destination in row bands through ImageTaskScheduler
+    void DrawBands(const DrawPixelmapArgs &args, bool tiled);
+
+    void DrawBand(const DrawPixelmapArgs &args, int32_t top, int32_t bottom, bool tiled);
+
+    void DrawSpan(const DrawPixelmapArgs &args, int32_t y, int32_t left, int32_t right);
+
+    // Draw a run of destination pixels whose source positions are stepped in 32.32 fixed point
+    void DrawPixels(const DrawPixelmapArgs &args, FixedSpan span, uint8_t *out);
+
+    void DrawPixels8888(const DrawPixelmapArgs &args, FixedSpan span, uint32_t *out);
+
+    bool LocateAroundPos(const DrawPixelmapArgs &args, int64_t fx, int64_t fy, AroundPos &aroundPos,
+                         uint32_t &subx, uint32_t &suby);
+
     bool CheckAllocateBuffer(PixmapInfo &outPixmap, AllocateMem allocate, int &fd, uint64_t &bufferSize, Size &dstSize);
 
-    void BilinearProc(const Point &pt, const PixmapInfo &pixmapInfo, const uint32_t rb, const int32_t shiftBytes,
-                      uint8_t *data);
     void GetAroundPixelRGB565(const AroundPos aroundPos, uint8_t *data, uint32_t rb, AroundPixels &aroundPixels);
 
     void GetAroundPixelRGB888(const AroundPos aroundPos, uint8_t *data, uint32_t rb, AroundPixels &aroundPixels);
@@ -0,0 +1,48 @@
+/*
+ * Copyright (C) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FRAMEWORKS_INNERKITSIMPL_CONVERTER_INCLUDE_IMAGE_TASK_SCHEDULER_H
+#define FRAMEWORKS_INNERKITSIMPL_CONVERTER_INCLUDE_IMAGE_TASK_SCHEDULER_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+
+namespace OHOS {
+namespace Media {
+/*
+ * Row band scheduler shared by the post processing kernels. Rows are cut into bands sized from the
+ * amount of work and the number of cores; workers keep claiming the next unprocessed band until none
+ * are left, so a slow band does not hold the other workers idle.
+ */
+class ImageTaskScheduler {
+public:
+    // Process rows [rowStart, rowEnd). Bands never overlap and may run concurrently.
+    using RowTask = std::function<void(int32_t rowStart, int32_t rowEnd)>;
+
+    /*
+     * Run task over rows [0, rows). costPerRow is the work of one row in pixel units and decides how
+     * many workers are worth dispatching. Once cancelFlag becomes true no further band is started.
+     * Returns false when the task is empty or the run was cancelled before every band was processed.
+     */
+    static bool ParallelForRows(int32_t rows, int64_t costPerRow, const RowTask &task,
+        const std::atomic<bool> *cancelFlag = nullptr);
+
+    static int32_t GetWorkerCount();
+};
+} // namespace Media
+} // namespace OHOS
+
+#endif // FRAMEWORKS_INNERKITSIMPL_CONVERTER_INCLUDE_IMAGE_TASK_SCHEDULER_H
@@ -0,0 +1,60 @@
+/*
+ * Copyright (C) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FRAMEWORKS_INNERKITSIMPL_CONVERTER_INCLUDE_PIXEL_CONVERT_SIMD_H
+#define FRAMEWORKS_INNERKITSIMPL_CONVERTER_INCLUDE_PIXEL_CONVERT_SIMD_H
+
+#include <cstdint>
+#include "pixel_convert.h"
+
+namespace OHOS {
+namespace Media {
+constexpr uint8_t CHANNEL_NONE = 0xFF;
+
+// Position of each channel inside one pixel, in elements (bytes for 8 bit formats, halves for F16).
+struct ChannelLayout {
+    uint8_t r;
+    uint8_t g;
+    uint8_t b;
+    uint8_t a;
+};
+
+/*
+ * Vectorized row kernels for the common PixelConvert pairs. Every kernel converts a prefix of the row
+ * and returns the number of pixels it handled; the caller finishes the remainder with the scalar
+ * converter, so results are bit-identical to the scalar path. A kernel returns 0 when the cpu has no
+ * usable instruction set or the alpha conversion is not supported by the kernel.
+ */
+class PixelConvertSimd {
+public:
+    static bool IsSupported();
+    static uint32_t Swizzle8888(void *destinationRow, const uint8_t *sourceRow, uint32_t sourceWidth,
+        const ChannelLayout &srcLayout, const ChannelLayout &dstLayout, AlphaConvertType alphaConvertType);
+    static uint32_t Expand888(void *destinationRow, const uint8_t *sourceRow, uint32_t sourceWidth,
+        const ChannelLayout &srcLayout, const ChannelLayout &dstLayout);
+    static uint32_t PackRGB565(void *destinationRow, const uint8_t *sourceRow, uint32_t sourceWidth,
+        const ChannelLayout &srcLayout, uint32_t srcBytes, AlphaConvertType alphaConvertType);
+    static uint32_t UnpackRGB565(void *destinationRow, const uint8_t *sourceRow, uint32_t sourceWidth,
+        const ChannelLayout &dstLayout);
+    static uint32_t U8ToF16(void *destinationRow, const uint8_t *sourceRow, uint32_t sourceWidth,
+        const ChannelLayout &srcLayout, uint32_t srcBytes, const ChannelLayout &dstLayout,
+        AlphaConvertType alphaConvertType);
+    static uint32_t F16ToU8(void *destinationRow, const uint8_t *sourceRow, uint32_t sourceWidth,
+        const ChannelLayout &srcLayout, const ChannelLayout &dstLayout, AlphaConvertType alphaConvertType);
+};
+} // namespace Media
+} // namespace OHOS
+
+#endif // FRAMEWORKS_INNERKITSIMPL_CONVERTER_INCLUDE_PIXEL_CONVERT_SIMD_H
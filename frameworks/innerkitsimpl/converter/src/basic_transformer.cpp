@@ -14,10 +14,12 @@
  */
 
 #include "basic_transformer.h"
+#include <cmath>
 #include <iostream>
 #include <new>
 #include <unistd.h>
 #include "image_log.h"
+#include "image_task_scheduler.h"
 #include "image_utils.h"
 #include "pixel_convert.h"
 #include "pixel_map.h"
@@ -32,6 +34,14 @@
 #include <sys/mman.h>
 #endif
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define BASIC_TRANSFORMER_SIMD_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define BASIC_TRANSFORMER_SIMD_NEON
+#endif
+
 #undef LOG_DOMAIN
 #define LOG_DOMAIN LOG_TAG_DOMAIN_ID_IMAGE
 
@@ -61,6 +71,15 @@ namespace {
     constexpr uint32_t OFFSET_2 = 2;
 
     constexpr uint32_t NUM_256 = 256;
+    constexpr uint32_t SUB_STEPS = 16;
+    constexpr uint32_t RGBA_CHANNELS = 4;
+    constexpr uint32_t BILINEAR_LANES = 8;
+
+    constexpr int32_t FIXED_SHIFT = 32;
+    constexpr double FIXED_ONE = 4294967296.0;
+    // Spans reaching beyond this distance are evaluated per pixel so the fixed point steps cannot overflow
+    constexpr double FIXED_SAFE_LIMIT = 1073741824.0;
+    constexpr int32_t DRAW_TILE_SIZE = 64;
 }
 namespace OHOS {
 namespace Media {
@@ -188,16 +207,6 @@ uint32_t BasicTransformer::TransformPixmap(const PixmapInfo &inPixmap, PixmapInf
     outPixmap.imageInfo.alphaType = inPixmap.imageInfo.alphaType;
     outPixmap.imageInfo.baseDensity = inPixmap.imageInfo.baseDensity;
 
-    if (memset_s(outPixmap.data, bufferSize * sizeof(uint8_t), COLOR_DEFAULT, bufferSize * sizeof(uint8_t)) != EOK) {
-        IMAGE_LOGE("[BasicTransformer]apply heap memory failed.");
-        ReleaseBuffer((allocate == nullptr) ? AllocatorType::HEAP_ALLOC : AllocatorType::SHARE_MEM_ALLOC,
-            fd, bufferSize, outPixmap.data);
-        outPixmap.data = nullptr;
-        delete outPixmap.context;
-        outPixmap.context = nullptr;
-        return ERR_IMAGE_GENERAL_ERROR;
-    }
-
     if (!DrawPixelmap(inPixmap, pixelBytes, dstSize, outPixmap.data)) {
         IMAGE_LOGE("[BasicTransformer] the matrix can not invert.");
         ReleaseBuffer((allocate == nullptr) ? AllocatorType::HEAP_ALLOC : AllocatorType::SHARE_MEM_ALLOC,
@@ -210,15 +219,114 @@ uint32_t BasicTransformer::TransformPixmap(const PixmapInfo &inPixmap, PixmapInf
     return IMAGE_SUCCESS;
 }
 
-static inline void pointLoop(Point &pt, const Size &size)
+struct BilinearPixelProcArgs {
+    PixelFormat format;
+    uint8_t* in;
+    uint8_t* out;
+    uint32_t rowBytes;
+    uint32_t subx;
+    uint32_t suby;
+};
+
+struct DrawPixelmapArgs {
+    PixelFormat format;
+    uint8_t *in;
+    uint32_t rowBytes;
+    Size srcSize;
+    int64_t srcWidthFixed;
+    int64_t srcHeightFixed;
+    uint8_t *out;
+    Size dstSize;
+    int32_t pixelBytes;
+    // Source point of the center of destination pixel (0, 0), and its delta per destination column and row
+    double originX;
+    double originY;
+    double colX;
+    double colY;
+    double rowX;
+    double rowY;
+    bool wrap;
+};
+
+struct FixedSpan {
+    int64_t x;
+    int64_t y;
+    int64_t stepX;
+    int64_t stepY;
+    int32_t count;
+};
+
+static inline int64_t ToFixed(double value)
 {
-    if (pt.x < 0) {
-        pt.x = size.width + pt.x;
-    }
-    if (pt.y < 0) {
-        pt.y = size.height + pt.y;
+    value = std::min(std::max(value, -FIXED_SAFE_LIMIT), FIXED_SAFE_LIMIT);
+    return static_cast<int64_t>(std::floor(value * FIXED_ONE));
+}
+
+static inline bool IsFormat8888(PixelFormat format)
+{
+    return format == PixelFormat::RGBA_8888 || format == PixelFormat::ARGB_8888 || format == PixelFormat::BGRA_8888;
+}
+
+#if defined(BASIC_TRANSFORMER_SIMD_SSE2) || defined(BASIC_TRANSFORMER_SIMD_NEON)
+// FilterProc weights of one sub position, replicated to the 16 bit lanes of {color00, color01} and {color10, color11}
+struct alignas(16) BilinearWeights {
+    uint16_t top[BILINEAR_LANES];
+    uint16_t bottom[BILINEAR_LANES];
+};
+
+struct BilinearWeightTable {
+    BilinearWeightTable()
+    {
+        for (uint32_t suby = 0; suby < SUB_STEPS; ++suby) {
+            for (uint32_t subx = 0; subx < SUB_STEPS; ++subx) {
+                BilinearWeights &entry = weights[suby * SUB_STEPS + subx];
+                uint32_t xy = subx * suby;
+                uint32_t weight[] = { NUM_256 - SUB_STEPS * suby - SUB_STEPS * subx + xy, SUB_STEPS * subx - xy,
+                    SUB_STEPS * suby - xy, xy };
+                for (uint32_t lane = 0; lane < BILINEAR_LANES; ++lane) {
+                    uint32_t pixel = lane / RGBA_CHANNELS;
+                    entry.top[lane] = static_cast<uint16_t>(weight[pixel]);
+                    entry.bottom[lane] = static_cast<uint16_t>(weight[pixel + OFFSET_2]);
+                }
+            }
+        }
     }
+    BilinearWeights weights[SUB_STEPS * SUB_STEPS];
+};
+
+static const BilinearWeightTable &GetBilinearWeightTable()
+{
+    static const BilinearWeightTable table;
+    return table;
 }
+#endif
+
+#if defined(BASIC_TRANSFORMER_SIMD_SSE2)
+// Same result as FilterProc when color01 and color11 follow color00 and color10 in memory.
+static inline uint32_t FilterAdjacent8888(const uint8_t *row0, const uint8_t *row1, const BilinearWeights &weights)
+{
+    __m128i zero = _mm_setzero_si128();
+    __m128i top = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(row0)), zero);
+    __m128i bottom = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(row1)), zero);
+    // Every channel sum is at most 255 * 256, so 16 bit lanes never overflow
+    __m128i acc = _mm_add_epi16(_mm_mullo_epi16(top, _mm_load_si128(reinterpret_cast<const __m128i *>(weights.top))),
+        _mm_mullo_epi16(bottom, _mm_load_si128(reinterpret_cast<const __m128i *>(weights.bottom))));
+    acc = _mm_add_epi16(acc, _mm_srli_si128(acc, BILINEAR_LANES));
+    acc = _mm_srli_epi16(acc, SHIFT_8_BIT);
+    return static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_packus_epi16(acc, acc)));
+}
+#elif defined(BASIC_TRANSFORMER_SIMD_NEON)
+// Same result as FilterProc when color01 and color11 follow color00 and color10 in memory.
+static inline uint32_t FilterAdjacent8888(const uint8_t *row0, const uint8_t *row1, const BilinearWeights &weights)
+{
+    // Every channel sum is at most 255 * 256, so 16 bit lanes never overflow
+    uint16x8_t acc = vmulq_u16(vmovl_u8(vld1_u8(row0)), vld1q_u16(weights.top));
+    acc = vmlaq_u16(acc, vmovl_u8(vld1_u8(row1)), vld1q_u16(weights.bottom));
+    uint16x4_t sum = vadd_u16(vget_low_u16(acc), vget_high_u16(acc));
+    uint8x8_t pixel = vshrn_n_u16(vcombine_u16(sum, sum), SHIFT_8_BIT);
+    return vget_lane_u32(vreinterpret_u32_u8(pixel), 0);
+}
+#endif
 
 bool BasicTransformer::DrawPixelmap(const PixmapInfo &pixmapInfo, const int32_t pixelBytes, const Size &size,
                                     uint8_t *data)
@@ -228,27 +336,177 @@ bool BasicTransformer::DrawPixelmap(const PixmapInfo &pixmapInfo, const int32_t
         return false;
     }
 
-    uint32_t rb = pixmapInfo.imageInfo.size.width * pixelBytes;
+    DrawPixelmapArgs args;
+    args.format = pixmapInfo.imageInfo.pixelFormat;
+    args.in = pixmapInfo.data;
+    args.rowBytes = pixmapInfo.imageInfo.size.width * pixelBytes;
+    args.srcSize = pixmapInfo.imageInfo.size;
+    args.srcWidthFixed = static_cast<int64_t>(args.srcSize.width) << FIXED_SHIFT;
+    args.srcHeightFixed = static_cast<int64_t>(args.srcSize.height) << FIXED_SHIFT;
+    args.out = data;
+    args.dstSize = size;
+    args.pixelBytes = pixelBytes;
+
+    // The inverse matrix is affine, so the source point moves by a constant delta per destination column and row.
+    args.colX = invertMatrix.GetScaleX();
+    args.colY = invertMatrix.GetSkewY();
+    args.rowX = invertMatrix.GetSkewX();
+    args.rowY = invertMatrix.GetScaleY();
+    // Center coordinate alignment, need to add 0.5, so the boundary can also be considered
+    double centerX = static_cast<double>(minX_) + FHALF;
+    double centerY = static_cast<double>(minY_) + FHALF;
+    args.originX = centerX * args.colX + centerY * args.rowX + invertMatrix.GetTransX();
+    args.originY = centerX * args.colY + centerY * args.rowY + invertMatrix.GetTranY();
+
     Matrix::OperType operType = matrix_.GetOperType();
-    Matrix::CalcXYProc fInvProc = Matrix::GetXYProc(operType);
-
-    for (int32_t y = 0; y < size.height; ++y) {
-        for (int32_t x = 0; x < size.width; ++x) {
-            Point srcPoint;
-            // Center coordinate alignment, need to add 0.5, so the boundary can also be considered
-            fInvProc(invertMatrix, static_cast<float>(x) + minX_ + FHALF, static_cast<float>(y) + minY_ + FHALF,
-                     srcPoint);
-            if ((static_cast<uint8_t>(operType) & Matrix::OperType::SCALE) == Matrix::OperType::SCALE) {
-                pointLoop(srcPoint, pixmapInfo.imageInfo.size);
-            }
-            if (CheckOutOfRange(srcPoint, pixmapInfo.imageInfo.size)) {
-                continue;
+    args.wrap = (static_cast<uint8_t>(operType) & Matrix::OperType::SCALE) == Matrix::OperType::SCALE;
+    bool tiled = (static_cast<uint8_t>(operType) & Matrix::OperType::ROTATEORSKEW) == Matrix::OperType::ROTATEORSKEW;
+
+    bool supported = IsFormat8888(args.format) || args.format == PixelFormat::RGB_565 ||
+        args.format == PixelFormat::RGB_888 || args.format == PixelFormat::ALPHA_8;
+    if (!supported) {
+        IMAGE_LOGE("[BasicTransformer] pixel format not supported, format:%{public}d", args.format);
+        uint64_t bufferSize = static_cast<uint64_t>(size.width) * static_cast<uint64_t>(size.height) *
+            static_cast<uint64_t>(pixelBytes);
+        std::fill_n(data, bufferSize, COLOR_DEFAULT);
+        return true;
+    }
+    DrawBands(args, tiled);
+    return true;
+}
+
+void BasicTransformer::DrawBands(const DrawPixelmapArgs &args, bool tiled)
+{
+    int32_t height = args.dstSize.height;
+    // Bands are scheduled in whole tile rows so every tile is drawn by exactly one band
+    int32_t tileRows = (height + DRAW_TILE_SIZE - 1) / DRAW_TILE_SIZE;
+    int64_t costPerTileRow = static_cast<int64_t>(args.dstSize.width) * DRAW_TILE_SIZE;
+    auto task = [this, &args, height, tiled](int32_t rowStart, int32_t rowEnd) {
+        DrawBand(args, rowStart * DRAW_TILE_SIZE, std::min(rowEnd * DRAW_TILE_SIZE, height), tiled);
+    };
+    ImageTaskScheduler::ParallelForRows(tileRows, costPerTileRow, task);
+}
+
+void BasicTransformer::DrawBand(const DrawPixelmapArgs &args, int32_t top, int32_t bottom, bool tiled)
+{
+    int32_t width = args.dstSize.width;
+    if (!tiled) {
+        for (int32_t y = top; y < bottom; ++y) {
+            DrawSpan(args, y, 0, width);
+        }
+        return;
+    }
+
+    // A rotated row reads the source along a diagonal, walking small tiles keeps those source rows in cache
+    for (int32_t tileTop = top; tileTop < bottom; tileTop += DRAW_TILE_SIZE) {
+        int32_t tileBottom = std::min(tileTop + DRAW_TILE_SIZE, bottom);
+        for (int32_t tileLeft = 0; tileLeft < width; tileLeft += DRAW_TILE_SIZE) {
+            int32_t tileRight = std::min(tileLeft + DRAW_TILE_SIZE, width);
+            for (int32_t y = tileTop; y < tileBottom; ++y) {
+                DrawSpan(args, y, tileLeft, tileRight);
             }
-            uint32_t shiftBytes = static_cast<uint32_t>((y * size.width + x) * pixelBytes);
-            BilinearProc(srcPoint, pixmapInfo, rb, shiftBytes, data);
         }
     }
+}
+
+void BasicTransformer::DrawSpan(const DrawPixelmapArgs &args, int32_t y, int32_t left, int32_t right)
+{
+    int32_t count = right - left;
+    double startX = args.originX + args.colX * left + args.rowX * y;
+    double startY = args.originY + args.colY * left + args.rowY * y;
+    double endX = startX + args.colX * count;
+    double endY = startY + args.colY * count;
+    uint8_t *out = args.out + (static_cast<uint64_t>(y) * args.dstSize.width + left) * args.pixelBytes;
+
+    bool safe = std::fabs(startX) < FIXED_SAFE_LIMIT && std::fabs(startY) < FIXED_SAFE_LIMIT &&
+        std::fabs(endX) < FIXED_SAFE_LIMIT && std::fabs(endY) < FIXED_SAFE_LIMIT;
+    if (safe) {
+        FixedSpan span = { ToFixed(startX), ToFixed(startY), ToFixed(args.colX), ToFixed(args.colY), count };
+        DrawPixels(args, span, out);
+        return;
+    }
+    for (int32_t x = 0; x < count; ++x) {
+        FixedSpan span = { ToFixed(startX + args.colX * x), ToFixed(startY + args.colY * x), 0, 0, 1 };
+        DrawPixels(args, span, out + x * args.pixelBytes);
+    }
+}
+
+void BasicTransformer::DrawPixels(const DrawPixelmapArgs &args, FixedSpan span, uint8_t *out)
+{
+    if (IsFormat8888(args.format)) {
+        DrawPixels8888(args, span, reinterpret_cast<uint32_t *>(out));
+        return;
+    }
+
+    struct BilinearPixelProcArgs procArgs;
+    procArgs.format = args.format;
+    procArgs.in = args.in;
+    procArgs.rowBytes = args.rowBytes;
+    AroundPos aroundPos;
+    for (int32_t i = 0; i < span.count; ++i) {
+        procArgs.out = out + i * args.pixelBytes;
+        if (LocateAroundPos(args, span.x, span.y, aroundPos, procArgs.subx, procArgs.suby)) {
+            BilinearPixelProc(aroundPos, procArgs);
+        } else {
+            std::fill_n(procArgs.out, args.pixelBytes, COLOR_DEFAULT);
+        }
+        span.x += span.stepX;
+        span.y += span.stepY;
+    }
+}
+
+void BasicTransformer::DrawPixels8888(const DrawPixelmapArgs &args, FixedSpan span, uint32_t *out)
+{
+    AroundPos aroundPos;
+    AroundPixels aroundPixels;
+    uint32_t subx = 0;
+    uint32_t suby = 0;
+#if defined(BASIC_TRANSFORMER_SIMD_SSE2) || defined(BASIC_TRANSFORMER_SIMD_NEON)
+    const BilinearWeights *weights = GetBilinearWeightTable().weights;
+#endif
+    for (int32_t i = 0; i < span.count; ++i) {
+        bool inRange = LocateAroundPos(args, span.x, span.y, aroundPos, subx, suby);
+        span.x += span.stepX;
+        span.y += span.stepY;
+        if (!inRange) {
+            out[i] = COLOR_DEFAULT;
+            continue;
+        }
+#if defined(BASIC_TRANSFORMER_SIMD_SSE2) || defined(BASIC_TRANSFORMER_SIMD_NEON)
+        // Only the last source column has a clamped right neighbour
+        if (aroundPos.x1 != aroundPos.x0) {
+            const uint8_t *pixel0 = args.in + aroundPos.y0 * args.rowBytes + aroundPos.x0 * sizeof(uint32_t);
+            const uint8_t *pixel1 = args.in + aroundPos.y1 * args.rowBytes + aroundPos.x0 * sizeof(uint32_t);
+            out[i] = FilterAdjacent8888(pixel0, pixel1, weights[suby * SUB_STEPS + subx]);
+            continue;
+        }
+#endif
+        GetAroundPixelRGBA(aroundPos, args.in, args.rowBytes, aroundPixels);
+        out[i] = FilterProc(subx, suby, aroundPixels);
+    }
+}
+
+bool BasicTransformer::LocateAroundPos(const DrawPixelmapArgs &args, int64_t fx, int64_t fy, AroundPos &aroundPos,
+                                       uint32_t &subx, uint32_t &suby)
+{
+    // A scaled matrix maps negative points back into the source
+    if (args.wrap) {
+        fx = (fx < 0) ? fx + args.srcWidthFixed : fx;
+        fy = (fy < 0) ? fy + args.srcHeightFixed : fy;
+    }
+    if (fx < 0 || fx >= args.srcWidthFixed || fy < 0 || fy >= args.srcHeightFixed) {
+        return false;
+    }
 
+    // Move to 16.16 and back off half a pixel to address the top-left neighbour
+    uint32_t srcX = static_cast<uint32_t>(std::max<int64_t>((fx >> SHIFT_16_BIT) - HALF_BASIC, 0));
+    uint32_t srcY = static_cast<uint32_t>(std::max<int64_t>((fy >> SHIFT_16_BIT) - HALF_BASIC, 0));
+    subx = GetSubValue(srcX);
+    suby = GetSubValue(srcY);
+    aroundPos.x0 = RightShift16Bit(srcX, args.srcSize.width - 1);
+    aroundPos.x1 = RightShift16Bit(srcX + BASIC, args.srcSize.width - 1);
+    aroundPos.y0 = RightShift16Bit(srcY, args.srcSize.height - 1);
+    aroundPos.y1 = RightShift16Bit(srcY + BASIC, args.srcSize.height - 1);
     return true;
 }
 
@@ -296,15 +554,6 @@ static uint16_t Color32toRGB565(uint32_t c)
     return (r << SHIFT_11_BIT) | (g << SHIFT_5_BIT) | b;
 }
 
-struct BilinearPixelProcArgs {
-    PixelFormat format;
-    uint8_t* in;
-    uint8_t* out;
-    uint32_t rowBytes;
-    uint32_t subx;
-    uint32_t suby;
-};
-
 void BasicTransformer::BilinearPixelProc(const AroundPos aroundPos, struct BilinearPixelProcArgs &args)
 {
     AroundPixels aroundPixels;
@@ -350,29 +599,6 @@ void BasicTransformer::BilinearPixelProc(const AroundPos aroundPos, struct Bilin
     }
 }
 
-void BasicTransformer::BilinearProc(const Point &pt, const PixmapInfo &pixmapInfo, const uint32_t rb,
-                                    const int32_t shiftBytes, uint8_t *data)
-{
-    uint32_t srcX = (pt.x * MULTI_65536) - HALF_BASIC < 0 ? 0 : (pt.x * MULTI_65536) - HALF_BASIC;
-    uint32_t srcY = (pt.y * MULTI_65536) - HALF_BASIC < 0 ? 0 : (pt.y * MULTI_65536) - HALF_BASIC;
-
-    struct BilinearPixelProcArgs procArgs;
-    procArgs.format = pixmapInfo.imageInfo.pixelFormat;
-    procArgs.in = pixmapInfo.data;
-    procArgs.out = data + shiftBytes;
-    procArgs.rowBytes = rb;
-    procArgs.subx = GetSubValue(srcX);
-    procArgs.suby = GetSubValue(srcY);
-
-    AroundPos aroundPos;
-    aroundPos.x0 = RightShift16Bit(srcX, pixmapInfo.imageInfo.size.width - 1);
-    aroundPos.x1 = RightShift16Bit(srcX + BASIC, pixmapInfo.imageInfo.size.width - 1);
-    aroundPos.y0 = RightShift16Bit(srcY, pixmapInfo.imageInfo.size.height - 1);
-    aroundPos.y1 = RightShift16Bit(srcY + BASIC, pixmapInfo.imageInfo.size.height - 1);
-
-    BilinearPixelProc(aroundPos, procArgs);
-}
-
 void BasicTransformer::GetAroundPixelRGB565(const AroundPos aroundPos, uint8_t *data, uint32_t rb,
                                             AroundPixels &aroundPixels)
 {
@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "image_task_scheduler.h"
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+#if !defined(_WIN32) && !defined(_APPLE) && !defined(IOS_PLATFORM) && !defined(ANDROID_PLATFORM)
+#include "ffrt.h"
+#endif
+#include "image_log.h"
+
+#undef LOG_DOMAIN
+#define LOG_DOMAIN LOG_TAG_DOMAIN_ID_IMAGE
+
+#undef LOG_TAG
+#define LOG_TAG "ImageTaskScheduler"
+
+namespace OHOS {
+namespace Media {
+namespace {
+constexpr int32_t MAX_WORKERS = 16;
+// Bands handed out per worker, more bands balance better but cost more claims
+constexpr int32_t BANDS_PER_WORKER = 4;
+// Smallest amount of work, in pixels, worth a band of its own
+constexpr int64_t MIN_BAND_COST = 64 * 1024;
+#if !defined(_WIN32) && !defined(_APPLE) && !defined(IOS_PLATFORM) && !defined(ANDROID_PLATFORM)
+// Bands run for a caller that is waiting on them, so they get the highest ffrt qos
+constexpr int WORKER_QOS = ffrt::qos_user_interactive;
+#endif
+}
+
+int32_t ImageTaskScheduler::GetWorkerCount()
+{
+#if !defined(_WIN32) && !defined(_APPLE) && !defined(IOS_PLATFORM) && !defined(ANDROID_PLATFORM)
+    static const int32_t workerCount = std::clamp(static_cast<int32_t>(std::thread::hardware_concurrency()),
+        1, MAX_WORKERS);
+    return workerCount;
+#else
+    return 1;
+#endif
+}
+
+static inline bool IsCancelled(const std::atomic<bool> *cancelFlag)
+{
+    return cancelFlag != nullptr && cancelFlag->load(std::memory_order_relaxed);
+}
+
+bool ImageTaskScheduler::ParallelForRows(int32_t rows, int64_t costPerRow, const RowTask &task,
+    const std::atomic<bool> *cancelFlag)
+{
+    CHECK_ERROR_RETURN_RET_LOG(!task, false, "ParallelForRows task is empty");
+    if (rows <= 0) {
+        return true;
+    }
+    int64_t totalCost = static_cast<int64_t>(rows) * std::max<int64_t>(costPerRow, 1);
+    int64_t maxBands = std::max<int64_t>(totalCost / MIN_BAND_COST, 1);
+    int32_t workers = static_cast<int32_t>(std::min<int64_t>(GetWorkerCount(), maxBands));
+    int32_t bandCount = static_cast<int32_t>(std::min<int64_t>({ static_cast<int64_t>(rows), maxBands,
+        static_cast<int64_t>(workers) * BANDS_PER_WORKER }));
+    int32_t bandRows = (rows + bandCount - 1) / bandCount;
+    bandCount = (rows + bandRows - 1) / bandRows;
+
+    std::atomic<int32_t> nextBand(0);
+    std::atomic<bool> stopped(false);
+    auto worker = [&task, &nextBand, &stopped, cancelFlag, bandCount, bandRows, rows] {
+        for (;;) {
+            int32_t band = nextBand.fetch_add(1, std::memory_order_relaxed);
+            if (band >= bandCount) {
+                return;
+            }
+            // Only a band that is claimed and then skipped makes the call cancelled
+            if (IsCancelled(cancelFlag)) {
+                stopped.store(true, std::memory_order_relaxed);
+                return;
+            }
+            int32_t rowStart = band * bandRows;
+            task(rowStart, std::min(rowStart + bandRows, rows));
+        }
+    };
+
+#if !defined(_WIN32) && !defined(_APPLE) && !defined(IOS_PLATFORM) && !defined(ANDROID_PLATFORM)
+    std::vector<ffrt::dependence> ffrtHandles;
+    // The calling thread is one of the workers
+    for (int32_t i = 1; i < workers; i++) {
+        ffrtHandles.emplace_back(ffrt::submit_h(worker, {}, {}, ffrt::task_attr().qos(WORKER_QOS)));
+    }
+    worker();
+    ffrt::wait(ffrtHandles);
+#else
+    worker();
+#endif
+    return !stopped.load(std::memory_order_relaxed);
+}
+} // namespace Media
+} // namespace OHOS
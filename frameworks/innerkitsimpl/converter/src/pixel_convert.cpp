@@ -26,6 +26,7 @@
 #include "memory.h"
 #endif
 #include "pixel_convert_adapter.h"
+#include "pixel_convert_simd.h"
 #include "image_utils.h"
 #include "pixel_map.h"
 
@@ -994,117 +995,354 @@ static void RGBAF16ConvertRGB565(void *destinationRow, const uint8_t *sourceRow,
     RGBAF16Convert(newDestinationRow, sourceRow, sourceWidth, BRANCH_RGBAF16_TO_RGB565, extension);
 }
 
-static map<string, ProcFuncType> g_procMapping;
-static mutex g_procMutex;
+// Dense slots for the formats owning a row converter, g_procTable is indexed as [src][dst].
+enum ProcFormatIndex : uint32_t {
+    PROC_INDEX_GRAY_BIT = 0,
+    PROC_INDEX_GRAY_ALPHA,
+    PROC_INDEX_ALPHA_8,
+    PROC_INDEX_RGB_565,
+    PROC_INDEX_RGB_888,
+    PROC_INDEX_BGR_888,
+    PROC_INDEX_RGBA_8888,
+    PROC_INDEX_BGRA_8888,
+    PROC_INDEX_ARGB_8888,
+    PROC_INDEX_ABGR_8888,
+    PROC_INDEX_RGBA_F16,
+    PROC_INDEX_RGB_161616,
+    PROC_INDEX_RGBA_16161616,
+    PROC_INDEX_CMKY,
+    PROC_INDEX_COUNT,
+};
+
+static ProcFuncType g_procTable[PROC_INDEX_COUNT][PROC_INDEX_COUNT] = {};
+static once_flag g_procOnce;
+
+static uint32_t GetProcFormatIndex(uint32_t format)
+{
+    switch (format) {
+        case GRAY_BIT:
+            return PROC_INDEX_GRAY_BIT;
+        case GRAY_ALPHA:
+            return PROC_INDEX_GRAY_ALPHA;
+        case ALPHA_8:
+            return PROC_INDEX_ALPHA_8;
+        case RGB_565:
+            return PROC_INDEX_RGB_565;
+        case RGB_888:
+            return PROC_INDEX_RGB_888;
+        case BGR_888:
+            return PROC_INDEX_BGR_888;
+        case RGBA_8888:
+            return PROC_INDEX_RGBA_8888;
+        case BGRA_8888:
+            return PROC_INDEX_BGRA_8888;
+        case ARGB_8888:
+            return PROC_INDEX_ARGB_8888;
+        case ABGR_8888:
+            return PROC_INDEX_ABGR_8888;
+        case RGBA_F16:
+            return PROC_INDEX_RGBA_F16;
+        case RGB_161616:
+            return PROC_INDEX_RGB_161616;
+        case RGBA_16161616:
+            return PROC_INDEX_RGBA_16161616;
+        case CMKY:
+            return PROC_INDEX_CMKY;
+        default:
+            return PROC_INDEX_COUNT;
+    }
+}
 
-static string MakeKey(uint32_t srcFormat, uint32_t dstFormat)
+static void RegisterProc(uint32_t srcFormat, uint32_t dstFormat, ProcFuncType procFunc)
 {
-    return to_string(srcFormat) + ("_") + to_string(dstFormat);
+    uint32_t srcIndex = GetProcFormatIndex(srcFormat);
+    uint32_t dstIndex = GetProcFormatIndex(dstFormat);
+    if (srcIndex < PROC_INDEX_COUNT && dstIndex < PROC_INDEX_COUNT) {
+        g_procTable[srcIndex][dstIndex] = procFunc;
+    }
 }
 
 static void InitGrayProc()
 {
-    g_procMapping.emplace(MakeKey(GRAY_BIT, ARGB_8888), &BitConvertARGB8888);
-    g_procMapping.emplace(MakeKey(GRAY_BIT, RGB_565), &BitConvertRGB565);
-    g_procMapping.emplace(MakeKey(GRAY_BIT, ALPHA_8), &BitConvertGray);
+    RegisterProc(GRAY_BIT, ARGB_8888, &BitConvertARGB8888);
+    RegisterProc(GRAY_BIT, RGB_565, &BitConvertRGB565);
+    RegisterProc(GRAY_BIT, ALPHA_8, &BitConvertGray);
 
-    g_procMapping.emplace(MakeKey(ALPHA_8, ARGB_8888), &GrayConvertARGB8888);
-    g_procMapping.emplace(MakeKey(ALPHA_8, RGB_565), &GrayConvertRGB565);
+    RegisterProc(ALPHA_8, ARGB_8888, &GrayConvertARGB8888);
+    RegisterProc(ALPHA_8, RGB_565, &GrayConvertRGB565);
 
-    g_procMapping.emplace(MakeKey(GRAY_ALPHA, ARGB_8888), &GrayAlphaConvertARGB8888);
-    g_procMapping.emplace(MakeKey(GRAY_ALPHA, ALPHA_8), &GrayAlphaConvertAlpha);
+    RegisterProc(GRAY_ALPHA, ARGB_8888, &GrayAlphaConvertARGB8888);
+    RegisterProc(GRAY_ALPHA, ALPHA_8, &GrayAlphaConvertAlpha);
 }
 
 static void InitRGBProc()
 {
-    g_procMapping.emplace(MakeKey(RGB_888, ARGB_8888), &RGB888ConvertARGB8888);
-    g_procMapping.emplace(MakeKey(RGB_888, RGBA_8888), &RGB888ConvertRGBA8888);
-    g_procMapping.emplace(MakeKey(RGB_888, BGRA_8888), &RGB888ConvertBGRA8888);
-    g_procMapping.emplace(MakeKey(RGB_888, RGB_565), &RGB888ConvertRGB565);
+    RegisterProc(RGB_888, ARGB_8888, &RGB888ConvertARGB8888);
+    RegisterProc(RGB_888, RGBA_8888, &RGB888ConvertRGBA8888);
+    RegisterProc(RGB_888, BGRA_8888, &RGB888ConvertBGRA8888);
+    RegisterProc(RGB_888, RGB_565, &RGB888ConvertRGB565);
 
-    g_procMapping.emplace(MakeKey(BGR_888, ARGB_8888), &BGR888ConvertARGB8888);
-    g_procMapping.emplace(MakeKey(BGR_888, RGBA_8888), &BGR888ConvertRGBA8888);
-    g_procMapping.emplace(MakeKey(BGR_888, BGRA_8888), &BGR888ConvertBGRA8888);
-    g_procMapping.emplace(MakeKey(BGR_888, RGB_565), &BGR888ConvertRGB565);
+    RegisterProc(BGR_888, ARGB_8888, &BGR888ConvertARGB8888);
+    RegisterProc(BGR_888, RGBA_8888, &BGR888ConvertRGBA8888);
+    RegisterProc(BGR_888, BGRA_8888, &BGR888ConvertBGRA8888);
+    RegisterProc(BGR_888, RGB_565, &BGR888ConvertRGB565);
 
-    g_procMapping.emplace(MakeKey(RGB_161616, ARGB_8888), &RGB161616ConvertARGB8888);
-    g_procMapping.emplace(MakeKey(RGB_161616, ABGR_8888), &RGB161616ConvertABGR8888);
-    g_procMapping.emplace(MakeKey(RGB_161616, RGBA_8888), &RGB161616ConvertRGBA8888);
-    g_procMapping.emplace(MakeKey(RGB_161616, BGRA_8888), &RGB161616ConvertBGRA8888);
-    g_procMapping.emplace(MakeKey(RGB_161616, RGB_565), &RGB161616ConvertRGB565);
+    RegisterProc(RGB_161616, ARGB_8888, &RGB161616ConvertARGB8888);
+    RegisterProc(RGB_161616, ABGR_8888, &RGB161616ConvertABGR8888);
+    RegisterProc(RGB_161616, RGBA_8888, &RGB161616ConvertRGBA8888);
+    RegisterProc(RGB_161616, BGRA_8888, &RGB161616ConvertBGRA8888);
+    RegisterProc(RGB_161616, RGB_565, &RGB161616ConvertRGB565);
 
-    g_procMapping.emplace(MakeKey(RGB_565, ARGB_8888), &RGB565ConvertARGB8888);
-    g_procMapping.emplace(MakeKey(RGB_565, RGBA_8888), &RGB565ConvertRGBA8888);
-    g_procMapping.emplace(MakeKey(RGB_565, BGRA_8888), &RGB565ConvertBGRA8888);
+    RegisterProc(RGB_565, ARGB_8888, &RGB565ConvertARGB8888);
+    RegisterProc(RGB_565, RGBA_8888, &RGB565ConvertRGBA8888);
+    RegisterProc(RGB_565, BGRA_8888, &RGB565ConvertBGRA8888);
 }
 
 static void InitRGBAProc()
 {
-    g_procMapping.emplace(MakeKey(RGBA_8888, RGBA_8888), &RGBA8888ConvertRGBA8888Alpha);
-    g_procMapping.emplace(MakeKey(RGBA_8888, ARGB_8888), &RGBA8888ConvertARGB8888);
-    g_procMapping.emplace(MakeKey(RGBA_8888, BGRA_8888), &RGBA8888ConvertBGRA8888);
-    g_procMapping.emplace(MakeKey(RGBA_8888, RGB_565), &RGBA8888ConvertRGB565);
+    RegisterProc(RGBA_8888, RGBA_8888, &RGBA8888ConvertRGBA8888Alpha);
+    RegisterProc(RGBA_8888, ARGB_8888, &RGBA8888ConvertARGB8888);
+    RegisterProc(RGBA_8888, BGRA_8888, &RGBA8888ConvertBGRA8888);
+    RegisterProc(RGBA_8888, RGB_565, &RGBA8888ConvertRGB565);
 
-    g_procMapping.emplace(MakeKey(BGRA_8888, RGBA_8888), &BGRA8888ConvertRGBA8888);
-    g_procMapping.emplace(MakeKey(BGRA_8888, ARGB_8888), &BGRA8888ConvertARGB8888);
-    g_procMapping.emplace(MakeKey(BGRA_8888, BGRA_8888), &BGRA8888ConvertBGRA8888Alpha);
-    g_procMapping.emplace(MakeKey(BGRA_8888, RGB_565), &BGRA8888ConvertRGB565);
+    RegisterProc(BGRA_8888, RGBA_8888, &BGRA8888ConvertRGBA8888);
+    RegisterProc(BGRA_8888, ARGB_8888, &BGRA8888ConvertARGB8888);
+    RegisterProc(BGRA_8888, BGRA_8888, &BGRA8888ConvertBGRA8888Alpha);
+    RegisterProc(BGRA_8888, RGB_565, &BGRA8888ConvertRGB565);
 
-    g_procMapping.emplace(MakeKey(ARGB_8888, RGBA_8888), &ARGB8888ConvertRGBA8888);
-    g_procMapping.emplace(MakeKey(ARGB_8888, ARGB_8888), &ARGB8888ConvertARGB8888Alpha);
-    g_procMapping.emplace(MakeKey(ARGB_8888, BGRA_8888), &ARGB8888ConvertBGRA8888);
-    g_procMapping.emplace(MakeKey(ARGB_8888, RGB_565), &ARGB8888ConvertRGB565);
+    RegisterProc(ARGB_8888, RGBA_8888, &ARGB8888ConvertRGBA8888);
+    RegisterProc(ARGB_8888, ARGB_8888, &ARGB8888ConvertARGB8888Alpha);
+    RegisterProc(ARGB_8888, BGRA_8888, &ARGB8888ConvertBGRA8888);
+    RegisterProc(ARGB_8888, RGB_565, &ARGB8888ConvertRGB565);
 
-    g_procMapping.emplace(MakeKey(RGBA_16161616, ARGB_8888), &RGBA16161616ConvertARGB8888);
-    g_procMapping.emplace(MakeKey(RGBA_16161616, RGBA_8888), &RGBA16161616ConvertRGBA8888);
-    g_procMapping.emplace(MakeKey(RGBA_16161616, BGRA_8888), &RGBA16161616ConvertBGRA8888);
-    g_procMapping.emplace(MakeKey(RGBA_16161616, ABGR_8888), &RGBA16161616ConvertABGR8888);
+    RegisterProc(RGBA_16161616, ARGB_8888, &RGBA16161616ConvertARGB8888);
+    RegisterProc(RGBA_16161616, RGBA_8888, &RGBA16161616ConvertRGBA8888);
+    RegisterProc(RGBA_16161616, BGRA_8888, &RGBA16161616ConvertBGRA8888);
+    RegisterProc(RGBA_16161616, ABGR_8888, &RGBA16161616ConvertABGR8888);
 }
 
 static void InitCMYKProc()
 {
-    g_procMapping.emplace(MakeKey(CMKY, ARGB_8888), &CMYKConvertARGB8888);
-    g_procMapping.emplace(MakeKey(CMKY, RGBA_8888), &CMYKConvertRGBA8888);
-    g_procMapping.emplace(MakeKey(CMKY, BGRA_8888), &CMYKConvertBGRA8888);
-    g_procMapping.emplace(MakeKey(CMKY, ABGR_8888), &CMYKConvertABGR8888);
-    g_procMapping.emplace(MakeKey(CMKY, RGB_565), &CMYKConvertRGB565);
+    RegisterProc(CMKY, ARGB_8888, &CMYKConvertARGB8888);
+    RegisterProc(CMKY, RGBA_8888, &CMYKConvertRGBA8888);
+    RegisterProc(CMKY, BGRA_8888, &CMYKConvertBGRA8888);
+    RegisterProc(CMKY, ABGR_8888, &CMYKConvertABGR8888);
+    RegisterProc(CMKY, RGB_565, &CMYKConvertRGB565);
 }
 
 static void InitF16Proc()
 {
-    g_procMapping.emplace(MakeKey(RGBA_F16, ARGB_8888), &RGBAF16ConvertARGB8888);
-    g_procMapping.emplace(MakeKey(RGBA_F16, RGBA_8888), &RGBAF16ConvertRGBA8888);
-    g_procMapping.emplace(MakeKey(RGBA_F16, BGRA_8888), &RGBAF16ConvertBGRA8888);
-    g_procMapping.emplace(MakeKey(RGBA_F16, ABGR_8888), &RGBAF16ConvertABGR8888);
-    g_procMapping.emplace(MakeKey(RGBA_F16, RGB_565), &RGBAF16ConvertRGB565);
+    RegisterProc(RGBA_F16, ARGB_8888, &RGBAF16ConvertARGB8888);
+    RegisterProc(RGBA_F16, RGBA_8888, &RGBAF16ConvertRGBA8888);
+    RegisterProc(RGBA_F16, BGRA_8888, &RGBAF16ConvertBGRA8888);
+    RegisterProc(RGBA_F16, ABGR_8888, &RGBAF16ConvertABGR8888);
+    RegisterProc(RGBA_F16, RGB_565, &RGBAF16ConvertRGB565);
+
+    RegisterProc(BGR_888, RGBA_F16, &BGR888ConvertRGBAF16);
+    RegisterProc(RGB_888, RGBA_F16, &RGB888ConvertRGBAF16);
+    RegisterProc(RGB_161616, RGBA_F16, &RGB161616ConvertRGBAF16);
+    RegisterProc(ARGB_8888, RGBA_F16, &ARGB8888ConvertRGBAF16);
+    RegisterProc(RGBA_8888, RGBA_F16, &RGBA8888ConvertRGBAF16);
+    RegisterProc(BGRA_8888, RGBA_F16, &BGRA8888ConvertRGBAF16);
+    RegisterProc(RGB_565, RGBA_F16, &RGB565ConvertRGBAF16);
+    RegisterProc(RGBA_16161616, RGBA_F16, &RGBA16161616ConvertRGBAF16);
+}
+
+enum class SimdRowKind : uint32_t {
+    SWIZZLE_8888 = 0,
+    EXPAND_888,
+    PACK_RGB565,
+    UNPACK_RGB565,
+    U8_TO_F16,
+    F16_TO_U8,
+};
+
+// RGBAF16Convert reads halves as R, G, B, A while FillRGBAF16 stores them as B, G, R, A.
+constexpr ChannelLayout F16_READ_LAYOUT = {0, 1, 2, 3};
+constexpr ChannelLayout F16_WRITE_LAYOUT = {2, 1, 0, 3};
+
+// Byte positions matching the Fill* helpers on little endian targets.
+static ChannelLayout GetChannelLayout(uint32_t format)
+{
+    switch (format) {
+        case BGRA_8888:
+            return {2, 1, 0, 3};
+        case ARGB_8888:
+            return {1, 2, 3, 0};
+        case ABGR_8888:
+            return {3, 2, 1, 0};
+        case RGB_888:
+            return {0, 1, 2, CHANNEL_NONE};
+        case BGR_888:
+            return {2, 1, 0, CHANNEL_NONE};
+        default:
+            return {0, 1, 2, 3};
+    }
+}
+
+static uint32_t GetProcPixelBytes(uint32_t format)
+{
+    switch (format) {
+        case RGB_565:
+            return SIZE_2_BYTE;
+        case RGB_888:
+        case BGR_888:
+            return SIZE_3_BYTE;
+        case RGBA_F16:
+            return SIZE_8_BYTE;
+        default:
+            return SIZE_4_BYTE;
+    }
+}
 
-    g_procMapping.emplace(MakeKey(BGR_888, RGBA_F16), &BGR888ConvertRGBAF16);
-    g_procMapping.emplace(MakeKey(RGB_888, RGBA_F16), &RGB888ConvertRGBAF16);
-    g_procMapping.emplace(MakeKey(RGB_161616, RGBA_F16), &RGB161616ConvertRGBAF16);
-    g_procMapping.emplace(MakeKey(ARGB_8888, RGBA_F16), &ARGB8888ConvertRGBAF16);
-    g_procMapping.emplace(MakeKey(RGBA_8888, RGBA_F16), &RGBA8888ConvertRGBAF16);
-    g_procMapping.emplace(MakeKey(BGRA_8888, RGBA_F16), &BGRA8888ConvertRGBAF16);
-    g_procMapping.emplace(MakeKey(RGB_565, RGBA_F16), &RGB565ConvertRGBAF16);
-    g_procMapping.emplace(MakeKey(RGBA_16161616, RGBA_F16), &RGBA16161616ConvertRGBAF16);
+// Runs the vector kernel on as much of the row as it accepts and finishes the tail with the scalar converter.
+template<SimdRowKind KIND, uint32_t SRC, uint32_t DST, ProcFuncType SCALAR>
+static void SimdRowConvert(void *destinationRow, const uint8_t *sourceRow, uint32_t sourceWidth,
+                           const ProcFuncExtension &extension)
+{
+    uint32_t converted = 0;
+    switch (KIND) {
+        case SimdRowKind::SWIZZLE_8888:
+            converted = PixelConvertSimd::Swizzle8888(destinationRow, sourceRow, sourceWidth,
+                GetChannelLayout(SRC), GetChannelLayout(DST), extension.alphaConvertType);
+            break;
+        case SimdRowKind::EXPAND_888:
+            converted = PixelConvertSimd::Expand888(destinationRow, sourceRow, sourceWidth,
+                GetChannelLayout(SRC), GetChannelLayout(DST));
+            break;
+        case SimdRowKind::PACK_RGB565:
+            converted = PixelConvertSimd::PackRGB565(destinationRow, sourceRow, sourceWidth,
+                GetChannelLayout(SRC), GetProcPixelBytes(SRC), extension.alphaConvertType);
+            break;
+        case SimdRowKind::UNPACK_RGB565:
+            converted = PixelConvertSimd::UnpackRGB565(destinationRow, sourceRow, sourceWidth,
+                GetChannelLayout(DST));
+            break;
+        case SimdRowKind::U8_TO_F16:
+            converted = PixelConvertSimd::U8ToF16(destinationRow, sourceRow, sourceWidth,
+                GetChannelLayout(SRC), GetProcPixelBytes(SRC), F16_WRITE_LAYOUT, extension.alphaConvertType);
+            break;
+        case SimdRowKind::F16_TO_U8:
+            converted = PixelConvertSimd::F16ToU8(destinationRow, sourceRow, sourceWidth,
+                F16_READ_LAYOUT, GetChannelLayout(DST), extension.alphaConvertType);
+            break;
+        default:
+            break;
+    }
+    if (converted < sourceWidth) {
+        SCALAR(static_cast<uint8_t *>(destinationRow) + converted * GetProcPixelBytes(DST),
+            sourceRow + converted * GetProcPixelBytes(SRC), sourceWidth - converted, extension);
+    }
+}
+
+static void InitSimdSwizzleProc()
+{
+    RegisterProc(RGBA_8888, RGBA_8888,
+        &SimdRowConvert<SimdRowKind::SWIZZLE_8888, RGBA_8888, RGBA_8888, &RGBA8888ConvertRGBA8888Alpha>);
+    RegisterProc(RGBA_8888, ARGB_8888,
+        &SimdRowConvert<SimdRowKind::SWIZZLE_8888, RGBA_8888, ARGB_8888, &RGBA8888ConvertARGB8888>);
+    RegisterProc(RGBA_8888, BGRA_8888,
+        &SimdRowConvert<SimdRowKind::SWIZZLE_8888, RGBA_8888, BGRA_8888, &RGBA8888ConvertBGRA8888>);
+
+    RegisterProc(BGRA_8888, RGBA_8888,
+        &SimdRowConvert<SimdRowKind::SWIZZLE_8888, BGRA_8888, RGBA_8888, &BGRA8888ConvertRGBA8888>);
+    RegisterProc(BGRA_8888, ARGB_8888,
+        &SimdRowConvert<SimdRowKind::SWIZZLE_8888, BGRA_8888, ARGB_8888, &BGRA8888ConvertARGB8888>);
+    RegisterProc(BGRA_8888, BGRA_8888,
+        &SimdRowConvert<SimdRowKind::SWIZZLE_8888, BGRA_8888, BGRA_8888, &BGRA8888ConvertBGRA8888Alpha>);
+
+    RegisterProc(ARGB_8888, RGBA_8888,
+        &SimdRowConvert<SimdRowKind::SWIZZLE_8888, ARGB_8888, RGBA_8888, &ARGB8888ConvertRGBA8888>);
+    RegisterProc(ARGB_8888, ARGB_8888,
+        &SimdRowConvert<SimdRowKind::SWIZZLE_8888, ARGB_8888, ARGB_8888, &ARGB8888ConvertARGB8888Alpha>);
+    RegisterProc(ARGB_8888, BGRA_8888,
+        &SimdRowConvert<SimdRowKind::SWIZZLE_8888, ARGB_8888, BGRA_8888, &ARGB8888ConvertBGRA8888>);
+
+    RegisterProc(RGB_888, ARGB_8888,
+        &SimdRowConvert<SimdRowKind::EXPAND_888, RGB_888, ARGB_8888, &RGB888ConvertARGB8888>);
+    RegisterProc(RGB_888, RGBA_8888,
+        &SimdRowConvert<SimdRowKind::EXPAND_888, RGB_888, RGBA_8888, &RGB888ConvertRGBA8888>);
+    RegisterProc(RGB_888, BGRA_8888,
+        &SimdRowConvert<SimdRowKind::EXPAND_888, RGB_888, BGRA_8888, &RGB888ConvertBGRA8888>);
+    RegisterProc(BGR_888, ARGB_8888,
+        &SimdRowConvert<SimdRowKind::EXPAND_888, BGR_888, ARGB_8888, &BGR888ConvertARGB8888>);
+    RegisterProc(BGR_888, RGBA_8888,
+        &SimdRowConvert<SimdRowKind::EXPAND_888, BGR_888, RGBA_8888, &BGR888ConvertRGBA8888>);
+    RegisterProc(BGR_888, BGRA_8888,
+        &SimdRowConvert<SimdRowKind::EXPAND_888, BGR_888, BGRA_8888, &BGR888ConvertBGRA8888>);
+}
+
+static void InitSimdRGB565Proc()
+{
+    RegisterProc(RGB_888, RGB_565,
+        &SimdRowConvert<SimdRowKind::PACK_RGB565, RGB_888, RGB_565, &RGB888ConvertRGB565>);
+    RegisterProc(BGR_888, RGB_565,
+        &SimdRowConvert<SimdRowKind::PACK_RGB565, BGR_888, RGB_565, &BGR888ConvertRGB565>);
+    RegisterProc(RGBA_8888, RGB_565,
+        &SimdRowConvert<SimdRowKind::PACK_RGB565, RGBA_8888, RGB_565, &RGBA8888ConvertRGB565>);
+    RegisterProc(BGRA_8888, RGB_565,
+        &SimdRowConvert<SimdRowKind::PACK_RGB565, BGRA_8888, RGB_565, &BGRA8888ConvertRGB565>);
+    RegisterProc(ARGB_8888, RGB_565,
+        &SimdRowConvert<SimdRowKind::PACK_RGB565, ARGB_8888, RGB_565, &ARGB8888ConvertRGB565>);
+
+    RegisterProc(RGB_565, ARGB_8888,
+        &SimdRowConvert<SimdRowKind::UNPACK_RGB565, RGB_565, ARGB_8888, &RGB565ConvertARGB8888>);
+    RegisterProc(RGB_565, RGBA_8888,
+        &SimdRowConvert<SimdRowKind::UNPACK_RGB565, RGB_565, RGBA_8888, &RGB565ConvertRGBA8888>);
+    RegisterProc(RGB_565, BGRA_8888,
+        &SimdRowConvert<SimdRowKind::UNPACK_RGB565, RGB_565, BGRA_8888, &RGB565ConvertBGRA8888>);
+}
+
+static void InitSimdF16Proc()
+{
+    RegisterProc(RGB_888, RGBA_F16,
+        &SimdRowConvert<SimdRowKind::U8_TO_F16, RGB_888, RGBA_F16, &RGB888ConvertRGBAF16>);
+    RegisterProc(BGR_888, RGBA_F16,
+        &SimdRowConvert<SimdRowKind::U8_TO_F16, BGR_888, RGBA_F16, &BGR888ConvertRGBAF16>);
+    RegisterProc(RGBA_8888, RGBA_F16,
+        &SimdRowConvert<SimdRowKind::U8_TO_F16, RGBA_8888, RGBA_F16, &RGBA8888ConvertRGBAF16>);
+    RegisterProc(BGRA_8888, RGBA_F16,
+        &SimdRowConvert<SimdRowKind::U8_TO_F16, BGRA_8888, RGBA_F16, &BGRA8888ConvertRGBAF16>);
+    RegisterProc(ARGB_8888, RGBA_F16,
+        &SimdRowConvert<SimdRowKind::U8_TO_F16, ARGB_8888, RGBA_F16, &ARGB8888ConvertRGBAF16>);
+
+    RegisterProc(RGBA_F16, ARGB_8888,
+        &SimdRowConvert<SimdRowKind::F16_TO_U8, RGBA_F16, ARGB_8888, &RGBAF16ConvertARGB8888>);
+    RegisterProc(RGBA_F16, RGBA_8888,
+        &SimdRowConvert<SimdRowKind::F16_TO_U8, RGBA_F16, RGBA_8888, &RGBAF16ConvertRGBA8888>);
+    RegisterProc(RGBA_F16, BGRA_8888,
+        &SimdRowConvert<SimdRowKind::F16_TO_U8, RGBA_F16, BGRA_8888, &RGBAF16ConvertBGRA8888>);
+    RegisterProc(RGBA_F16, ABGR_8888,
+        &SimdRowConvert<SimdRowKind::F16_TO_U8, RGBA_F16, ABGR_8888, &RGBAF16ConvertABGR8888>);
+}
+
+// Vector kernels replace the scalar converters of the hot pairs; layouts above assume little endian.
+static void InitSimdProc()
+{
+    if (!IS_LITTLE_ENDIAN || !PixelConvertSimd::IsSupported()) {
+        return;
+    }
+    InitSimdSwizzleProc();
+    InitSimdRGB565Proc();
+    InitSimdF16Proc();
 }
 
 static ProcFuncType GetProcFuncType(uint32_t srcPixelFormat, uint32_t dstPixelFormat)
 {
-    unique_lock<mutex> guard(g_procMutex);
-    if (g_procMapping.empty()) {
+    call_once(g_procOnce, [] {
         InitGrayProc();
         InitRGBProc();
         InitRGBAProc();
         InitCMYKProc();
         InitF16Proc();
+        InitSimdProc();
+    });
+    uint32_t srcIndex = GetProcFormatIndex(srcPixelFormat);
+    uint32_t dstIndex = GetProcFormatIndex(dstPixelFormat);
+    if (srcIndex >= PROC_INDEX_COUNT || dstIndex >= PROC_INDEX_COUNT) {
+        return nullptr;
     }
-    guard.unlock();
-    string procKey = MakeKey(srcPixelFormat, dstPixelFormat);
-    map<string, ProcFuncType>::iterator iter = g_procMapping.find(procKey);
-    if (iter != g_procMapping.end()) {
-        return iter->second;
-    }
-    return nullptr;
+    return g_procTable[srcIndex][dstIndex];
 }
 
 static AVPixelFormat PixelFormatToAVPixelFormat(const PixelFormat &pixelFormat)
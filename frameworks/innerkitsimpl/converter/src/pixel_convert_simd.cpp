@@ -0,0 +1,735 @@
+/*
+ * Copyright (C) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "pixel_convert_simd.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__)) && !defined(_WIN32)
+#define PIXEL_CONVERT_SIMD_X86
+#include <immintrin.h>
+#define TARGET_SSE41 __attribute__((target("sse4.1")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#define TARGET_F16C __attribute__((target("sse4.1,f16c")))
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define PIXEL_CONVERT_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+namespace OHOS {
+namespace Media {
+namespace {
+constexpr uint32_t CHANNEL_COUNT = 4;
+constexpr uint32_t PIXEL_8888_BYTES = 4;
+constexpr uint32_t PIXEL_565_BYTES = 2;
+constexpr uint32_t PIXEL_F16_BYTES = 8;
+constexpr uint32_t VECTOR_HALVES = 2;
+constexpr float ALPHA_OPAQUE_FLOAT = 255.0F;
+constexpr float F16_TO_U8_LIMIT = 256.0F;
+
+// How the alpha channel is treated while swizzling, derived from AlphaConvertType.
+enum class AlphaOp : uint32_t {
+    KEEP = 0,
+    OPAQUE,
+    PREMUL,
+    UNPREMUL,
+    UNPREMUL_OPAQUE,
+};
+
+AlphaOp GetAlphaOp(AlphaConvertType alphaConvertType)
+{
+    switch (alphaConvertType) {
+        case AlphaConvertType::UNPREMUL_CONVERT_OPAQUE:
+            return AlphaOp::OPAQUE;
+        case AlphaConvertType::UNPREMUL_CONVERT_PREMUL:
+            return AlphaOp::PREMUL;
+        case AlphaConvertType::PREMUL_CONVERT_UNPREMUL:
+            return AlphaOp::UNPREMUL;
+        case AlphaConvertType::PREMUL_CONVERT_OPAQUE:
+            return AlphaOp::UNPREMUL_OPAQUE;
+        default:
+            return AlphaOp::KEEP;
+    }
+}
+
+// gather[dstPos] is the source position feeding that destination element, CHANNEL_NONE means opaque alpha.
+void MakeGather(const ChannelLayout &srcLayout, const ChannelLayout &dstLayout, uint8_t gather[CHANNEL_COUNT])
+{
+    for (uint32_t i = 0; i < CHANNEL_COUNT; i++) {
+        gather[i] = CHANNEL_NONE;
+    }
+    gather[dstLayout.r] = srcLayout.r;
+    gather[dstLayout.g] = srcLayout.g;
+    gather[dstLayout.b] = srcLayout.b;
+    if (dstLayout.a != CHANNEL_NONE) {
+        gather[dstLayout.a] = srcLayout.a;
+    }
+}
+
+#ifdef PIXEL_CONVERT_SIMD_X86
+constexpr uint32_t SSE_BYTES = 16;
+constexpr uint32_t SSE_PIXELS = 4;
+constexpr uint32_t AVX_PIXELS = 8;
+constexpr uint32_t F16_STEP_PIXELS = 2;
+constexpr uint8_t SHUFFLE_ZERO = 0x80;
+constexpr uint32_t ROUND_HALF = 0x80;
+constexpr int F16_ROUND_NEAREST = 0;
+constexpr int ALL_LANES_MASK = 0xF;
+
+struct CpuFeatures {
+    bool sse41 = false;
+    bool avx2 = false;
+    bool f16c = false;
+};
+
+const CpuFeatures &GetCpuFeatures()
+{
+    static const CpuFeatures features = [] {
+        CpuFeatures detected;
+        __builtin_cpu_init();
+        detected.sse41 = __builtin_cpu_supports("sse4.1");
+        detected.avx2 = detected.sse41 && __builtin_cpu_supports("avx2");
+        detected.f16c = detected.sse41 && __builtin_cpu_supports("f16c");
+        return detected;
+    }();
+    return features;
+}
+
+// Number of pixels that must remain so a 16 byte load starting at the current pixel stays inside the row.
+inline uint32_t SafeLoadPixels(uint32_t pixelBytes)
+{
+    return (SSE_BYTES + pixelBytes - 1) / pixelBytes;
+}
+
+// Builds a pshufb mask moving four source pixels into destination order, plus the opaque bytes to OR in.
+void BuildShuffleMask(const uint8_t gather[CHANNEL_COUNT], uint32_t srcBytes, uint8_t fillPos,
+    uint8_t mask[SSE_BYTES], uint8_t fill[SSE_BYTES])
+{
+    for (uint32_t k = 0; k < SSE_PIXELS; k++) {
+        for (uint32_t p = 0; p < CHANNEL_COUNT; p++) {
+            uint32_t idx = k * CHANNEL_COUNT + p;
+            bool filled = gather[p] == CHANNEL_NONE || p == fillPos;
+            mask[idx] = filled ? SHUFFLE_ZERO : static_cast<uint8_t>(k * srcBytes + gather[p]);
+            fill[idx] = filled ? ALPHA_OPAQUE : 0;
+        }
+    }
+}
+
+// Moves channel `from` of pixel k into the low byte of 32 bit lane `lane`.
+void BuildLaneMask(uint32_t k, uint32_t pixelBytes, const uint8_t from[CHANNEL_COUNT], uint8_t mask[SSE_BYTES])
+{
+    for (uint32_t lane = 0; lane < CHANNEL_COUNT; lane++) {
+        for (uint32_t byte = 0; byte < CHANNEL_COUNT; byte++) {
+            bool valid = byte == 0 && from[lane] != CHANNEL_NONE;
+            mask[lane * CHANNEL_COUNT + byte] =
+                valid ? static_cast<uint8_t>(k * pixelBytes + from[lane]) : SHUFFLE_ZERO;
+        }
+    }
+}
+
+struct UnpremulMasks {
+    __m128i channel[SSE_PIXELS];
+    __m128i alpha[SSE_PIXELS];
+    __m128i alphaLane;
+};
+
+TARGET_SSE41 void BuildUnpremulMasks(uint8_t alphaPos, UnpremulMasks &masks)
+{
+    uint8_t identity[CHANNEL_COUNT] = {0, 1, 2, 3};
+    uint8_t broadcast[CHANNEL_COUNT] = {alphaPos, alphaPos, alphaPos, alphaPos};
+    alignas(SSE_BYTES) uint8_t bytes[SSE_BYTES];
+    for (uint32_t k = 0; k < SSE_PIXELS; k++) {
+        BuildLaneMask(k, PIXEL_8888_BYTES, identity, bytes);
+        masks.channel[k] = _mm_load_si128(reinterpret_cast<const __m128i *>(bytes));
+        BuildLaneMask(k, PIXEL_8888_BYTES, broadcast, bytes);
+        masks.alpha[k] = _mm_load_si128(reinterpret_cast<const __m128i *>(bytes));
+    }
+    alignas(SSE_BYTES) int32_t lanes[CHANNEL_COUNT] = {0, 0, 0, 0};
+    lanes[alphaPos] = -1;
+    masks.alphaLane = _mm_load_si128(reinterpret_cast<const __m128i *>(lanes));
+}
+
+// Same rounding as Premul255: (p + (p >> 8)) >> 8 with p = c * a + 128, alpha bytes are kept.
+TARGET_SSE41 inline __m128i PremulSse41(__m128i px, __m128i alphaBroadcast, __m128i alphaBytes)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i round = _mm_set1_epi16(ROUND_HALF);
+    __m128i alpha = _mm_shuffle_epi8(px, alphaBroadcast);
+    __m128i lo = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(px, zero), _mm_unpacklo_epi8(alpha, zero)), round);
+    __m128i hi = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(px, zero), _mm_unpackhi_epi8(alpha, zero)), round);
+    lo = _mm_srli_epi16(_mm_add_epi16(lo, _mm_srli_epi16(lo, SHIFT_8_BIT)), SHIFT_8_BIT);
+    hi = _mm_srli_epi16(_mm_add_epi16(hi, _mm_srli_epi16(hi, SHIFT_8_BIT)), SHIFT_8_BIT);
+    return _mm_blendv_epi8(_mm_packus_epi16(lo, hi), px, alphaBytes);
+}
+
+// Same arithmetic as Unpremul255, one pixel with its channels in 32 bit lanes.
+TARGET_SSE41 inline __m128i UnpremulPixelSse41(__m128i c, __m128i a, __m128i alphaLane, bool opaque)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i max = _mm_set1_epi32(ALPHA_OPAQUE);
+    __m128 q = _mm_div_ps(_mm_mul_ps(_mm_cvtepi32_ps(c), _mm_set1_ps(ALPHA_OPAQUE_FLOAT)), _mm_cvtepi32_ps(a));
+    __m128i r = _mm_cvttps_epi32(_mm_add_ps(q, _mm_set1_ps(HALF_ONE)));
+    r = _mm_min_epi32(r, max);
+    r = _mm_blendv_epi8(r, zero, _mm_cmpeq_epi32(a, zero));
+    r = _mm_blendv_epi8(r, c, _mm_cmpeq_epi32(a, max));
+    return _mm_blendv_epi8(r, opaque ? max : a, alphaLane);
+}
+
+TARGET_SSE41 inline __m128i UnpremulSse41(__m128i px, const UnpremulMasks &masks, bool opaque)
+{
+    __m128i r0 = UnpremulPixelSse41(_mm_shuffle_epi8(px, masks.channel[0]), _mm_shuffle_epi8(px, masks.alpha[0]),
+        masks.alphaLane, opaque);
+    __m128i r1 = UnpremulPixelSse41(_mm_shuffle_epi8(px, masks.channel[1]), _mm_shuffle_epi8(px, masks.alpha[1]),
+        masks.alphaLane, opaque);
+    __m128i r2 = UnpremulPixelSse41(_mm_shuffle_epi8(px, masks.channel[2]), _mm_shuffle_epi8(px, masks.alpha[2]),
+        masks.alphaLane, opaque);
+    __m128i r3 = UnpremulPixelSse41(_mm_shuffle_epi8(px, masks.channel[3]), _mm_shuffle_epi8(px, masks.alpha[3]),
+        masks.alphaLane, opaque);
+    return _mm_packus_epi16(_mm_packus_epi32(r0, r1), _mm_packus_epi32(r2, r3));
+}
+
+TARGET_AVX2 uint32_t ShuffleRowAvx2(uint8_t *dst, const uint8_t *src, uint32_t width,
+    const uint8_t mask[SSE_BYTES], const uint8_t fill[SSE_BYTES])
+{
+    const __m256i shuffle = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(mask)));
+    const __m256i opaque = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(fill)));
+    uint32_t i = 0;
+    for (; i + AVX_PIXELS <= width; i += AVX_PIXELS) {
+        __m256i px = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i * PIXEL_8888_BYTES));
+        px = _mm256_or_si256(_mm256_shuffle_epi8(px, shuffle), opaque);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i * PIXEL_8888_BYTES), px);
+    }
+    return i;
+}
+
+TARGET_SSE41 uint32_t ShuffleRowSse41(uint8_t *dst, const uint8_t *src, uint32_t width, uint32_t start,
+    uint32_t srcBytes, const uint8_t mask[SSE_BYTES], const uint8_t fill[SSE_BYTES], uint8_t alphaPos, AlphaOp op)
+{
+    const __m128i shuffle = _mm_loadu_si128(reinterpret_cast<const __m128i *>(mask));
+    const __m128i opaque = _mm_loadu_si128(reinterpret_cast<const __m128i *>(fill));
+    __m128i alphaBroadcast = _mm_setzero_si128();
+    __m128i alphaBytes = _mm_setzero_si128();
+    UnpremulMasks unpremulMasks = {};
+    if (op == AlphaOp::PREMUL) {
+        alignas(SSE_BYTES) uint8_t broadcast[SSE_BYTES];
+        alignas(SSE_BYTES) uint8_t keep[SSE_BYTES];
+        for (uint32_t idx = 0; idx < SSE_BYTES; idx++) {
+            broadcast[idx] = static_cast<uint8_t>((idx / CHANNEL_COUNT) * CHANNEL_COUNT + alphaPos);
+            keep[idx] = (idx % CHANNEL_COUNT == alphaPos) ? ALPHA_OPAQUE : 0;
+        }
+        alphaBroadcast = _mm_load_si128(reinterpret_cast<const __m128i *>(broadcast));
+        alphaBytes = _mm_load_si128(reinterpret_cast<const __m128i *>(keep));
+    } else if (op == AlphaOp::UNPREMUL || op == AlphaOp::UNPREMUL_OPAQUE) {
+        BuildUnpremulMasks(alphaPos, unpremulMasks);
+    }
+    const uint32_t loadPixels = SafeLoadPixels(srcBytes);
+    uint32_t i = start;
+    for (; i + loadPixels <= width; i += SSE_PIXELS) {
+        __m128i px = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i * srcBytes));
+        px = _mm_or_si128(_mm_shuffle_epi8(px, shuffle), opaque);
+        if (op == AlphaOp::PREMUL) {
+            px = PremulSse41(px, alphaBroadcast, alphaBytes);
+        } else if (op == AlphaOp::UNPREMUL || op == AlphaOp::UNPREMUL_OPAQUE) {
+            px = UnpremulSse41(px, unpremulMasks, op == AlphaOp::UNPREMUL_OPAQUE);
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i * PIXEL_8888_BYTES), px);
+    }
+    return i;
+}
+
+uint32_t ShuffleRow(uint8_t *dst, const uint8_t *src, uint32_t width, uint32_t srcBytes,
+    const uint8_t gather[CHANNEL_COUNT], uint8_t alphaPos, AlphaOp op)
+{
+    const CpuFeatures &features = GetCpuFeatures();
+    if (!features.sse41) {
+        return 0;
+    }
+    alignas(SSE_BYTES) uint8_t mask[SSE_BYTES];
+    alignas(SSE_BYTES) uint8_t fill[SSE_BYTES];
+    BuildShuffleMask(gather, srcBytes, op == AlphaOp::OPAQUE ? alphaPos : CHANNEL_NONE, mask, fill);
+    uint32_t start = 0;
+    if (features.avx2 && srcBytes == PIXEL_8888_BYTES && (op == AlphaOp::KEEP || op == AlphaOp::OPAQUE)) {
+        start = ShuffleRowAvx2(dst, src, width, mask, fill);
+    }
+    return ShuffleRowSse41(dst, src, width, start, srcBytes, mask, fill, alphaPos, op);
+}
+
+TARGET_SSE41 inline __m128i Pack565Sse41(__m128i px, __m128i rMask, __m128i gMask, __m128i bMask)
+{
+    __m128i r = _mm_srli_epi32(_mm_shuffle_epi8(px, rMask), SHIFT_3_BIT);
+    __m128i g = _mm_srli_epi32(_mm_shuffle_epi8(px, gMask), SHIFT_2_BIT);
+    __m128i b = _mm_srli_epi32(_mm_shuffle_epi8(px, bMask), SHIFT_3_BIT);
+    return _mm_or_si128(_mm_or_si128(_mm_slli_epi32(b, SHIFT_11_BIT), _mm_slli_epi32(g, SHIFT_5_BIT)), r);
+}
+
+TARGET_SSE41 uint32_t PackRGB565Row(uint8_t *dst, const uint8_t *src, uint32_t width,
+    const ChannelLayout &srcLayout, uint32_t srcBytes)
+{
+    if (!GetCpuFeatures().sse41) {
+        return 0;
+    }
+    alignas(SSE_BYTES) uint8_t bytes[SSE_BYTES];
+    __m128i channelMasks[CHANNEL_COUNT - 1];
+    const uint8_t positions[CHANNEL_COUNT - 1] = {srcLayout.r, srcLayout.g, srcLayout.b};
+    for (uint32_t c = 0; c < CHANNEL_COUNT - 1; c++) {
+        for (uint32_t k = 0; k < SSE_PIXELS; k++) {
+            for (uint32_t byte = 0; byte < CHANNEL_COUNT; byte++) {
+                bytes[k * CHANNEL_COUNT + byte] =
+                    byte == 0 ? static_cast<uint8_t>(k * srcBytes + positions[c]) : SHUFFLE_ZERO;
+            }
+        }
+        channelMasks[c] = _mm_load_si128(reinterpret_cast<const __m128i *>(bytes));
+    }
+    const uint32_t loadPixels = SSE_PIXELS + SafeLoadPixels(srcBytes);
+    uint32_t i = 0;
+    for (; i + loadPixels <= width; i += SSE_PIXELS + SSE_PIXELS) {
+        __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i * srcBytes));
+        __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + (i + SSE_PIXELS) * srcBytes));
+        lo = Pack565Sse41(lo, channelMasks[0], channelMasks[1], channelMasks[2]);
+        hi = Pack565Sse41(hi, channelMasks[0], channelMasks[1], channelMasks[2]);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i * PIXEL_565_BYTES), _mm_packus_epi32(lo, hi));
+    }
+    return i;
+}
+
+// Mirrors RGB565Convert: the 5/6 bit fields are stored unscaled, alpha is opaque.
+TARGET_SSE41 uint32_t UnpackRGB565Row(uint8_t *dst, const uint8_t *src, uint32_t width,
+    const ChannelLayout &dstLayout)
+{
+    if (!GetCpuFeatures().sse41) {
+        return 0;
+    }
+    const __m128i mask5 = _mm_set1_epi16(SHIFT_5_MASK);
+    const __m128i mask3 = _mm_set1_epi16(SHIFT_3_MASK);
+    const __m128i shiftR = _mm_cvtsi32_si128(dstLayout.r * SHIFT_8_BIT);
+    const __m128i shiftG = _mm_cvtsi32_si128(dstLayout.g * SHIFT_8_BIT);
+    const __m128i shiftB = _mm_cvtsi32_si128(dstLayout.b * SHIFT_8_BIT);
+    const uint32_t alphaBits = static_cast<uint32_t>(ALPHA_OPAQUE) << (dstLayout.a * SHIFT_8_BIT);
+    const __m128i alpha = _mm_set1_epi32(static_cast<int32_t>(alphaBits));
+    uint32_t i = 0;
+    for (; i + SSE_PIXELS + SSE_PIXELS <= width; i += SSE_PIXELS + SSE_PIXELS) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i * PIXEL_565_BYTES));
+        __m128i r = _mm_and_si128(_mm_srli_epi16(v, SHIFT_3_BIT), mask5);
+        __m128i g = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(v, mask3), SHIFT_3_BIT),
+            _mm_and_si128(_mm_srli_epi16(v, SHIFT_8_BIT + SHIFT_5_BIT), mask3));
+        __m128i b = _mm_and_si128(_mm_srli_epi16(v, SHIFT_8_BIT), mask5);
+        for (uint32_t half = 0; half < VECTOR_HALVES; half++) {
+            __m128i px = _mm_or_si128(_mm_sll_epi32(_mm_cvtepu16_epi32(r), shiftR),
+                _mm_sll_epi32(_mm_cvtepu16_epi32(g), shiftG));
+            px = _mm_or_si128(_mm_or_si128(px, _mm_sll_epi32(_mm_cvtepu16_epi32(b), shiftB)), alpha);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + (i + half * SSE_PIXELS) * PIXEL_8888_BYTES), px);
+            r = _mm_srli_si128(r, SSE_BYTES / VECTOR_HALVES);
+            g = _mm_srli_si128(g, SSE_BYTES / VECTOR_HALVES);
+            b = _mm_srli_si128(b, SSE_BYTES / VECTOR_HALVES);
+        }
+    }
+    return i;
+}
+
+TARGET_F16C uint32_t U8ToF16Row(uint8_t *dst, const uint8_t *src, uint32_t width, uint32_t srcBytes,
+    const uint8_t gather[CHANNEL_COUNT], uint8_t alphaPos, bool opaque)
+{
+    const CpuFeatures &features = GetCpuFeatures();
+    if (!features.f16c) {
+        return 0;
+    }
+    uint8_t from[CHANNEL_COUNT];
+    alignas(SSE_BYTES) int32_t fillLanes[CHANNEL_COUNT];
+    for (uint32_t p = 0; p < CHANNEL_COUNT; p++) {
+        bool filled = gather[p] == CHANNEL_NONE || (opaque && p == alphaPos);
+        from[p] = filled ? CHANNEL_NONE : gather[p];
+        fillLanes[p] = filled ? ALPHA_OPAQUE : 0;
+    }
+    const __m128i fill = _mm_load_si128(reinterpret_cast<const __m128i *>(fillLanes));
+    __m128i masks[SSE_PIXELS];
+    alignas(SSE_BYTES) uint8_t bytes[SSE_BYTES];
+    for (uint32_t k = 0; k < SSE_PIXELS; k++) {
+        BuildLaneMask(k, srcBytes, from, bytes);
+        masks[k] = _mm_load_si128(reinterpret_cast<const __m128i *>(bytes));
+    }
+    const uint32_t loadPixels = SafeLoadPixels(srcBytes);
+    uint32_t i = 0;
+    for (; i + loadPixels <= width; i += SSE_PIXELS) {
+        __m128i px = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i * srcBytes));
+        __m128i h[SSE_PIXELS];
+        for (uint32_t k = 0; k < SSE_PIXELS; k++) {
+            __m128 f = _mm_cvtepi32_ps(_mm_or_si128(_mm_shuffle_epi8(px, masks[k]), fill));
+            h[k] = _mm_cvtps_ph(f, F16_ROUND_NEAREST);
+        }
+        uint8_t *out = dst + i * PIXEL_F16_BYTES;
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out), _mm_unpacklo_epi64(h[0], h[1]));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + SSE_BYTES), _mm_unpacklo_epi64(h[2], h[3]));
+    }
+    return i;
+}
+
+// Stops at the first pixel whose halves fall outside [0, 256); the scalar path keeps its own handling there.
+TARGET_F16C uint32_t F16ToU8Row(uint8_t *dst, const uint8_t *src, uint32_t width,
+    const uint8_t gather[CHANNEL_COUNT], uint8_t alphaPos, bool opaque)
+{
+    if (!GetCpuFeatures().f16c) {
+        return 0;
+    }
+    alignas(SSE_BYTES) uint8_t mask[SSE_BYTES];
+    alignas(SSE_BYTES) uint8_t fill[SSE_BYTES];
+    BuildShuffleMask(gather, PIXEL_8888_BYTES, opaque ? alphaPos : CHANNEL_NONE, mask, fill);
+    const __m128i shuffle = _mm_load_si128(reinterpret_cast<const __m128i *>(mask));
+    const __m128i opaqueBytes = _mm_load_si128(reinterpret_cast<const __m128i *>(fill));
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 limit = _mm_set1_ps(F16_TO_U8_LIMIT);
+    uint32_t i = 0;
+    for (; i + F16_STEP_PIXELS <= width; i += F16_STEP_PIXELS) {
+        __m128i halves = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i * PIXEL_F16_BYTES));
+        __m128 f0 = _mm_cvtph_ps(halves);
+        __m128 f1 = _mm_cvtph_ps(_mm_srli_si128(halves, PIXEL_F16_BYTES));
+        __m128 inRange = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(f0, zero), _mm_cmplt_ps(f0, limit)),
+            _mm_and_ps(_mm_cmpge_ps(f1, zero), _mm_cmplt_ps(f1, limit)));
+        if (_mm_movemask_ps(inRange) != ALL_LANES_MASK) {
+            break;
+        }
+        __m128i packed = _mm_packus_epi32(_mm_cvttps_epi32(f0), _mm_cvttps_epi32(f1));
+        packed = _mm_packus_epi16(packed, _mm_setzero_si128());
+        packed = _mm_or_si128(_mm_shuffle_epi8(packed, shuffle), opaqueBytes);
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(dst + i * PIXEL_8888_BYTES), packed);
+    }
+    return i;
+}
+#endif
+
+#ifdef PIXEL_CONVERT_SIMD_NEON
+constexpr uint32_t NEON_PIXELS = 16;
+constexpr uint32_t NEON_HALF_PIXELS = 8;
+constexpr uint32_t NEON_QUARTER_PIXELS = 4;
+
+// Same rounding as Premul255: vraddhn(t, (t + 128) >> 8) == (p + (p >> 8)) >> 8 with p = t + 128.
+inline uint8x16_t PremulNeon(uint8x16_t c, uint8x16_t a)
+{
+    uint16x8_t lo = vmull_u8(vget_low_u8(c), vget_low_u8(a));
+    uint16x8_t hi = vmull_u8(vget_high_u8(c), vget_high_u8(a));
+    return vcombine_u8(vraddhn_u16(lo, vrshrq_n_u16(lo, SHIFT_8_BIT)),
+        vraddhn_u16(hi, vrshrq_n_u16(hi, SHIFT_8_BIT)));
+}
+
+#ifdef __aarch64__
+// Same arithmetic as Unpremul255 on four lanes.
+inline uint32x4_t UnpremulLaneNeon(uint32x4_t c, uint32x4_t a)
+{
+    const uint32x4_t zero = vdupq_n_u32(0);
+    const uint32x4_t max = vdupq_n_u32(ALPHA_OPAQUE);
+    float32x4_t q = vdivq_f32(vmulq_n_f32(vcvtq_f32_u32(c), ALPHA_OPAQUE_FLOAT), vcvtq_f32_u32(a));
+    uint32x4_t r = vminq_u32(vcvtq_u32_f32(vaddq_f32(q, vdupq_n_f32(HALF_ONE))), max);
+    r = vbslq_u32(vceqq_u32(a, zero), zero, r);
+    return vbslq_u32(vceqq_u32(a, max), c, r);
+}
+
+inline uint16x8_t UnpremulHalfNeon(uint8x8_t c, uint8x8_t a)
+{
+    uint16x8_t c16 = vmovl_u8(c);
+    uint16x8_t a16 = vmovl_u8(a);
+    uint32x4_t lo = UnpremulLaneNeon(vmovl_u16(vget_low_u16(c16)), vmovl_u16(vget_low_u16(a16)));
+    uint32x4_t hi = UnpremulLaneNeon(vmovl_u16(vget_high_u16(c16)), vmovl_u16(vget_high_u16(a16)));
+    return vcombine_u16(vmovn_u32(lo), vmovn_u32(hi));
+}
+
+inline uint8x16_t UnpremulNeon(uint8x16_t c, uint8x16_t a)
+{
+    return vcombine_u8(vmovn_u16(UnpremulHalfNeon(vget_low_u8(c), vget_low_u8(a))),
+        vmovn_u16(UnpremulHalfNeon(vget_high_u8(c), vget_high_u8(a))));
+}
+
+inline float16x4_t U8ToHalfNeon(uint16x4_t v)
+{
+    return vcvt_f16_f32(vcvtq_f32_u32(vmovl_u16(v)));
+}
+#endif
+
+inline void LoadChannelsNeon(const uint8_t *src, uint32_t srcBytes, uint8x16_t channels[CHANNEL_COUNT])
+{
+    if (srcBytes == PIXEL_8888_BYTES) {
+        uint8x16x4_t in = vld4q_u8(src);
+        for (uint32_t c = 0; c < CHANNEL_COUNT; c++) {
+            channels[c] = in.val[c];
+        }
+    } else {
+        uint8x16x3_t in = vld3q_u8(src);
+        for (uint32_t c = 0; c < CHANNEL_COUNT - 1; c++) {
+            channels[c] = in.val[c];
+        }
+        channels[CHANNEL_COUNT - 1] = vdupq_n_u8(ALPHA_OPAQUE);
+    }
+}
+
+uint32_t ShuffleRow(uint8_t *dst, const uint8_t *src, uint32_t width, uint32_t srcBytes,
+    const uint8_t gather[CHANNEL_COUNT], uint8_t alphaPos, AlphaOp op)
+{
+#ifndef __aarch64__
+    if (op == AlphaOp::UNPREMUL || op == AlphaOp::UNPREMUL_OPAQUE) {
+        return 0;
+    }
+#endif
+    const uint8x16_t opaque = vdupq_n_u8(ALPHA_OPAQUE);
+    uint32_t i = 0;
+    for (; i + NEON_PIXELS <= width; i += NEON_PIXELS) {
+        uint8x16_t channels[CHANNEL_COUNT];
+        LoadChannelsNeon(src + i * srcBytes, srcBytes, channels);
+        uint8x16x4_t out;
+        for (uint32_t p = 0; p < CHANNEL_COUNT; p++) {
+            out.val[p] = gather[p] == CHANNEL_NONE ? opaque : channels[gather[p]];
+        }
+        if (op == AlphaOp::OPAQUE) {
+            out.val[alphaPos] = opaque;
+        } else if (op != AlphaOp::KEEP) {
+            for (uint32_t p = 0; p < CHANNEL_COUNT; p++) {
+                if (p == alphaPos) {
+                    continue;
+                }
+#ifdef __aarch64__
+                out.val[p] = op == AlphaOp::PREMUL ? PremulNeon(out.val[p], out.val[alphaPos]) :
+                    UnpremulNeon(out.val[p], out.val[alphaPos]);
+#else
+                out.val[p] = PremulNeon(out.val[p], out.val[alphaPos]);
+#endif
+            }
+            if (op == AlphaOp::UNPREMUL_OPAQUE) {
+                out.val[alphaPos] = opaque;
+            }
+        }
+        vst4q_u8(dst + i * PIXEL_8888_BYTES, out);
+    }
+    return i;
+}
+
+uint32_t PackRGB565Row(uint8_t *dst, const uint8_t *src, uint32_t width,
+    const ChannelLayout &srcLayout, uint32_t srcBytes)
+{
+    uint16_t *out = reinterpret_cast<uint16_t *>(dst);
+    uint32_t i = 0;
+    for (; i + NEON_PIXELS <= width; i += NEON_PIXELS) {
+        uint8x16_t channels[CHANNEL_COUNT];
+        LoadChannelsNeon(src + i * srcBytes, srcBytes, channels);
+        uint8x16_t r = vshrq_n_u8(channels[srcLayout.r], SHIFT_3_BIT);
+        uint8x16_t g = vshrq_n_u8(channels[srcLayout.g], SHIFT_2_BIT);
+        uint8x16_t b = vshrq_n_u8(channels[srcLayout.b], SHIFT_3_BIT);
+        uint16x8_t lo = vorrq_u16(vorrq_u16(vshlq_n_u16(vmovl_u8(vget_low_u8(b)), SHIFT_11_BIT),
+            vshlq_n_u16(vmovl_u8(vget_low_u8(g)), SHIFT_5_BIT)), vmovl_u8(vget_low_u8(r)));
+        uint16x8_t hi = vorrq_u16(vorrq_u16(vshlq_n_u16(vmovl_u8(vget_high_u8(b)), SHIFT_11_BIT),
+            vshlq_n_u16(vmovl_u8(vget_high_u8(g)), SHIFT_5_BIT)), vmovl_u8(vget_high_u8(r)));
+        vst1q_u8(reinterpret_cast<uint8_t *>(out + i), vreinterpretq_u8_u16(lo));
+        vst1q_u8(reinterpret_cast<uint8_t *>(out + i + NEON_HALF_PIXELS), vreinterpretq_u8_u16(hi));
+    }
+    return i;
+}
+
+// Mirrors RGB565Convert: the 5/6 bit fields are stored unscaled, alpha is opaque.
+uint32_t UnpackRGB565Row(uint8_t *dst, const uint8_t *src, uint32_t width, const ChannelLayout &dstLayout)
+{
+    const uint16x8_t mask5 = vdupq_n_u16(SHIFT_5_MASK);
+    const uint16x8_t mask3 = vdupq_n_u16(SHIFT_3_MASK);
+    uint32_t i = 0;
+    for (; i + NEON_PIXELS <= width; i += NEON_PIXELS) {
+        uint16x8_t v[VECTOR_HALVES];
+        uint8x8_t r[VECTOR_HALVES];
+        uint8x8_t g[VECTOR_HALVES];
+        uint8x8_t b[VECTOR_HALVES];
+        for (uint32_t h = 0; h < VECTOR_HALVES; h++) {
+            v[h] = vreinterpretq_u16_u8(vld1q_u8(src + (i + h * NEON_HALF_PIXELS) * PIXEL_565_BYTES));
+            r[h] = vmovn_u16(vandq_u16(vshrq_n_u16(v[h], SHIFT_3_BIT), mask5));
+            g[h] = vmovn_u16(vorrq_u16(vshlq_n_u16(vandq_u16(v[h], mask3), SHIFT_3_BIT),
+                vshrq_n_u16(v[h], SHIFT_8_BIT + SHIFT_5_BIT)));
+            b[h] = vmovn_u16(vandq_u16(vshrq_n_u16(v[h], SHIFT_8_BIT), mask5));
+        }
+        uint8x16x4_t out;
+        out.val[dstLayout.r] = vcombine_u8(r[0], r[1]);
+        out.val[dstLayout.g] = vcombine_u8(g[0], g[1]);
+        out.val[dstLayout.b] = vcombine_u8(b[0], b[1]);
+        out.val[dstLayout.a] = vdupq_n_u8(ALPHA_OPAQUE);
+        vst4q_u8(dst + i * PIXEL_8888_BYTES, out);
+    }
+    return i;
+}
+
+uint32_t U8ToF16Row(uint8_t *dst, const uint8_t *src, uint32_t width, uint32_t srcBytes,
+    const uint8_t gather[CHANNEL_COUNT], uint8_t alphaPos, bool opaque)
+{
+#ifdef __aarch64__
+    uint16_t *out = reinterpret_cast<uint16_t *>(dst);
+    uint32_t i = 0;
+    for (; i + NEON_PIXELS <= width; i += NEON_PIXELS) {
+        uint8x16_t channels[CHANNEL_COUNT];
+        LoadChannelsNeon(src + i * srcBytes, srcBytes, channels);
+        uint16x8_t wide[CHANNEL_COUNT][VECTOR_HALVES];
+        for (uint32_t p = 0; p < CHANNEL_COUNT; p++) {
+            bool filled = gather[p] == CHANNEL_NONE || (opaque && p == alphaPos);
+            uint8x16_t c = filled ? vdupq_n_u8(ALPHA_OPAQUE) : channels[gather[p]];
+            wide[p][0] = vmovl_u8(vget_low_u8(c));
+            wide[p][1] = vmovl_u8(vget_high_u8(c));
+        }
+        for (uint32_t q = 0; q < CHANNEL_COUNT; q++) {
+            uint16x4x4_t halves;
+            for (uint32_t p = 0; p < CHANNEL_COUNT; p++) {
+                uint16x8_t w = wide[p][q / VECTOR_HALVES];
+                uint16x4_t part = (q % VECTOR_HALVES == 0) ? vget_low_u16(w) : vget_high_u16(w);
+                halves.val[p] = vreinterpret_u16_f16(U8ToHalfNeon(part));
+            }
+            vst4_u16(out + (i + q * NEON_QUARTER_PIXELS) * CHANNEL_COUNT, halves);
+        }
+    }
+    return i;
+#else
+    return 0;
+#endif
+}
+
+// Stops at the first block whose halves fall outside [0, 256); the scalar path keeps its own handling there.
+uint32_t F16ToU8Row(uint8_t *dst, const uint8_t *src, uint32_t width,
+    const uint8_t gather[CHANNEL_COUNT], uint8_t alphaPos, bool opaque)
+{
+#ifdef __aarch64__
+    const uint16_t *in = reinterpret_cast<const uint16_t *>(src);
+    const float32x4_t zero = vdupq_n_f32(0.0F);
+    const float32x4_t limit = vdupq_n_f32(F16_TO_U8_LIMIT);
+    uint32_t i = 0;
+    for (; i + NEON_HALF_PIXELS <= width; i += NEON_HALF_PIXELS) {
+        uint16x4x4_t lo = vld4_u16(in + i * CHANNEL_COUNT);
+        uint16x4x4_t hi = vld4_u16(in + (i + NEON_QUARTER_PIXELS) * CHANNEL_COUNT);
+        uint8x8_t channels[CHANNEL_COUNT];
+        uint32x4_t inRange = vdupq_n_u32(UINT32_MAX);
+        for (uint32_t c = 0; c < CHANNEL_COUNT; c++) {
+            float32x4_t fl = vcvt_f32_f16(vreinterpret_f16_u16(lo.val[c]));
+            float32x4_t fh = vcvt_f32_f16(vreinterpret_f16_u16(hi.val[c]));
+            inRange = vandq_u32(inRange, vandq_u32(vcgeq_f32(fl, zero), vcltq_f32(fl, limit)));
+            inRange = vandq_u32(inRange, vandq_u32(vcgeq_f32(fh, zero), vcltq_f32(fh, limit)));
+            channels[c] = vmovn_u16(vcombine_u16(vmovn_u32(vcvtq_u32_f32(fl)), vmovn_u32(vcvtq_u32_f32(fh))));
+        }
+        if (vminvq_u32(inRange) == 0) {
+            break;
+        }
+        uint8x8x4_t out;
+        for (uint32_t p = 0; p < CHANNEL_COUNT; p++) {
+            bool filled = gather[p] == CHANNEL_NONE || (opaque && p == alphaPos);
+            out.val[p] = filled ? vdup_n_u8(ALPHA_OPAQUE) : channels[gather[p]];
+        }
+        vst4_u8(dst + i * PIXEL_8888_BYTES, out);
+    }
+    return i;
+#else
+    return 0;
+#endif
+}
+#endif
+} // namespace
+
+bool PixelConvertSimd::IsSupported()
+{
+#if defined(PIXEL_CONVERT_SIMD_X86)
+    return GetCpuFeatures().sse41;
+#elif defined(PIXEL_CONVERT_SIMD_NEON)
+    return true;
+#else
+    return false;
+#endif
+}
+
+uint32_t PixelConvertSimd::Swizzle8888(void *destinationRow, const uint8_t *sourceRow, uint32_t sourceWidth,
+    const ChannelLayout &srcLayout, const ChannelLayout &dstLayout, AlphaConvertType alphaConvertType)
+{
+#if defined(PIXEL_CONVERT_SIMD_X86) || defined(PIXEL_CONVERT_SIMD_NEON)
+    if (dstLayout.a == CHANNEL_NONE) {
+        return 0;
+    }
+    uint8_t gather[CHANNEL_COUNT];
+    MakeGather(srcLayout, dstLayout, gather);
+    return ShuffleRow(static_cast<uint8_t *>(destinationRow), sourceRow, sourceWidth, PIXEL_8888_BYTES, gather,
+        dstLayout.a, GetAlphaOp(alphaConvertType));
+#else
+    return 0;
+#endif
+}
+
+uint32_t PixelConvertSimd::Expand888(void *destinationRow, const uint8_t *sourceRow, uint32_t sourceWidth,
+    const ChannelLayout &srcLayout, const ChannelLayout &dstLayout)
+{
+#if defined(PIXEL_CONVERT_SIMD_X86) || defined(PIXEL_CONVERT_SIMD_NEON)
+    uint8_t gather[CHANNEL_COUNT];
+    MakeGather(srcLayout, dstLayout, gather);
+    return ShuffleRow(static_cast<uint8_t *>(destinationRow), sourceRow, sourceWidth, SIZE_3_BYTE, gather,
+        dstLayout.a, AlphaOp::KEEP);
+#else
+    return 0;
+#endif
+}
+
+uint32_t PixelConvertSimd::PackRGB565(void *destinationRow, const uint8_t *sourceRow, uint32_t sourceWidth,
+    const ChannelLayout &srcLayout, uint32_t srcBytes, AlphaConvertType alphaConvertType)
+{
+#if defined(PIXEL_CONVERT_SIMD_X86) || defined(PIXEL_CONVERT_SIMD_NEON)
+    // Only the alpha conversions that leave the color channels untouched can skip AlphaTypeConvertOnRGB.
+    AlphaOp op = GetAlphaOp(alphaConvertType);
+    if (op != AlphaOp::KEEP && op != AlphaOp::OPAQUE) {
+        return 0;
+    }
+    return PackRGB565Row(static_cast<uint8_t *>(destinationRow), sourceRow, sourceWidth, srcLayout, srcBytes);
+#else
+    return 0;
+#endif
+}
+
+uint32_t PixelConvertSimd::UnpackRGB565(void *destinationRow, const uint8_t *sourceRow, uint32_t sourceWidth,
+    const ChannelLayout &dstLayout)
+{
+#if defined(PIXEL_CONVERT_SIMD_X86) || defined(PIXEL_CONVERT_SIMD_NEON)
+    if (dstLayout.a == CHANNEL_NONE) {
+        return 0;
+    }
+    return UnpackRGB565Row(static_cast<uint8_t *>(destinationRow), sourceRow, sourceWidth, dstLayout);
+#else
+    return 0;
+#endif
+}
+
+uint32_t PixelConvertSimd::U8ToF16(void *destinationRow, const uint8_t *sourceRow, uint32_t sourceWidth,
+    const ChannelLayout &srcLayout, uint32_t srcBytes, const ChannelLayout &dstLayout,
+    AlphaConvertType alphaConvertType)
+{
+#if defined(PIXEL_CONVERT_SIMD_X86) || defined(PIXEL_CONVERT_SIMD_NEON)
+    AlphaOp op = (srcLayout.a == CHANNEL_NONE) ? AlphaOp::KEEP : GetAlphaOp(alphaConvertType);
+    if (op != AlphaOp::KEEP && op != AlphaOp::OPAQUE) {
+        return 0;
+    }
+    uint8_t gather[CHANNEL_COUNT];
+    MakeGather(srcLayout, dstLayout, gather);
+    return U8ToF16Row(static_cast<uint8_t *>(destinationRow), sourceRow, sourceWidth, srcBytes, gather,
+        dstLayout.a, op == AlphaOp::OPAQUE);
+#else
+    return 0;
+#endif
+}
+
+uint32_t PixelConvertSimd::F16ToU8(void *destinationRow, const uint8_t *sourceRow, uint32_t sourceWidth,
+    const ChannelLayout &srcLayout, const ChannelLayout &dstLayout, AlphaConvertType alphaConvertType)
+{
+#if defined(PIXEL_CONVERT_SIMD_X86) || defined(PIXEL_CONVERT_SIMD_NEON)
+    AlphaOp op = GetAlphaOp(alphaConvertType);
+    if ((op != AlphaOp::KEEP && op != AlphaOp::OPAQUE) || dstLayout.a == CHANNEL_NONE) {
+        return 0;
+    }
+    uint8_t gather[CHANNEL_COUNT];
+    MakeGather(srcLayout, dstLayout, gather);
+    return F16ToU8Row(static_cast<uint8_t *>(destinationRow), sourceRow, sourceWidth, gather, dstLayout.a,
+        op == AlphaOp::OPAQUE);
+#else
+    return 0;
+#endif
+}
+} // namespace Media
+} // namespace OHOS
@@ -16,14 +16,14 @@
 #include "post_proc_slr.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cstdint>
 #include <memory>
+#include <mutex>
 #include <unistd.h>
 #include <vector>
-#if !defined(_WIN32) && !defined(_APPLE) && !defined(IOS_PLATFORM) && !defined(ANDROID_PLATFORM)
-#include "ffrt.h"
-#endif
 #include "image_log.h"
+#include "image_task_scheduler.h"
 #include "image_trace.h"
 #include "image_utils.h"
 #include "memory_manager.h"
@@ -34,10 +34,12 @@ using namespace std;
 
 constexpr float PI = 3.14159265;
 constexpr float EPSILON = 1e-6;
-constexpr int FFRT_THREAD_LIMIT = 8;
 constexpr int SLR_MIN_RADIUS = 2;
 constexpr int SLR_WEIGHT_SPAN_FACTOR = 2;
 constexpr size_t SLR_PIXEL_BYTES = sizeof(uint32_t);
+constexpr int SLR_CHANNELS = 4;
+constexpr int SLR_SERIAL_BAND_ROWS = 32;
+constexpr int SLR_AXIS_CACHE_CAPACITY = 64;
 
 bool SLRMat::IsValid() const
 {
@@ -150,110 +152,128 @@ inline uint32_t SLRCast(float v)
     return uv;
 }
 
-struct SLRSliceKey {
-    SLRSliceKey(int v1, int v2) : x(v1), y(v2) {}
-    int x;
-    int y;
+// Clamped source index and weight of every tap, taps entries per destination index
+struct SLRAxis {
+    int taps = 0;
+    std::shared_ptr<const std::vector<int>> index;
+    std::vector<float> weight;
 };
 
-bool SLRBoxCheck(const SLRSliceKey &key, const SLRMat &src, const SLRMat &dst, const SLRWeightMat &x,
-    const SLRWeightMat &y)
+struct SLRAxisKey {
+    int srcLen;
+    int dstLen;
+    int a;
+
+    bool operator==(const SLRAxisKey &other) const
+    {
+        return srcLen == other.srcLen && dstLen == other.dstLen && a == other.a;
+    }
+};
+
+using SLRAxisIndexCache = SkLRUCache<SLRAxisKey, std::shared_ptr<const std::vector<int>>>;
+
+std::shared_ptr<const std::vector<int>> BuildSLRAxisIndex(const SLRAxisKey &key, int taps)
 {
-    if (key.x < 0 || key.y < 0) {
-        IMAGE_LOGE("SLRBoxCheck Key error:%{public}d, %{public}d", key.x, key.y);
-        return false;
+    float tao = static_cast<float>(key.srcLen) / key.dstLen;
+    auto index = std::make_shared<std::vector<int>>(static_cast<size_t>(key.dstLen) * taps);
+    for (int i = 0; i < key.dstLen; i++) {
+        int eta = static_cast<int>((i + 0.5) * tao - 0.5); // 0.5 middle index
+        int start = eta - key.a + 1;
+        for (int t = 0; t < taps; t++) {
+            (*index)[static_cast<size_t>(i) * taps + t] = std::clamp(start + t, 0, key.srcLen - 1);
+        }
     }
-    uint32_t* srcArr = static_cast<uint32_t*>(src.data_);
-    CHECK_ERROR_RETURN_RET_LOG(srcArr == nullptr, false, "SLRBoxCheck srcArr null");
-    uint32_t* dstArr = static_cast<uint32_t*>(dst.data_);
-    CHECK_ERROR_RETURN_RET_LOG(dstArr == nullptr, false, "SLRBoxCheck dstArr null");
+    return index;
+}
 
-    int srcM = src.size_.height;
-    int srcN = src.size_.width;
-    int dstM = dst.size_.height;
-    int dstN = dst.size_.width;
-    float coeffX = static_cast<float>(dstM) / srcM;
-    float coeffY = static_cast<float>(dstN) / srcN;
-    float taoX = 1 / coeffX;
-    float taoY = 1 / coeffY;
-    int aX = std::max(SLR_MIN_RADIUS, static_cast<int>(std::floor(taoX)));
-    int aY = std::max(SLR_MIN_RADIUS, static_cast<int>(std::floor(taoY)));
-    if (key.y >= static_cast<int>((*x).size()) ||
-        static_cast<int>((*x)[key.y].size()) < SLR_WEIGHT_SPAN_FACTOR * aY) {
-        IMAGE_LOGE("SLRBoxCheck h_y error:%{public}zu, %{public}d", (*x).size(), aY);
-        return false;
+// The clamped source indices depend only on the lengths and the radius, so scales to one size share them.
+// The weights are the caller's and are copied into the axis on every call.
+SLRAxis GetSLRAxis(const SLRWeightVec &weights, int srcLen, int dstLen)
+{
+    static std::mutex indexMutex;
+    static SLRAxisIndexCache indexCache(SLR_AXIS_CACHE_CAPACITY);
+    float tao = static_cast<float>(srcLen) / dstLen;
+    SLRAxisKey key { srcLen, dstLen, std::max(SLR_MIN_RADIUS, static_cast<int>(std::floor(tao))) };
+    SLRAxis axis;
+    axis.taps = SLR_WEIGHT_SPAN_FACTOR * key.a;
+    {
+        std::lock_guard<std::mutex> lock(indexMutex);
+        auto cached = indexCache.find(key);
+        if (cached != nullptr) {
+            axis.index = *cached;
+        }
     }
-    if (key.x >= static_cast<int>((*y).size()) ||
-        static_cast<int>((*y)[key.x].size()) < SLR_WEIGHT_SPAN_FACTOR * aX) {
-        IMAGE_LOGE("SLRBoxCheck h_x error:%{public}zu, %{public}d", (*y).size(), aX);
-        return false;
+    if (axis.index == nullptr) {
+        axis.index = BuildSLRAxisIndex(key, axis.taps);
+        std::lock_guard<std::mutex> lock(indexMutex);
+        indexCache.insert(key, axis.index);
     }
-    size_t dstIndex = 0;
-    CHECK_ERROR_RETURN_RET_LOG(!dst.GetIndex(key.x, key.y, dstIndex), false,
-        "SLRBoxCheck dst index error:%{public}d, %{public}d", key.x, key.y);
-    return true;
+    axis.weight.resize(static_cast<size_t>(dstLen) * axis.taps);
+    for (int i = 0; i < dstLen; i++) {
+        std::copy(weights[i].begin(), weights[i].begin() + axis.taps,
+            axis.weight.begin() + static_cast<size_t>(i) * axis.taps);
+    }
+    return axis;
 }
 
-void SLRBox(const SLRSliceKey &key, const SLRMat &src, SLRMat &dst, const SLRWeightMat &x, const SLRWeightMat &y)
+// Horizontal pass over the source rows one band of destination rows needs, then the vertical pass
+void SLRSeparableBand(const SLRMat &src, SLRMat &dst, const SLRAxis &rowAxis, const SLRAxis &colAxis,
+    int rowStart, int rowEnd)
 {
-    CHECK_ERROR_RETURN(!SLRBoxCheck(key, src, dst, x, y));
-    uint32_t* srcArr = static_cast<uint32_t*>(src.data_);
+    const uint32_t* srcArr = static_cast<const uint32_t*>(src.data_);
     uint32_t* dstArr = static_cast<uint32_t*>(dst.data_);
-    int srcM = src.size_.height;
-    int srcN = src.size_.width;
-    int dstM = dst.size_.height;
-    int dstN = dst.size_.width;
-    float coeffX = static_cast<float>(dstM) / srcM;
-    float coeffY = static_cast<float>(dstN) / srcN;
-    float taoX = 1 / coeffX;
-    float taoY = 1 / coeffY;
-    int aX = std::max(SLR_MIN_RADIUS, static_cast<int>(std::floor(taoX)));
-    int aY = std::max(SLR_MIN_RADIUS, static_cast<int>(std::floor(taoY)));
-    int etaI = static_cast<int>((key.x + 0.5) * taoX - 0.5); // 0.5 middle index
-    int etaJ = static_cast<int>((key.y + 0.5) * taoY - 0.5); // 0.5 middle index
-    int rStart = etaI - aX + 1;
-    int rEnd = etaI + aX;
-    int cStart = etaJ - aY + 1;
-    int cEnd = etaJ + aY;
-    float rgba[4]{ .0f, .0f, .0f, .0f };
-    for (int r = rStart; r <= rEnd; ++r) {
-        int nR = min(max(0, r), srcM - 1);
-        for (int c = cStart; c <= cEnd; ++c) {
-            int nC = min(max(0, c), srcN - 1);
-            auto w = (*x)[key.y][c - cStart];
-            w *= (*y)[key.x][r - rStart];
-            size_t srcIndex = 0;
-            if (!src.GetIndex(nR, nC, srcIndex)) {
-                IMAGE_LOGE("SLRBox src index error:%{public}d, %{public}d", nR, nC);
-                return;
+    const int n = dst.size_.width;
+    const size_t rowFloats = static_cast<size_t>(n) * SLR_CHANNELS;
+    const std::vector<int> &rowIndex = *rowAxis.index;
+    int first = rowIndex[static_cast<size_t>(rowStart) * rowAxis.taps];
+    int last = rowIndex[static_cast<size_t>(rowEnd) * rowAxis.taps - 1];
+
+    std::vector<float> horizontal(static_cast<size_t>(last - first + 1) * rowFloats);
+    for (int r = first; r <= last; r++) {
+        const uint32_t* srcRow = srcArr + static_cast<size_t>(r) * src.rowStride_;
+        float* out = horizontal.data() + static_cast<size_t>(r - first) * rowFloats;
+        for (int j = 0; j < n; j++) {
+            const int* index = colAxis.index->data() + static_cast<size_t>(j) * colAxis.taps;
+            const float* weight = colAxis.weight.data() + static_cast<size_t>(j) * colAxis.taps;
+            float rgba[SLR_CHANNELS]{ .0f, .0f, .0f, .0f };
+            for (int t = 0; t < colAxis.taps; t++) {
+                uint32_t color = srcRow[index[t]];
+                rgba[0] += ((color >> 24) & 0xFF) * weight[t]; // 24 rgba r
+                rgba[1] += ((color >> 16) & 0xFF) * weight[t]; // 16 rgba g
+                rgba[2] += ((color >> 8) & 0xFF) * weight[t];  // 2 8 rgba b
+                rgba[3] += (color & 0xFF) * weight[t];         // 3 rgba a
+            }
+            std::copy(rgba, rgba + SLR_CHANNELS, out + static_cast<size_t>(j) * SLR_CHANNELS);
+        }
+    }
+
+    std::vector<float> acc(rowFloats);
+    for (int i = rowStart; i < rowEnd; i++) {
+        std::fill(acc.begin(), acc.end(), .0f);
+        for (int t = 0; t < rowAxis.taps; t++) {
+            size_t tap = static_cast<size_t>(i) * rowAxis.taps + t;
+            const float* in = horizontal.data() + static_cast<size_t>(rowIndex[tap] - first) * rowFloats;
+            float w = rowAxis.weight[tap];
+            for (size_t k = 0; k < rowFloats; k++) {
+                acc[k] += in[k] * w;
             }
-            uint32_t color = *(srcArr + srcIndex);
-            rgba[0] += ((color >> 24) & 0xFF) * w; // 24 rgba r
-            rgba[1] += ((color >> 16) & 0xFF) * w; // 16 rgba g
-            rgba[2] += ((color >> 8) & 0xFF) * w;  // 2 8 rgba b
-            rgba[3] += (color & 0xFF) * w;         // 3 rgba a
+        }
+        uint32_t* dstRow = dstArr + static_cast<size_t>(i) * dst.rowStride_;
+        for (int j = 0; j < n; j++) {
+            const float* rgba = acc.data() + static_cast<size_t>(j) * SLR_CHANNELS;
+            dstRow[j] = (SLRCast(rgba[0]) << 24) | (SLRCast(rgba[1]) << 16) | // 24 16 rgba
+                (SLRCast(rgba[2]) << 8) | SLRCast(rgba[3]); // 2 3 8 rgba
         }
     }
-    uint32_t r = SLRCast(rgba[0]);
-    uint32_t g = SLRCast(rgba[1]);
-    uint32_t b = SLRCast(rgba[2]); // 2 rgba
-    uint32_t a = SLRCast(rgba[3]); // 3 rgba
-    size_t dstIndex = 0;
-    CHECK_ERROR_RETURN(!dst.GetIndex(key.x, key.y, dstIndex));
-    dstArr[dstIndex] = (r << 24) | (g << 16) | (b << 8) | a; // 24 16 8 rgba
 }
 
-bool SLRProc::Laplacian(const SLRMat &src, SLRMat &dst, float alpha)
+bool LaplacianRows(const SLRMat &src, SLRMat &dst, float alpha, int rowStart, int rowEnd)
 {
-    IMAGE_LOGD("Laplacian pixelMap SLR:width=%{public}d,height=%{public}d,alpha=%{public}f", src.size_.width,
-        src.size_.height, alpha);
-    CHECK_ERROR_RETURN_RET_LOG(!src.IsValid() || !dst.IsValid() || src.size_.width != dst.size_.width ||
-        src.size_.height != dst.size_.height, false, "SLRProc::Laplacian invalid buffer layout");
     const int m = src.size_.height;
     const int n = src.size_.width;
     uint32_t* srcArr = static_cast<uint32_t*>(src.data_);
     uint32_t* dstArr = static_cast<uint32_t*>(dst.data_);
-  
+
     auto getPixel = [&](int i, int j) -> uint32_t {
         i = std::clamp(i, 0, m - 1);
         j = std::clamp(j, 0, n - 1);
@@ -265,7 +285,7 @@ bool SLRProc::Laplacian(const SLRMat &src, SLRMat &dst, float alpha)
     };
 
     auto extract = [](uint32_t color, int shift) -> uint32_t { return (color >> shift) & 0xFF; };
-    for (int i = 0; i < m; i++) {
+    for (int i = rowStart; i < rowEnd; i++) {
         for (int j = 0; j < n; j++) {
             const uint32_t pixels[5] = {
                 getPixel(i, j),       // center
@@ -297,75 +317,51 @@ bool SLRProc::Laplacian(const SLRMat &src, SLRMat &dst, float alpha)
     }
     return true;
 }
- 
+
+bool SLRProc::Laplacian(const SLRMat &src, SLRMat &dst, float alpha)
+{
+    IMAGE_LOGD("Laplacian pixelMap SLR:width=%{public}d,height=%{public}d,alpha=%{public}f", src.size_.width,
+        src.size_.height, alpha);
+    CHECK_ERROR_RETURN_RET_LOG(!src.IsValid() || !dst.IsValid() || src.size_.width != dst.size_.width ||
+        src.size_.height != dst.size_.height, false, "SLRProc::Laplacian invalid buffer layout");
+    std::atomic<bool> failed(false);
+    auto task = [&src, &dst, alpha, &failed](int rowStart, int rowEnd) {
+        if (!LaplacianRows(src, dst, alpha, rowStart, rowEnd)) {
+            failed.store(true, std::memory_order_relaxed);
+        }
+    };
+    // 5 pixels are read for every output pixel
+    int64_t costPerRow = static_cast<int64_t>(src.size_.width) * 5;
+    return ImageTaskScheduler::ParallelForRows(src.size_.height, costPerRow, task, &failed) &&
+        !failed.load(std::memory_order_relaxed);
+}
+
 bool SLRProc::Serial(const SLRMat &src, SLRMat &dst, const SLRWeightMat &x, const SLRWeightMat &y)
 {
     CHECK_ERROR_RETURN_RET_LOG(!SLRCheck(src, dst, x, y), false, "SLRProc::Serial param error");
 
+    SLRAxis rowAxis = GetSLRAxis(*y, src.size_.height, dst.size_.height);
+    SLRAxis colAxis = GetSLRAxis(*x, src.size_.width, dst.size_.width);
     int m = dst.size_.height;
-    int n = dst.size_.width;
-    for (int i = 0; i < m; i++) {
-        for (int j = 0; j < n; j++) {
-            SLRSliceKey key(i, j);
-            SLRBox(key, src, dst, x, y);
-        }
+    for (int i = 0; i < m; i += SLR_SERIAL_BAND_ROWS) {
+        SLRSeparableBand(src, dst, rowAxis, colAxis, i, std::min(i + SLR_SERIAL_BAND_ROWS, m));
     }
     return true;
 }
 
-inline void SLRSubtask(const SLRSliceKey &key, const SLRMat &src, SLRMat &dst,
-    const SLRWeightMat &x, const SLRWeightMat &y)
-{
-    int start = key.x;
-    int end = key.y;
-    int n = dst.size_.width;
-    for (int i = start; i < end; i++) {
-        for (int j = 0; j < n; j++) {
-            SLRSliceKey boxKey(i, j);
-            SLRBox(boxKey, src, dst, x, y);
-        }
-    }
-}
-
 bool SLRProc::Parallel(const SLRMat &src, SLRMat &dst, const SLRWeightMat &x, const SLRWeightMat &y)
 {
-#if !defined(_WIN32) && !defined(_APPLE) && !defined(IOS_PLATFORM) && !defined(ANDROID_PLATFORM)
     CHECK_ERROR_RETURN_RET_LOG(!SLRCheck(src, dst, x, y), false, "SLRProc::Parallel param error");
-    const int maxThread = 16; // 16 max thread size
-    int m = dst.size_.height;
-    int n = dst.size_.width;
-    int step = m / maxThread;
-    int stepMod = (m % maxThread == 0) ? 1 : 0;
-    std::vector<ffrt::dependence> ffrtHandles;
-    std::vector<ffrt::dependence> ffrtHandles1;
-    for (int k = 0; k < maxThread - stepMod; k++) {
-        int start = k * step;
-        int end = (k + 1) * step;
-        auto func = [&src, &dst, &x, &y, start, end, n] {
-            SLRSliceKey key(start, end);
-            SLRSubtask(key, src, dst, x, y);
-        };
-        auto handler = ffrt::submit_h(func, {}, {}, ffrt::task_attr().qos(5)); // 5 max ffrt qos value
-        if (ffrtHandles.size() < FFRT_THREAD_LIMIT) {
-            ffrtHandles.emplace_back(handler);
-        } else {
-            ffrtHandles1.emplace_back(handler);
-        }
-    }
-
-    for (int i = (maxThread - stepMod) * step; i < m; i++) {
-        for (int j = 0; j < n; j++) {
-            SLRSliceKey key(i, j);
-            SLRBox(key, src, dst, x, y);
-        }
-    }
 
-    ffrt::wait(ffrtHandles);
-    ffrt::wait(ffrtHandles1);
-    return true;
-#else
-    return SLRProc::Serial(src, dst, x, y);
-#endif
+    SLRAxis rowAxis = GetSLRAxis(*y, src.size_.height, dst.size_.height);
+    SLRAxis colAxis = GetSLRAxis(*x, src.size_.width, dst.size_.width);
+    auto task = [&src, &dst, &rowAxis, &colAxis](int rowStart, int rowEnd) {
+        SLRSeparableBand(src, dst, rowAxis, colAxis, rowStart, rowEnd);
+    };
+    // Every destination row costs its vertical taps plus its share of the horizontal pass
+    int64_t srcRowsPerRow = std::max(src.size_.height / dst.size_.height, 1);
+    int64_t costPerRow = static_cast<int64_t>(dst.size_.width) * (rowAxis.taps + colAxis.taps * srcRowsPerRow);
+    return ImageTaskScheduler::ParallelForRows(dst.size_.height, costPerRow, task);
 }
 } // namespace Media
 } // namespace OHOS
@@ -48,12 +48,18 @@ public:
     uint8_t *GetDataPtr(bool populate) override;
     uint32_t GetStreamType() override;
     int GetMMapFd();
+    // Serves Read and Peek from a private read-only mapping of the file instead of fread. Off by default: the
+    // caller must keep the file from being truncated while the stream is alive, or a read faults with SIGBUS.
+    void SetMappedRead(bool enabled);
 
 private:
     DISALLOW_COPY_AND_MOVE(FileSourceStream);
     bool GetData(uint32_t desiredSize, uint8_t *outBuffer, uint32_t bufferSize, uint32_t &readSize);
     bool GetData(uint32_t desiredSize, ImagePlugin::DataStreamBuffer &outData);
     void ResetReadBuffer();
+    bool MapForRead();
+    void ReleaseReadMapping();
+    void AdviseAccess(size_t position, size_t length);
     std::FILE *filePtr_ = nullptr;
     size_t fileSize_ = 0;
     size_t fileOffset_ = 0;
@@ -63,6 +69,14 @@ private:
     int mmapFd_ = -1;
     bool mmapFdPassedOn_ = false;
     bool useMmap_ = true;
+    // Read-only mapping that Read and Peek are served from, mappedData_ is the first byte of the stream.
+    uint8_t *mappedBase_ = nullptr;
+    uint8_t *mappedData_ = nullptr;
+    size_t mappedLength_ = 0;
+    bool mappedRead_ = false;
+    bool mapFailed_ = false;
+    size_t lastReadEnd_ = 0;
+    uint32_t sequentialReads_ = 0;
 };
 } // namespace Media
 } // namespace OHOS
@@ -38,13 +38,31 @@ public:
     bool Seek(uint32_t position) override;
 
     uint32_t UpdateData(const uint8_t *data, uint32_t size, bool isCompleted) override;
+    // Appends a chunk allocated by the caller without copying it, the stream owns it afterwards.
+    uint32_t AdoptData(std::unique_ptr<uint8_t[]> data, uint32_t size, bool isCompleted);
     bool IsStreamCompleted() override;
     size_t GetStreamSize() override;
     uint8_t *GetDataPtr() override;
 private:
+    struct DataChunk {
+        std::unique_ptr<uint8_t[]> data;
+        size_t size = 0;
+        size_t capacity = 0;
+    };
+
+    uint32_t AppendData(const uint8_t *data, size_t size);
+    void PushChunk(std::unique_ptr<uint8_t[]> data, size_t size, size_t capacity);
+    size_t FindChunk(size_t offset) const;
+    bool Coalesce(size_t first);
+    void ResetData();
+
     IncrementalMode incrementalMode_;
     bool isFinalize_;
-    std::vector<uint8_t> sourceData_;
+    // The stream is kept as a list of chunks so appending never moves what was received before.
+    std::vector<DataChunk> chunks_;
+    std::vector<size_t> chunkOffsets_;
+    // Chunks replaced by a merge, released on the next Seek or reset.
+    std::vector<std::unique_ptr<uint8_t[]>> retiredChunks_;
     size_t dataSize_ = 0;
     size_t dataOffset_ = 0;
 };
@@ -25,9 +25,11 @@
 #include "image_log.h"
 #include "image_utils.h"
 #include "media_errors.h"
+#include "securec.h"
 
 #if !defined(_WIN32) && !defined(_APPLE) &&!defined(IOS_PLATFORM) &&!defined(ANDROID_PLATFORM)
 #include <sys/mman.h>
+#include <sys/stat.h>
 #define SUPPORT_MMAP
 #endif
 
@@ -49,6 +51,10 @@ constexpr int INVALID_POSITION = -1;
 constexpr int IOCTL_SUCCESS = 0;
 constexpr int LOCAL_FILE_POSITION = 1;
 const static uint64_t FILE_SOURCE_FDSAN_TAG = LOG_TAG_DOMAIN_ID_IMAGE;
+// Reads continuing where the previous one stopped, before the mapping is advised as sequential.
+constexpr uint32_t SEQUENTIAL_READ_COUNT = 4;
+// Reads at least this large are prefetched in one go.
+constexpr size_t WILLNEED_MIN_SIZE = 256 * 1024;
 
 FileSourceStream::FileSourceStream(std::FILE *file, size_t size, size_t offset, size_t original,
                                    bool useMmap, int originalFd)
@@ -74,6 +80,7 @@ FileSourceStream::~FileSourceStream()
         filePtr_ = nullptr;
     }
     ResetReadBuffer();
+    ReleaseReadMapping();
 }
 
 unique_ptr<FileSourceStream> FileSourceStream::CreateSourceStream(const string &pathName)
@@ -176,6 +183,7 @@ bool FileSourceStream::Read(uint32_t desiredSize, DataStreamBuffer &outData)
         IMAGE_LOGI("[FileSourceStream]read dataStreamBuffer fail.");
         return false;
     }
+    AdviseAccess(fileOffset_ - fileOriginalOffset_, outData.dataSize);
     fileOffset_ += outData.dataSize;
     return true;
 }
@@ -190,6 +198,9 @@ bool FileSourceStream::Peek(uint32_t desiredSize, DataStreamBuffer &outData)
         IMAGE_LOGD("[FileSourceStream]peek dataStreamBuffer fail, desiredSize:%{public}u", desiredSize);
         return false;
     }
+    if (mappedData_ != nullptr) {
+        return true;
+    }
     int ret = fseek(filePtr_, fileOffset_, SEEK_SET);
     if (ret != 0) {
         IMAGE_LOGE("[FileSourceStream]go to original position fail, ret:%{public}d.", ret);
@@ -209,6 +220,7 @@ bool FileSourceStream::Read(uint32_t desiredSize, uint8_t *outBuffer, uint32_t b
         IMAGE_LOGD("[FileSourceStream]read outBuffer fail.");
         return false;
     }
+    AdviseAccess(fileOffset_ - fileOriginalOffset_, readSize);
     fileOffset_ += readSize;
     return true;
 }
@@ -225,6 +237,9 @@ bool FileSourceStream::Peek(uint32_t desiredSize, uint8_t *outBuffer, uint32_t b
         return false;
     }
     CHECK_ERROR_RETURN_RET(filePtr_ == nullptr, false);
+    if (mappedData_ != nullptr) {
+        return true;
+    }
 
     int ret = fseek(filePtr_, fileOffset_, SEEK_SET);
     if (ret != 0) {
@@ -270,6 +285,12 @@ bool FileSourceStream::GetData(uint32_t desiredSize, uint8_t *outBuffer, uint32_
     if (desiredSize > (fileSize_ - fileOffset_)) {
         desiredSize = fileSize_ - fileOffset_;
     }
+    if (MapForRead()) {
+        errno_t ret = memcpy_s(outBuffer, bufferSize, mappedData_ + (fileOffset_ - fileOriginalOffset_), desiredSize);
+        CHECK_ERROR_RETURN_RET_LOG(ret != EOK, false, "[FileSourceStream]copy mapped data fail, ret:%{public}d.", ret);
+        readSize = desiredSize;
+        return true;
+    }
     size_t bytesRead = fread(outBuffer, sizeof(outBuffer[0]), desiredSize, filePtr_);
     if (bytesRead < desiredSize) {
         IMAGE_LOGD("read outBuffer end, bytesRead:%{public}zu, desiredSize:%{public}u, fileSize_:%{public}zu,"
@@ -294,6 +315,13 @@ bool FileSourceStream::GetData(uint32_t desiredSize, DataStreamBuffer &outData)
         return false;
     }
     CHECK_ERROR_RETURN_RET(filePtr_ == nullptr, false);
+    if (MapForRead()) {
+        size_t remaining = fileSize_ - fileOffset_;
+        outData.inputStreamBuffer = mappedData_ + (fileOffset_ - fileOriginalOffset_);
+        outData.bufferSize = static_cast<uint32_t>(min(remaining, static_cast<size_t>(UINT32_MAX)));
+        outData.dataSize = static_cast<uint32_t>(min(remaining, static_cast<size_t>(desiredSize)));
+        return true;
+    }
 
     ResetReadBuffer();
     readBuffer_ = static_cast<uint8_t *>(malloc(desiredSize));
@@ -422,6 +450,110 @@ int FileSourceStream::GetMMapFd()
     return mmapFd_;
 }
 
+#ifdef SUPPORT_MMAP
+static size_t GetPageSize()
+{
+    static const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    return pageSize;
+}
+
+static bool CanMapForRead(int fd, size_t end)
+{
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) != 0 || !S_ISREG(fileStat.st_mode) || fileStat.st_size < 0 ||
+        static_cast<size_t>(fileStat.st_size) < end) {
+        return false;
+    }
+    // Remote distributed files keep using fread, faulting their pages in would stall the decoder.
+    int location = INVALID_POSITION;
+    if (ioctl(fd, HMDFS_IOC_GET_LOCATION, &location) == IOCTL_SUCCESS && location != LOCAL_FILE_POSITION) {
+        return false;
+    }
+    return true;
+}
+#endif
+
+void FileSourceStream::SetMappedRead(bool enabled)
+{
+    mappedRead_ = enabled;
+}
+
+bool FileSourceStream::MapForRead()
+{
+    // Only streams that opted in with SetMappedRead are mapped, the rest read through fread. A mapping that was
+    // made stays until the stream is destroyed because earlier reads may still point into it.
+    if (!mappedRead_) {
+        return false;
+    }
+    if (mappedData_ != nullptr) {
+        return true;
+    }
+    if (mapFailed_) {
+        return false;
+    }
+    mapFailed_ = true;
+#ifdef SUPPORT_MMAP
+    CHECK_ERROR_RETURN_RET(filePtr_ == nullptr || fileSize_ <= fileOriginalOffset_, false);
+    int fd = fileno(filePtr_);
+    if (fd < 0 || !CanMapForRead(fd, fileSize_)) {
+        IMAGE_LOGD("[FileSourceStream] fd is not mappable, read with fread.");
+        return false;
+    }
+    size_t mapOffset = fileOriginalOffset_ - fileOriginalOffset_ % GetPageSize();
+    size_t mapLength = fileSize_ - mapOffset;
+    void *mapped = ::mmap(nullptr, mapLength, PROT_READ, MAP_PRIVATE, fd, static_cast<off_t>(mapOffset));
+    if (mapped == MAP_FAILED) {
+        IMAGE_LOGD("[FileSourceStream] mmap for read failed, errno:%{public}d, read with fread.", errno);
+        return false;
+    }
+    mappedBase_ = static_cast<uint8_t *>(mapped);
+    mappedLength_ = mapLength;
+    mappedData_ = mappedBase_ + (fileOriginalOffset_ - mapOffset);
+    mapFailed_ = false;
+    return true;
+#else
+    return false;
+#endif
+}
+
+void FileSourceStream::ReleaseReadMapping()
+{
+#ifdef SUPPORT_MMAP
+    if (mappedBase_ != nullptr) {
+        ::munmap(mappedBase_, mappedLength_);
+    }
+#endif
+    mappedBase_ = nullptr;
+    mappedData_ = nullptr;
+    mappedLength_ = 0;
+}
+
+void FileSourceStream::AdviseAccess(size_t position, size_t length)
+{
+#ifdef SUPPORT_MMAP
+    if (mappedData_ == nullptr || length == 0) {
+        return;
+    }
+    // Decoders that keep reading where they stopped get aggressive readahead, a jump turns it back off.
+    if (position == lastReadEnd_) {
+        if (++sequentialReads_ == SEQUENTIAL_READ_COUNT) {
+            ::madvise(mappedBase_, mappedLength_, MADV_SEQUENTIAL);
+        }
+    } else {
+        if (sequentialReads_ >= SEQUENTIAL_READ_COUNT) {
+            ::madvise(mappedBase_, mappedLength_, MADV_NORMAL);
+        }
+        sequentialReads_ = 0;
+    }
+    lastReadEnd_ = position + length;
+    if (length >= WILLNEED_MIN_SIZE) {
+        size_t begin = static_cast<size_t>(mappedData_ - mappedBase_) + position;
+        size_t alignedBegin = begin - begin % GetPageSize();
+        ::madvise(mappedBase_ + alignedBegin, begin + length - alignedBegin, MADV_WILLNEED);
+    }
+#endif
+}
+
 bool FileSourceStream::ShouldUseMmap(int fd)
 {
     int offset = INVALID_POSITION;
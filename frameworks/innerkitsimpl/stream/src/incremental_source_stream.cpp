@@ -16,6 +16,8 @@
 #include "incremental_source_stream.h"
 
 #include <algorithm>
+#include <new>
+#include <utility>
 #include <vector>
 #include "image_log.h"
 #ifndef _WIN32
@@ -35,6 +37,9 @@ namespace Media {
 using namespace std;
 using namespace ImagePlugin;
 const uint32_t MAX_SOURCE_SIZE = 1024 * 1024 * 1024;
+// Small network pieces are packed into chunks of at least this size.
+constexpr size_t MIN_CHUNK_SIZE = 64 * 1024;
+constexpr size_t COALESCE_HEADROOM_DIVISOR = 2;
 
 IncrementalSourceStream::IncrementalSourceStream(IncrementalMode mode)
     : incrementalMode_(mode), isFinalize_(false), dataSize_(0), dataOffset_(0)
@@ -62,17 +67,25 @@ bool IncrementalSourceStream::Peek(uint32_t desiredSize, DataStreamBuffer &outDa
         IMAGE_LOGE("[IncrementalSourceStream]input the parameter exception.");
         return false;
     }
-    if (sourceData_.empty() || dataSize_ == 0 || dataOffset_ >= dataSize_) {
+    if (chunks_.empty() || dataSize_ == 0 || dataOffset_ >= dataSize_) {
         IMAGE_LOGE("[IncrementalSourceStream]source data exception. dataSize_:%{public}zu,"
             "dataOffset_:%{public}zu.", dataSize_, dataOffset_);
         return false;
     }
-    outData.bufferSize = dataSize_ - dataOffset_;
     if (desiredSize > dataSize_ - dataOffset_) {
         desiredSize = dataSize_ - dataOffset_;
     }
+    size_t index = FindChunk(dataOffset_);
+    size_t chunkOffset = dataOffset_ - chunkOffsets_[index];
+    // A view across a chunk border needs the rest of the stream merged into one chunk first.
+    if (chunkOffset + desiredSize > chunks_[index].size && !Coalesce(index)) {
+        IMAGE_LOGE("[IncrementalSourceStream]merge chunks fail, offset:%{public}zu.", dataOffset_);
+        return false;
+    }
+    const DataChunk &chunk = chunks_[index];
+    outData.bufferSize = chunk.size - chunkOffset;
     outData.dataSize = desiredSize;
-    outData.inputStreamBuffer = sourceData_.data() + dataOffset_;
+    outData.inputStreamBuffer = chunk.data.get() + chunkOffset;
     IMAGE_LOGD("[IncrementalSourceStream]Peek end. desiredSize:%{public}u, offset:%{public}zu,"
         "dataSize_:%{public}zu,dataOffset_:%{public}zu.", desiredSize, dataOffset_, dataSize_, dataOffset_);
     return true;
@@ -95,7 +108,7 @@ bool IncrementalSourceStream::Peek(uint32_t desiredSize, uint8_t *outBuffer, uin
             "bufferSize:%{public}u.", desiredSize, bufferSize);
         return false;
     }
-    if (sourceData_.empty() || dataSize_ == 0 || dataOffset_ >= dataSize_) {
+    if (chunks_.empty() || dataSize_ == 0 || dataOffset_ >= dataSize_) {
         IMAGE_LOGE("[IncrementalSourceStream]source data exception. dataSize_:%{public}zu,"
             "dataOffset_:%{public}zu.", dataSize_, dataOffset_);
         return false;
@@ -103,11 +116,21 @@ bool IncrementalSourceStream::Peek(uint32_t desiredSize, uint8_t *outBuffer, uin
     if (desiredSize > (dataSize_ - dataOffset_)) {
         desiredSize = dataSize_ - dataOffset_;
     }
-    errno_t ret = memcpy_s(outBuffer, bufferSize, sourceData_.data() + dataOffset_, desiredSize);
-    CHECK_ERROR_RETURN_RET_LOG(ret != 0, false,
-        "[IncrementalSourceStream]copy data fail, ret:%{public}d, bufferSize:%{public}u,"
-        "offset:%{public}zu, desiredSize:%{public}u, dataSize:%{public}zu.", ret, bufferSize, dataOffset_,
-        desiredSize, dataSize_);
+    size_t index = FindChunk(dataOffset_);
+    size_t chunkOffset = dataOffset_ - chunkOffsets_[index];
+    uint32_t copied = 0;
+    while (copied < desiredSize) {
+        const DataChunk &chunk = chunks_[index];
+        size_t length = min(chunk.size - chunkOffset, static_cast<size_t>(desiredSize - copied));
+        errno_t ret = memcpy_s(outBuffer + copied, bufferSize - copied, chunk.data.get() + chunkOffset, length);
+        CHECK_ERROR_RETURN_RET_LOG(ret != 0, false,
+            "[IncrementalSourceStream]copy data fail, ret:%{public}d, bufferSize:%{public}u,"
+            "offset:%{public}zu, desiredSize:%{public}u, dataSize:%{public}zu.", ret, bufferSize, dataOffset_,
+            desiredSize, dataSize_);
+        copied += static_cast<uint32_t>(length);
+        chunkOffset = 0;
+        index++;
+    }
     readSize = desiredSize;
     return true;
 }
@@ -123,6 +146,8 @@ bool IncrementalSourceStream::Seek(uint32_t position)
         IMAGE_LOGE("[IncrementalSourceStream]Seek the position greater than the Data Size.");
         return false;
     }
+    // Views handed out before a seek are not used afterwards, so merged away chunks can go now.
+    retiredChunks_.clear();
     dataOffset_ = position;
     return true;
 }
@@ -141,20 +166,41 @@ uint32_t IncrementalSourceStream::UpdateData(const uint8_t *data, uint32_t size,
         bool cond = (dataSize_ > (UINT32_MAX - size));
         CHECK_ERROR_RETURN_RET_LOG(cond, ERR_IMAGE_TOO_LARGE,
             "[IncrementalSourceStream]total size would exceed limit");
-        vector<uint8_t> newData;
-        newData.resize(size);
-        copy(data, data + size, newData.begin());
-        sourceData_.resize(dataSize_ + size);
-        sourceData_.insert(sourceData_.begin() + dataSize_, newData.begin(), newData.end());
-        dataSize_ += size;
+        uint32_t ret = AppendData(data, size);
+        CHECK_ERROR_RETURN_RET(ret != SUCCESS, ret);
+        isFinalize_ = isCompleted;
+    } else {
+        ResetData();
+        unique_ptr<uint8_t[]> chunk(new (nothrow) uint8_t[size]);
+        CHECK_ERROR_RETURN_RET_LOG(chunk == nullptr, ERR_IMAGE_MALLOC_ABNORMAL,
+            "[IncrementalSourceStream]alloc data fail, size:%{public}u.", size);
+        copy(data, data + size, chunk.get());
+        PushChunk(std::move(chunk), size, size);
+        isFinalize_ = true;
+    }
+    return SUCCESS;
+}
+
+uint32_t IncrementalSourceStream::AdoptData(unique_ptr<uint8_t[]> data, uint32_t size, bool isCompleted)
+{
+    if (data == nullptr || size > MAX_SOURCE_SIZE) {
+        IMAGE_LOGE("[IncrementalSourceStream]input the parameter exception.");
+        return ERR_IMAGE_DATA_ABNORMAL;
+    }
+    if (size == 0) {
+        IMAGE_LOGD("[IncrementalSourceStream]no need to update data.");
+        return SUCCESS;
+    }
+    if (incrementalMode_ == IncrementalMode::INCREMENTAL_DATA) {
+        bool cond = (dataSize_ > (UINT32_MAX - size));
+        CHECK_ERROR_RETURN_RET_LOG(cond, ERR_IMAGE_TOO_LARGE,
+            "[IncrementalSourceStream]total size would exceed limit");
         isFinalize_ = isCompleted;
     } else {
-        sourceData_.clear();
-        sourceData_.resize(size);
-        dataSize_ = size;
-        copy(data, data + size, sourceData_.begin());
+        ResetData();
         isFinalize_ = true;
     }
+    PushChunk(std::move(data), size, size);
     return SUCCESS;
 }
 
@@ -170,7 +216,87 @@ size_t IncrementalSourceStream::GetStreamSize()
 
 uint8_t *IncrementalSourceStream::GetDataPtr()
 {
-    return sourceData_.data();
+    if (chunks_.empty() || !Coalesce(0)) {
+        return nullptr;
+    }
+    return chunks_[0].data.get();
+}
+
+uint32_t IncrementalSourceStream::AppendData(const uint8_t *data, size_t size)
+{
+    // Fill the spare room of the last chunk first, so small pieces do not turn into many tiny chunks.
+    size_t tailLength = chunks_.empty() ? 0 : min(chunks_.back().capacity - chunks_.back().size, size);
+    size_t rest = size - tailLength;
+    // Allocate before touching the tail, a failed append must leave the stream as it was.
+    size_t capacity = max(rest, MIN_CHUNK_SIZE);
+    unique_ptr<uint8_t[]> chunk;
+    if (rest > 0) {
+        chunk.reset(new (nothrow) uint8_t[capacity]);
+        CHECK_ERROR_RETURN_RET_LOG(chunk == nullptr, ERR_IMAGE_MALLOC_ABNORMAL,
+            "[IncrementalSourceStream]alloc chunk fail, capacity:%{public}zu.", capacity);
+        copy(data + tailLength, data + size, chunk.get());
+    }
+    if (tailLength > 0) {
+        DataChunk &tail = chunks_.back();
+        copy(data, data + tailLength, tail.data.get() + tail.size);
+        tail.size += tailLength;
+        dataSize_ += tailLength;
+    }
+    if (chunk != nullptr) {
+        PushChunk(std::move(chunk), rest, capacity);
+    }
+    return SUCCESS;
+}
+
+void IncrementalSourceStream::PushChunk(unique_ptr<uint8_t[]> data, size_t size, size_t capacity)
+{
+    chunkOffsets_.push_back(dataSize_);
+    DataChunk chunk;
+    chunk.data = std::move(data);
+    chunk.size = size;
+    chunk.capacity = capacity;
+    chunks_.push_back(std::move(chunk));
+    dataSize_ += size;
+}
+
+size_t IncrementalSourceStream::FindChunk(size_t offset) const
+{
+    auto iter = upper_bound(chunkOffsets_.begin(), chunkOffsets_.end(), offset);
+    return static_cast<size_t>(iter - chunkOffsets_.begin()) - 1;
+}
+
+bool IncrementalSourceStream::Coalesce(size_t first)
+{
+    if (first + 1 >= chunks_.size()) {
+        return true;
+    }
+    size_t total = dataSize_ - chunkOffsets_[first];
+    // Keep some headroom so that the following appends still extend the merged chunk in place.
+    size_t capacity = total + total / COALESCE_HEADROOM_DIVISOR;
+    unique_ptr<uint8_t[]> merged(new (nothrow) uint8_t[capacity]);
+    CHECK_ERROR_RETURN_RET_LOG(merged == nullptr, false,
+        "[IncrementalSourceStream]alloc merged chunk fail, capacity:%{public}zu.", capacity);
+    size_t offset = 0;
+    // Views returned by earlier Peek calls may still point into the merged chunks, keep them alive.
+    for (size_t i = first; i < chunks_.size(); i++) {
+        copy(chunks_[i].data.get(), chunks_[i].data.get() + chunks_[i].size, merged.get() + offset);
+        offset += chunks_[i].size;
+        retiredChunks_.push_back(std::move(chunks_[i].data));
+    }
+    chunks_.resize(first + 1);
+    chunkOffsets_.resize(first + 1);
+    chunks_[first].data = std::move(merged);
+    chunks_[first].size = total;
+    chunks_[first].capacity = capacity;
+    return true;
+}
+
+void IncrementalSourceStream::ResetData()
+{
+    chunks_.clear();
+    chunkOffsets_.clear();
+    retiredChunks_.clear();
+    dataSize_ = 0;
 }
 
 } // namespace Media
@@ -460,6 +460,42 @@ HWTEST_F(AvifDecodeTest, CreatePictureAtIndexTest002, TestSize.Level1)
     CreatePictureAtIndexTest(image, DECODING_WITH_10_FRAME_SKIP);
     GTEST_LOG_(INFO) << "AvifDecodeTest: CreatePictureAtIndexTest002 end";
 }
+
+/**
+ * @tc.name: CreatePictureAtIndexTest003
+ * @tc.desc: Test avis frames decoded backwards match the frames decoded in playback order.
+ * @tc.type: FUNC
+ */
+HWTEST_F(AvifDecodeTest, CreatePictureAtIndexTest003, TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "AvifDecodeTest: CreatePictureAtIndexTest003 start";
+#if !defined(CROSS_PLATFORM)
+    auto image = Get8bitAvisImage();
+    SourceOptions sourceOptions;
+    uint32_t errorCode = 0;
+    std::unique_ptr<ImageSource> forwardSource = ImageSource::CreateImageSource(image.path, sourceOptions, errorCode);
+    ASSERT_NE(forwardSource, nullptr);
+    std::unique_ptr<ImageSource> backwardSource = ImageSource::CreateImageSource(image.path, sourceOptions, errorCode);
+    ASSERT_NE(backwardSource, nullptr);
+    std::vector<std::vector<uint8_t>> forwardPixels;
+    for (uint32_t index = 0; index < image.frameCount; index++) {
+        std::unique_ptr<Picture> picture = forwardSource->CreatePictureAtIndex(index, errorCode);
+        ASSERT_NE(picture, nullptr);
+        auto pixelMap = picture->GetMainPixel();
+        ASSERT_NE(pixelMap, nullptr);
+        forwardPixels.emplace_back(pixelMap->GetPixels(), pixelMap->GetPixels() + pixelMap->GetByteCount());
+    }
+    for (uint32_t index = image.frameCount; index > 0; index--) {
+        std::unique_ptr<Picture> picture = backwardSource->CreatePictureAtIndex(index - 1, errorCode);
+        ASSERT_NE(picture, nullptr);
+        auto pixelMap = picture->GetMainPixel();
+        ASSERT_NE(pixelMap, nullptr);
+        std::vector<uint8_t> pixels(pixelMap->GetPixels(), pixelMap->GetPixels() + pixelMap->GetByteCount());
+        ASSERT_EQ(pixels, forwardPixels[index - 1]);
+    }
+#endif
+    GTEST_LOG_(INFO) << "AvifDecodeTest: CreatePictureAtIndexTest003 end";
+}
 #endif
 
 /**
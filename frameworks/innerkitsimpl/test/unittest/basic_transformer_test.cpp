@@ -58,6 +58,8 @@ static constexpr uint16_t RGB565_BLUE = 0x001F;
 static constexpr uint16_t RGB565_YELLOW = 0xFFE0;
 static constexpr uint32_t PIXEL_INDEX_0 = 0;
 static constexpr uint32_t PIXEL_INDEX_1 = 1;
+static constexpr float ROTATE_DEGREE_45 = 45.0f;
+static constexpr uint32_t RGBA_SOLID_COLOR = 0x80402010;
 static constexpr uint32_t PIXEL_INDEX_2 = 2;
 static constexpr uint32_t PIXEL_INDEX_3 = 3;
 
@@ -460,5 +462,45 @@ HWTEST_F(BasicTransformerTest, BilinearPixelProcRGB565Test001, TestSize.Level3)
 
     GTEST_LOG_(INFO) << "BasicTransformerTest: BilinearPixelProcRGB565Test001 end";
 }
+
+/**
+ * @tc.name: DrawPixelmapTiledRotateTest001
+ * @tc.desc: Rotate a solid RGBA_8888 image large enough to be drawn in tiles and row bands.
+ * Pixels inside the source keep the exact color, pixels outside it are cleared without a prior memset.
+ * @tc.type: FUNC
+ */
+HWTEST_F(BasicTransformerTest, DrawPixelmapTiledRotateTest001, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "BasicTransformerTest: DrawPixelmapTiledRotateTest001 start";
+    PixmapInfo inPixmap(false);
+    inPixmap.imageInfo.pixelFormat = PixelFormat::RGBA_8888;
+    inPixmap.imageInfo.size = {DST_WIDTH_640, DST_HEIGHT_480};
+    uint32_t *srcPixels = new uint32_t[DST_WIDTH_640 * DST_HEIGHT_480];
+    std::fill_n(srcPixels, DST_WIDTH_640 * DST_HEIGHT_480, RGBA_SOLID_COLOR);
+    inPixmap.data = reinterpret_cast<uint8_t *>(srcPixels);
+    BasicTransformer transformer;
+    transformer.SetRotateParam(ROTATE_DEGREE_45, DST_WIDTH_640 / 2.0f, DST_HEIGHT_480 / 2.0f);
+    PixmapInfo outPixmap(false);
+    uint32_t ret = transformer.TransformPixmap(inPixmap, outPixmap, nullptr);
+    ASSERT_EQ(ret, IMAGE_SUCCESS);
+    ASSERT_NE(outPixmap.data, nullptr);
+
+    int32_t width = outPixmap.imageInfo.size.width;
+    int32_t height = outPixmap.imageInfo.size.height;
+    EXPECT_GT(width, static_cast<int32_t>(DST_WIDTH_640));
+    EXPECT_GT(height, static_cast<int32_t>(DST_HEIGHT_480));
+    const uint32_t *dstPixels = reinterpret_cast<const uint32_t *>(outPixmap.data);
+    EXPECT_EQ(dstPixels[(height / 2) * width + width / 2], RGBA_SOLID_COLOR);
+    EXPECT_EQ(dstPixels[0], 0u);
+    EXPECT_EQ(dstPixels[width - 1], 0u);
+    EXPECT_EQ(dstPixels[(height - 1) * width], 0u);
+    EXPECT_EQ(dstPixels[height * width - 1], 0u);
+
+    delete[] srcPixels;
+    inPixmap.data = nullptr;
+    free(outPixmap.data);
+    outPixmap.data = nullptr;
+    GTEST_LOG_(INFO) << "BasicTransformerTest: DrawPixelmapTiledRotateTest001 end";
+}
 }
 }
\ No newline at end of file
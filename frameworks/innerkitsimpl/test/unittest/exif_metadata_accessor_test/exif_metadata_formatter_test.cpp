@@ -516,5 +516,34 @@ HWTEST_F(ExifMetadataFormatterTest, ValidRegexWithGpsOneRationalFormatTest002, T
     int32_t res = ExifMetadatFormatter::ValidateValueRange(keyName, largeValue);
     EXPECT_EQ(res, Media::ERR_MEDIA_OUT_OF_RANGE);
 }
+
+/**
+ * @tc.name: ValidConvertRationalFormatTest004
+ * @tc.desc: test the ValidConvertRationalFormat converts integer, rational and decimal segments of one value
+ * @tc.type: FUNC
+ */
+HWTEST_F(ExifMetadataFormatterTest, ValidConvertRationalFormatTest004, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "ExifMetadataFormatterTest: ValidConvertRationalFormatTest004 start";
+    std::string testValue = "3/2 1.5 7";
+    EXPECT_TRUE(ExifMetadatFormatter::ValidConvertRationalFormat(testValue));
+    EXPECT_EQ(testValue, "3/2 3/2 7/1");
+    GTEST_LOG_(INFO) << "ExifMetadataFormatterTest: ValidConvertRationalFormatTest004 end";
+}
+
+/**
+ * @tc.name: IsSensitiveInfoTest001
+ * @tc.desc: test the IsSensitiveInfo matches the gps and location keys regardless of case
+ * @tc.type: FUNC
+ */
+HWTEST_F(ExifMetadataFormatterTest, IsSensitiveInfoTest001, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "ExifMetadataFormatterTest: IsSensitiveInfoTest001 start";
+    EXPECT_TRUE(ExifMetadatFormatter::IsSensitiveInfo("GPSLatitude"));
+    EXPECT_TRUE(ExifMetadatFormatter::IsSensitiveInfo("SubjectLongitude"));
+    EXPECT_TRUE(ExifMetadatFormatter::IsSensitiveInfo("gpsTimeStamp"));
+    EXPECT_FALSE(ExifMetadatFormatter::IsSensitiveInfo("Orientation"));
+    GTEST_LOG_(INFO) << "ExifMetadataFormatterTest: IsSensitiveInfoTest001 end";
+}
 } // namespace Multimedia
 } // namespace OHOS
@@ -2482,5 +2482,57 @@ HWTEST_F(ExifMetadataTest, GetValueByTypeTest008, TestSize.Level3)
     MetadataValue result;
     EXPECT_EQ(ERR_IMAGE_DECODE_EXIF_UNSUPPORT, meta.GetValueByType("HwMnoteIsXmageSupported", result));
 }
+
+/**
+ * @tc.name: CreateLazyTest001
+ * @tc.desc: Verify lazily indexed exif returns the same properties as a full load and materializes on write.
+ * @tc.type: FUNC
+ */
+HWTEST_F(ExifMetadataTest, CreateLazyTest001, TestSize.Level3)
+{
+    auto exifData = exif_data_new_from_file(IMAGE_INPUT_JPEG_PATH.c_str());
+    ASSERT_NE(exifData, nullptr);
+    unsigned char *blob = nullptr;
+    unsigned int size = 0;
+    exif_data_save_data(exifData, &blob, &size);
+    exif_data_unref(exifData);
+    ASSERT_NE(blob, nullptr);
+
+    ExifData *fullData = nullptr;
+    uint32_t blobSize = static_cast<uint32_t>(size);
+    TiffParser::DecodeJpegExif(blob, blobSize, &fullData);
+    ASSERT_NE(fullData, nullptr);
+    ExifMetadata full(fullData);
+    auto lazy = ExifMetadata::CreateLazy(blob, blobSize);
+    free(blob);
+    ASSERT_NE(lazy, nullptr);
+    ASSERT_EQ(lazy->exifData_, nullptr);
+
+    auto lazyProperties = lazy->GetAllProperties();
+    auto fullProperties = full.GetAllProperties();
+    ASSERT_NE(lazyProperties, nullptr);
+    ASSERT_NE(fullProperties, nullptr);
+    EXPECT_EQ(*lazyProperties, *fullProperties);
+    MetadataValue lazyValue;
+    MetadataValue fullValue;
+    ASSERT_EQ(full.GetValueByType("ImageWidth", fullValue), lazy->GetValueByType("ImageWidth", lazyValue));
+    EXPECT_EQ(fullValue.intArrayValue, lazyValue.intArrayValue);
+    ASSERT_EQ(lazy->exifData_, nullptr);
+    for (const std::string key : {"MakerNote", "HwMnoteFocusModeExif"}) {
+        std::string fullMnote;
+        std::string lazyMnote;
+        EXPECT_EQ(full.GetValue(key, fullMnote), lazy->GetValue(key, lazyMnote));
+        EXPECT_EQ(fullMnote, lazyMnote);
+    }
+    if (exif_data_get_entry(full.exifData_, EXIF_TAG_MAKER_NOTE) == nullptr) {
+        ASSERT_EQ(lazy->exifData_, nullptr);
+    }
+
+    ASSERT_TRUE(lazy->SetValue("Orientation", "1"));
+    ASSERT_NE(lazy->exifData_, nullptr);
+    std::string value;
+    ASSERT_EQ(lazy->GetValue("Orientation", value), SUCCESS);
+    EXPECT_EQ(value, "Top-left");
+}
 } // namespace Multimedia
 } // namespace OHOS
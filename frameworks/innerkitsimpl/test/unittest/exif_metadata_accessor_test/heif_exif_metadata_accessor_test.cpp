@@ -46,6 +46,93 @@ static const uint8_t TIFF_IFD_OFFSET = 0x08;
 constexpr size_t RANDOM_DATA_SIZE = 100;
 constexpr int DIRECTORY_PERMISSIONS = 0777;
 constexpr size_t INVALID_FILE_SIZE = 256;
+constexpr uint32_t BOX_HEADER_SIZE = 8;
+constexpr uint32_t IDAT_EXIF_OFFSET = 4;
+constexpr long EXIF_TIFF_HEADER_POS = 10;
+
+void PutUInt32(std::vector<uint8_t> &data, uint32_t value)
+{
+    for (int shift = 24; shift >= 0; shift -= 8) { // 24, 8: big endian bytes
+        data.push_back(static_cast<uint8_t>(value >> shift));
+    }
+}
+
+void PutUInt16(std::vector<uint8_t> &data, uint16_t value)
+{
+    data.push_back(static_cast<uint8_t>(value >> 8)); // 8: high byte first
+    data.push_back(static_cast<uint8_t>(value));
+}
+
+std::vector<uint8_t> MakeBox(const char *type, const std::vector<uint8_t> &payload, int version = -1)
+{
+    std::vector<uint8_t> box;
+    bool isFullBox = version >= 0;
+    PutUInt32(box, BOX_HEADER_SIZE + (isFullBox ? sizeof(uint32_t) : 0) + payload.size());
+    box.insert(box.end(), type, type + sizeof(uint32_t));
+    if (isFullBox) {
+        PutUInt32(box, static_cast<uint32_t>(version) << 24); // 24: version byte, no flags
+    }
+    box.insert(box.end(), payload.begin(), payload.end());
+    return box;
+}
+
+std::vector<uint8_t> Concat(std::initializer_list<std::vector<uint8_t>> parts)
+{
+    std::vector<uint8_t> data;
+    for (const auto &part : parts) {
+        data.insert(data.end(), part.begin(), part.end());
+    }
+    return data;
+}
+
+std::vector<uint8_t> MakeInfe(uint16_t itemId, const char *itemType)
+{
+    std::vector<uint8_t> payload;
+    PutUInt16(payload, itemId);
+    PutUInt16(payload, 0);
+    payload.insert(payload.end(), itemType, itemType + sizeof(uint32_t));
+    payload.push_back(0);
+    return MakeBox("infe", payload, 2); // 2: infe version with a four character item type
+}
+
+// A HEIF whose primary image (item 1) is described by an Exif item (item 2) stored in idat, behind
+// IDAT_EXIF_OFFSET unrelated bytes. exifPos is the file position of the Exif item.
+std::vector<uint8_t> MakeIdatExifHeif(const std::vector<uint8_t> &exif, long &exifPos)
+{
+    std::vector<uint8_t> idat(IDAT_EXIF_OFFSET, 0xAA);
+    idat.insert(idat.end(), exif.begin(), exif.end());
+    std::vector<uint8_t> ftyp = MakeBox("ftyp", {'h', 'e', 'i', 'c', 0, 0, 0, 0, 'm', 'i', 'f', '1', 'h', 'e', 'i', 'c'});
+    std::vector<uint8_t> hdlr = {0, 0, 0, 0, 'p', 'i', 'c', 't', 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+    std::vector<uint8_t> pitm;
+    PutUInt16(pitm, 1);
+    std::vector<uint8_t> iinf;
+    PutUInt16(iinf, 2); // 2: image and Exif item
+    iinf = Concat({iinf, MakeInfe(1, "hvc1"), MakeInfe(2, "Exif")});
+    std::vector<uint8_t> cdsc;
+    PutUInt16(cdsc, 2); // 2: Exif item describes
+    PutUInt16(cdsc, 1); // 1: one reference
+    PutUInt16(cdsc, 1); // 1: the image item
+    std::vector<uint8_t> ipma;
+    PutUInt32(ipma, 0);
+    // iloc version 1, 4 byte offsets and lengths, no base offset; item 1 in the file, item 2 in idat
+    std::vector<uint8_t> iloc = {0x44, 0x00};
+    PutUInt16(iloc, 2); // 2: item count
+    for (uint16_t itemId : {1, 2}) {
+        PutUInt16(iloc, itemId);
+        PutUInt16(iloc, itemId == 1 ? 0 : 1); // 0: file offset, 1: idat offset
+        PutUInt16(iloc, 0);
+        PutUInt16(iloc, 1);
+        PutUInt32(iloc, itemId == 1 ? 0 : IDAT_EXIF_OFFSET);
+        PutUInt32(iloc, itemId == 1 ? 1 : exif.size());
+    }
+    std::vector<uint8_t> meta = Concat({MakeBox("hdlr", hdlr, 0), MakeBox("pitm", pitm, 0), MakeBox("iinf", iinf, 0),
+        MakeBox("iref", MakeBox("cdsc", cdsc), 0),
+        MakeBox("iprp", Concat({MakeBox("ipco", {}), MakeBox("ipma", ipma, 0)})),
+        MakeBox("iloc", iloc, 1), MakeBox("idat", idat)});
+    std::vector<uint8_t> file = Concat({ftyp, MakeBox("meta", meta, 0)});
+    exifPos = static_cast<long>(file.size() - exif.size());
+    return file;
+}
 }
 
 class HeifExifMetadataAccessorTest : public testing::Test {
@@ -785,5 +872,74 @@ HWTEST_F(HeifExifMetadataAccessorTest, TestWriteAndReadHwTagVignettingAndNoise00
     ASSERT_EQ(GetProperty(exifMetadata, "HwMnoteXtStyleNoise"), "0.666666");
     GTEST_LOG_(INFO) << "HeifExifMetadataAccessorTest: TestWriteAndReadHwTagVignettingAndNoise001 end";
 }
+/**
+ * @tc.name: ScanExifItemData001
+ * @tc.desc: test the box scan reads the same Exif item and tiff offset as the full Heif parser
+ * @tc.type: FUNC
+ */
+HWTEST_F(HeifExifMetadataAccessorTest, ScanExifItemData001, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "HeifExifMetadataAccessorTest: ScanExifItemData001 start";
+    std::shared_ptr<MetadataStream> stream = std::make_shared<FileMetadataStream>(IMAGE_INPUT_HEIF_EXIF_PATH);
+    ASSERT_TRUE(stream->Open(OpenMode::ReadWrite));
+    HeifExifMetadataAccessor imageAccessor(stream);
+    DataBuf scanData;
+    ASSERT_TRUE(imageAccessor.ScanExifItemData(scanData));
+    long scanTiffOffset = imageAccessor.tiffOffset_;
+
+    std::shared_ptr<ImagePlugin::HeifParser> parser;
+    ASSERT_EQ(ImagePlugin::HeifParser::MakeFromMemory(stream->GetAddr(), stream->GetSize(), false, &parser),
+        ImagePlugin::heif_error_ok);
+    DataBuf parserData;
+    ASSERT_TRUE(imageAccessor.GetExifItemData(parser, parserData));
+    ASSERT_EQ(scanData.Size(), parserData.Size());
+    ASSERT_EQ(memcmp(scanData.CData(), parserData.CData(), scanData.Size()), 0);
+    ASSERT_EQ(scanTiffOffset, imageAccessor.tiffOffset_);
+
+    std::shared_ptr<MetadataStream> noExifStream = std::make_shared<FileMetadataStream>(IMAGE_INPUT_HEIF_NO_EXIF_PATH);
+    ASSERT_TRUE(noExifStream->Open(OpenMode::ReadWrite));
+    HeifExifMetadataAccessor noExifAccessor(noExifStream);
+    ASSERT_FALSE(noExifAccessor.ScanExifItemData(scanData));
+    GTEST_LOG_(INFO) << "HeifExifMetadataAccessorTest: ScanExifItemData001 end";
+}
+
+/**
+ * @tc.name: ScanExifItemData002
+ * @tc.desc: test the box scan and the full Heif parser agree on the tiff offset of an Exif item stored in idat
+ * @tc.type: FUNC
+ */
+HWTEST_F(HeifExifMetadataAccessorTest, ScanExifItemData002, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "HeifExifMetadataAccessorTest: ScanExifItemData002 start";
+    // offset to the tiff header, Exif identifier, little endian tiff header and an empty IFD0
+    std::vector<uint8_t> exif = {0, 0, 0, 6, 'E', 'x', 'i', 'f', 0, 0, 'I', 'I', TIFF_MAGIC_NUMBER,
+        TIFF_MAGIC_NUMBER_LOW, TIFF_IFD_OFFSET, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+    long exifPos = 0;
+    std::vector<uint8_t> heif = MakeIdatExifHeif(exif, exifPos);
+    std::shared_ptr<MetadataStream> stream =
+        std::make_shared<BufferMetadataStream>(heif.data(), heif.size(), BufferMetadataStream::Fix);
+    ASSERT_TRUE(stream->Open(OpenMode::ReadWrite));
+    HeifExifMetadataAccessor imageAccessor(stream);
+    DataBuf scanData;
+    ASSERT_TRUE(imageAccessor.ScanExifItemData(scanData));
+    ASSERT_EQ(scanData.Size(), exif.size());
+    ASSERT_EQ(memcmp(scanData.CData(), exif.data(), exif.size()), 0);
+    ASSERT_EQ(imageAccessor.tiffOffset_, exifPos);
+
+    std::shared_ptr<ImagePlugin::HeifParser> parser;
+    ASSERT_EQ(ImagePlugin::HeifParser::MakeFromMemory(heif.data(), heif.size(), false, &parser),
+        ImagePlugin::heif_error_ok);
+    DataBuf parserData;
+    imageAccessor.tiffOffset_ = 0;
+    ASSERT_TRUE(imageAccessor.GetExifItemData(parser, parserData));
+    ASSERT_EQ(parserData.Size(), exif.size());
+    ASSERT_EQ(memcmp(parserData.CData(), exif.data(), exif.size()), 0);
+    ASSERT_EQ(imageAccessor.tiffOffset_, exifPos);
+
+    size_t byteOrderPos = 0;
+    ASSERT_TRUE(imageAccessor.CheckTiffPos(const_cast<byte *>(scanData.CData()), scanData.Size(), byteOrderPos));
+    ASSERT_EQ(static_cast<long>(byteOrderPos), EXIF_TIFF_HEADER_POS);
+    GTEST_LOG_(INFO) << "HeifExifMetadataAccessorTest: ScanExifItemData002 end";
+}
 } // namespace Multimedia
 } // namespace OHOS
\ No newline at end of file
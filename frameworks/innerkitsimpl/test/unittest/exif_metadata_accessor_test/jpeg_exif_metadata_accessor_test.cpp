@@ -16,6 +16,7 @@
 #include <gtest/gtest.h>
 #include <memory>
 
+#include "buffer_metadata_stream.h"
 #include "file_metadata_stream.h"
 #include "jpeg_exif_metadata_accessor.h"
 #include "log_tags.h"
@@ -58,6 +59,8 @@ static const std::string IMAGE_OUTPUT_WRITE6_JPEG_PATH = "/data/local/tmp/image/
 static const std::string IMAGE_OUTPUT_WRITE7_JPEG_PATH = "/data/local/tmp/image/no_marknote.jpg";
 constexpr auto EXIF_ID = "Exif\0\0";
 constexpr auto EXIF_ID_SIZE = 6;
+constexpr auto JFIF_APP0_END = 20;
+constexpr auto APP1_HEADER_SIZE = 4;
 }
 
 class JpegExifMetadataAccessorTest : public testing::Test {
@@ -1431,6 +1434,87 @@ HWTEST_F(JpegExifMetadataAccessorTest, WriteBlob003, TestSize.Level3)
     ASSERT_EQ(outputBuf.Size(), inputBuf.Size());
 }
 
+/**
+ * @tc.name: WriteBlob004
+ * @tc.desc: test WriteBlob updates the EXIF segment in place, the file keeps its size while the blob fits and a
+ *           smaller blob is zero padded inside the segment
+ * @tc.type: FUNC
+ */
+HWTEST_F(JpegExifMetadataAccessorTest, WriteBlob004, TestSize.Level3)
+{
+    std::shared_ptr<MetadataStream> readStream = std::make_shared<FileMetadataStream>(IMAGE_INPUT_WRITE2_JPEG_PATH);
+    ASSERT_TRUE(readStream->Open(OpenMode::ReadWrite));
+    JpegExifMetadataAccessor imageReadAccessor(readStream);
+    DataBuf inputBuf;
+    ASSERT_TRUE(imageReadAccessor.ReadBlob(inputBuf));
+
+    std::shared_ptr<MetadataStream> writeStream = std::make_shared<FileMetadataStream>(IMAGE_OUTPUT_WRITE2_JPEG_PATH);
+    ASSERT_TRUE(writeStream->Open(OpenMode::ReadWrite));
+    JpegExifMetadataAccessor imageWriteAccessor(writeStream);
+    ASSERT_EQ(imageWriteAccessor.WriteBlob(inputBuf), 0);
+    ssize_t fileSize = writeStream->GetSize();
+
+    DataBuf smallBuf(inputBuf.CData(), inputBuf.Size() / 2);
+    ASSERT_EQ(imageWriteAccessor.WriteBlob(smallBuf), 0);
+    ASSERT_EQ(writeStream->GetSize(), fileSize);
+    DataBuf outputBuf;
+    ASSERT_TRUE(imageWriteAccessor.ReadBlob(outputBuf));
+    ASSERT_EQ(outputBuf.Size(), inputBuf.Size());
+    ASSERT_EQ(memcmp(outputBuf.CData(), smallBuf.CData(), smallBuf.Size()), 0);
+    for (size_t i = smallBuf.Size(); i < outputBuf.Size(); i++) {
+        ASSERT_EQ(outputBuf.CData()[i], 0);
+    }
+
+    ASSERT_EQ(imageWriteAccessor.WriteBlob(inputBuf), 0);
+    ASSERT_EQ(writeStream->GetSize(), fileSize);
+    ASSERT_TRUE(imageWriteAccessor.ReadBlob(outputBuf));
+    ASSERT_EQ(outputBuf.Size(), inputBuf.Size());
+    ASSERT_EQ(memcmp(outputBuf.CData(), inputBuf.CData(), inputBuf.Size()), 0);
+}
+
+/**
+ * @tc.name: WriteBlob005
+ * @tc.desc: test WriteBlob adds the EXIF segment of a JFIF file behind APP0, without fill bytes
+ * @tc.type: FUNC
+ */
+HWTEST_F(JpegExifMetadataAccessorTest, WriteBlob005, TestSize.Level3)
+{
+    std::shared_ptr<MetadataStream> readStream = std::make_shared<FileMetadataStream>(IMAGE_INPUT_WRITE2_JPEG_PATH);
+    ASSERT_TRUE(readStream->Open(OpenMode::ReadWrite));
+    JpegExifMetadataAccessor imageReadAccessor(readStream);
+    DataBuf inputBuf;
+    ASSERT_TRUE(imageReadAccessor.ReadBlob(inputBuf));
+
+    // SOI, JFIF APP0, DQT, SOS with a few bytes of scan data, EOI
+    std::vector<byte> jfif = {
+        0xFF, 0xD8,
+        0xFF, 0xE0, 0x00, 0x10, 'J', 'F', 'I', 'F', 0x00, 0x01, 0x01, 0x00, 0x00, 0x01, 0x00, 0x01, 0x00, 0x00,
+        0xFF, 0xDB, 0x00, 0x04, 0x00, 0x01,
+        0xFF, 0xDA, 0x00, 0x08, 0x01, 0x01, 0x00, 0x00, 0x3F, 0x00, 0x12, 0x34, 0x56,
+        0xFF, 0xD9,
+    };
+    std::shared_ptr<MetadataStream> writeStream = std::make_shared<BufferMetadataStream>();
+    ASSERT_TRUE(writeStream->Open(OpenMode::ReadWrite));
+    ASSERT_EQ(writeStream->Write(jfif.data(), jfif.size()), static_cast<ssize_t>(jfif.size()));
+    JpegExifMetadataAccessor imageWriteAccessor(writeStream);
+    ASSERT_EQ(imageWriteAccessor.WriteBlob(inputBuf), 0);
+
+    size_t app1Size = APP1_HEADER_SIZE + inputBuf.Size();
+    ASSERT_EQ(static_cast<size_t>(writeStream->GetSize()), jfif.size() + app1Size);
+    const byte *output = writeStream->GetAddr();
+    ASSERT_NE(output, nullptr);
+    ASSERT_EQ(memcmp(output, jfif.data(), JFIF_APP0_END), 0);
+    ASSERT_EQ(output[JFIF_APP0_END], 0xFF);
+    ASSERT_EQ(output[JFIF_APP0_END + 1], 0xE1);
+    ASSERT_EQ(memcmp(output + JFIF_APP0_END + APP1_HEADER_SIZE, EXIF_ID, EXIF_ID_SIZE), 0);
+    ASSERT_EQ(memcmp(output + JFIF_APP0_END + app1Size, jfif.data() + JFIF_APP0_END, jfif.size() - JFIF_APP0_END),
+        0);
+
+    DataBuf outputBuf;
+    ASSERT_TRUE(imageWriteAccessor.ReadBlob(outputBuf));
+    ASSERT_EQ(outputBuf.Size(), inputBuf.Size());
+}
+
 std::string JpegExifMetadataAccessorTest::GetProperty(const std::shared_ptr<ExifMetadata> &metadata,
     const std::string &prop)
 {
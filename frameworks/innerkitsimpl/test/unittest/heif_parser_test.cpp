@@ -404,6 +404,37 @@ HWTEST_F(HeifParserTest, GetItemDataTest001, TestSize.Level3)
     GTEST_LOG_(INFO) << "HeifParserTest: GetItemDataTest001 end";
 }
 
+/**
+ * @tc.name: ReadDataViewTest001
+ * @tc.desc: Test ReadDataView refers to the stream memory for one extent and copies split extents
+ * @tc.type: FUNC
+ */
+HWTEST_F(HeifParserTest, ReadDataViewTest001, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "HeifParserTest: ReadDataViewTest001 start";
+    uint8_t buffer[NUM_10] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    auto stream = std::make_shared<HeifBufferInputStream>(buffer, sizeof(buffer), false);
+    HeifIlocBox ilocBox;
+    HeifIlocBox::Item item;
+    item.extents.push_back({0, MOCK_DATA_SIZE, INDEX_2});
+    HeifDataView view;
+    ASSERT_EQ(ilocBox.ReadDataView(item, stream, nullptr, view), heif_error_ok);
+    ASSERT_FALSE(view.IsCopied());
+    ASSERT_EQ(view.Data(), buffer + INDEX_2);
+    ASSERT_EQ(view.Size(), MOCK_DATA_SIZE);
+
+    item.extents.push_back({0, INDEX_1, 0});
+    ASSERT_EQ(ilocBox.ReadDataView(item, stream, nullptr, view), heif_error_ok);
+    ASSERT_TRUE(view.IsCopied());
+    ASSERT_EQ(view.Size(), MOCK_DATA_SIZE + INDEX_1);
+    ASSERT_EQ(view.Data()[MOCK_DATA_SIZE], buffer[0]);
+
+    item.extents.pop_back();
+    item.extents[0].offset = NUM_8;
+    ASSERT_EQ(ilocBox.ReadDataView(item, stream, nullptr, view), heif_error_eof);
+    GTEST_LOG_(INFO) << "HeifParserTest: ReadDataViewTest001 end";
+}
+
 /**
  * @tc.name: GetTileImagesTest001
  * @tc.desc: HeifParser
@@ -1485,5 +1485,76 @@ HWTEST_F(ImagePackerTest, EncodeControlParamsTest014, TestSize.Level3)
     ASSERT_EQ(retPack, OHOS::Media::SUCCESS);
     GTEST_LOG_(INFO) << "ImagePackerTest: EncodeControlParamsTest014 end";
 }
+
+/**
+ * @tc.name: JpegTransformTest001
+ * @tc.desc: test packing a jpeg image source to jpeg with a rotation
+ * @tc.type: FUNC
+ */
+HWTEST_F(ImagePackerTest, JpegTransformTest001, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "ImagePackerTest: JpegTransformTest001 start";
+    SourceOptions opts;
+    uint32_t errorCode = 0;
+    std::unique_ptr<ImageSource> imageSource = ImageSource::CreateImageSource(IMAGE_INPUT_JPEG_PATH, opts, errorCode);
+    ASSERT_NE(imageSource, nullptr);
+    ImageInfo srcInfo;
+    ASSERT_EQ(imageSource->GetImageInfo(srcInfo), OHOS::Media::SUCCESS);
+
+    ImagePacker pack;
+    PackOption option;
+    option.format = "image/jpeg";
+    option.quality = NUM_100;
+    option.jpegPackingOption.transform = JpegTransformType::ROTATE_90;
+    auto outputData = std::make_unique<uint8_t[]>(BUFFER_SIZE);
+    ASSERT_EQ(pack.StartPacking(outputData.get(), BUFFER_SIZE, option), OHOS::Media::SUCCESS);
+    ASSERT_EQ(pack.AddImage(*imageSource), OHOS::Media::SUCCESS);
+    int64_t packedSize = 0;
+    ASSERT_EQ(pack.FinalizePacking(packedSize), OHOS::Media::SUCCESS);
+    ASSERT_GT(packedSize, 0);
+
+    std::unique_ptr<ImageSource> packedSource = ImageSource::CreateImageSource(outputData.get(),
+        static_cast<uint32_t>(packedSize), opts, errorCode);
+    ASSERT_NE(packedSource, nullptr);
+    ImageInfo dstInfo;
+    ASSERT_EQ(packedSource->GetImageInfo(dstInfo), OHOS::Media::SUCCESS);
+    ASSERT_EQ(dstInfo.size.width, srcInfo.size.height);
+    ASSERT_EQ(dstInfo.size.height, srcInfo.size.width);
+    GTEST_LOG_(INFO) << "ImagePackerTest: JpegTransformTest001 end";
+}
+
+/**
+ * @tc.name: JpegTransformTest002
+ * @tc.desc: test a jpeg source coded below quality 100 is only repacked on coefficients when keepSourceCoding is set
+ * @tc.type: FUNC
+ */
+HWTEST_F(ImagePackerTest, JpegTransformTest002, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "ImagePackerTest: JpegTransformTest002 start";
+    SourceOptions opts;
+    uint32_t errorCode = 0;
+    std::unique_ptr<ImageSource> imageSource = ImageSource::CreateImageSource(IMAGE_INPUT_JPEG_PATH, opts, errorCode);
+    ASSERT_NE(imageSource, nullptr);
+
+    PackOption option;
+    option.format = "image/jpeg";
+    option.quality = NUM_100;
+    auto outputData = std::make_unique<uint8_t[]>(BUFFER_SIZE);
+    int64_t packedSize = 0;
+    ImagePacker reencodePacker;
+    ASSERT_EQ(reencodePacker.StartPacking(outputData.get(), BUFFER_SIZE, option), OHOS::Media::SUCCESS);
+    ASSERT_EQ(reencodePacker.AddImage(*imageSource), OHOS::Media::SUCCESS);
+    ASSERT_FALSE(reencodePacker.losslessTranscoded_);
+    ASSERT_EQ(reencodePacker.FinalizePacking(packedSize), OHOS::Media::SUCCESS);
+
+    option.jpegPackingOption.keepSourceCoding = true;
+    ImagePacker keepPacker;
+    ASSERT_EQ(keepPacker.StartPacking(outputData.get(), BUFFER_SIZE, option), OHOS::Media::SUCCESS);
+    ASSERT_EQ(keepPacker.AddImage(*imageSource), OHOS::Media::SUCCESS);
+    ASSERT_TRUE(keepPacker.losslessTranscoded_);
+    ASSERT_EQ(keepPacker.FinalizePacking(packedSize), OHOS::Media::SUCCESS);
+    ASSERT_GT(packedSize, 0);
+    GTEST_LOG_(INFO) << "ImagePackerTest: JpegTransformTest002 end";
+}
 } // namespace Multimedia
 } // namespace OHOS
@@ -14,6 +14,11 @@
  */
 
 #include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include "image_frame_runs.h"
 #include "image_log.h"
 #include "image_source_util.h"
 #include "media_errors.h"
@@ -195,6 +200,114 @@ HWTEST_F(ImageSourceGifExTest, CreatePixelMapList004, TestSize.Level3)
     GTEST_LOG_(INFO) << "ImageSourceGifExTest: CreatePixelMapList004 end";
 }
 
+/**
+ * @tc.name: CreatePixelMapList005
+ * @tc.desc: test CreatePixelMapList with max concurrency keeps frame order and content
+ * @tc.type: FUNC
+ */
+HWTEST_F(ImageSourceGifExTest, CreatePixelMapList005, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "ImageSourceGifExTest: CreatePixelMapList005 start";
+
+    uint32_t errorCode = 0;
+    const SourceOptions opts;
+    const std::string inputName = INPUT_PATH + TEST_FILE_MULTI_FRAME_GIF;
+    auto serialSource = ImageSource::CreateImageSource(inputName, opts, errorCode);
+    ASSERT_NE(serialSource, nullptr);
+    auto parallelSource = ImageSource::CreateImageSource(inputName, opts, errorCode);
+    ASSERT_NE(parallelSource, nullptr);
+
+    DecodeOptions decodeOpts;
+    decodeOpts.allocatorType = AllocatorType::HEAP_ALLOC;
+    auto serialMaps = serialSource->CreatePixelMapList(decodeOpts, errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_NE(serialMaps, nullptr);
+    const uint32_t maxConcurrency = 2;
+    auto parallelMaps = parallelSource->CreatePixelMapList(decodeOpts, maxConcurrency, errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_NE(parallelMaps, nullptr);
+    ASSERT_EQ(parallelMaps->size(), TEST_FILE_MULTI_FRAME_GIF_FRAME_COUNT);
+    ASSERT_EQ(parallelMaps->size(), serialMaps->size());
+
+    for (size_t index = 0; index < parallelMaps->size(); index++) {
+        auto &serial = (*serialMaps)[index];
+        auto &parallel = (*parallelMaps)[index];
+        ASSERT_NE(parallel, nullptr);
+        ASSERT_EQ(parallel->GetWidth(), serial->GetWidth());
+        ASSERT_EQ(parallel->GetHeight(), serial->GetHeight());
+        ASSERT_EQ(parallel->GetByteCount(), serial->GetByteCount());
+        EXPECT_EQ(memcmp(parallel->GetPixels(), serial->GetPixels(), parallel->GetByteCount()), 0);
+    }
+
+    GTEST_LOG_(INFO) << "ImageSourceGifExTest: CreatePixelMapList005 end";
+}
+
+/**
+ * @tc.name: CreatePixelMapList006
+ * @tc.desc: test CreatePixelMapList with max concurrency 1 falls back to serial decode
+ * @tc.type: FUNC
+ */
+HWTEST_F(ImageSourceGifExTest, CreatePixelMapList006, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "ImageSourceGifExTest: CreatePixelMapList006 start";
+
+    uint32_t errorCode = 0;
+    const SourceOptions opts;
+    const std::string inputName = INPUT_PATH + TEST_FILE_MULTI_FRAME_GIF;
+    auto imageSource = ImageSource::CreateImageSource(inputName, opts, errorCode);
+    ASSERT_NE(imageSource, nullptr);
+
+    const DecodeOptions decodeOpts;
+    auto pixelMaps = imageSource->CreatePixelMapList(decodeOpts, 1, errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_NE(pixelMaps, nullptr);
+    ASSERT_EQ(pixelMaps->size(), TEST_FILE_MULTI_FRAME_GIF_FRAME_COUNT);
+    for (auto &pixelMap : *pixelMaps) {
+        ASSERT_NE(pixelMap, nullptr);
+    }
+
+    GTEST_LOG_(INFO) << "ImageSourceGifExTest: CreatePixelMapList006 end";
+}
+
+/**
+ * @tc.name: CreatePixelMapReverse001
+ * @tc.desc: test decoding gif frames in reverse order with an animation cache budget
+ * @tc.type: FUNC
+ */
+HWTEST_F(ImageSourceGifExTest, CreatePixelMapReverse001, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "ImageSourceGifExTest: CreatePixelMapReverse001 start";
+
+    uint32_t errorCode = 0;
+    const SourceOptions opts;
+    const std::string inputName = INPUT_PATH + TEST_FILE_MULTI_FRAME_GIF;
+    auto serialSource = ImageSource::CreateImageSource(inputName, opts, errorCode);
+    ASSERT_NE(serialSource, nullptr);
+    auto reverseSource = ImageSource::CreateImageSource(inputName, opts, errorCode);
+    ASSERT_NE(reverseSource, nullptr);
+    const uint64_t cacheBudget = 4 * 1024 * 1024;
+    reverseSource->SetAnimationCacheBudget(cacheBudget);
+    ASSERT_EQ(reverseSource->GetAnimationCacheBudget(), cacheBudget);
+
+    DecodeOptions decodeOpts;
+    decodeOpts.allocatorType = AllocatorType::HEAP_ALLOC;
+    auto serialMaps = serialSource->CreatePixelMapList(decodeOpts, errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_NE(serialMaps, nullptr);
+    ASSERT_EQ(serialMaps->size(), TEST_FILE_MULTI_FRAME_GIF_FRAME_COUNT);
+
+    for (uint32_t index = TEST_FILE_MULTI_FRAME_GIF_FRAME_COUNT; index > 0; index--) {
+        auto pixelMap = reverseSource->CreatePixelMap(index - 1, decodeOpts, errorCode);
+        ASSERT_EQ(errorCode, SUCCESS);
+        ASSERT_NE(pixelMap, nullptr);
+        auto &expected = (*serialMaps)[index - 1];
+        ASSERT_EQ(pixelMap->GetByteCount(), expected->GetByteCount());
+        EXPECT_EQ(memcmp(pixelMap->GetPixels(), expected->GetPixels(), pixelMap->GetByteCount()), 0);
+    }
+
+    GTEST_LOG_(INFO) << "ImageSourceGifExTest: CreatePixelMapReverse001 end";
+}
+
 /**
  * @tc.name: GetDelayTime001
  * @tc.desc: test GetDelayTime
@@ -722,5 +835,37 @@ HWTEST_F(ImageSourceGifExTest, CreatePictureAtIndex005, TestSize.Level3)
 
     GTEST_LOG_(INFO) << "ImageSourceGifExTest: CreatePictureAtIndex005 end";
 }
+
+/**
+ * @tc.name: DecodeFrameRunsTest001
+ * @tc.desc: Runs snapped to disposal boundaries outnumber the workers; no more than workerNum run at once.
+ * @tc.type: FUNC
+ */
+HWTEST_F(ImageSourceGifExTest, DecodeFrameRunsTest001, TestSize.Level3)
+{
+    const uint32_t workerNum = 2;
+    const int32_t restoreBg = 2;
+    std::vector<int32_t> disposalTypes = {0, 0, restoreBg, 0, 0, restoreBg, 0, 0};
+    auto runs = ImageFrameRuns::Split(disposalTypes.size(), workerNum, disposalTypes);
+    ASSERT_GT(runs.size(), workerNum);
+    ASSERT_EQ(runs.back().second, disposalTypes.size());
+
+    std::atomic<uint32_t> inFlight(0);
+    std::atomic<uint32_t> maxInFlight(0);
+    std::vector<std::atomic<uint32_t>> decodeCounts(runs.size());
+    ImageFrameRuns::Decode(runs.size(), workerNum, [&](size_t runIndex) {
+        uint32_t current = ++inFlight;
+        uint32_t seen = maxInFlight.load();
+        while (current > seen && !maxInFlight.compare_exchange_weak(seen, current)) {
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        decodeCounts[runIndex]++;
+        --inFlight;
+    });
+    EXPECT_LE(maxInFlight.load(), workerNum);
+    for (auto &count : decodeCounts) {
+        EXPECT_EQ(count.load(), 1u);
+    }
+}
 } // namespace Multimedia
 } // namespace OHOS
\ No newline at end of file
@@ -31,6 +31,9 @@ static const std::string OUTPUT_PATH = "/data/local/tmp/image/output_";
 static const std::string OUTPUT_EXT = ".jpg";
 static const std::string TEST_FILE_SVG = "test.svg";
 static const std::string TEST_FILE_LARGE_SVG = "test_large.svg";
+// test.svg is 400 x 200, every size keeps its aspect ratio so the decode lands on it exactly
+static const std::vector<Size> SVG_TEST_SIZES = {{100, 50}, {200, 100}, {800, 400}};
+static const Size SVG_OVERSIZED = {100000, 50000};
 }
 
 class ImageSourceSvgTest : public testing::Test {};
@@ -366,5 +369,67 @@ HWTEST_F(ImageSourceSvgTest, SvgGetEncodedFormat002, TestSize.Level3)
     GTEST_LOG_(INFO) << "ImageSourceSvgTest: SvgGetEncodedFormat002 imageinfo2: " << imageinfo2.encodedFormat;
     GTEST_LOG_(INFO) << "ImageSourceSvgTest: SvgGetEncodedFormat002 end";
 }
+
+/**
+ * @tc.name: SvgCreatePixelMapsForSizes001
+ * @tc.desc: Decode one svg source at several sizes, every pixel map has the size asked for
+ * @tc.type: FUNC
+ */
+HWTEST_F(ImageSourceSvgTest, SvgCreatePixelMapsForSizes001, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "ImageSourceSvgTest: SvgCreatePixelMapsForSizes001 start";
+    uint32_t errorCode = 0;
+    SourceOptions opts;
+    opts.formatHint = SVG_FORMAT_TYPE;
+    auto imageSource = ImageSource::CreateImageSource(INPUT_PATH + TEST_FILE_SVG, opts, errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_NE(imageSource.get(), nullptr);
+
+    DecodeOptions decodeOpts;
+    auto pixelMaps = imageSource->CreatePixelMapsForSizes(0, decodeOpts, SVG_TEST_SIZES, errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_NE(pixelMaps, nullptr);
+    ASSERT_EQ(pixelMaps->size(), SVG_TEST_SIZES.size());
+    for (size_t i = 0; i < SVG_TEST_SIZES.size(); i++) {
+        ASSERT_NE((*pixelMaps)[i], nullptr);
+        EXPECT_EQ((*pixelMaps)[i]->GetWidth(), SVG_TEST_SIZES[i].width);
+        EXPECT_EQ((*pixelMaps)[i]->GetHeight(), SVG_TEST_SIZES[i].height);
+    }
+    GTEST_LOG_(INFO) << "ImageSourceSvgTest: SvgCreatePixelMapsForSizes001 end";
+}
+
+/**
+ * @tc.name: SvgCreatePixelMapsForSizes002
+ * @tc.desc: A size that cannot be decoded fails the whole call with the error of that decode, no size fails with
+ *           an invalid parameter
+ * @tc.type: FUNC
+ */
+HWTEST_F(ImageSourceSvgTest, SvgCreatePixelMapsForSizes002, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "ImageSourceSvgTest: SvgCreatePixelMapsForSizes002 start";
+    uint32_t errorCode = 0;
+    SourceOptions opts;
+    opts.formatHint = SVG_FORMAT_TYPE;
+    auto imageSource = ImageSource::CreateImageSource(INPUT_PATH + TEST_FILE_SVG, opts, errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_NE(imageSource.get(), nullptr);
+
+    DecodeOptions decodeOpts;
+    decodeOpts.desiredSize = SVG_OVERSIZED;
+    uint32_t singleErrorCode = SUCCESS;
+    auto pixelMap = imageSource->CreatePixelMap(0, decodeOpts, singleErrorCode);
+    ASSERT_EQ(pixelMap, nullptr);
+    ASSERT_NE(singleErrorCode, SUCCESS);
+
+    std::vector<Size> sizes = {SVG_TEST_SIZES[0], SVG_OVERSIZED, SVG_TEST_SIZES[1]};
+    auto pixelMaps = imageSource->CreatePixelMapsForSizes(0, DecodeOptions(), sizes, errorCode);
+    EXPECT_EQ(pixelMaps, nullptr);
+    EXPECT_EQ(errorCode, singleErrorCode);
+
+    pixelMaps = imageSource->CreatePixelMapsForSizes(0, DecodeOptions(), {}, errorCode);
+    EXPECT_EQ(pixelMaps, nullptr);
+    EXPECT_EQ(errorCode, ERR_IMAGE_INVALID_PARAMETER);
+    GTEST_LOG_(INFO) << "ImageSourceSvgTest: SvgCreatePixelMapsForSizes002 end";
+}
 } // namespace Multimedia
 } // namespace OHOS
\ No newline at end of file
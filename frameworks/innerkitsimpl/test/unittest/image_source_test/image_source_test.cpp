@@ -5870,5 +5870,29 @@ HWTEST_F(ImageSourceTest, GetPngMetadata001, TestSize.Level3)
     ASSERT_EQ(imageSource->IsEncodedFormat("image/png"), false);
 }
 
+/**
+ * @tc.name: SniffEncodedFormatTest001
+ * @tc.desc: test the format of jpeg and png sources is resolved without creating a decoder
+ * @tc.type: FUNC
+ */
+HWTEST_F(ImageSourceTest, SniffEncodedFormatTest001, TestSize.Level3)
+{
+    uint32_t errorCode = 0;
+    SourceOptions opts;
+    std::unique_ptr<ImageSource> imageSource = ImageSource::CreateImageSource(IMAGE_INPUT_JPEG_PATH, opts, errorCode);
+    ASSERT_NE(imageSource, nullptr);
+    std::string format;
+    ASSERT_EQ(imageSource->GetEncodedFormat("", format), SUCCESS);
+    ASSERT_EQ(format, "image/jpeg");
+    ASSERT_EQ(imageSource->mainDecoder_, nullptr);
+    ASSERT_EQ(imageSource->InitMainDecoder(), SUCCESS);
+    ASSERT_NE(imageSource->mainDecoder_, nullptr);
+
+    imageSource = ImageSource::CreateImageSource(IMAGE_INPUT_PNG_PATH, opts, errorCode);
+    ASSERT_NE(imageSource, nullptr);
+    ASSERT_EQ(imageSource->SniffEncodedFormat(format), SUCCESS);
+    ASSERT_EQ(format, "image/png");
+}
+
 } // namespace Multimedia
 } // namespace OHOS
\ No newline at end of file
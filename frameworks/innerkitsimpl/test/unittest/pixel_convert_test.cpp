@@ -15,6 +15,7 @@
 
 #include <gtest/gtest.h>
 #include <fstream>
+#include <vector>
 #include <fcntl.h>
 #include "image_source.h"
 #include "image_type.h"
@@ -3790,5 +3791,91 @@ HWTEST_F(PixelConvertTest, PixelsConvertAlphaF16InvalidRowStrideTest001, TestSiz
     ASSERT_EQ(ret, CONVERT_FAIL);
     GTEST_LOG_(INFO) << "PixelConvertTest: PixelsConvertAlphaF16InvalidRowStrideTest001 end";
 }
+
+/**
+ * @tc.name: PixelConvertRowKernelTest001
+ * @tc.desc: Convert a row longer than one vector block from unpremul RGBA_8888 to premul BGRA_8888
+ * @tc.type: FUNC
+ */
+HWTEST_F(PixelConvertTest, PixelConvertRowKernelTest001, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "PixelConvertTest: PixelConvertRowKernelTest001 start";
+    constexpr uint32_t pixelCount = 37;
+    ImageInfo srcImageInfo;
+    srcImageInfo.alphaType = AlphaType::IMAGE_ALPHA_TYPE_UNPREMUL;
+    srcImageInfo.pixelFormat = PixelFormat::RGBA_8888;
+    ImageInfo dstImageInfo;
+    dstImageInfo.alphaType = AlphaType::IMAGE_ALPHA_TYPE_PREMUL;
+    dstImageInfo.pixelFormat = PixelFormat::BGRA_8888;
+    std::unique_ptr<PixelConvert> converter = PixelConvert::Create(srcImageInfo, dstImageInfo);
+    ASSERT_NE(converter, nullptr);
+
+    std::vector<uint8_t> src(pixelCount * 4);
+    for (uint32_t i = 0; i < src.size(); i++) {
+        src[i] = static_cast<uint8_t>(i * 7 + 3);
+    }
+    std::vector<uint8_t> dst(pixelCount * 4, 0);
+    converter->Convert(dst.data(), src.data(), pixelCount);
+    for (uint32_t i = 0; i < pixelCount; i++) {
+        const uint8_t *in = src.data() + i * 4;
+        const uint8_t *out = dst.data() + i * 4;
+        ASSERT_EQ(out[0], Premul255(in[2], in[3]));
+        ASSERT_EQ(out[1], Premul255(in[1], in[3]));
+        ASSERT_EQ(out[2], Premul255(in[0], in[3]));
+        ASSERT_EQ(out[3], in[3]);
+    }
+    GTEST_LOG_(INFO) << "PixelConvertTest: PixelConvertRowKernelTest001 end";
+}
+
+/**
+ * @tc.name: PixelConvertRowKernelTest002
+ * @tc.desc: Convert a row longer than one vector block from RGB_888 to RGBA_8888 and premul to unpremul
+ * @tc.type: FUNC
+ */
+HWTEST_F(PixelConvertTest, PixelConvertRowKernelTest002, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "PixelConvertTest: PixelConvertRowKernelTest002 start";
+    constexpr uint32_t pixelCount = 37;
+    ImageInfo srcImageInfo;
+    srcImageInfo.alphaType = AlphaType::IMAGE_ALPHA_TYPE_OPAQUE;
+    srcImageInfo.pixelFormat = PixelFormat::RGB_888;
+    ImageInfo dstImageInfo;
+    dstImageInfo.alphaType = AlphaType::IMAGE_ALPHA_TYPE_OPAQUE;
+    dstImageInfo.pixelFormat = PixelFormat::RGBA_8888;
+    std::unique_ptr<PixelConvert> expander = PixelConvert::Create(srcImageInfo, dstImageInfo);
+    ASSERT_NE(expander, nullptr);
+
+    std::vector<uint8_t> src(pixelCount * 3);
+    for (uint32_t i = 0; i < src.size(); i++) {
+        src[i] = static_cast<uint8_t>(i * 11 + 5);
+    }
+    std::vector<uint8_t> rgba(pixelCount * 4, 0);
+    expander->Convert(rgba.data(), src.data(), pixelCount);
+    for (uint32_t i = 0; i < pixelCount; i++) {
+        ASSERT_EQ(rgba[i * 4], src[i * 3]);
+        ASSERT_EQ(rgba[i * 4 + 1], src[i * 3 + 1]);
+        ASSERT_EQ(rgba[i * 4 + 2], src[i * 3 + 2]);
+        ASSERT_EQ(rgba[i * 4 + 3], ALPHA_OPAQUE);
+    }
+
+    srcImageInfo.alphaType = AlphaType::IMAGE_ALPHA_TYPE_PREMUL;
+    srcImageInfo.pixelFormat = PixelFormat::RGBA_8888;
+    dstImageInfo.alphaType = AlphaType::IMAGE_ALPHA_TYPE_UNPREMUL;
+    std::unique_ptr<PixelConvert> unpremul = PixelConvert::Create(srcImageInfo, dstImageInfo);
+    ASSERT_NE(unpremul, nullptr);
+    for (uint32_t i = 0; i < pixelCount; i++) {
+        rgba[i * 4 + 3] = static_cast<uint8_t>(i * 13);
+    }
+    std::vector<uint8_t> dst(pixelCount * 4, 0);
+    unpremul->Convert(dst.data(), rgba.data(), pixelCount);
+    for (uint32_t i = 0; i < pixelCount; i++) {
+        uint8_t alpha = rgba[i * 4 + 3];
+        ASSERT_EQ(dst[i * 4], Unpremul255(rgba[i * 4], alpha));
+        ASSERT_EQ(dst[i * 4 + 1], Unpremul255(rgba[i * 4 + 1], alpha));
+        ASSERT_EQ(dst[i * 4 + 2], Unpremul255(rgba[i * 4 + 2], alpha));
+        ASSERT_EQ(dst[i * 4 + 3], alpha);
+    }
+    GTEST_LOG_(INFO) << "PixelConvertTest: PixelConvertRowKernelTest002 end";
+}
 }
 }
@@ -1465,5 +1465,27 @@ HWTEST_F(PluginTextureEncodeTest, FillMetaDataTest001, TestSize.Level3)
     mapNoFd->imageInfo_.pixelFormat = PixelFormat::ASTC_4x4;
     EXPECT_FALSE(codec.FillMetaData(info, mapNoFd.get()));
 }
+
+/**
+ * @tc.name: AstcSoftwareEncodeCoreTest002
+ * @tc.desc: Encode a large image through the context pool on the worker threads and on a private single thread
+ *           context, the blocks must be identical.
+ * @tc.type: FUNC
+ */
+HWTEST_F(PluginTextureEncodeTest, AstcSoftwareEncodeCoreTest002, TestSize.Level3)
+{
+    constexpr int32_t largeSize = 1024;
+    TextureEncodeOptions param;
+    ASSERT_TRUE(FillEncodeOptions(param, largeSize, largeSize, ASTC_BLOCK_WIDTH, HIGH_SPEED_PROFILE));
+    std::vector<uint8_t> pixels(static_cast<size_t>(largeSize) * largeSize * BYTES_PER_PIXEL);
+    for (size_t i = 0; i < pixels.size(); i++) {
+        pixels[i] = static_cast<uint8_t>((i * i) % PIXEL_VALUE_MAX);
+    }
+    std::vector<uint8_t> pooled(param.astcBytes);
+    std::vector<uint8_t> single(param.astcBytes);
+    ASSERT_TRUE(AstcCodec::AstcSoftwareEncodeCore(param, pixels.data(), pooled.data()));
+    ASSERT_TRUE(AstcCodec::AstcSoftwareEncodeCoreUnpooled(param, pixels.data(), single.data()));
+    EXPECT_EQ(pooled, single);
+}
 } // namespace Multimedia
 } // namespace OHOS
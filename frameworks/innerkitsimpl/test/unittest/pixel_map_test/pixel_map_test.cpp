@@ -3844,6 +3844,67 @@ HWTEST_F(PixelMapTest, RotateApiTest001, TestSize.Level3)
     GTEST_LOG_(INFO) << "PixelMapTest: RotateApiTest001 end";
 }
 
+/**
+ * @tc.name: ApplyTransformTest001
+ * @tc.desc: Verify ApplyTransform composes crop, scale, rotate and flip into the sequential result size.
+ * @tc.type: FUNC
+ */
+HWTEST_F(PixelMapTest, ApplyTransformTest001, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "PixelMapTest: ApplyTransformTest001 start";
+
+    auto [pixelMap, errCode] = CreateTransformApiPixelMap(PixelFormat::RGBA_8888, 8, 4);
+    ASSERT_EQ(errCode, SUCCESS);
+    ASSERT_NE(pixelMap, nullptr);
+    PixelMapTransform transform;
+    Rect rect = {0, 0, 6, 4};
+    transform.Crop(rect).Scale(0.5f, 0.5f).Rotate(90.0f).Flip(true, false);
+    EXPECT_EQ(transform.GetOps().size(), 4);
+    EXPECT_EQ(pixelMap->ApplyTransform(transform, AntiAliasingOption::LOW), SUCCESS);
+    EXPECT_EQ(pixelMap->GetWidth(), 2);
+    EXPECT_EQ(pixelMap->GetHeight(), 3);
+
+    GTEST_LOG_(INFO) << "PixelMapTest: ApplyTransformTest001 end";
+}
+
+/**
+ * @tc.name: ApplyTransformTest002
+ * @tc.desc: Verify ApplyTransform matches sequential crop and flip pixels and rejects an out-of-range crop.
+ * @tc.type: FUNC
+ */
+HWTEST_F(PixelMapTest, ApplyTransformTest002, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "PixelMapTest: ApplyTransformTest002 start";
+
+    auto [composed, composedErrCode] = CreateTransformApiPixelMap(PixelFormat::RGBA_8888, 8, 4);
+    ASSERT_EQ(composedErrCode, SUCCESS);
+    ASSERT_NE(composed, nullptr);
+    auto [sequential, sequentialErrCode] = CreateTransformApiPixelMap(PixelFormat::RGBA_8888, 8, 4);
+    ASSERT_EQ(sequentialErrCode, SUCCESS);
+    ASSERT_NE(sequential, nullptr);
+
+    Rect rect = {2, 1, 4, 3};
+    PixelMapTransform transform;
+    transform.Crop(rect).Flip(true, true);
+    ASSERT_EQ(composed->ApplyTransform(transform), SUCCESS);
+    ASSERT_EQ(sequential->Crop(rect), SUCCESS);
+    ASSERT_EQ(sequential->Flip(true, true), SUCCESS);
+    ASSERT_EQ(composed->GetWidth(), sequential->GetWidth());
+    ASSERT_EQ(composed->GetHeight(), sequential->GetHeight());
+    for (int32_t y = 0; y < composed->GetHeight(); y++) {
+        EXPECT_EQ(memcmp(composed->GetPixels() + y * composed->GetRowStride(),
+            sequential->GetPixels() + y * sequential->GetRowStride(), composed->GetRowBytes()), 0);
+    }
+
+    PixelMapTransform invalid;
+    Rect outside = {0, 0, 16, 16};
+    invalid.Crop(outside).Rotate(90.0f);
+    EXPECT_EQ(composed->ApplyTransform(invalid), ERR_IMAGE_INVALID_PARAMETER);
+    EXPECT_EQ(composed->GetWidth(), 4);
+
+    GTEST_LOG_(INFO) << "PixelMapTest: ApplyTransformTest002 end";
+}
+
 /**
  * @tc.name: TransformApiInvalidFloatTest001
  * @tc.desc: Verify transform APIs reject non-finite and overflowing float parameters without changing image size.
@@ -0,0 +1,269 @@
+/*
+ * Copyright (C) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <cstring>
+#include <vector>
+#include "pixel_yuv_utils.h"
+
+using namespace testing::ext;
+using namespace OHOS::Media;
+namespace OHOS {
+namespace Media {
+static constexpr int32_t IMAGE_SIZE = 4;
+static constexpr int32_t DEGREES_90 = 90;
+static constexpr int32_t DEGREES_180 = 180;
+static constexpr int32_t DEGREES_270 = 270;
+
+class PixelYuvUtilsTest : public testing::Test {
+public:
+    PixelYuvUtilsTest() {}
+    ~PixelYuvUtilsTest() {}
+};
+
+// Packed 4x4 NV12 frame, luma counts 0..15 row by row and chroma pairs are 100 + 10 * row + index.
+static YuvImageInfo MakeNV12Image(std::vector<uint8_t> &data)
+{
+    data = {
+        0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+        100, 101, 102, 103, 110, 111, 112, 113,
+    };
+    YuvImageInfo info;
+    info.format = AVPixelFormat::AV_PIX_FMT_NV12;
+    info.yuvFormat = PixelFormat::NV12;
+    info.width = IMAGE_SIZE;
+    info.height = IMAGE_SIZE;
+    info.yuvDataInfo.yStride = IMAGE_SIZE;
+    info.yuvDataInfo.uvStride = IMAGE_SIZE;
+    info.yuvDataInfo.yOffset = 0;
+    info.yuvDataInfo.uvOffset = IMAGE_SIZE * IMAGE_SIZE;
+    return info;
+}
+
+/**
+ * @tc.name: YuvRotate90Test001
+ * @tc.desc: Rotate NV12 clockwise, luma and interleaved chroma pairs move as a whole
+ * @tc.type: FUNC
+ */
+HWTEST_F(PixelYuvUtilsTest, YuvRotate90Test001, TestSize.Level3)
+{
+    std::vector<uint8_t> src;
+    YuvImageInfo srcInfo = MakeNV12Image(src);
+    std::vector<uint8_t> dst(src.size(), 0);
+    YuvImageInfo dstInfo;
+    ASSERT_TRUE(PixelYuvUtils::YuvRotate(src.data(), srcInfo, dst.data(), dstInfo, DEGREES_90));
+    std::vector<uint8_t> expected = {
+        12, 8, 4, 0, 13, 9, 5, 1, 14, 10, 6, 2, 15, 11, 7, 3,
+        110, 111, 100, 101, 112, 113, 102, 103,
+    };
+    EXPECT_EQ(dst, expected);
+    EXPECT_EQ(dstInfo.width, IMAGE_SIZE);
+    EXPECT_EQ(dstInfo.height, IMAGE_SIZE);
+}
+
+/**
+ * @tc.name: YuvRotate180Test001
+ * @tc.desc: Rotate NV12 by 180 degrees, equals flipping both axes
+ * @tc.type: FUNC
+ */
+HWTEST_F(PixelYuvUtilsTest, YuvRotate180Test001, TestSize.Level3)
+{
+    std::vector<uint8_t> src;
+    YuvImageInfo srcInfo = MakeNV12Image(src);
+    std::vector<uint8_t> dst(src.size(), 0);
+    YuvImageInfo dstInfo;
+    ASSERT_TRUE(PixelYuvUtils::YuvRotate(src.data(), srcInfo, dst.data(), dstInfo, DEGREES_180));
+    std::vector<uint8_t> expected = {
+        15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0,
+        112, 113, 110, 111, 102, 103, 100, 101,
+    };
+    EXPECT_EQ(dst, expected);
+}
+
+/**
+ * @tc.name: YuvFlipTest001
+ * @tc.desc: Mirror NV21 horizontally, the chroma pair order is kept
+ * @tc.type: FUNC
+ */
+HWTEST_F(PixelYuvUtilsTest, YuvFlipTest001, TestSize.Level3)
+{
+    std::vector<uint8_t> src;
+    YuvImageInfo srcInfo = MakeNV12Image(src);
+    srcInfo.format = AVPixelFormat::AV_PIX_FMT_NV21;
+    srcInfo.yuvFormat = PixelFormat::NV21;
+    std::vector<uint8_t> dst(src.size(), 0);
+    ASSERT_TRUE(PixelYuvUtils::YuvFlip(src.data(), srcInfo, dst.data(), true));
+    std::vector<uint8_t> expected = {
+        3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+        102, 103, 100, 101, 112, 113, 110, 111,
+    };
+    EXPECT_EQ(dst, expected);
+}
+
+/**
+ * @tc.name: YuvCropTest001
+ * @tc.desc: Crop the bottom right quarter of a P010 image
+ * @tc.type: FUNC
+ */
+HWTEST_F(PixelYuvUtilsTest, YuvCropTest001, TestSize.Level3)
+{
+    std::vector<uint16_t> src(IMAGE_SIZE * IMAGE_SIZE + IMAGE_SIZE * IMAGE_SIZE / 2);
+    for (size_t i = 0; i < src.size(); i++) {
+        src[i] = static_cast<uint16_t>(i << 6);
+    }
+    YuvImageInfo srcInfo;
+    srcInfo.format = AVPixelFormat::AV_PIX_FMT_P010LE;
+    srcInfo.yuvFormat = PixelFormat::YCBCR_P010;
+    srcInfo.width = IMAGE_SIZE;
+    srcInfo.height = IMAGE_SIZE;
+    srcInfo.yuvDataInfo.yStride = IMAGE_SIZE;
+    srcInfo.yuvDataInfo.uvStride = IMAGE_SIZE;
+    srcInfo.yuvDataInfo.uvOffset = IMAGE_SIZE * IMAGE_SIZE;
+    Rect rect = {2, 2, 2, 2};
+    YUVStrideInfo dstStrides = {2, 2, 0, 4};
+    std::vector<uint16_t> dst(6, 0);
+    ASSERT_TRUE(PixelYuvUtils::YuvCrop(reinterpret_cast<uint8_t *>(src.data()), srcInfo,
+        reinterpret_cast<uint8_t *>(dst.data()), rect, dstStrides));
+    std::vector<uint16_t> expected = {10 << 6, 11 << 6, 14 << 6, 15 << 6, 22 << 6, 23 << 6};
+    EXPECT_EQ(dst, expected);
+}
+
+/**
+ * @tc.name: YuvStridePaddingTest001
+ * @tc.desc: Flip and rotate a 2x2 NV12 image with stride 4, the destination padding is cleared
+ * @tc.type: FUNC
+ */
+HWTEST_F(PixelYuvUtilsTest, YuvStridePaddingTest001, TestSize.Level3)
+{
+    constexpr uint8_t pad = 0xEE;
+    constexpr uint8_t stale = 0xAA;
+    std::vector<uint8_t> src = {
+        0, 1, pad, pad, 2, 3, pad, pad,
+        100, 101, pad, pad,
+    };
+    YuvImageInfo srcInfo;
+    srcInfo.format = AVPixelFormat::AV_PIX_FMT_NV12;
+    srcInfo.yuvFormat = PixelFormat::NV12;
+    srcInfo.width = 2;
+    srcInfo.height = 2;
+    srcInfo.yuvDataInfo.yStride = IMAGE_SIZE;
+    srcInfo.yuvDataInfo.uvStride = IMAGE_SIZE;
+    srcInfo.yuvDataInfo.uvOffset = 8;
+
+    std::vector<uint8_t> flipped(src.size(), stale);
+    ASSERT_TRUE(PixelYuvUtils::YuvFlip(src.data(), srcInfo, flipped.data(), true));
+    std::vector<uint8_t> expectedFlip = {
+        1, 0, 0, 0, 3, 2, 0, 0,
+        100, 101, 0, 0,
+    };
+    EXPECT_EQ(flipped, expectedFlip);
+
+    std::vector<uint8_t> rotated(src.size(), stale);
+    YuvImageInfo dstInfo;
+    ASSERT_TRUE(PixelYuvUtils::YuvRotate(src.data(), srcInfo, rotated.data(), dstInfo, DEGREES_90));
+    std::vector<uint8_t> expectedRotate = {
+        2, 0, 3, 1, 0, 0, 0, 0,
+        100, 101, 0, 0,
+    };
+    EXPECT_EQ(rotated, expectedRotate);
+}
+
+// Semi-planar frame with stride == width filled with a byte pattern that has no period of 8 or 32.
+static YuvImageInfo MakeSemiPlanarImage(AVPixelFormat format, int32_t width, int32_t height,
+    std::vector<uint8_t> &data)
+{
+    int32_t pixelBytes = format == AVPixelFormat::AV_PIX_FMT_P010LE ? 2 : 1;
+    data.resize(static_cast<size_t>(width) * height * pixelBytes * 3 / 2);
+    for (size_t i = 0; i < data.size(); i++) {
+        data[i] = static_cast<uint8_t>((i * 37 + i / 251) & 0xFF);
+    }
+    YuvImageInfo info;
+    info.format = format;
+    info.width = width;
+    info.height = height;
+    info.yuvDataInfo.yStride = static_cast<uint32_t>(width);
+    info.yuvDataInfo.uvStride = static_cast<uint32_t>(width);
+    info.yuvDataInfo.yOffset = 0;
+    info.yuvDataInfo.uvOffset = static_cast<uint32_t>(width * height);
+    return info;
+}
+
+// Element by element rotation of both planes, a chroma element being one interleaved pair.
+static std::vector<uint8_t> RotateReference(const std::vector<uint8_t> &src, int32_t width, int32_t height,
+    int32_t pixelBytes, bool clockwise)
+{
+    std::vector<uint8_t> dst(src.size(), 0);
+    struct Plane {
+        size_t offset;
+        int32_t cols;
+        int32_t rows;
+        int32_t elementBytes;
+    };
+    const Plane planes[] = {
+        {0, width, height, pixelBytes},
+        {static_cast<size_t>(width) * height * pixelBytes, width / 2, height / 2, pixelBytes * 2},
+    };
+    for (const Plane &plane : planes) {
+        for (int32_t row = 0; row < plane.rows; row++) {
+            for (int32_t col = 0; col < plane.cols; col++) {
+                int32_t dstRow = clockwise ? col : plane.cols - 1 - col;
+                int32_t dstCol = clockwise ? plane.rows - 1 - row : row;
+                size_t srcIndex = plane.offset + (static_cast<size_t>(row) * plane.cols + col) * plane.elementBytes;
+                size_t dstIndex = plane.offset +
+                    (static_cast<size_t>(dstRow) * plane.rows + dstCol) * plane.elementBytes;
+                memcpy(dst.data() + dstIndex, src.data() + srcIndex, plane.elementBytes);
+            }
+        }
+    }
+    return dst;
+}
+
+// Rotates with the 8x8 block kernels plus their scalar tails and compares with the element wise reference.
+static void CheckRotateMatchesReference(AVPixelFormat format, int32_t width, int32_t height)
+{
+    int32_t pixelBytes = format == AVPixelFormat::AV_PIX_FMT_P010LE ? 2 : 1;
+    std::vector<uint8_t> src;
+    YuvImageInfo srcInfo = MakeSemiPlanarImage(format, width, height, src);
+    for (int32_t degrees : {DEGREES_90, DEGREES_270}) {
+        std::vector<uint8_t> dst(src.size(), 0xAA);
+        YuvImageInfo dstInfo;
+        ASSERT_TRUE(PixelYuvUtils::YuvRotate(src.data(), srcInfo, dst.data(), dstInfo, degrees));
+        EXPECT_EQ(dstInfo.width, height);
+        EXPECT_EQ(dstInfo.height, width);
+        EXPECT_EQ(dst, RotateReference(src, width, height, pixelBytes, degrees == DEGREES_90))
+            << "format " << static_cast<int32_t>(format) << " size " << width << "x" << height <<
+            " degrees " << degrees;
+    }
+}
+
+/**
+ * @tc.name: YuvRotateBlockTest001
+ * @tc.desc: Rotate NV12, NV21 and P010 images larger than one 8x8 block, with and without partial blocks,
+ *           and compare with an element wise rotation byte for byte
+ * @tc.type: FUNC
+ */
+HWTEST_F(PixelYuvUtilsTest, YuvRotateBlockTest001, TestSize.Level3)
+{
+    // 40x24 fills whole blocks in luma and leaves 4 element tails in chroma, 42x26 leaves tails in both planes
+    const Size sizes[] = {{40, 24}, {42, 26}, {8, 8}};
+    for (AVPixelFormat format : {AVPixelFormat::AV_PIX_FMT_NV12, AVPixelFormat::AV_PIX_FMT_NV21,
+        AVPixelFormat::AV_PIX_FMT_P010LE}) {
+        for (const Size &size : sizes) {
+            CheckRotateMatchesReference(format, size.width, size.height);
+        }
+    }
+}
+} // namespace Media
+} // namespace OHOS
@@ -13,6 +13,8 @@
  * limitations under the License.
  */
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdlib>
 #include "gif_encoder.h"
 #include "image_source.h"
 #include "buffer_packer_stream.h"
@@ -49,6 +51,9 @@ constexpr int32_t FLUSH_OUTPUT_CODE = 4096;
 constexpr int32_t COLOR_SUBDIVMAP_SIZE = 256;
 constexpr int32_t COLOR_PIXEL_NUM = 100;
 constexpr int32_t COLOR_NUM = 1;
+// Per channel bounds for the 256 color gradient below, dithering trades a larger single pixel error for texture
+constexpr double MAX_DITHER_MEAN_ERROR = 12.0;
+constexpr int32_t MAX_DITHER_PIXEL_ERROR = 80;
 class GifEncoderTest : public testing::Test {
 public:
     GifEncoderTest() {}
@@ -455,5 +460,176 @@ HWTEST_F(GifEncoderTest, LZWBufferOutputSecondByteTest001, TestSize.Level3)
     ASSERT_EQ(ret, SUCCESS);
     GTEST_LOG_(INFO) << "GifEncoderTest: LZWBufferOutputSecondByteTest001 end";
 }
+
+/**
+ * @tc.name: PlanFrameRectTest001
+ * @tc.desc: Only the changed bounding box of a frame is written when the previous frame is kept
+ * @tc.type: FUNC
+ */
+HWTEST_F(GifEncoderTest, PlanFrameRectTest001, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "GifEncoderTest: PlanFrameRectTest001 start";
+    auto gifEncoder = std::make_shared<GifEncoder>();
+    ASSERT_NE(gifEncoder, nullptr);
+    GifFrame previous;
+    previous.width = WIDTH;
+    previous.height = HEIGHT;
+    previous.argb.assign(WIDTH * HEIGHT, 0xFF00FF00);
+    GifFrame frame = previous;
+    frame.argb[3 * WIDTH + 2] = 0xFFFF0000;
+    frame.argb[5 * WIDTH + 6] = 0xFFFF0000;
+    gifEncoder->PlanFrameRect(1, previous, frame);
+    ASSERT_TRUE(frame.isDelta);
+    ASSERT_EQ(frame.left, 2);
+    ASSERT_EQ(frame.top, 3);
+    ASSERT_EQ(frame.rectWidth, 5);
+    ASSERT_EQ(frame.rectHeight, 3);
+
+    GifFrame disposed = previous;
+    disposed.argb[0] = 0xFFFF0000;
+    gifEncoder->encodeOpts_.disposalTypes = {2, 1};
+    gifEncoder->PlanFrameRect(1, previous, disposed);
+    ASSERT_FALSE(disposed.isDelta);
+    GTEST_LOG_(INFO) << "GifEncoderTest: PlanFrameRectTest001 end";
+}
+
+/**
+ * @tc.name: FinalizeEncodeFrameDiffTest001
+ * @tc.desc: Frames that barely change are written as small deltas on the global color table
+ * @tc.type: FUNC
+ */
+HWTEST_F(GifEncoderTest, FinalizeEncodeFrameDiffTest001, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "GifEncoderTest: FinalizeEncodeFrameDiffTest001 start";
+    auto gifEncoder = std::make_shared<GifEncoder>();
+    ASSERT_NE(gifEncoder, nullptr);
+    PlEncodeOptions plOpts;
+    auto outputData = std::make_unique<uint8_t[]>(OUTPUT_DATA_LENGTH * ENCODE_BUFFER_10);
+    auto stream = std::make_shared<BufferPackerStream>(outputData.get(), OUTPUT_DATA_LENGTH * ENCODE_BUFFER_10);
+    ASSERT_EQ(gifEncoder->StartEncode(*stream.get(), plOpts), SUCCESS);
+
+    Media::InitializationOptions opts;
+    opts.size.width = TEST_WIDTH_20x20;
+    opts.size.height = TEST_HEIGHT_20x20;
+    opts.pixelFormat = PixelFormat::BGRA_8888;
+    opts.alphaType = AlphaType::IMAGE_ALPHA_TYPE_OPAQUE;
+    std::vector<uint32_t> colors(TEST_WIDTH_20x20 * TEST_HEIGHT_20x20, 0xFF808080);
+    auto frame1 = Media::PixelMap::Create(colors.data(), colors.size(), opts);
+    colors[TEST_WIDTH_20x20 + 1] = 0xFF818181;
+    auto frame2 = Media::PixelMap::Create(colors.data(), colors.size(), opts);
+    ASSERT_NE(frame1, nullptr);
+    ASSERT_NE(frame2, nullptr);
+    ASSERT_EQ(gifEncoder->AddImage(*frame1.get()), SUCCESS);
+    ASSERT_EQ(gifEncoder->AddImage(*frame2.get()), SUCCESS);
+    ASSERT_EQ(gifEncoder->FinalizeEncode(), SUCCESS);
+
+    uint32_t errorCode = 0;
+    SourceOptions sourceOpts;
+    auto imageSource = ImageSource::CreateImageSource(outputData.get(), stream->BytesWritten(), sourceOpts,
+        errorCode);
+    ASSERT_NE(imageSource, nullptr);
+    ASSERT_EQ(imageSource->GetFrameCount(errorCode), 2u);
+    GTEST_LOG_(INFO) << "GifEncoderTest: FinalizeEncodeFrameDiffTest001 end";
+}
+
+// Mean and largest per channel difference between a decoded RGBA frame and the ARGB colors it was encoded from.
+static void GetDecodeError(PixelMap &decoded, const std::vector<uint32_t> &colors, double &meanError,
+    int32_t &maxError)
+{
+    constexpr int32_t rgbaBytes = 4;
+    const uint8_t *pixels = decoded.GetPixels();
+    double total = 0;
+    maxError = 0;
+    for (int32_t y = 0; y < decoded.GetHeight(); y++) {
+        const uint8_t *row = pixels + y * decoded.GetRowStride();
+        for (int32_t x = 0; x < decoded.GetWidth(); x++) {
+            uint32_t color = colors[y * decoded.GetWidth() + x];
+            const int32_t source[] = {static_cast<int32_t>((color >> 16) & 0xFF),
+                static_cast<int32_t>((color >> 8) & 0xFF), static_cast<int32_t>(color & 0xFF)};
+            for (int32_t c = 0; c < 3; c++) {
+                int32_t error = std::abs(row[x * rgbaBytes + c] - source[c]);
+                total += error;
+                maxError = std::max(maxError, error);
+            }
+        }
+    }
+    meanError = total / (3.0 * decoded.GetWidth() * decoded.GetHeight());
+}
+
+/**
+ * @tc.name: FinalizeEncodeDitherTest001
+ * @tc.desc: Ordered and Floyd-Steinberg dithering map a gradient to other indices than the undithered
+ *           median-cut mapping, and the encoded gif still decodes close to the source colors
+ * @tc.type: FUNC
+ */
+HWTEST_F(GifEncoderTest, FinalizeEncodeDitherTest001, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "GifEncoderTest: FinalizeEncodeDitherTest001 start";
+    Media::InitializationOptions opts;
+    opts.size.width = LARGE_WIDTH;
+    opts.size.height = LARGE_HEIGHT;
+    opts.pixelFormat = PixelFormat::BGRA_8888;
+    opts.alphaType = AlphaType::IMAGE_ALPHA_TYPE_OPAQUE;
+    std::vector<uint32_t> colors(LARGE_WIDTH * LARGE_HEIGHT);
+    for (int32_t y = 0; y < LARGE_HEIGHT; y++) {
+        for (int32_t x = 0; x < LARGE_WIDTH; x++) {
+            colors[y * LARGE_WIDTH + x] = 0xFF000000 | ((x * 0xFF / LARGE_WIDTH) << 16) |
+                ((y * 0xFF / LARGE_HEIGHT) << 8) | ((x + y) & 0xFF);
+        }
+    }
+    auto pixelMap = Media::PixelMap::Create(colors.data(), colors.size(), opts);
+    ASSERT_NE(pixelMap, nullptr);
+    GifFrame source;
+    source.width = LARGE_WIDTH;
+    source.height = LARGE_HEIGHT;
+    source.rectWidth = LARGE_WIDTH;
+    source.rectHeight = LARGE_HEIGHT;
+    source.argb = colors;
+
+    std::vector<uint8_t> undithered;
+    for (auto ditherType : {DitherType::NONE, DitherType::ORDERED, DitherType::FLOYD_STEINBERG}) {
+        auto gifEncoder = std::make_shared<GifEncoder>();
+        gifEncoder->encodeOpts_.ditherType = ditherType;
+        GifFrame frame = source;
+        ASSERT_EQ(gifEncoder->QuantizeFrame(0, nullptr, frame), SUCCESS);
+        ASSERT_EQ(frame.indices.size(), colors.size());
+        if (ditherType == DitherType::NONE) {
+            undithered = frame.indices;
+        } else {
+            size_t changed = 0;
+            for (size_t i = 0; i < colors.size(); i++) {
+                changed += (frame.indices[i] != undithered[i]) ? 1 : 0;
+            }
+            // The palette is the same, dithering spreads the gradient over neighbouring entries
+            EXPECT_GT(changed, colors.size() / 4);
+        }
+
+        gifEncoder = std::make_shared<GifEncoder>();
+        PlEncodeOptions plOpts;
+        plOpts.ditherType = ditherType;
+        auto outputData = std::make_unique<uint8_t[]>(LARGE_DATA_LENGTH * ENCODE_BUFFER_10);
+        auto stream = std::make_shared<BufferPackerStream>(outputData.get(), LARGE_DATA_LENGTH * ENCODE_BUFFER_10);
+        ASSERT_EQ(gifEncoder->StartEncode(*stream.get(), plOpts), SUCCESS);
+        ASSERT_EQ(gifEncoder->AddImage(*pixelMap.get()), SUCCESS);
+        ASSERT_EQ(gifEncoder->FinalizeEncode(), SUCCESS);
+
+        uint32_t errorCode = 0;
+        SourceOptions sourceOpts;
+        auto imageSource = ImageSource::CreateImageSource(outputData.get(), stream->BytesWritten(), sourceOpts,
+            errorCode);
+        ASSERT_NE(imageSource, nullptr);
+        DecodeOptions decodeOpts;
+        decodeOpts.desiredPixelFormat = PixelFormat::RGBA_8888;
+        auto decoded = imageSource->CreatePixelMap(0, decodeOpts, errorCode);
+        ASSERT_EQ(errorCode, SUCCESS);
+        ASSERT_NE(decoded, nullptr);
+        double meanError = 0;
+        int32_t maxError = 0;
+        GetDecodeError(*decoded, colors, meanError, maxError);
+        EXPECT_LT(meanError, MAX_DITHER_MEAN_ERROR) << "dither type " << static_cast<int32_t>(ditherType);
+        EXPECT_LT(maxError, MAX_DITHER_PIXEL_ERROR) << "dither type " << static_cast<int32_t>(ditherType);
+    }
+    GTEST_LOG_(INFO) << "GifEncoderTest: FinalizeEncodeDitherTest001 end";
+}
 }
 }
\ No newline at end of file
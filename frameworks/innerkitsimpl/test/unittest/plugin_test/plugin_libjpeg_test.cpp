@@ -12,6 +12,7 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include <cstring>
 #include <gtest/gtest.h>
 #define IMAGE_COLORSPACE_FLAG
 #define private public
@@ -19,6 +20,8 @@
 #include <fcntl.h>
 #include "buffer_packer_stream.h"
 #include "buffer_source_stream.h"
+#include "image_source.h"
+#include "image_task_scheduler.h"
 #include "plugin_export.h"
 #include "icc_profile_info.h"
 #include "jpeg_decoder.h"
@@ -48,13 +51,53 @@ static constexpr uint32_t TEST_IMAGE_WIDTH_LARGE = 32;
 static constexpr uint32_t TEST_IMAGE_HEIGHT_LARGE = 32;
 static constexpr uint32_t TEST_BUFFER_SIZE_SMALL = NUM_1000;
 static constexpr uint32_t TEST_BUFFER_SIZE_LARGE = NUM_1000 * 10;
+static constexpr uint32_t TEST_IMAGE_SIZE_BANDED = 2048;
+static constexpr uint32_t TEST_BUFFER_SIZE_BANDED = NUM_1000 * NUM_1000 * 4;
+static constexpr uint8_t JPEG_MARKER_PREFIX = 0xFF;
+static constexpr uint8_t JPEG_MARKER_DRI = 0xDD;
 
 class PluginLibJpegTest : public testing::Test {
 public:
     PluginLibJpegTest() {}
     ~PluginLibJpegTest() {}
     void FinalizeEncodeTest(PixelFormat format);
+    std::unique_ptr<PixelMap> EncodeAndDecode(PixelMap &pixelMap, bool bandEncodeEnabled, bool &hasRestartInterval);
 };
+
+std::unique_ptr<PixelMap> PluginLibJpegTest::EncodeAndDecode(PixelMap &pixelMap, bool bandEncodeEnabled,
+    bool &hasRestartInterval)
+{
+    auto jpegEncoder = std::make_shared<JpegEncoder>();
+    jpegEncoder->bandEncodeEnabled_ = bandEncodeEnabled;
+    PlEncodeOptions plOpts;
+    plOpts.quality = 90; // 90 keeps the quantization error small enough for a close comparison
+    auto outputData = std::make_unique<uint8_t[]>(TEST_BUFFER_SIZE_BANDED);
+    auto stream = std::make_shared<BufferPackerStream>(outputData.get(), TEST_BUFFER_SIZE_BANDED);
+    jpegEncoder->StartEncode(*(stream.get()), plOpts);
+    if (jpegEncoder->AddImage(pixelMap) != SUCCESS || jpegEncoder->FinalizeEncode() != SUCCESS) {
+        return nullptr;
+    }
+    // stuffed 0xFF bytes of the entropy coded data are followed by 0x00, so 0xFFDD can only be the DRI segment
+    // that the band encoder adds
+    hasRestartInterval = false;
+    for (int64_t i = 0; i + 1 < stream->BytesWritten(); i++) {
+        if (outputData[i] == JPEG_MARKER_PREFIX && outputData[i + 1] == JPEG_MARKER_DRI) {
+            hasRestartInterval = true;
+            break;
+        }
+    }
+    uint32_t errorCode = 0;
+    SourceOptions sourceOpts;
+    auto imageSource = ImageSource::CreateImageSource(outputData.get(), stream->BytesWritten(), sourceOpts,
+        errorCode);
+    if (imageSource == nullptr) {
+        return nullptr;
+    }
+    DecodeOptions decodeOpts;
+    decodeOpts.desiredPixelFormat = PixelFormat::RGBA_8888;
+    auto decoded = imageSource->CreatePixelMap(decodeOpts, errorCode);
+    return errorCode == SUCCESS ? std::move(decoded) : nullptr;
+}
 void PluginLibJpegTest::FinalizeEncodeTest(PixelFormat format)
 {
     uint32_t errorCode = 0;
@@ -385,5 +428,56 @@ HWTEST_F(PluginLibJpegTest, BranchCoverage004, TestSize.Level3)
     ASSERT_EQ(errorCode, SUCCESS);
     GTEST_LOG_(INFO) << "PluginLibJpegTest: BranchCoverage004 end";
 }
+
+/**
+ * @tc.name: PluginLibJpegTest_BandEncode001
+ * @tc.desc: Test an image encoded in restart interval bands decodes to exactly the same pixels as a single pass
+ *           encode, the bands only reset the DC prediction and leave every quantized coefficient unchanged
+ * @tc.type: FUNC
+ */
+HWTEST_F(PluginLibJpegTest, BandEncode001, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "PluginLibJpegTest: BandEncode001 start";
+    if (ImageTaskScheduler::GetWorkerCount() <= 1) {
+        GTEST_SKIP() << "band encoding needs more than one worker";
+    }
+    Media::InitializationOptions opts;
+    opts.pixelFormat = PixelFormat::RGBA_8888;
+    opts.size.width = TEST_IMAGE_SIZE_BANDED;
+    opts.size.height = TEST_IMAGE_SIZE_BANDED;
+    opts.editable = true;
+    auto pixelMap = Media::PixelMap::Create(opts);
+    ASSERT_NE(pixelMap.get(), nullptr);
+    // smooth gradients that differ per channel, so every band carries different content
+    uint8_t *pixels = static_cast<uint8_t *>(pixelMap->GetWritablePixels());
+    ASSERT_NE(pixels, nullptr);
+    for (uint32_t y = 0; y < TEST_IMAGE_SIZE_BANDED; y++) {
+        uint8_t *row = pixels + static_cast<size_t>(y) * pixelMap->GetRowStride();
+        for (uint32_t x = 0; x < TEST_IMAGE_SIZE_BANDED; x++) {
+            row[x * COMPONENT_NUM_RGBA] = static_cast<uint8_t>(x / 8); // 8: 2048 columns span 0..255
+            row[x * COMPONENT_NUM_RGBA + 1] = static_cast<uint8_t>(y / 8); // 8: 2048 rows span 0..255
+            row[x * COMPONENT_NUM_RGBA + 2] = static_cast<uint8_t>((x + y) / 16); // 2, 16: diagonal blue ramp
+            row[x * COMPONENT_NUM_RGBA + 3] = UINT8_MAX; // 3: opaque alpha
+        }
+    }
+
+    bool bandedRestart = false;
+    bool singleRestart = true;
+    auto banded = EncodeAndDecode(*pixelMap, true, bandedRestart);
+    auto single = EncodeAndDecode(*pixelMap, false, singleRestart);
+    ASSERT_NE(banded, nullptr);
+    ASSERT_NE(single, nullptr);
+    ASSERT_TRUE(bandedRestart);
+    ASSERT_FALSE(singleRestart);
+    ASSERT_EQ(banded->GetWidth(), static_cast<int32_t>(TEST_IMAGE_SIZE_BANDED));
+    ASSERT_EQ(banded->GetHeight(), static_cast<int32_t>(TEST_IMAGE_SIZE_BANDED));
+    ASSERT_EQ(single->GetByteCount(), banded->GetByteCount());
+    const uint8_t *bandedPixels = banded->GetPixels();
+    const uint8_t *singlePixels = single->GetPixels();
+    ASSERT_NE(bandedPixels, nullptr);
+    ASSERT_NE(singlePixels, nullptr);
+    EXPECT_EQ(memcmp(bandedPixels, singlePixels, banded->GetByteCount()), 0);
+    GTEST_LOG_(INFO) << "PluginLibJpegTest: BandEncode001 end";
+}
 } // namespace Multimedia
 } // namespace OHOS
\ No newline at end of file
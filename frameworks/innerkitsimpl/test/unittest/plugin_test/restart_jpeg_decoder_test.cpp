@@ -0,0 +1,136 @@
+/*
+ * Copyright (C) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <vector>
+#include "bandjpeg/restart_jpeg_decoder.h"
+#include "image_task_scheduler.h"
+#include "include/codec/SkCodec.h"
+#include "SkData.h"
+#include "jpeglib.h"
+#include "media_errors.h"
+
+using namespace testing::ext;
+using namespace OHOS::Media;
+namespace OHOS {
+namespace ImagePlugin {
+static constexpr uint32_t TEST_IMAGE_WIDTH = 509;
+static constexpr uint32_t TEST_IMAGE_HEIGHT = 387;
+static constexpr int TEST_RGB_COMPONENTS = 3;
+static constexpr int TEST_RGBA_COMPONENTS = 4;
+static constexpr int TEST_QUALITY = 90;
+
+class RestartJpegDecoderTest : public testing::Test {
+public:
+    RestartJpegDecoderTest() {}
+    ~RestartJpegDecoderTest() {}
+};
+
+// Baseline 4:2:0 JPEG with a restart marker after every MCU row, sizes deliberately off the MCU grid.
+static std::vector<uint8_t> EncodeRestartJpeg(uint32_t width, uint32_t height)
+{
+    std::vector<uint8_t> rgb(static_cast<size_t>(width) * height * TEST_RGB_COMPONENTS);
+    for (uint32_t y = 0; y < height; y++) {
+        for (uint32_t x = 0; x < width; x++) {
+            uint8_t *pixel = rgb.data() + (static_cast<size_t>(y) * width + x) * TEST_RGB_COMPONENTS;
+            pixel[0] = static_cast<uint8_t>(x);
+            pixel[1] = static_cast<uint8_t>(y * 2); // 2: steeper green ramp
+            pixel[2] = static_cast<uint8_t>((x * y) >> 6); // 2, 6: curved blue pattern
+        }
+    }
+    jpeg_compress_struct cinfo;
+    jpeg_error_mgr jerr;
+    cinfo.err = jpeg_std_error(&jerr);
+    jpeg_create_compress(&cinfo);
+    unsigned char *buffer = nullptr;
+    unsigned long size = 0;
+    jpeg_mem_dest(&cinfo, &buffer, &size);
+    cinfo.image_width = width;
+    cinfo.image_height = height;
+    cinfo.input_components = TEST_RGB_COMPONENTS;
+    cinfo.in_color_space = JCS_RGB;
+    jpeg_set_defaults(&cinfo);
+    jpeg_set_quality(&cinfo, TEST_QUALITY, TRUE);
+    cinfo.restart_in_rows = 1;
+    jpeg_start_compress(&cinfo, TRUE);
+    while (cinfo.next_scanline < cinfo.image_height) {
+        JSAMPROW row = rgb.data() + static_cast<size_t>(cinfo.next_scanline) * width * TEST_RGB_COMPONENTS;
+        jpeg_write_scanlines(&cinfo, &row, 1);
+    }
+    jpeg_finish_compress(&cinfo);
+    jpeg_destroy_compress(&cinfo);
+    std::vector<uint8_t> jpeg(buffer, buffer + size);
+    free(buffer);
+    return jpeg;
+}
+
+/**
+ * @tc.name: RestartJpegDecoderTest001
+ * @tc.desc: A baseline JPEG with DRI and RST markers decodes in bands to the same pixels as the Skia decode
+ * @tc.type: FUNC
+ */
+HWTEST_F(RestartJpegDecoderTest, RestartJpegDecoderTest001, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "RestartJpegDecoderTest: RestartJpegDecoderTest001 start";
+    std::vector<uint8_t> jpeg = EncodeRestartJpeg(TEST_IMAGE_WIDTH, TEST_IMAGE_HEIGHT);
+    ASSERT_FALSE(jpeg.empty());
+
+    auto codec = SkCodec::MakeFromData(SkData::MakeWithoutCopy(jpeg.data(), jpeg.size()));
+    ASSERT_NE(codec, nullptr);
+    SkImageInfo info = SkImageInfo::Make(TEST_IMAGE_WIDTH, TEST_IMAGE_HEIGHT, kRGBA_8888_SkColorType,
+        kUnpremul_SkAlphaType);
+    size_t stride = static_cast<size_t>(TEST_IMAGE_WIDTH) * TEST_RGBA_COMPONENTS;
+    std::vector<uint8_t> expected(stride * TEST_IMAGE_HEIGHT, 0);
+    ASSERT_EQ(codec->getPixels(info, expected.data(), stride), SkCodec::kSuccess);
+
+    std::vector<uint8_t> banded(stride * TEST_IMAGE_HEIGHT, 0);
+    uint32_t ret = RestartJpegDecoder::Decode(jpeg.data(), jpeg.size(), PixelFormat::RGBA_8888, banded.data(), stride);
+    // the decoder sizes its bands by the scheduler, which may have fewer workers than the device has cores
+    if (ImageTaskScheduler::GetWorkerCount() <= 1) {
+        ASSERT_EQ(ret, ERR_IMAGE_DATA_UNSUPPORT);
+        GTEST_LOG_(INFO) << "RestartJpegDecoderTest: RestartJpegDecoderTest001 single worker, skip compare";
+        return;
+    }
+    ASSERT_EQ(ret, SUCCESS);
+    EXPECT_EQ(banded, expected);
+    GTEST_LOG_(INFO) << "RestartJpegDecoderTest: RestartJpegDecoderTest001 end";
+}
+
+/**
+ * @tc.name: RestartJpegDecoderTest002
+ * @tc.desc: A JPEG without restart markers is left to the sequential decoder
+ * @tc.type: FUNC
+ */
+HWTEST_F(RestartJpegDecoderTest, RestartJpegDecoderTest002, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "RestartJpegDecoderTest: RestartJpegDecoderTest002 start";
+    std::vector<uint8_t> jpeg = EncodeRestartJpeg(TEST_IMAGE_WIDTH, TEST_IMAGE_HEIGHT);
+    ASSERT_FALSE(jpeg.empty());
+    // Drop the DRI segment, the intervals are then no longer addressable
+    for (size_t i = 0; i + 1 < jpeg.size(); i++) {
+        if (jpeg[i] == 0xFF && jpeg[i + 1] == 0xDD) {
+            jpeg[i + 1] = 0xFE; // 0xFE: turn DRI into a comment segment of the same length
+            break;
+        }
+    }
+    size_t stride = static_cast<size_t>(TEST_IMAGE_WIDTH) * TEST_RGBA_COMPONENTS;
+    std::vector<uint8_t> banded(stride * TEST_IMAGE_HEIGHT, 0);
+    ASSERT_EQ(RestartJpegDecoder::Decode(jpeg.data(), jpeg.size(), PixelFormat::RGBA_8888, banded.data(), stride),
+        ERR_IMAGE_DATA_UNSUPPORT);
+    GTEST_LOG_(INFO) << "RestartJpegDecoderTest: RestartJpegDecoderTest002 end";
+}
+} // namespace ImagePlugin
+} // namespace OHOS
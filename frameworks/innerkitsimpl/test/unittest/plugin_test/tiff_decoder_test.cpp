@@ -14,6 +14,7 @@
  */
 
 #include <gtest/gtest.h>
+#include <cstring>
 #include "image_source.h"
 #include "image_log.h"
 #include "tiff_decoder.h"
@@ -644,5 +645,49 @@ HWTEST_F(TiffDecoderTest, AllocDmaBufferTest001, TestSize.Level3)
     EXPECT_FALSE(ret);
     GTEST_LOG_(INFO) << "TiffDecoderTest: AllocDmaBufferTest001 end";
 }
+
+/**
+ * @tc.name: DecodeDirectTest001
+ * @tc.desc: Test strip and tile decoding gives the same pixels as the RGBA interface, inside the crop region too
+ * @tc.type: FUNC
+ */
+HWTEST_F(TiffDecoderTest, DecodeDirectTest001, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "TiffDecoderTest: DecodeDirectTest001 start";
+    std::unique_ptr<FileSourceStream> fileSourceStream = FileSourceStream::CreateSourceStream(IMAGE_TIFF_NO_ICC_PATH);
+    ASSERT_NE(fileSourceStream, nullptr);
+    TiffDecoder decoder;
+    decoder.SetSource(*fileSourceStream.get());
+    ASSERT_NE(decoder.tifCodec_, nullptr);
+    PlImageInfo info;
+    ASSERT_EQ(decoder.SetDecodeOptions(0, PixelDecodeOptions(), info), SUCCESS);
+
+    DecodeContext expected;
+    size_t byteCount = static_cast<size_t>(info.size.width) * info.size.height * sizeof(uint32_t);
+    ASSERT_TRUE(decoder.AllocHeapBuffer(expected, byteCount));
+    ASSERT_EQ(decoder.DecodeRGBAImage(expected, byteCount), SUCCESS);
+
+    DecodeContext actual;
+    ASSERT_EQ(decoder.Decode(0, actual), SUCCESS);
+    ASSERT_EQ(memcmp(actual.pixelsBuffer.buffer, expected.pixelsBuffer.buffer, byteCount), 0);
+    FreeContext(actual);
+
+    PixelDecodeOptions cropOpts;
+    cropOpts.CropRect = { info.size.width / MOCK_INDEX, info.size.height / MOCK_INDEX,
+        info.size.width / MOCK_INDEX, info.size.height / MOCK_INDEX };
+    ASSERT_EQ(decoder.SetDecodeOptions(0, cropOpts, info), SUCCESS);
+    DecodeContext cropped;
+    ASSERT_EQ(decoder.Decode(0, cropped), SUCCESS);
+    const Rect &crop = cropOpts.CropRect;
+    size_t rowBytes = static_cast<size_t>(info.size.width) * sizeof(uint32_t);
+    for (int32_t row = crop.top; row < crop.top + crop.height; row++) {
+        size_t offset = row * rowBytes + crop.left * sizeof(uint32_t);
+        ASSERT_EQ(memcmp(static_cast<uint8_t *>(cropped.pixelsBuffer.buffer) + offset,
+            static_cast<uint8_t *>(expected.pixelsBuffer.buffer) + offset, crop.width * sizeof(uint32_t)), 0);
+    }
+    FreeContext(cropped);
+    FreeContext(expected);
+    GTEST_LOG_(INFO) << "TiffDecoderTest: DecodeDirectTest001 end";
+}
 } //ImagePlugin
 } //OHOS
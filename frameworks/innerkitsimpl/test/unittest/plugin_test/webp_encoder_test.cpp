@@ -1006,5 +1006,85 @@ HWTEST_F(WebpEncoderTest, DoTransformGrayTest001, TestSize.Level3)
     delete pixelMap.data_;
     GTEST_LOG_(INFO) << "WebpEncoderTest: DoTransformGrayTest001 end";
 }
+
+// Decodes one frame of an encoded image and compares every pixel with the RGBA colors it was made from.
+static void ExpectFramePixels(ImageSource &imageSource, uint32_t index, const std::vector<uint32_t> &colors,
+    int32_t size)
+{
+    uint32_t errorCode = 0;
+    DecodeOptions decodeOpts;
+    decodeOpts.desiredPixelFormat = PixelFormat::RGBA_8888;
+    auto frame = imageSource.CreatePixelMap(index, decodeOpts, errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_NE(frame, nullptr);
+    ASSERT_EQ(frame->GetWidth(), size);
+    ASSERT_EQ(frame->GetHeight(), size);
+    const uint8_t *pixels = frame->GetPixels();
+    ASSERT_NE(pixels, nullptr);
+    for (int32_t y = 0; y < size; y++) {
+        const uint32_t *row = reinterpret_cast<const uint32_t *>(pixels + y * frame->GetRowStride());
+        for (int32_t x = 0; x < size; x++) {
+            ASSERT_EQ(row[x], colors[y * size + x]) << "frame " << index << " pixel " << x << "," << y;
+        }
+    }
+}
+
+/**
+ * @tc.name: FinalizeEncodeAnimationTest001
+ * @tc.desc: Several frames are muxed into one animated webp, unchanged frames are merged and a frame that
+ *           changes a small block is encoded as a sub-rectangle that decodes back to the full frame
+ * @tc.type: FUNC
+ */
+HWTEST_F(WebpEncoderTest, FinalizeEncodeAnimationTest001, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "WebpEncoderTest: FinalizeEncodeAnimationTest001 start";
+    constexpr int32_t size = 16;
+    constexpr uint32_t red = 0xFF0000FF;
+    constexpr uint32_t blue = 0xFFFF0000;
+    Media::InitializationOptions opts;
+    opts.size.width = size;
+    opts.size.height = size;
+    opts.pixelFormat = PixelFormat::RGBA_8888;
+    opts.alphaType = AlphaType::IMAGE_ALPHA_TYPE_UNPREMUL;
+    opts.editable = true;
+    std::vector<uint32_t> firstColors(size * size, red);
+    auto frame1 = Media::PixelMap::Create(firstColors.data(), firstColors.size(), opts);
+    auto frame2 = Media::PixelMap::Create(firstColors.data(), firstColors.size(), opts);
+    // A 3x2 block away from the origin, at an odd column so the frame offset has to snap to an even one
+    std::vector<uint32_t> lastColors = firstColors;
+    for (int32_t y = 7; y < 9; y++) {
+        for (int32_t x = 9; x < 12; x++) {
+            lastColors[y * size + x] = blue;
+        }
+    }
+    auto frame3 = Media::PixelMap::Create(lastColors.data(), lastColors.size(), opts);
+    ASSERT_NE(frame1, nullptr);
+    ASSERT_NE(frame2, nullptr);
+    ASSERT_NE(frame3, nullptr);
+
+    constexpr uint32_t maxSize = 4096;
+    auto outputData = std::make_unique<uint8_t[]>(maxSize);
+    auto stream = std::make_shared<BufferPackerStream>(outputData.get(), maxSize);
+    PlEncodeOptions plOpts;
+    plOpts.delayTimes = {10, 10, 10};
+    auto webpEncoder = std::make_shared<WebpEncoder>();
+    ASSERT_EQ(webpEncoder->StartEncode(*stream.get(), plOpts), SUCCESS);
+    ASSERT_EQ(webpEncoder->AddImage(*frame1.get()), SUCCESS);
+    ASSERT_EQ(webpEncoder->AddImage(*frame2.get()), SUCCESS);
+    ASSERT_EQ(webpEncoder->AddImage(*frame3.get()), SUCCESS);
+    ASSERT_EQ(webpEncoder->FinalizeEncode(), SUCCESS);
+
+    int64_t packedSize = stream->BytesWritten();
+    ASSERT_GT(packedSize, 0);
+    uint32_t errorCode = 0;
+    SourceOptions sourceOpts;
+    auto imageSource = ImageSource::CreateImageSource(outputData.get(), packedSize, sourceOpts, errorCode);
+    ASSERT_NE(imageSource, nullptr);
+    ASSERT_EQ(imageSource->GetFrameCount(errorCode), 2u);
+    // Frames are lossless, so the decoded canvas must match the source frames exactly
+    ExpectFramePixels(*imageSource, 0, firstColors, size);
+    ExpectFramePixels(*imageSource, 1, lastColors, size);
+    GTEST_LOG_(INFO) << "WebpEncoderTest: FinalizeEncodeAnimationTest001 end";
+}
+}
 }
-}
\ No newline at end of file
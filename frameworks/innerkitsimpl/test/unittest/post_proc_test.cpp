@@ -15,8 +15,11 @@
 #define private public
 #define protected public
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
 #include <fstream>
 #include <limits>
+#include <vector>
 
 #if !defined(CROSS_PLATFORM)
 #include "surface_type.h"
@@ -31,6 +34,7 @@
 #include "pixel_map.h"
 #include "post_proc.h"
 #include "post_proc_slr.h"
+#include "image_task_scheduler.h"
 #include "basic_transformer.h"
 
 using namespace testing::ext;
@@ -110,6 +114,67 @@ HWTEST_F(PostProcTest, SLRProcRejectsInvalidDestinationCapacity, TestSize.Level3
     EXPECT_FALSE(SLRProc::Serial(src, dst, weightX, weightY));
 }
 
+/**
+ * @tc.name: ImageTaskSchedulerCoversEveryRow
+ * @tc.desc: Every row is handed to exactly one band, cancelled runs start no band and report a skipped band.
+ * @tc.type: FUNC
+ */
+HWTEST_F(PostProcTest, ImageTaskSchedulerCoversEveryRow, TestSize.Level3)
+{
+    constexpr int32_t rows = 1000;
+    constexpr int64_t costPerRow = 4096;
+    std::vector<int32_t> hits(rows, 0);
+    bool ret = ImageTaskScheduler::ParallelForRows(rows, costPerRow, [&hits](int32_t rowStart, int32_t rowEnd) {
+        for (int32_t row = rowStart; row < rowEnd; row++) {
+            hits[row]++;
+        }
+    });
+    EXPECT_TRUE(ret);
+    EXPECT_TRUE(std::all_of(hits.begin(), hits.end(), [](int32_t hit) { return hit == 1; }));
+
+    std::atomic<bool> cancelled(true);
+    std::atomic<int32_t> bands(0);
+    ret = ImageTaskScheduler::ParallelForRows(rows, costPerRow, [&bands](int32_t, int32_t) { bands++; }, &cancelled);
+    EXPECT_FALSE(ret);
+    EXPECT_EQ(bands.load(), 0);
+
+    // a flag raised by the only band skips nothing, so the run is complete
+    std::atomic<bool> lateCancel(false);
+    ret = ImageTaskScheduler::ParallelForRows(rows, 1, [&lateCancel](int32_t, int32_t) { lateCancel = true; },
+        &lateCancel);
+    EXPECT_TRUE(ret);
+    EXPECT_FALSE(ImageTaskScheduler::ParallelForRows(rows, costPerRow, nullptr));
+}
+
+/**
+ * @tc.name: SLRProcParallelMatchesSerial
+ * @tc.desc: The banded parallel SLR produces the same pixels as the serial pass.
+ * @tc.type: FUNC
+ */
+HWTEST_F(PostProcTest, SLRProcParallelMatchesSerial, TestSize.Level3)
+{
+    constexpr Size srcSize = { 64, 48 };
+    constexpr Size dstSize = { 30, 20 };
+    std::vector<uint32_t> srcPixels(srcSize.width * srcSize.height);
+    for (size_t i = 0; i < srcPixels.size(); i++) {
+        srcPixels[i] = static_cast<uint32_t>(i * 2654435761u);
+    }
+    std::vector<uint32_t> serialPixels(dstSize.width * dstSize.height, 0);
+    std::vector<uint32_t> parallelPixels(dstSize.width * dstSize.height, 0);
+    SLRMat src(srcSize, PixelFormat::RGBA_8888, srcPixels.data(), srcSize.width,
+        srcPixels.size() * sizeof(uint32_t));
+    SLRMat serialDst(dstSize, PixelFormat::RGBA_8888, serialPixels.data(), dstSize.width,
+        serialPixels.size() * sizeof(uint32_t));
+    SLRMat parallelDst(dstSize, PixelFormat::RGBA_8888, parallelPixels.data(), dstSize.width,
+        parallelPixels.size() * sizeof(uint32_t));
+    auto weightX = SLRProc::GetWeights(static_cast<float>(dstSize.width) / srcSize.width, dstSize.width);
+    auto weightY = SLRProc::GetWeights(static_cast<float>(dstSize.height) / srcSize.height, dstSize.height);
+
+    ASSERT_TRUE(SLRProc::Serial(src, serialDst, weightX, weightY));
+    ASSERT_TRUE(SLRProc::Parallel(src, parallelDst, weightX, weightY));
+    EXPECT_EQ(serialPixels, parallelPixels);
+}
+
 /**
  * @tc.name: PostProcTest001
  * @tc.desc: test DecodePostProc
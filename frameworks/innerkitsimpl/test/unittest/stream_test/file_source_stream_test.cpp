@@ -15,6 +15,7 @@
 
 #include <gtest/gtest.h>
 #define private public
+#include <cstring>
 #include <fstream>
 #include <fcntl.h>
 #include <vector>
@@ -41,6 +42,8 @@ static constexpr size_t TEST_FILE_SIZE_PARTIAL_1 = 50;
 static constexpr uint32_t TEST_DESIRED_SIZE_PARTIAL = 100;
 static constexpr size_t TEST_FILE_SIZE_PARTIAL_2 = 30;
 static constexpr uint32_t TEST_BUFFER_SIZE_PARTIAL = 100;
+static constexpr size_t TEST_FILE_SIZE_MAPPED = 4096 * 3 + 17;
+static constexpr uint32_t TEST_READ_SIZE_MAPPED = 1000;
 class FileSourceStreamTest : public testing::Test {
 public:
     FileSourceStreamTest() {}
@@ -647,5 +650,81 @@ HWTEST_F(FileSourceStreamTest, FileSourceStreamTest0031, TestSize.Level3)
     unlink(testFile);
     GTEST_LOG_(INFO) << "FileSourceStreamTest: FileSourceStreamTest0031 end";
 }
+
+/**
+ * @tc.name: FileSourceStreamTest0032
+ * @tc.desc: Read and Peek return views into the read mapping that follow the stream position when mapped reads
+ *           are enabled
+ * @tc.type: FUNC
+ */
+HWTEST_F(FileSourceStreamTest, FileSourceStreamTest0032, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "FileSourceStreamTest: FileSourceStreamTest0032 start";
+
+    const char* testFile = "/data/local/tmp/image/test_mapped_read.dat";
+    std::vector<char> data(TEST_FILE_SIZE_MAPPED);
+    for (size_t i = 0; i < data.size(); i++) {
+        data[i] = static_cast<char>(i % UINT8_MAX);
+    }
+    std::ofstream ofs(testFile, std::ios::binary);
+    ofs.write(data.data(), data.size());
+    ofs.close();
+
+    std::unique_ptr<FileSourceStream> fileSourceStream = FileSourceStream::CreateSourceStream(testFile);
+    ASSERT_NE(fileSourceStream, nullptr);
+    fileSourceStream->SetMappedRead(true);
+
+    DataStreamBuffer peekData;
+    ASSERT_TRUE(fileSourceStream->Peek(TEST_READ_SIZE_MAPPED, peekData));
+    ASSERT_NE(fileSourceStream->mappedData_, nullptr);
+    DataStreamBuffer outData;
+    ASSERT_TRUE(fileSourceStream->Read(TEST_READ_SIZE_MAPPED, outData));
+    ASSERT_EQ(outData.inputStreamBuffer, peekData.inputStreamBuffer);
+    ASSERT_EQ(memcmp(outData.inputStreamBuffer, data.data(), TEST_READ_SIZE_MAPPED), 0);
+    ASSERT_TRUE(fileSourceStream->Read(TEST_READ_SIZE_MAPPED, outData));
+    ASSERT_EQ(outData.inputStreamBuffer, peekData.inputStreamBuffer + TEST_READ_SIZE_MAPPED);
+    ASSERT_EQ(outData.bufferSize, TEST_FILE_SIZE_MAPPED - TEST_READ_SIZE_MAPPED);
+
+    std::vector<uint8_t> outBuffer(TEST_FILE_SIZE_MAPPED);
+    uint32_t readSize = 0;
+    ASSERT_TRUE(fileSourceStream->Read(TEST_FILE_SIZE_MAPPED, outBuffer.data(), outBuffer.size(), readSize));
+    ASSERT_EQ(readSize, TEST_FILE_SIZE_MAPPED - TEST_READ_SIZE_MAPPED * 2);
+    ASSERT_EQ(memcmp(outBuffer.data(), data.data() + TEST_READ_SIZE_MAPPED * 2, readSize), 0);
+
+    unlink(testFile);
+    GTEST_LOG_(INFO) << "FileSourceStreamTest: FileSourceStreamTest0032 end";
+}
+
+/**
+ * @tc.name: FileSourceStreamTest0033
+ * @tc.desc: Streams read through fread and never map the file unless mapped reads are enabled, even when mmap
+ *           is allowed for GetDataPtr
+ * @tc.type: FUNC
+ */
+HWTEST_F(FileSourceStreamTest, FileSourceStreamTest0033, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "FileSourceStreamTest: FileSourceStreamTest0033 start";
+
+    const char* testFile = "/data/local/tmp/image/test_buffered_read.dat";
+    std::vector<char> data(TEST_FILE_SIZE_MAPPED);
+    for (size_t i = 0; i < data.size(); i++) {
+        data[i] = static_cast<char>(i % UINT8_MAX);
+    }
+    std::ofstream ofs(testFile, std::ios::binary);
+    ofs.write(data.data(), data.size());
+    ofs.close();
+
+    std::unique_ptr<FileSourceStream> fileSourceStream = FileSourceStream::CreateSourceStream(testFile);
+    ASSERT_NE(fileSourceStream, nullptr);
+    fileSourceStream->useMmap_ = true;
+
+    DataStreamBuffer outData;
+    ASSERT_TRUE(fileSourceStream->Read(TEST_READ_SIZE_MAPPED, outData));
+    ASSERT_EQ(fileSourceStream->mappedData_, nullptr);
+    ASSERT_EQ(memcmp(outData.inputStreamBuffer, data.data(), TEST_READ_SIZE_MAPPED), 0);
+
+    unlink(testFile);
+    GTEST_LOG_(INFO) << "FileSourceStreamTest: FileSourceStreamTest0033 end";
+}
 }
 }
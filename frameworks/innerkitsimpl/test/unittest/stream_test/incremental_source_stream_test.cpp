@@ -14,8 +14,11 @@
  */
 #define private public
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <cstring>
 #include <fstream>
 #include <fcntl.h>
+#include <vector>
 #include "incremental_source_stream.h"
 #include "image_type.h"
 #include "image_utils.h"
@@ -34,6 +37,7 @@ namespace Multimedia {
 static const std::string IMAGE_INPUT_JPG_PATH = "/data/local/tmp/image/test.jpg";
 static constexpr uint32_t MAXSIZE = 10000;
 static constexpr size_t SIZE_T = 0;
+static constexpr size_t CHUNK_COUNT = 2;
 class IncrementalSourceStreamTest : public testing::Test {
 public:
     IncrementalSourceStreamTest() {}
@@ -394,10 +398,9 @@ HWTEST_F(IncrementalSourceStreamTest, IncrementalSourceStreamTest0018, TestSize.
     ASSERT_NE(ins, nullptr);
     DataStreamBuffer outData;
     uint32_t desiredSize = 3;
-    uint8_t set = 1;
-    ins->sourceData_.push_back(set);
+    const uint8_t set[2] = {1, 1};
+    ASSERT_EQ(ins->UpdateData(set, sizeof(set), false), SUCCESS);
     ins->dataOffset_  = 1;
-    ins->dataSize_ = 2;
     bool ret = ins->Peek(desiredSize, outData);
     ASSERT_EQ(ret, true);
     GTEST_LOG_(INFO) << "IncrementalSourceStreamTest: IncrementalSourceStreamTest0018 end";
@@ -418,10 +421,9 @@ HWTEST_F(IncrementalSourceStreamTest, IncrementalSourceStreamTest0019, TestSize.
     uint8_t *outBuffer = new uint8_t;
     uint32_t bufferSize = 3;
     uint32_t readSize = 0;
-    uint8_t set = 1;
-    ins->sourceData_.push_back(set);
+    const uint8_t set[2] = {1, 1};
+    ASSERT_EQ(ins->UpdateData(set, sizeof(set), false), SUCCESS);
     ins->dataOffset_  = 1;
-    ins->dataSize_ = 2;
     bool ret = ins->Peek(desiredSize, outBuffer, bufferSize, readSize);
     ASSERT_EQ(ret, true);
     delete outBuffer;
@@ -468,5 +470,81 @@ HWTEST_F(IncrementalSourceStreamTest, IncrementalSourceStreamTest0021, TestSize.
     ASSERT_EQ(ret, SUCCESS);
     GTEST_LOG_(INFO) << "IncrementalSourceStreamTest: IncrementalSourceStreamTest0021 end";
 }
+
+/**
+ * @tc.name: IncrementalSourceStreamChunkTest001
+ * @tc.desc: Test reading across appended and adopted chunks
+ * @tc.type: FUNC
+ */
+HWTEST_F(IncrementalSourceStreamTest, IncrementalSourceStreamChunkTest001, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "IncrementalSourceStreamTest: IncrementalSourceStreamChunkTest001 start";
+    std::unique_ptr<IncrementalSourceStream> ins =
+        IncrementalSourceStream::CreateSourceStream(IncrementalMode::INCREMENTAL_DATA);
+    ASSERT_NE(ins, nullptr);
+    std::vector<uint8_t> expected(MAXSIZE * 10);
+    for (size_t i = 0; i < expected.size(); i++) {
+        expected[i] = static_cast<uint8_t>(i * 7);
+    }
+    uint32_t half = expected.size() / 2;
+    ASSERT_EQ(ins->UpdateData(expected.data(), half, false), SUCCESS);
+    std::unique_ptr<uint8_t[]> adopted = std::make_unique<uint8_t[]>(expected.size() - half);
+    std::copy(expected.begin() + half, expected.end(), adopted.get());
+    ASSERT_EQ(ins->AdoptData(std::move(adopted), expected.size() - half, true), SUCCESS);
+    ASSERT_EQ(ins->chunks_.size(), CHUNK_COUNT);
+    ASSERT_EQ(ins->GetStreamSize(), expected.size());
+
+    uint8_t outBuffer[MAXSIZE] = {0};
+    uint32_t readSize = 0;
+    ASSERT_TRUE(ins->Seek(half - MAXSIZE / 2));
+    ASSERT_TRUE(ins->Peek(MAXSIZE, outBuffer, MAXSIZE, readSize));
+    ASSERT_EQ(readSize, MAXSIZE);
+    ASSERT_EQ(memcmp(outBuffer, expected.data() + half - MAXSIZE / 2, MAXSIZE), 0);
+    ASSERT_EQ(ins->chunks_.size(), CHUNK_COUNT);
+
+    DataStreamBuffer outData;
+    ASSERT_TRUE(ins->Read(MAXSIZE, outData));
+    ASSERT_EQ(outData.dataSize, MAXSIZE);
+    ASSERT_EQ(memcmp(outData.inputStreamBuffer, expected.data() + half - MAXSIZE / 2, MAXSIZE), 0);
+    ASSERT_EQ(ins->Tell(), half + MAXSIZE / 2);
+    ASSERT_EQ(memcmp(ins->GetDataPtr(), expected.data(), expected.size()), 0);
+    GTEST_LOG_(INFO) << "IncrementalSourceStreamTest: IncrementalSourceStreamChunkTest001 end";
+}
+
+/**
+ * @tc.name: IncrementalSourceStreamChunkTest002
+ * @tc.desc: Test a view returned before chunks are merged stays readable until the next seek
+ * @tc.type: FUNC
+ */
+HWTEST_F(IncrementalSourceStreamTest, IncrementalSourceStreamChunkTest002, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "IncrementalSourceStreamTest: IncrementalSourceStreamChunkTest002 start";
+    std::unique_ptr<IncrementalSourceStream> ins =
+        IncrementalSourceStream::CreateSourceStream(IncrementalMode::INCREMENTAL_DATA);
+    ASSERT_NE(ins, nullptr);
+    std::vector<uint8_t> expected(MAXSIZE * 10);
+    for (size_t i = 0; i < expected.size(); i++) {
+        expected[i] = static_cast<uint8_t>(i * 7);
+    }
+    uint32_t half = expected.size() / 2;
+    ASSERT_EQ(ins->UpdateData(expected.data(), half, false), SUCCESS);
+    std::unique_ptr<uint8_t[]> adopted = std::make_unique<uint8_t[]>(expected.size() - half);
+    std::copy(expected.begin() + half, expected.end(), adopted.get());
+    ASSERT_EQ(ins->AdoptData(std::move(adopted), expected.size() - half, true), SUCCESS);
+
+    DataStreamBuffer headView;
+    ASSERT_TRUE(ins->Read(MAXSIZE, headView));
+    ASSERT_TRUE(ins->Seek(half - MAXSIZE / 2));
+    DataStreamBuffer borderView;
+    ASSERT_TRUE(ins->Peek(MAXSIZE, borderView));
+    ASSERT_EQ(ins->chunks_.size(), 1u);
+    ASSERT_FALSE(ins->retiredChunks_.empty());
+    ASSERT_EQ(memcmp(headView.inputStreamBuffer, expected.data(), MAXSIZE), 0);
+    ASSERT_EQ(memcmp(borderView.inputStreamBuffer, expected.data() + half - MAXSIZE / 2, MAXSIZE), 0);
+
+    ASSERT_TRUE(ins->Seek(0));
+    ASSERT_TRUE(ins->retiredChunks_.empty());
+    GTEST_LOG_(INFO) << "IncrementalSourceStreamTest: IncrementalSourceStreamChunkTest002 end";
+}
+}
 }
-}
\ No newline at end of file
@@ -852,5 +852,75 @@ HWTEST_F(SvgDecoderTest, AllocBufferHeapAllocTest001, TestSize.Level3)
     ASSERT_NE(context.pixelsBuffer.buffer, nullptr);
     GTEST_LOG_(INFO) << "SvgDecoderTest: AllocBufferHeapAllocTest001 end";
 }
+
+/**
+ * @tc.name: DomReuseTest001
+ * @tc.desc: Test a decoder renders a second size from the DOM it already parsed
+ * @tc.type: FUNC
+ */
+HWTEST_F(SvgDecoderTest, DomReuseTest001, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "SvgDecoderTest: DomReuseTest001 start";
+    sk_sp<SkData> svgData = SkData::MakeFromFileName(IMAGE_SVG_SRC.c_str());
+    ASSERT_NE(svgData, nullptr);
+    auto streamPtr = BufferSourceStream::CreateSourceStream(svgData->bytes(), svgData->size());
+    ASSERT_NE(streamPtr, nullptr);
+    auto svgDecoder = std::make_shared<SvgDecoder>();
+    svgDecoder->SetSource(*streamPtr);
+    PixelDecodeOptions opts;
+    opts.desiredSize.width = DESIRED_WIDTH;
+    opts.desiredSize.height = DESIRED_HEIGHT;
+    PlImageInfo info;
+    ASSERT_EQ(svgDecoder->SetDecodeOptions(0, opts, info), Media::SUCCESS);
+    int32_t firstWidth = info.size.width;
+    DecodeContext context;
+    context.allocatorType = Media::AllocatorType::HEAP_ALLOC;
+    ASSERT_EQ(svgDecoder->Decode(0, context), Media::SUCCESS);
+    free(context.pixelsBuffer.buffer);
+    SkSVGDOM *dom = svgDecoder->svgDom_.get();
+
+    opts.desiredSize.width = DESIRED_WIDTH * OPTS_DESIREDSIZE;
+    opts.desiredSize.height = DESIRED_HEIGHT * OPTS_DESIREDSIZE;
+    ASSERT_EQ(svgDecoder->SetDecodeOptions(0, opts, info), Media::SUCCESS);
+    ASSERT_EQ(svgDecoder->svgDom_.get(), dom);
+    ASSERT_NEAR(info.size.width, firstWidth * OPTS_DESIREDSIZE, 1);
+    GTEST_LOG_(INFO) << "SvgDecoderTest: DomReuseTest001 end";
+}
+
+/**
+ * @tc.name: DomCacheTest001
+ * @tc.desc: Test a released DOM is handed to the next decoder of the same content, unless colors modified it
+ * @tc.type: FUNC
+ */
+HWTEST_F(SvgDecoderTest, DomCacheTest001, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "SvgDecoderTest: DomCacheTest001 start";
+    sk_sp<SkData> svgData = SkData::MakeFromFileName(IMAGE_SVG_SRC.c_str());
+    ASSERT_NE(svgData, nullptr);
+    auto streamPtr = BufferSourceStream::CreateSourceStream(svgData->bytes(), svgData->size());
+    ASSERT_NE(streamPtr, nullptr);
+    ImagePlugin::Size size;
+    auto firstDecoder = std::make_shared<SvgDecoder>();
+    firstDecoder->SetSource(*streamPtr);
+    ASSERT_EQ(firstDecoder->GetImageSize(0, size), Media::SUCCESS);
+    SkSVGDOM *dom = firstDecoder->svgDom_.get();
+    SkSize svgSize = firstDecoder->svgSize_;
+    firstDecoder->Reset();
+
+    auto secondDecoder = std::make_shared<SvgDecoder>();
+    secondDecoder->SetSource(*streamPtr);
+    ASSERT_EQ(secondDecoder->GetImageSize(0, size), Media::SUCCESS);
+    ASSERT_EQ(secondDecoder->svgDom_.get(), dom);
+    ASSERT_EQ(secondDecoder->svgSize_, svgSize);
+    secondDecoder->svgDomDirty_ = true;
+    secondDecoder->Reset();
+
+    auto thirdDecoder = std::make_shared<SvgDecoder>();
+    thirdDecoder->SetSource(*streamPtr);
+    ASSERT_EQ(thirdDecoder->GetImageSize(0, size), Media::SUCCESS);
+    ASSERT_NE(thirdDecoder->svgDom_, nullptr);
+    ASSERT_EQ(thirdDecoder->svgSize_, svgSize);
+    GTEST_LOG_(INFO) << "SvgDecoderTest: DomCacheTest001 end";
+}
+}
 }
-}
\ No newline at end of file
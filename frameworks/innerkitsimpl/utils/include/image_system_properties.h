@@ -44,6 +44,8 @@ public:
     static bool IsImageSubSample();
     static bool GetDecodeDfxDataEnabled();
     static bool GetEncodeDfxDataEnabled();
+    // Worker threads for AVIS animation decoding, 0 lets the decoder pick.
+    static int32_t GetAvisDecodeThreads();
     static bool IsSystemApp();
     static void SetIsSystemAppForTest(bool isSystemApp);
 private:
@@ -288,6 +288,18 @@ bool ImageSystemProperties::GetEncodeDfxDataEnabled()
 #endif
 }
 
+int32_t ImageSystemProperties::GetAvisDecodeThreads()
+{
+#if !defined(CROSS_PLATFORM)
+    constexpr int32_t AVIS_DECODE_THREADS_MAX = 16;
+    static int32_t ret = system::GetIntParameter<int32_t>("persist.multimedia.image.avis.decodeThreads", 0,
+        0, AVIS_DECODE_THREADS_MAX);
+    return ret;
+#else
+    return 0;
+#endif
+}
+
 static bool g_isSystemAppForTest = false;
 
 void ImageSystemProperties::SetIsSystemAppForTest(bool isSystemApp)
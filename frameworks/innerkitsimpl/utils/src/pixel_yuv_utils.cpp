@@ -15,6 +15,8 @@
 
 #include "pixel_yuv_utils.h"
 
+#include <algorithm>
+
 #include "image_log.h"
 #include "ios"
 #include "istream"
@@ -29,6 +31,14 @@
 #include "vpe_utils.h"
 #endif
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define PIXEL_YUV_SIMD_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define PIXEL_YUV_SIMD_NEON
+#endif
+
 #undef LOG_DOMAIN
 #define LOG_DOMAIN LOG_TAG_DOMAIN_ID_IMAGE
 
@@ -56,6 +66,8 @@ constexpr uint8_t TRANSPOSE_CLOCK = 1;
 constexpr uint8_t TRANSPOSE_CCLOCK = 2;
 constexpr int32_t EXPR_SUCCESS = 0;
 constexpr int32_t MAX_DIMENSION = INT32_MAX >> NUM_2;
+constexpr int32_t TRANSPOSE_TILE = 32;
+constexpr int32_t TRANSPOSE_BLOCK = 8;
 
 static const std::map<PixelFormat, AVPixelFormat> FFMPEG_PIXEL_FORMAT_MAP = {
     {PixelFormat::UNKNOWN, AVPixelFormat::AV_PIX_FMT_NONE},
@@ -443,7 +455,349 @@ static bool CropUpDataDstdata(uint8_t *dstData, AVFrame *dstFrame, const Rect &r
     return true;
 }
 
-bool PixelYuvUtils::YuvCrop(uint8_t *srcData, YuvImageInfo &srcInfo, uint8_t *dstData, const Rect &rect,
+// Plane pointers of a semi-planar NV12/NV21/P010 buffer. Pitches are in bytes and are negative when the
+// rows are walked bottom up.
+struct YuvPlanes {
+    uint8_t *y = nullptr;
+    uint8_t *uv = nullptr;
+    int64_t yPitch = 0;
+    int64_t uvPitch = 0;
+};
+
+static bool IsNativeYuvLayout(const YuvImageInfo &info)
+{
+    if (info.format != AVPixelFormat::AV_PIX_FMT_NV12 && info.format != AVPixelFormat::AV_PIX_FMT_NV21 &&
+        info.format != AVPixelFormat::AV_PIX_FMT_P010LE) {
+        return false;
+    }
+    return info.width > 0 && info.height > 0 && info.yuvDataInfo.yStride <= INT32_MAX &&
+        info.yuvDataInfo.yStride >= static_cast<uint32_t>(info.width) &&
+        info.yuvDataInfo.uvStride >= static_cast<uint32_t>(GetUVStride(info.width));
+}
+
+static int64_t GetYuvPixelBytes(AVPixelFormat format)
+{
+    return format == AVPixelFormat::AV_PIX_FMT_P010LE ? NUM_2 : 1;
+}
+
+static YuvPlanes GetSrcPlanes(uint8_t *data, const YuvImageInfo &info)
+{
+    int64_t pixelBytes = GetYuvPixelBytes(info.format);
+    YuvPlanes planes;
+    planes.y = data + info.yuvDataInfo.yOffset * pixelBytes;
+    planes.uv = data + info.yuvDataInfo.uvOffset * pixelBytes;
+    planes.yPitch = info.yuvDataInfo.yStride * pixelBytes;
+    planes.uvPitch = info.yuvDataInfo.uvStride * pixelBytes;
+    return planes;
+}
+
+// Same packing as av_image_copy_to_buffer with align 1, which the filter graph path produced.
+static YuvPlanes GetPackedPlanes(uint8_t *data, int32_t width, int32_t height, AVPixelFormat format)
+{
+    int64_t pixelBytes = GetYuvPixelBytes(format);
+    YuvPlanes planes;
+    planes.y = data;
+    planes.uv = data + static_cast<int64_t>(width) * height * pixelBytes;
+    planes.yPitch = width * pixelBytes;
+    planes.uvPitch = GetUVStride(width) * pixelBytes;
+    return planes;
+}
+
+template <typename T>
+static void CopyRows(const uint8_t *src, int64_t srcPitch, uint8_t *dst, int64_t dstPitch,
+    int32_t cols, int32_t rows, bool mirror)
+{
+    size_t rowBytes = static_cast<size_t>(cols) * sizeof(T);
+    for (int32_t row = 0; row < rows; row++) {
+        const T *srcRow = reinterpret_cast<const T *>(src + row * srcPitch);
+        T *dstRow = reinterpret_cast<T *>(dst + row * dstPitch);
+        if (!mirror) {
+            memcpy_s(dstRow, rowBytes, srcRow, rowBytes);
+            continue;
+        }
+        for (int32_t col = 0; col < cols; col++) {
+            dstRow[col] = srcRow[cols - 1 - col];
+        }
+    }
+}
+
+#if defined(PIXEL_YUV_SIMD_SSE2)
+static void Transpose8x8U8(const uint8_t *src, int64_t srcPitch, uint8_t *dst, int64_t dstPitch)
+{
+    __m128i rows[TRANSPOSE_BLOCK];
+    for (int32_t i = 0; i < TRANSPOSE_BLOCK; i++) {
+        rows[i] = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(src + i * srcPitch));
+    }
+    __m128i pair01 = _mm_unpacklo_epi8(rows[0], rows[1]);
+    __m128i pair23 = _mm_unpacklo_epi8(rows[2], rows[3]);
+    __m128i pair45 = _mm_unpacklo_epi8(rows[4], rows[5]);
+    __m128i pair67 = _mm_unpacklo_epi8(rows[6], rows[7]);
+    __m128i quadLo0 = _mm_unpacklo_epi16(pair01, pair23);
+    __m128i quadHi0 = _mm_unpackhi_epi16(pair01, pair23);
+    __m128i quadLo1 = _mm_unpacklo_epi16(pair45, pair67);
+    __m128i quadHi1 = _mm_unpackhi_epi16(pair45, pair67);
+    // Every register now holds two complete output rows.
+    __m128i cols[TRANSPOSE_BLOCK / NUM_2] = {
+        _mm_unpacklo_epi32(quadLo0, quadLo1), _mm_unpackhi_epi32(quadLo0, quadLo1),
+        _mm_unpacklo_epi32(quadHi0, quadHi1), _mm_unpackhi_epi32(quadHi0, quadHi1),
+    };
+    for (int32_t i = 0; i < TRANSPOSE_BLOCK / NUM_2; i++) {
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(dst + (i * NUM_2) * dstPitch), cols[i]);
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(dst + (i * NUM_2 + 1) * dstPitch),
+            _mm_unpackhi_epi64(cols[i], cols[i]));
+    }
+}
+
+static void Transpose8x8U16(const uint8_t *src, int64_t srcPitch, uint8_t *dst, int64_t dstPitch)
+{
+    __m128i rows[TRANSPOSE_BLOCK];
+    for (int32_t i = 0; i < TRANSPOSE_BLOCK; i++) {
+        rows[i] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i * srcPitch));
+    }
+    __m128i pairs[TRANSPOSE_BLOCK];
+    for (int32_t i = 0; i < TRANSPOSE_BLOCK; i += NUM_2) {
+        pairs[i] = _mm_unpacklo_epi16(rows[i], rows[i + 1]);
+        pairs[i + 1] = _mm_unpackhi_epi16(rows[i], rows[i + 1]);
+    }
+    __m128i quads[TRANSPOSE_BLOCK] = {
+        _mm_unpacklo_epi32(pairs[0], pairs[2]), _mm_unpackhi_epi32(pairs[0], pairs[2]),
+        _mm_unpacklo_epi32(pairs[1], pairs[3]), _mm_unpackhi_epi32(pairs[1], pairs[3]),
+        _mm_unpacklo_epi32(pairs[4], pairs[6]), _mm_unpackhi_epi32(pairs[4], pairs[6]),
+        _mm_unpacklo_epi32(pairs[5], pairs[7]), _mm_unpackhi_epi32(pairs[5], pairs[7]),
+    };
+    for (int32_t i = 0; i < TRANSPOSE_BLOCK / NUM_2; i++) {
+        __m128i upper = quads[i];
+        __m128i lower = quads[i + TRANSPOSE_BLOCK / NUM_2];
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + (i * NUM_2) * dstPitch), _mm_unpacklo_epi64(upper, lower));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + (i * NUM_2 + 1) * dstPitch),
+            _mm_unpackhi_epi64(upper, lower));
+    }
+}
+#elif defined(PIXEL_YUV_SIMD_NEON)
+static void Transpose8x8U8(const uint8_t *src, int64_t srcPitch, uint8_t *dst, int64_t dstPitch)
+{
+    uint8x8_t rows[TRANSPOSE_BLOCK];
+    for (int32_t i = 0; i < TRANSPOSE_BLOCK; i++) {
+        rows[i] = vld1_u8(src + i * srcPitch);
+    }
+    uint8x8x2_t pair01 = vtrn_u8(rows[0], rows[1]);
+    uint8x8x2_t pair23 = vtrn_u8(rows[2], rows[3]);
+    uint8x8x2_t pair45 = vtrn_u8(rows[4], rows[5]);
+    uint8x8x2_t pair67 = vtrn_u8(rows[6], rows[7]);
+    uint16x4x2_t even0 = vtrn_u16(vreinterpret_u16_u8(pair01.val[0]), vreinterpret_u16_u8(pair23.val[0]));
+    uint16x4x2_t odd0 = vtrn_u16(vreinterpret_u16_u8(pair01.val[1]), vreinterpret_u16_u8(pair23.val[1]));
+    uint16x4x2_t even1 = vtrn_u16(vreinterpret_u16_u8(pair45.val[0]), vreinterpret_u16_u8(pair67.val[0]));
+    uint16x4x2_t odd1 = vtrn_u16(vreinterpret_u16_u8(pair45.val[1]), vreinterpret_u16_u8(pair67.val[1]));
+    // Each result holds output rows i and i + 4.
+    uint32x2x2_t cols[TRANSPOSE_BLOCK / NUM_2] = {
+        vtrn_u32(vreinterpret_u32_u16(even0.val[0]), vreinterpret_u32_u16(even1.val[0])),
+        vtrn_u32(vreinterpret_u32_u16(odd0.val[0]), vreinterpret_u32_u16(odd1.val[0])),
+        vtrn_u32(vreinterpret_u32_u16(even0.val[1]), vreinterpret_u32_u16(even1.val[1])),
+        vtrn_u32(vreinterpret_u32_u16(odd0.val[1]), vreinterpret_u32_u16(odd1.val[1])),
+    };
+    for (int32_t i = 0; i < TRANSPOSE_BLOCK / NUM_2; i++) {
+        vst1_u8(dst + i * dstPitch, vreinterpret_u8_u32(cols[i].val[0]));
+        vst1_u8(dst + (i + TRANSPOSE_BLOCK / NUM_2) * dstPitch, vreinterpret_u8_u32(cols[i].val[1]));
+    }
+}
+
+static void Transpose8x8U16(const uint8_t *src, int64_t srcPitch, uint8_t *dst, int64_t dstPitch)
+{
+    uint16x8_t rows[TRANSPOSE_BLOCK];
+    for (int32_t i = 0; i < TRANSPOSE_BLOCK; i++) {
+        rows[i] = vld1q_u16(reinterpret_cast<const uint16_t *>(src + i * srcPitch));
+    }
+    uint16x8x2_t pairs[TRANSPOSE_BLOCK / NUM_2];
+    for (int32_t i = 0; i < TRANSPOSE_BLOCK / NUM_2; i++) {
+        pairs[i] = vtrnq_u16(rows[i * NUM_2], rows[i * NUM_2 + 1]);
+    }
+    // quads[0] holds columns 0/4 and 2/6 of rows 0-3, quads[1] columns 1/5 and 3/7, quads[2..3] rows 4-7.
+    uint32x4x2_t quads[TRANSPOSE_BLOCK / NUM_2] = {
+        vtrnq_u32(vreinterpretq_u32_u16(pairs[0].val[0]), vreinterpretq_u32_u16(pairs[1].val[0])),
+        vtrnq_u32(vreinterpretq_u32_u16(pairs[0].val[1]), vreinterpretq_u32_u16(pairs[1].val[1])),
+        vtrnq_u32(vreinterpretq_u32_u16(pairs[2].val[0]), vreinterpretq_u32_u16(pairs[3].val[0])),
+        vtrnq_u32(vreinterpretq_u32_u16(pairs[2].val[1]), vreinterpretq_u32_u16(pairs[3].val[1])),
+    };
+    for (int32_t i = 0; i < TRANSPOSE_BLOCK / NUM_2; i++) {
+        // Output row i comes from quads[i % 2].val[i / 2], low half for rows 0-3, high half for rows 4-7.
+        uint16x8_t upper = vreinterpretq_u16_u32(quads[i % NUM_2].val[i / NUM_2]);
+        uint16x8_t lower = vreinterpretq_u16_u32(quads[i % NUM_2 + NUM_2].val[i / NUM_2]);
+        vst1q_u16(reinterpret_cast<uint16_t *>(dst + i * dstPitch), vcombine_u16(vget_low_u16(upper),
+            vget_low_u16(lower)));
+        vst1q_u16(reinterpret_cast<uint16_t *>(dst + (i + TRANSPOSE_BLOCK / NUM_2) * dstPitch),
+            vcombine_u16(vget_high_u16(upper), vget_high_u16(lower)));
+    }
+}
+#endif
+
+template <typename T>
+static void TransposeScalar(const uint8_t *src, int64_t srcPitch, uint8_t *dst, int64_t dstPitch,
+    int32_t cols, int32_t rows)
+{
+    for (int32_t col = 0; col < cols; col++) {
+        T *dstRow = reinterpret_cast<T *>(dst + col * dstPitch);
+        for (int32_t row = 0; row < rows; row++) {
+            dstRow[row] = reinterpret_cast<const T *>(src + row * srcPitch)[col];
+        }
+    }
+}
+
+template <typename T>
+static void TransposeTile(const uint8_t *src, int64_t srcPitch, uint8_t *dst, int64_t dstPitch,
+    int32_t cols, int32_t rows)
+{
+#if defined(PIXEL_YUV_SIMD_SSE2) || defined(PIXEL_YUV_SIMD_NEON)
+    if (sizeof(T) <= sizeof(uint16_t)) {
+        int32_t blockCols = cols - cols % TRANSPOSE_BLOCK;
+        int32_t blockRows = rows - rows % TRANSPOSE_BLOCK;
+        for (int32_t row = 0; row < blockRows; row += TRANSPOSE_BLOCK) {
+            for (int32_t col = 0; col < blockCols; col += TRANSPOSE_BLOCK) {
+                const uint8_t *srcBlock = src + row * srcPitch + col * sizeof(T);
+                uint8_t *dstBlock = dst + col * dstPitch + row * sizeof(T);
+                if (sizeof(T) == sizeof(uint8_t)) {
+                    Transpose8x8U8(srcBlock, srcPitch, dstBlock, dstPitch);
+                } else {
+                    Transpose8x8U16(srcBlock, srcPitch, dstBlock, dstPitch);
+                }
+            }
+        }
+        TransposeScalar<T>(src + blockCols * sizeof(T), srcPitch, dst + blockCols * dstPitch, dstPitch,
+            cols - blockCols, blockRows);
+        TransposeScalar<T>(src + blockRows * srcPitch, srcPitch, dst + blockRows * sizeof(T), dstPitch,
+            cols, rows - blockRows);
+        return;
+    }
+#endif
+    TransposeScalar<T>(src, srcPitch, dst, dstPitch, cols, rows);
+}
+
+// dst[col][row] = src[row][col], walked in tiles so both sides stay in cache.
+template <typename T>
+static void TransposePlane(const uint8_t *src, int64_t srcPitch, uint8_t *dst, int64_t dstPitch,
+    int32_t cols, int32_t rows)
+{
+    for (int32_t row = 0; row < rows; row += TRANSPOSE_TILE) {
+        int32_t tileRows = std::min(TRANSPOSE_TILE, rows - row);
+        for (int32_t col = 0; col < cols; col += TRANSPOSE_TILE) {
+            TransposeTile<T>(src + row * srcPitch + col * sizeof(T), srcPitch,
+                dst + col * dstPitch + row * sizeof(T), dstPitch, std::min(TRANSPOSE_TILE, cols - col), tileRows);
+        }
+    }
+}
+
+template <typename YT, typename UVT>
+static void CopyPlanes(const YuvPlanes &src, const YuvPlanes &dst, int32_t width, int32_t height,
+    bool mirror, bool upsideDown)
+{
+    int32_t uvWidth = GetUStride(width);
+    int32_t uvHeight = GetUVHeight(height);
+    if (upsideDown) {
+        CopyRows<YT>(src.y + (height - 1) * src.yPitch, -src.yPitch, dst.y, dst.yPitch, width, height, mirror);
+        CopyRows<UVT>(src.uv + (uvHeight - 1) * src.uvPitch, -src.uvPitch, dst.uv, dst.uvPitch,
+            uvWidth, uvHeight, mirror);
+        return;
+    }
+    CopyRows<YT>(src.y, src.yPitch, dst.y, dst.yPitch, width, height, mirror);
+    CopyRows<UVT>(src.uv, src.uvPitch, dst.uv, dst.uvPitch, uvWidth, uvHeight, mirror);
+}
+
+// Interleaved chroma is moved as one element per pair, so NV12 and NV21 share the kernels.
+template <typename YT, typename UVT>
+static void TransposePlanes(const YuvPlanes &src, const YuvPlanes &dst, int32_t width, int32_t height,
+    bool clockwise)
+{
+    int32_t uvWidth = GetUStride(width);
+    int32_t uvHeight = GetUVHeight(height);
+    if (clockwise) {
+        TransposePlane<YT>(src.y + (height - 1) * src.yPitch, -src.yPitch, dst.y, dst.yPitch, width, height);
+        TransposePlane<UVT>(src.uv + (uvHeight - 1) * src.uvPitch, -src.uvPitch, dst.uv, dst.uvPitch,
+            uvWidth, uvHeight);
+        return;
+    }
+    TransposePlane<YT>(src.y, src.yPitch, dst.y + (width - 1) * dst.yPitch, -dst.yPitch, width, height);
+    TransposePlane<UVT>(src.uv, src.uvPitch, dst.uv + (uvWidth - 1) * dst.uvPitch, -dst.uvPitch,
+        uvWidth, uvHeight);
+}
+
+static void NativeCopyPlanes(AVPixelFormat format, const YuvPlanes &src, const YuvPlanes &dst, const Size &size,
+    bool mirror, bool upsideDown)
+{
+    if (format == AVPixelFormat::AV_PIX_FMT_P010LE) {
+        CopyPlanes<uint16_t, uint32_t>(src, dst, size.width, size.height, mirror, upsideDown);
+    } else {
+        CopyPlanes<uint8_t, uint16_t>(src, dst, size.width, size.height, mirror, upsideDown);
+    }
+}
+
+static void ClearPlanePadding(uint8_t *plane, int64_t pitch, int64_t rowBytes, int32_t rows, int32_t totalRows)
+{
+    if (pitch > rowBytes) {
+        size_t padBytes = static_cast<size_t>(pitch - rowBytes);
+        for (int32_t row = 0; row < rows; row++) {
+            memset_s(plane + row * pitch + rowBytes, padBytes, 0, padBytes);
+        }
+    }
+    if (totalRows > rows) {
+        size_t padBytes = static_cast<size_t>(totalRows - rows) * static_cast<size_t>(pitch);
+        memset_s(plane + rows * pitch, padBytes, 0, padBytes);
+    }
+}
+
+// The packed destination is as wide as the source stride, or as tall for rotations. The filter graph wrote that
+// padding too, so clear what the kernels leave untouched instead of handing out stale memory.
+static void ClearDstPadding(AVPixelFormat format, const YuvPlanes &dst, const Size &size, int32_t totalRows)
+{
+    int64_t pixelBytes = GetYuvPixelBytes(format);
+    ClearPlanePadding(dst.y, dst.yPitch, size.width * pixelBytes, size.height, totalRows);
+    ClearPlanePadding(dst.uv, dst.uvPitch, GetUVStride(size.width) * pixelBytes, GetUVHeight(size.height),
+        GetUVHeight(totalRows));
+}
+
+static bool NativeYuvCrop(uint8_t *srcData, YuvImageInfo &srcInfo, uint8_t *dstData, const Rect &rect,
+    YUVStrideInfo &dstStrides)
+{
+    if (!IsNativeYuvLayout(srcInfo) || rect.left < 0 || rect.top < 0 || rect.width <= 0 || rect.height <= 0 ||
+        rect.width > srcInfo.width - rect.left || rect.height > srcInfo.height - rect.top ||
+        dstStrides.yStride < static_cast<uint32_t>(rect.width) || dstStrides.yStride > INT32_MAX) {
+        return false;
+    }
+    // Like the crop filter, the origin snaps to the chroma grid so luma and chroma stay registered.
+    int32_t left = rect.left - rect.left % NUM_2;
+    int32_t top = rect.top - rect.top % NUM_2;
+    int64_t pixelBytes = GetYuvPixelBytes(srcInfo.format);
+    YuvPlanes src = GetSrcPlanes(srcData, srcInfo);
+    src.y += top * src.yPitch + left * pixelBytes;
+    src.uv += (top / NUM_2) * src.uvPitch + left * pixelBytes;
+    YuvPlanes dst = GetPackedPlanes(dstData, static_cast<int32_t>(dstStrides.yStride), rect.height, srcInfo.format);
+    NativeCopyPlanes(srcInfo.format, src, dst, {rect.width, rect.height}, false, false);
+    ClearDstPadding(srcInfo.format, dst, {rect.width, rect.height}, rect.height);
+    return true;
+}
+
+static void NativeYuvFlip(uint8_t *srcData, YuvImageInfo &srcInfo, uint8_t *dstData, bool mirror, bool upsideDown)
+{
+    YuvPlanes src = GetSrcPlanes(srcData, srcInfo);
+    YuvPlanes dst = GetPackedPlanes(dstData, static_cast<int32_t>(srcInfo.yuvDataInfo.yStride), srcInfo.height,
+        srcInfo.format);
+    NativeCopyPlanes(srcInfo.format, src, dst, {srcInfo.width, srcInfo.height}, mirror, upsideDown);
+    ClearDstPadding(srcInfo.format, dst, {srcInfo.width, srcInfo.height}, srcInfo.height);
+}
+
+static void NativeYuvRotate(uint8_t *srcData, YuvImageInfo &srcInfo, uint8_t *dstData, bool clockwise)
+{
+    YuvPlanes src = GetSrcPlanes(srcData, srcInfo);
+    YuvPlanes dst = GetPackedPlanes(dstData, srcInfo.height, static_cast<int32_t>(srcInfo.yuvDataInfo.yStride),
+        srcInfo.format);
+    if (srcInfo.format == AVPixelFormat::AV_PIX_FMT_P010LE) {
+        TransposePlanes<uint16_t, uint32_t>(src, dst, srcInfo.width, srcInfo.height, clockwise);
+    } else {
+        TransposePlanes<uint8_t, uint16_t>(src, dst, srcInfo.width, srcInfo.height, clockwise);
+    }
+    ClearDstPadding(srcInfo.format, dst, {srcInfo.height, srcInfo.width},
+        static_cast<int32_t>(srcInfo.yuvDataInfo.yStride));
+}
+
+static bool CropByFilter(uint8_t *srcData, YuvImageInfo &srcInfo, uint8_t *dstData, const Rect &rect,
     YUVStrideInfo &dstStrides)
 {
     AVFrame *srcFrame = av_frame_alloc();
@@ -496,6 +850,15 @@ bool PixelYuvUtils::YuvCrop(uint8_t *srcData, YuvImageInfo &srcInfo, uint8_t *ds
     return true;
 }
 
+bool PixelYuvUtils::YuvCrop(uint8_t *srcData, YuvImageInfo &srcInfo, uint8_t *dstData, const Rect &rect,
+    YUVStrideInfo &dstStrides)
+{
+    if (NativeYuvCrop(srcData, srcInfo, dstData, rect, dstStrides)) {
+        return true;
+    }
+    return CropByFilter(srcData, srcInfo, dstData, rect, dstStrides);
+}
+
 int32_t PixelYuvUtils::YuvScale(uint8_t *srcPixels, YuvImageInfo &srcInfo,
     uint8_t *dstPixels, YuvImageInfo &dstInfo, int32_t module)
 {
@@ -582,7 +945,7 @@ static bool RoatateUpDataDstdata(YuvImageInfo &srcInfo, YuvImageInfo &dstInfo, u
     return true;
 }
 
-static bool Rotate(uint8_t *srcData, YuvImageInfo &srcInfo, uint8_t *dstData,
+static bool RotateByFilter(uint8_t *srcData, YuvImageInfo &srcInfo, uint8_t *dstData,
     YuvImageInfo &dstInfo, int32_t rotateNum)
 {
     AVFrame *srcFrame = av_frame_alloc();
@@ -637,6 +1000,18 @@ static bool Rotate(uint8_t *srcData, YuvImageInfo &srcInfo, uint8_t *dstData,
     return true;
 }
 
+static bool Rotate(uint8_t *srcData, YuvImageInfo &srcInfo, uint8_t *dstData,
+    YuvImageInfo &dstInfo, int32_t rotateNum)
+{
+    if (!IsNativeYuvLayout(srcInfo)) {
+        return RotateByFilter(srcData, srcInfo, dstData, dstInfo, rotateNum);
+    }
+    NativeYuvRotate(srcData, srcInfo, dstData, rotateNum == TRANSPOSE_CLOCK);
+    dstInfo.width = srcInfo.height;
+    dstInfo.height = srcInfo.width;
+    return true;
+}
+
 static bool CreateFilpFilter(AVFilterGraph **filterGraph, AVFilterContext **flipCtx, bool xAxis)
 {
     const char *flipType = xAxis ? "hflip" : "vflip";
@@ -671,7 +1046,7 @@ static bool FlipUpDataDstdata(YuvImageInfo &srcInfo, uint8_t *dstData, AVFrame *
     return true;
 }
 
-bool PixelYuvUtils::YuvFlip(uint8_t *srcData, YuvImageInfo &srcInfo, uint8_t *dstData, bool xAxis)
+static bool FlipByFilter(uint8_t *srcData, YuvImageInfo &srcInfo, uint8_t *dstData, bool xAxis)
 {
     AVFrame *srcFrame = av_frame_alloc();
     AVFrame *dstFrame = av_frame_alloc();
@@ -723,6 +1098,15 @@ bool PixelYuvUtils::YuvFlip(uint8_t *srcData, YuvImageInfo &srcInfo, uint8_t *ds
     return true;
 }
 
+bool PixelYuvUtils::YuvFlip(uint8_t *srcData, YuvImageInfo &srcInfo, uint8_t *dstData, bool xAxis)
+{
+    if (!IsNativeYuvLayout(srcInfo)) {
+        return FlipByFilter(srcData, srcInfo, dstData, xAxis);
+    }
+    NativeYuvFlip(srcData, srcInfo, dstData, xAxis, !xAxis);
+    return true;
+}
+
 static bool IsYUVP010Format(PixelFormat format)
 {
     return format == PixelFormat::YCBCR_P010 || format == PixelFormat::YCRCB_P010;
@@ -730,6 +1114,12 @@ static bool IsYUVP010Format(PixelFormat format)
 
 bool PixelYuvUtils::YuvReversal(uint8_t *srcData, YuvImageInfo &srcInfo, uint8_t *dstData, YuvImageInfo &dstInfo)
 {
+    if (IsNativeYuvLayout(srcInfo)) {
+        NativeYuvFlip(srcData, srcInfo, dstData, true, true);
+        dstInfo.width = srcInfo.width;
+        dstInfo.height = srcInfo.height;
+        return true;
+    }
     uint32_t dataSize = GetImageSize(srcInfo.width, srcInfo.height);
     std::unique_ptr<uint8_t[]> tmpData = nullptr;
     if (IsYUVP010Format(srcInfo.yuvFormat)) {
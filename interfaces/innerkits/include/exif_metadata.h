@@ -19,6 +19,7 @@
 #include <libexif/exif-entry.h>
 #include <libexif/exif-tag.h>
 #include <libexif/huawei/exif-mnote-data-huawei.h>
+#include <memory>
 #include <unordered_map>
 
 #include "image_type.h"
@@ -34,6 +35,7 @@ struct EntryBasicInfo {
     unsigned char *data;
     ExifByteOrder byteOrder;
 };
+struct ExifLazyIndex;
 class ExifMetadata : public ImageMetadata {
 public:
     ExifMetadata();
@@ -76,6 +78,9 @@ public:
     bool IsSpecialHwKey(const std::string &key) const;
     static PropertyValueType GetPropertyValueType(const std::string& key);
     static std::shared_ptr<ExifMetadata> InitExifMetadata();
+    // Indexes an APP1 exif payload ("Exif\0\0" + TIFF) without loading it; tags are decoded on first read and
+    // the libexif tree is built on the first write. Returns nullptr if the payload needs a full load.
+    static std::shared_ptr<ExifMetadata> CreateLazy(const unsigned char *data, uint32_t size);
     static const std::map<std::string, PropertyValueType>& GetExifMetadataMap();
     static const std::map<std::string, PropertyValueType>& GetHwMetadataMap();
     static const std::map<std::string, PropertyValueType>& GetHeifsMetadataMap();
@@ -102,6 +107,11 @@ public:
     }
 
 private:
+    ExifData *EnsureExifData() const;
+    bool HasExifData() const;
+    bool GetLazyEntry(const std::string &key, ExifTag tag, ExifEntry *&entry) const;
+    ExifMnoteData *GetMnoteData() const;
+    bool IsLazyWithoutMakerNote() const;
     bool ParseExifCoordinate(const std::string& fieldName, uint32_t& outputValue) const;
     ExifEntry* CreateEntry(const std::string &key, const ExifTag &tag, const size_t len);
     MnoteHuaweiEntry* CreateHwEntry(const std::string &key);
@@ -127,7 +137,8 @@ private:
         std::vector<std::pair<uint32_t, uint32_t>> &ranges, int index);
     void FindRanges(const ExifTag &tag, std::vector<std::pair<uint32_t, uint32_t>> &ranges);
     int GetUserMakerNote(std::string& value) const;
-    ExifData *exifData_;
+    mutable ExifData *exifData_;
+    std::unique_ptr<ExifLazyIndex> lazyIndex_;
     bool isSystemApi_ = false;
 };
 } // namespace Media
@@ -56,6 +56,30 @@ struct PackingOptionsForTiff {
     int32_t resolutionUnit = 0;   // Resolution unit, 0 means not written, 2=INCH
 };
 
+enum class JpegTransformType : int32_t {
+    NONE = 0,
+    FLIP_HORIZONTAL,
+    FLIP_VERTICAL,
+    TRANSPOSE,   // Mirror along the top-left to bottom-right diagonal
+    TRANSVERSE,  // Mirror along the top-right to bottom-left diagonal
+    ROTATE_90,   // Clockwise
+    ROTATE_180,
+    ROTATE_270,
+};
+
+// Edits for packing a JPEG ImageSource to JPEG. At quality 100 the source is repacked on its DCT
+// coefficients without decoding when it was coded the way a fresh quality 100 encode would be (all-one
+// quantization tables, 4:2:0 chroma), or when keepSourceCoding is set. Otherwise the source is decoded,
+// the pixels are edited and then encoded at the requested quality.
+struct PackingOptionsForJpeg {
+    JpegTransformType transform = JpegTransformType::NONE;
+    Rect cropRegion;         // In transformed coordinates, empty keeps the whole image
+    bool grayscale = false;  // Drops the chroma components, needs the coefficient path
+    // Repack on the coefficients even if the source's quantization tables or chroma subsampling differ
+    // from the requested encode; the output then keeps the source's coding instead of the quality setting.
+    bool keepSourceCoding = false;
+};
+
 struct PackingOptionsForAstc {
     bool enableGPUEncode = false;
 };
@@ -152,6 +176,17 @@ struct PackOption {
      * ASTC-specific encoding options.
      */
     PackingOptionsForAstc astcPackingOption;
+
+    /**
+     * JPEG-specific edits, only for AddImage(ImageSource &) with JPEG output.
+     */
+    PackingOptionsForJpeg jpegPackingOption;
+
+    /**
+     * Specify how pixels are dithered when they are mapped onto the palette.
+     * Only for gif.
+     */
+    DitherType ditherType = DitherType::NONE;
 };
 
 class PackerStream;
@@ -192,6 +227,9 @@ private:
     bool GetEncoderPlugin(const PackOption &option);
     void FreeOldPackerStream();
     bool IsPackOptionValid(const PackOption &option);
+    bool HasJpegEdits() const;
+    uint32_t TranscodeJpegLossless(ImageSource &source, uint32_t index);
+    uint32_t ApplyJpegEdits(PixelMap &pixelMap);
 #if defined(SUPPORT_LIBTIFF)
     static uint32_t ValidateBinaryImageBufferInfo(const PixelBufferInfo &bufferInfo, const char *funcName);
     static uint32_t EncodeBinaryImageToTiffStream(const PixelBufferInfo &bufferInfo,
@@ -209,7 +247,9 @@ private:
     std::unique_ptr<Picture> picture_;  // inner imagesource create, our manage the lifecycle
 #endif
     bool encodeToSdr_ = true;
+    bool losslessTranscoded_ = false;
     std::string format_;
+    PackOption packOption_;
 };
 } // namespace Media
 } // namespace OHOS
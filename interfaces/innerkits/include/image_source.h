@@ -266,11 +266,20 @@ public:
     NATIVEEXPORT const NinePatchInfo &GetNinePatchInfo() const;
     NATIVEEXPORT void SetMemoryUsagePreference(const MemoryUsagePreference preference);
     NATIVEEXPORT MemoryUsagePreference GetMemoryUsagePreference();
+    // Memory in bytes the decoder may spend on composited animation frames to speed up random frame access.
+    NATIVEEXPORT void SetAnimationCacheBudget(uint64_t budget);
+    NATIVEEXPORT uint64_t GetAnimationCacheBudget();
     NATIVEEXPORT uint32_t GetFilterArea(const int &privacyType, std::vector<std::pair<uint32_t, uint32_t>> &ranges);
     NATIVEEXPORT uint32_t GetFilterArea(const std::vector<std::string> &exifKeys,
                                         std::vector<std::pair<uint32_t, uint32_t>> &ranges);
     NATIVEEXPORT std::unique_ptr<std::vector<std::unique_ptr<PixelMap>>> CreatePixelMapList(const DecodeOptions &opts,
         uint32_t &errorCode);
+    // Decodes independent frame runs concurrently, at most maxConcurrency at a time; output keeps frame order.
+    NATIVEEXPORT std::unique_ptr<std::vector<std::unique_ptr<PixelMap>>> CreatePixelMapList(const DecodeOptions &opts,
+        uint32_t maxConcurrency, uint32_t &errorCode);
+    // Decodes one image at every desired size, in order. SVG sources parse their document only once.
+    NATIVEEXPORT std::unique_ptr<std::vector<std::unique_ptr<PixelMap>>> CreatePixelMapsForSizes(uint32_t index,
+        const DecodeOptions &opts, const std::vector<Size> &sizes, uint32_t &errorCode);
     NATIVEEXPORT std::unique_ptr<std::vector<int32_t>> GetDelayTime(uint32_t &errorCode);
     NATIVEEXPORT std::unique_ptr<std::vector<int32_t>> GetDisposalType(uint32_t &errorCode);
     NATIVEEXPORT int32_t GetLoopCount(uint32_t &errorCode);
@@ -314,6 +323,8 @@ public:
     NATIVEEXPORT uint32_t WriteXMPMetadata(std::shared_ptr<XMPMetadata> &xmpMetadata);
     NATIVEEXPORT std::shared_ptr<ImageMetadata> GetMetadata(MetadataType type);
     NATIVEEXPORT uint32_t GetImageRawData(std::vector<uint8_t> &data, uint32_t &bitsPerSample);
+    // Copies the whole encoded stream, for callers that rewrite it without decoding.
+    NATIVEEXPORT uint32_t GetEncodedData(std::vector<uint8_t> &data);
 
     void SetSystemApi(bool isSystemApi)
     {
@@ -330,6 +341,7 @@ private:
     uint32_t GetData(ImagePlugin::DataStreamBuffer &outData, size_t size);
     static FormatAgentMap InitClass();
     uint32_t GetEncodedFormat(const std::string &formatHint, std::string &format);
+    uint32_t SniffEncodedFormat(std::string &format);
     uint32_t DecodeImageInfo(uint32_t index, ImageStatusMap::iterator &iter);
     uint32_t DecodeSourceInfo(bool isAcquiredImageNum);
     uint32_t InitMainDecoder();
@@ -543,6 +555,7 @@ private:
     bool isIncrementalCompleted_ = false;
     bool hasDesiredSizeOptions = false;
     MemoryUsagePreference preference_ = MemoryUsagePreference::DEFAULT;
+    uint64_t animationCacheBudget_ = 0;
     std::optional<bool> isAstc_;
     uint64_t imageId_; // generated from the last six bits of the current timestamp
     ImageHdrType sourceHdrType_; // source image hdr type;
@@ -554,6 +567,7 @@ private:
     bool isExifReadFailed_ = false;
     uint32_t exifReadStatus_ = 0;
     uint32_t heifParseErr_ = 0;
+    bool useExtendedCodec_ = false;
     std::string srcFilePath_ = "";
     int srcFd_ = -1;
     uint8_t* srcBuffer_ = nullptr;
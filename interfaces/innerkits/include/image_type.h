@@ -237,6 +237,12 @@ enum class EncodeDynamicRange : int32_t {
     HDR_VIVID_SINGLE,
 };
 
+enum class DitherType : int32_t {
+    NONE = 0,
+    ORDERED, // 8x8 Bayer threshold matrix, stable between animation frames
+    FLOYD_STEINBERG,
+};
+
 enum class AlphaType : int32_t {
     IMAGE_ALPHA_TYPE_UNKNOWN = 0,
     IMAGE_ALPHA_TYPE_OPAQUE = 1,   // image pixels are stored as opaque.
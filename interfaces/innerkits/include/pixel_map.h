@@ -22,6 +22,7 @@
 #include <mutex>
 #include <shared_mutex>
 #include <utility>
+#include <vector>
 #ifdef IMAGE_COLORSPACE_FLAG
 #include "color_space.h"
 #endif
@@ -76,6 +77,78 @@ struct InitializationOptions {
     bool useSourceIfMatch = false;
     bool useDMA = false;
 };
+
+enum class TransformOpType : int32_t {
+    CROP = 0,
+    SCALE = 1,
+    ROTATE = 2,
+    FLIP = 3,
+    TRANSLATE = 4,
+};
+
+struct TransformOp {
+    TransformOpType type = TransformOpType::SCALE;
+    float x = 0.0f; // x scale ratio, x translate distance, rotate degrees, or non-zero to flip horizontally
+    float y = 0.0f; // y scale ratio, y translate distance, or non-zero to flip vertically
+    Rect rect;
+};
+
+// Records transforms in order so that PixelMap::ApplyTransform can run them in a single resampling pass.
+class PixelMapTransform {
+public:
+    PixelMapTransform &Crop(const Rect &rect)
+    {
+        TransformOp op;
+        op.type = TransformOpType::CROP;
+        op.rect = rect;
+        ops_.push_back(op);
+        return *this;
+    }
+
+    PixelMapTransform &Scale(float xAxis, float yAxis)
+    {
+        return Push(TransformOpType::SCALE, xAxis, yAxis);
+    }
+
+    PixelMapTransform &Rotate(float degrees)
+    {
+        return Push(TransformOpType::ROTATE, degrees, 0.0f);
+    }
+
+    PixelMapTransform &Flip(bool xAxis, bool yAxis)
+    {
+        return Push(TransformOpType::FLIP, xAxis ? 1.0f : 0.0f, yAxis ? 1.0f : 0.0f);
+    }
+
+    PixelMapTransform &Translate(float xAxis, float yAxis)
+    {
+        return Push(TransformOpType::TRANSLATE, xAxis, yAxis);
+    }
+
+    const std::vector<TransformOp> &GetOps() const
+    {
+        return ops_;
+    }
+
+    void Clear()
+    {
+        ops_.clear();
+    }
+
+private:
+    PixelMapTransform &Push(TransformOpType type, float xAxis, float yAxis)
+    {
+        TransformOp op;
+        op.type = type;
+        op.x = xAxis;
+        op.y = yAxis;
+        ops_.push_back(op);
+        return *this;
+    }
+
+    std::vector<TransformOp> ops_;
+};
+
 struct TransInfos;
 struct HdrInfo;
 
@@ -501,6 +574,18 @@ public:
      */
     NATIVEEXPORT virtual uint32_t Crop(const Rect &rect);
 
+    /**
+     * Applies recorded transforms with one resampling pass into one destination buffer.
+     * Not virtual, so the vtable layout is unchanged; YUV pixel maps still run each step through their
+     * overridden crop, scale, rotate, flip and translate.
+     *
+     * @param transform The crop, scale, rotate, flip and translate operations, in order.
+     * @param option The anti-aliasing algorithm to be used.
+     * @return The resulting status code.
+     */
+    NATIVEEXPORT uint32_t ApplyTransform(const PixelMapTransform &transform,
+        AntiAliasingOption option = AntiAliasingOption::NONE);
+
     /**
      * Get pixelmap information.
      */
@@ -1022,6 +1107,7 @@ protected:
         const int32_t &height, const int32_t &rowDataSize, const int32_t &rowStride) const;
     static bool ReadTlvAttr(std::vector<uint8_t>& buff, ImageInfo& info, std::unique_ptr<AbsMemory>& mem, int32_t& csm);
     uint32_t ApplyAffineTransform(TransInfos &infos, AntiAliasingOption option = AntiAliasingOption::NONE);
+    uint32_t ApplyTransformSequentially(const std::vector<TransformOp> &ops, AntiAliasingOption option);
     void UpdateImageInfo();
     static int32_t ConvertPixelAlpha(const void *srcPixels, const int32_t srcLength, const ImageInfo &srcInfo,
         void *dstPixels, const ImageInfo &dstInfo);
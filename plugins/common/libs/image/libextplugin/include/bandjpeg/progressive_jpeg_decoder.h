@@ -60,6 +60,8 @@ public:
         OHOS::Media::PixelFormat pixelFormat = OHOS::Media::PixelFormat::UNKNOWN;
         bool useDesiredSize = false;
         bool isRgb888Output = false;
+        // Baseline stream with restart markers, decoded by RestartJpegDecoder instead of FAST
+        bool useRestartIntervals = false;
     };
 
     struct YuvDecodeOptions {
@@ -0,0 +1,44 @@
+/*
+ * Copyright (C) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef PLUGINS_COMMON_LIBS_IMAGE_LIBEXTPLUGIN_INCLUDE_RESTART_JPEG_DECODER_H
+#define PLUGINS_COMMON_LIBS_IMAGE_LIBEXTPLUGIN_INCLUDE_RESTART_JPEG_DECODER_H
+
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+
+#include "image_type.h"
+#include "jpeglib.h"
+
+namespace OHOS {
+namespace ImagePlugin {
+/*
+ * Software decoder for baseline JPEGs carrying restart markers. The entropy-coded segment is cut at
+ * restart markers into bands of whole MCU rows, and every band is decoded by its own libjpeg
+ * decompressor straight into the destination rows, so the bands run concurrently.
+ */
+class RestartJpegDecoder {
+public:
+    // Whether the parsed header and the output format allow a banded decode.
+    static bool CanDecode(const jpeg_decompress_struct *dinfo, OHOS::Media::PixelFormat format);
+    // Returns ERR_IMAGE_DATA_UNSUPPORT when the stream cannot be banded, the caller then falls back.
+    static uint32_t Decode(const uint8_t *data, uint32_t size, OHOS::Media::PixelFormat format,
+        uint8_t *dstPixels, size_t dstStride);
+};
+} // namespace ImagePlugin
+} // namespace OHOS
+
+#endif // PLUGINS_COMMON_LIBS_IMAGE_LIBEXTPLUGIN_INCLUDE_RESTART_JPEG_DECODER_H
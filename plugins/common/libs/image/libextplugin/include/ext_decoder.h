@@ -17,7 +17,9 @@
 #define PLUGINS_COMMON_LIBS_IMAGE_LIBEXTPLUGIN_INCLUDE_EXT_DECODER_H
 
 #include <cstdint>
+#include <map>
 #include <string>
+#include <vector>
 
 #include "abs_image_decoder.h"
 #if !defined(IOS_PLATFORM) && !defined(ANDROID_PLATFORM)
@@ -176,6 +178,10 @@ private:
     uint32_t AllocHeifSingleHdrBuffer(DecodeContext &context);
     uint32_t DoHeifToSingleHdrDecode(OHOS::ImagePlugin::DecodeContext &context);
     uint32_t HandleGifCache(uint8_t* src, uint8_t* dst, uint64_t rowStride, int dstHeight);
+    int GetGifCheckpointInterval();
+    void ClearGifCheckpoints();
+    void SaveGifCheckpoint(int index);
+    uint32_t RestoreGifCheckpoint(int index, const uint64_t rowStride);
     uint32_t ParseGifMetadata();
     uint32_t GetGifHasGlobalColorMapInt(int32_t &value);
     uint32_t GetFramePixels(SkImageInfo& info, uint8_t* buffer, uint64_t rowStride, SkCodec::Options options);
@@ -231,6 +237,10 @@ private:
     int32_t frameCount_ = 0;
     uint8_t *gifCache_ = nullptr;
     int gifCacheIndex_ = 0;
+    // composited gif frames kept every N frames so that random access decodes at most N frames
+    std::map<int, std::vector<uint8_t>> gifCheckpoints_;
+    uint64_t gifCheckpointBudget_ = 0;
+    bool gifCheckpointBudgetLogged_ = false;
     FrameCacheInfo frameCacheInfo_ = {0, 0, 0, 0};
     bool gifMetadataParsed_ = false;
     bool gifHasGlobalColorMap_ = false;
@@ -191,6 +191,7 @@ private:
     OutputDataStream* output_ = nullptr;
     PlEncodeOptions opts_;
     Media::PixelMap* pixelmap_ = nullptr;
+    uint32_t pixelmapCount_ = 0;
     std::unique_ptr<PixelMap> dstPixelmap_;
     std::vector<std::shared_ptr<Media::AbsMemory>> tmpMemoryList_;
     Media::Picture* picture_ = nullptr;
@@ -17,6 +17,7 @@
 #define PLUGINS_COMMON_LIBS_IMAGE_LIBEXTPLUGIN_INCLUDE_AVIF_DECODER_IMPL_H
 
 #include <array>
+#include <deque>
 #include <memory>
 #include <numeric>
 #include <limits>
@@ -65,16 +66,37 @@ public:
         ClearPicMap();
         DeleteDecoder();
     }
-    bool CreateDecoder();
+    // frameDelay above 1 lets dav1d decode that many frames at once, pictures then come out late.
+    bool CreateDecoder(int threads = 1, int frameDelay = 1);
     void DeleteDecoder();
-    bool DecodeFrame(uint32_t index, const std::vector<uint8_t> &frameData);
+    // Sends one frame and waits for its picture. The data is not copied, it has to stay valid until the call returns.
+    bool DecodeFrame(uint32_t index, const uint8_t *frameData, size_t frameSize);
+    // Borrowed data is not copied and has to stay valid until its picture is received.
+    bool SendFrame(uint32_t index, const uint8_t *frameData, size_t frameSize, bool borrowed);
+    // Moves finished pictures into the cache. Draining waits for every frame still in flight.
+    bool ReceivePictures(bool drain);
+    // Waits until the picture of index is in the cache, frames sent after it stay in flight.
+    bool WaitForPicture(uint32_t index);
+    bool IsPending(uint32_t index) const;
+    // Drops frames in flight and the reference state, cached pictures are kept.
+    void Flush();
     void ClearPicMap();
+    // Evicts pictures behind current first, then the farthest ahead, until at most maxCount are left.
+    void TrimPicMap(uint32_t current, size_t maxCount);
     std::shared_ptr<Dav1dPicture> GetOccurDecodeFrame(uint32_t index);
     bool ConvertWithFFmpeg(uint32_t index, ConvertInfo &info);
+    int GetFrameDelay() const
+    {
+        return settings_.max_frame_delay;
+    }
 private:
     bool ConvertToRGB(SwsContext *ctx, Dav1dPicture &pic, ConvertInfo &info);
+    // Moves the next picture into the cache, returns the dav1d_get_picture result.
+    int ReceivePicture();
 
-    std::unordered_map<uint32_t, std::shared_ptr<Dav1dPicture>> picMap_;
+    std::map<uint32_t, std::shared_ptr<Dav1dPicture>> picMap_;
+    // Frame indexes sent but not output yet, dav1d outputs one picture per sample in sending order
+    std::deque<uint32_t> pendingIndices_;
     Dav1dContext *ctx_ = nullptr;
     Dav1dSettings settings_;
 };
@@ -129,8 +151,8 @@ private:
 #ifdef AVIF_DECODE_ENABLE
     bool DecodeFrame();
     bool DecodeMovieFrame(uint32_t index);
-    std::vector<std::vector<uint32_t>> CalculateMiniGroup(uint32_t index, HeifsFrameGroup groupInfo);
-    bool IsMemoryExceed(uint32_t groupNum);
+    bool SendMovieFrames(uint32_t begin, uint32_t end, uint32_t target);
+    size_t GetFrameCacheCount();
     bool InitDecoder();
 #endif
 
@@ -148,6 +170,8 @@ private:
 
 #ifdef AVIF_DECODE_ENABLE
     std::unique_ptr<Dav1dDecoder> decoder_;
+    // Next sample the decoder state can continue from without a flush
+    uint32_t nextFrameIndex_ = std::numeric_limits<uint32_t>::max();
 #endif
 };
 } // namespace ImagePlugin
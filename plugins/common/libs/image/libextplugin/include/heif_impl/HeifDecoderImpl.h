@@ -118,7 +118,7 @@ private:
 
     bool ProcessChunkHead(uint8_t *data, size_t len);
 
-    bool copyToAshmem(std::vector<std::vector<uint8_t>> &inputs, std::vector<sptr<Ashmem>> &hwInputs);
+    bool copyToAshmem(std::vector<HeifDataView> &inputs, std::vector<sptr<Ashmem>> &hwInputs);
 
     void SetHwDecodeInfo(GridInfo &gridInfo,
         OHOS::HDI::Codec::Image::V2_1::CodecHeifDecInfo &heifDecodeInfo);
@@ -129,18 +129,18 @@ private:
         sptr<SurfaceBuffer> *outBuffer, bool isPrimary, uint32_t recursionCount = 0);
 
     void PrepareInput(std::vector<std::shared_ptr<HeifImage>> tileImages,
-        std::vector<std::vector<uint8_t>> &inputs, size_t gridCount);
+        std::vector<HeifDataView> &inputs, size_t gridCount);
 
     bool IsRegionDecode();
 
     void DoRegionDecodeForUnpacked(std::vector<std::shared_ptr<HeifImage>> tileImages, uint32_t decodeIndex,
-        std::vector<std::vector<uint8_t>> &unPackedInput, std::shared_ptr<HeifImage> &tileImage);
+        std::vector<HeifDataView> &unPackedInput, std::shared_ptr<HeifImage> &tileImage);
 
     void HwRegionDecodeForUnPacked(std::vector<std::shared_ptr<HeifImage>> tileImages,
-        std::vector<std::vector<uint8_t>> &unPackedInput, size_t gridCount);
+        std::vector<HeifDataView> &unPackedInput, size_t gridCount);
 
     void HwPrepareUnPackedInput(std::vector<std::shared_ptr<HeifImage>> tileImages,
-        std::vector<std::vector<uint8_t>> &unPackedInput, size_t gridCount);
+        std::vector<HeifDataView> &unPackedInput, size_t gridCount);
 
     void DoSwRegionDecode(std::vector<std::shared_ptr<HeifImage>> tileImages,
         std::vector<std::vector<uint8_t>> &inputs, std::shared_ptr<HeifImage> &tileImage, uint32_t decodeIndex);
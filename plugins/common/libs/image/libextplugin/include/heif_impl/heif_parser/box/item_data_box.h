@@ -57,6 +57,12 @@ public:
                     const std::shared_ptr<class HeifIdatBox> &idat,
                     std::vector<uint8_t> *dest) const;
 
+    // Same bytes as ReadData, referred to in place when the item is a single extent of a memory stream.
+    heif_error ReadDataView(const Item &item,
+                    const std::shared_ptr<HeifInputStream> &stream,
+                    const std::shared_ptr<class HeifIdatBox> &idat,
+                    HeifDataView &view) const;
+
     heif_error AppendData(heif_item_id itemId,
                      const std::vector<uint8_t> &data,
                      uint8_t constructionMethod = 0);
@@ -92,6 +98,7 @@ private:
     uint8_t indexSize_ = 0;
     heif_error ParseExtents(Item& item, HeifStreamReader &reader, int indexSize, int offsetSize, int lengthSize);
     void PackIlocHeader(HeifStreamWriter &writer) const;
+    heif_error CheckExtentReadSize(const Item &item, const Extent &extent, size_t &totalSize) const;
 
     uint64_t idatOffset_ = 0;
 };
@@ -43,6 +43,23 @@ struct HeifsFrameGroup {
     uint32_t endFrameIndex = 0;
 };
 
+struct HeifMetadataLocation {
+    heif_item_id itemId = 0;
+    std::string itemType;
+    std::string contentType;
+    // absolute stream offset and length of every extent, in item order
+    std::vector<std::pair<uint64_t, uint64_t>> extents;
+
+    uint64_t GetTotalSize() const
+    {
+        uint64_t total = 0;
+        for (const auto &extent : extents) {
+            total += extent.second;
+        }
+        return total;
+    }
+};
+
 class HeifParser {
 public:
     HeifParser();
@@ -55,6 +72,10 @@ public:
 
     static heif_error MakeFromMemory(const void *data, size_t size, bool isNeedCopy, std::shared_ptr<HeifParser> *out);
 
+    // Locates the Exif and XMP items by reading only ftyp, meta, iinf, iloc and idat, without assembling images.
+    static heif_error ScanMetadataItems(const std::shared_ptr<HeifInputStream> &stream,
+                                        std::vector<HeifMetadataLocation> &locations);
+
     void Write(HeifStreamWriter &writer);
 
     std::shared_ptr<HeifImage> GetImage(heif_item_id itemId);
@@ -76,6 +97,9 @@ public:
     heif_error GetItemData(heif_item_id itemId, std::vector<uint8_t> *out,
                            heif_header_option option = heif_no_header) const;
 
+    // Same bytes as GetItemData with heif_no_header, without copying them when they lie in one piece.
+    heif_error GetItemDataView(heif_item_id itemId, HeifDataView &view) const;
+
     void ResetIlocReadDataSize()
     {
         if (ilocBox_) {
@@ -108,6 +132,8 @@ public:
 
     heif_error GetHeifsFrameData(uint32_t index, std::vector<uint8_t> &dest);
 
+    heif_error GetHeifsFrameDataView(uint32_t index, HeifDataView &view);
+
     heif_error GetHeifsDelayTime(uint32_t index, int32_t &value) const;
 
     heif_error GetHeifsGroupFrameInfo(uint32_t index, HeifsFrameGroup &frameGroup);
@@ -124,6 +150,8 @@ public:
 
     heif_error GetAvisFrameData(uint32_t index, std::vector<uint8_t> &dest);
 
+    heif_error GetAvisFrameDataView(uint32_t index, HeifDataView &view);
+
     heif_error GetAvisFrameCount(uint32_t &sampleCount) const;
 
     uint32_t GetHeifsCanvasPixelWidthHeight(uint32_t index, uint32_t &width, uint32_t &height);
@@ -174,6 +202,8 @@ private:
 
     heif_error GetPreSampleSize(uint32_t index, uint32_t &preSampleSize);
 
+    heif_error GetHeifsSampleRange(uint32_t index, uint32_t &sampleOffset, uint32_t &sampleSize);
+
     // reading functions for boxes
     heif_error AssembleBoxes(HeifStreamReader &reader);
 
@@ -35,6 +35,12 @@ public:
     virtual bool Read(void *data, size_t size) = 0;
 
     virtual bool Seek(int64_t position) = 0;
+
+    // Memory holding [position, position + size) for reading in place, nullptr when the stream has none.
+    virtual const uint8_t *PeekData(int64_t position, size_t size) const
+    {
+        return nullptr;
+    }
 };
 
 class HeifBufferInputStream : public HeifInputStream {
@@ -51,6 +57,8 @@ public:
 
     bool Seek(int64_t position) override;
 
+    const uint8_t *PeekData(int64_t position, size_t size) const override;
+
 private:
     const uint8_t *data_;
     size_t length_;
@@ -58,6 +66,37 @@ private:
     bool copied_;
 };
 
+// Read-only bytes of an item or a sample. Refers to the stream memory when the bytes lie in one piece there,
+// and holds its own copy only when they had to be gathered.
+class HeifDataView {
+public:
+    const uint8_t *Data() const { return ref_ != nullptr ? ref_ : copy_.data(); }
+
+    size_t Size() const { return ref_ != nullptr ? refSize_ : copy_.size(); }
+
+    bool IsCopied() const { return ref_ == nullptr; }
+
+    void Refer(const uint8_t *data, size_t size)
+    {
+        ref_ = data;
+        refSize_ = size;
+        copy_.clear();
+    }
+
+    std::vector<uint8_t> &ResetCopy()
+    {
+        ref_ = nullptr;
+        refSize_ = 0;
+        copy_.clear();
+        return copy_;
+    }
+
+private:
+    const uint8_t *ref_ = nullptr;
+    size_t refSize_ = 0;
+    std::vector<uint8_t> copy_;
+};
+
 class HeifStreamReader {
 public:
     HeifStreamReader(std::shared_ptr<HeifInputStream> stream,
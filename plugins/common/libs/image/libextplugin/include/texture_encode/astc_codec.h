@@ -46,6 +46,7 @@ public:
     bool TryEncSUT(TextureEncodeOptions &param, uint8_t* astcBuffer, size_t astcBufferCapacity,
         AstcExtendInfo &extendInfo);
 private:
+    static bool AstcSoftwareEncodeCoreUnpooled(TextureEncodeOptions &param, uint8_t *pixmapIn, uint8_t *astcBuffer);
     bool IsAstcEnc(Media::ImageInfo &info, uint8_t* pixmapIn, TextureEncodeOptions &param,
         AstcExtendInfo &extendInfo);
     bool InitBeforeAstcEncode(ImageInfo &imageInfo, TextureEncodeOptions &param, uint8_t &colorData,
@@ -71,6 +71,8 @@ struct AstcEncoder {
     astcenc_config config;
     astcenc_profile profile;
     astcenc_context* codec_context;
+    bool pooledContext;
+    unsigned int threadCount;
     astcenc_image image_;
     astcenc_swizzle swizzle_;
     uint8_t* data_out_;
@@ -18,6 +18,7 @@
 #include <algorithm>
 
 #include "bandjpeg/fast_manager.h"
+#include "bandjpeg/restart_jpeg_decoder.h"
 #include "image_log.h"
 #include "input_data_stream.h"
 #include "jpeg_yuv_decoder/jpeg_decoder_yuv.h"
@@ -50,14 +51,30 @@ namespace OHOS {
 namespace ImagePlugin {
 using namespace Media;
 
-static bool IsProgressiveJpegCodec(SkCodec *codec)
+static jpeg_decompress_struct *GetJpegDecompressInfo(SkCodec *codec)
 {
     bool cond = (codec == nullptr) || (codec->getEncodedFormat() != SkEncodedImageFormat::kJPEG);
-    CHECK_ERROR_RETURN_RET(cond, false);
+    CHECK_ERROR_RETURN_RET(cond, nullptr);
     auto *jpegCodec = static_cast<SkJpegCodec *>(codec);
-    cond = (jpegCodec->decoderMgr() == nullptr) || (jpegCodec->decoderMgr()->dinfo() == nullptr);
+    CHECK_ERROR_RETURN_RET(jpegCodec->decoderMgr() == nullptr, nullptr);
+    return jpegCodec->decoderMgr()->dinfo();
+}
+
+static bool IsProgressiveJpegCodec(SkCodec *codec)
+{
+    jpeg_decompress_struct *dinfo = GetJpegDecompressInfo(codec);
+    CHECK_ERROR_RETURN_RET(dinfo == nullptr, false);
+    return dinfo->progressive_mode;
+}
+
+// Baseline files with restart markers decode in bands when no scaling is requested.
+static bool CanDecodeRestartIntervals(const ProgressiveJpegDecoder::RgbDecodeOptions &options,
+    const SkImageInfo &dstInfo)
+{
+    bool cond = (options.sampleSize != DEFAULT_SAMPLE_SIZE) || (options.softSampleSize != NUM_1) ||
+        (dstInfo.width() != options.srcInfo.width()) || (dstInfo.height() != options.srcInfo.height());
     CHECK_ERROR_RETURN_RET(cond, false);
-    return jpegCodec->decoderMgr()->dinfo()->progressive_mode;
+    return RestartJpegDecoder::CanDecode(GetJpegDecompressInfo(options.codec), options.pixelFormat);
 }
 
 static bool IsLargeImage(const SkImageInfo &srcInfo)
@@ -222,8 +239,8 @@ bool ProgressiveJpegDecoder::BuildRgbDecodePlan(const RgbDecodeOptions &options,
         (options.codec->getEncodedFormat() != SkEncodedImageFormat::kJPEG) ||
         (options.dstInfo.refColorSpace().get() != options.srcInfo.refColorSpace().get());
     CHECK_ERROR_RETURN_RET(cond, false);
-    cond = (!IsLargeImage(options.srcInfo)) || (!IsProgressiveJpegCodec(options.codec));
-    CHECK_ERROR_RETURN_RET(cond, false);
+    CHECK_ERROR_RETURN_RET(!IsLargeImage(options.srcInfo), false);
+    const bool isProgressive = IsProgressiveJpegCodec(options.codec);
 
     const Size sourceSize = {
         static_cast<int32_t>(options.srcInfo.width()), static_cast<int32_t>(options.srcInfo.height())
@@ -236,6 +253,8 @@ bool ProgressiveJpegDecoder::BuildRgbDecodePlan(const RgbDecodeOptions &options,
         (decodeSize.width != options.dstInfo.width() || decodeSize.height != options.dstInfo.height());
     plan.dstInfo = plan.useDesiredSize ? options.dstInfo.makeWH(decodeSize.width, decodeSize.height) :
         options.dstInfo;
+    plan.useRestartIntervals = !isProgressive && CanDecodeRestartIntervals(options, plan.dstInfo);
+    CHECK_ERROR_RETURN_RET(!isProgressive && !plan.useRestartIntervals, false);
     plan.pixelFormat = options.pixelFormat;
     plan.isRgb888Output = options.pixelFormat == PixelFormat::RGB_888;
     plan.byteCount = GetRgbOutputByteCount(plan.dstInfo, plan.isRgb888Output);
@@ -247,6 +266,10 @@ uint32_t ProgressiveJpegDecoder::DecodeRgb(const JpegInputData &jpegData, const
 {
     CHECK_ERROR_RETURN_RET(jpegData.buffer == nullptr || jpegData.bufferSize == 0 || dstPixels == nullptr,
         ERR_IMAGE_DATA_UNSUPPORT);
+    if (plan.useRestartIntervals) {
+        return RestartJpegDecoder::Decode(jpegData.buffer, jpegData.bufferSize, plan.pixelFormat, dstPixels,
+            dstStride);
+    }
 
     fast::image::RGBFormat colorFormat = fast::image::RGBFormat::RGBA8888;
     if (plan.pixelFormat == PixelFormat::RGB_888) {
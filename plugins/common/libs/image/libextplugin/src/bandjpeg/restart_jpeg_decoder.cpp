@@ -0,0 +1,401 @@
+/*
+ * Copyright (C) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "bandjpeg/restart_jpeg_decoder.h"
+
+#include <algorithm>
+#include <csetjmp>
+#include <numeric>
+#include <vector>
+
+#include "image_log.h"
+#include "media_errors.h"
+#if !defined(CROSS_PLATFORM)
+#include "image_task_scheduler.h"
+#endif
+
+#undef LOG_DOMAIN
+#define LOG_DOMAIN LOG_TAG_DOMAIN_ID_PLUGIN
+
+#undef LOG_TAG
+#define LOG_TAG "RestartJpegDecoder"
+
+namespace {
+constexpr uint8_t MARKER_PREFIX = 0xFF;
+constexpr uint8_t MARKER_SOI = 0xD8;
+constexpr uint8_t MARKER_EOI = 0xD9;
+constexpr uint8_t MARKER_SOS = 0xDA;
+constexpr uint8_t MARKER_DRI = 0xDD;
+constexpr uint8_t MARKER_RST0 = 0xD0;
+constexpr uint8_t MARKER_RST7 = 0xD7;
+constexpr uint8_t MARKER_SOF0 = 0xC0;
+constexpr uint8_t MARKER_SOF1 = 0xC1;
+constexpr uint8_t MARKER_DHT = 0xC4;
+constexpr uint8_t MARKER_SOF15 = 0xCF;
+constexpr uint8_t MARKER_APP0 = 0xE0;
+constexpr uint8_t MARKER_APP14 = 0xEE;
+constexpr uint8_t MARKER_APP15 = 0xEF;
+constexpr uint8_t MARKER_COM = 0xFE;
+constexpr uint8_t STUFFED_ZERO = 0x00;
+constexpr uint32_t RST_COUNT = 8;
+constexpr uint32_t MARKER_SIZE = 2;
+constexpr uint32_t SOF_HEADER_SIZE = 8;
+constexpr uint32_t SOF_HEIGHT_OFFSET = 5;
+constexpr uint32_t SOF_WIDTH_OFFSET = 7;
+constexpr uint32_t SOF_COMPONENTS_OFFSET = 9;
+constexpr uint32_t SOF_COMPONENT_SIZE = 3;
+constexpr uint32_t SOS_COMPONENTS_OFFSET = 4;
+constexpr uint32_t DRI_SIZE = 4;
+constexpr uint32_t BYTE_BITS = 8;
+constexpr uint32_t NIBBLE_BITS = 4;
+constexpr uint32_t NIBBLE_MASK = 0x0F;
+constexpr uint32_t MAX_FRAME_COMPONENTS = 4;
+constexpr int32_t RGB_COMPONENTS = 3;
+constexpr int32_t RGBA_COMPONENTS = 4;
+
+// Where the pieces of a baseline single-scan stream live and how its MCU rows line up with restart intervals.
+struct RestartJpegLayout {
+    std::vector<uint8_t> header;
+    size_t headerHeightPos = 0;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t mcuWidth = 0;
+    uint32_t mcuHeight = 0;
+    uint32_t components = 0;
+    uint32_t restartInterval = 0;
+    bool needContextRows = false;
+    std::vector<uint32_t> intervalStarts;
+    std::vector<uint32_t> intervalEnds;
+};
+
+struct BandErrorMgr {
+    jpeg_error_mgr pub;
+    jmp_buf setjmpBuffer;
+};
+}
+
+namespace OHOS {
+namespace ImagePlugin {
+using namespace Media;
+
+static inline uint32_t ReadBe16(const uint8_t *data)
+{
+    return (static_cast<uint32_t>(data[0]) << BYTE_BITS) | data[1];
+}
+
+static inline void WriteBe16(uint8_t *data, uint32_t value)
+{
+    data[0] = static_cast<uint8_t>(value >> BYTE_BITS);
+    data[1] = static_cast<uint8_t>(value);
+}
+
+// length is the segment length field, segment points at the marker.
+static bool ParseFrameHeader(const uint8_t *segment, uint32_t length, RestartJpegLayout &layout)
+{
+    CHECK_ERROR_RETURN_RET(length < SOF_HEADER_SIZE, false);
+    layout.height = ReadBe16(segment + SOF_HEIGHT_OFFSET);
+    layout.width = ReadBe16(segment + SOF_WIDTH_OFFSET);
+    uint32_t components = segment[SOF_COMPONENTS_OFFSET];
+    layout.components = components;
+    bool cond = (layout.width == 0) || (layout.height == 0) || (components == 0) ||
+        (components > MAX_FRAME_COMPONENTS) || (length < SOF_HEADER_SIZE + components * SOF_COMPONENT_SIZE);
+    CHECK_ERROR_RETURN_RET(cond, false);
+    if (components == 1) {
+        // A single component scan is not interleaved, each MCU is one block
+        layout.mcuWidth = DCTSIZE;
+        layout.mcuHeight = DCTSIZE;
+        layout.needContextRows = false;
+        return true;
+    }
+    uint32_t maxH = 1;
+    uint32_t maxV = 1;
+    uint32_t minV = UINT32_MAX;
+    for (uint32_t i = 0; i < components; i++) {
+        uint32_t sampling = segment[SOF_COMPONENTS_OFFSET + 1 + i * SOF_COMPONENT_SIZE + 1];
+        uint32_t h = sampling >> NIBBLE_BITS;
+        uint32_t v = sampling & NIBBLE_MASK;
+        CHECK_ERROR_RETURN_RET(h == 0 || v == 0, false);
+        maxH = std::max(maxH, h);
+        maxV = std::max(maxV, v);
+        minV = std::min(minV, v);
+    }
+    layout.mcuWidth = DCTSIZE * maxH;
+    layout.mcuHeight = DCTSIZE * maxV;
+    // Fancy upsampling of vertically subsampled chroma reads the row groups above and below
+    layout.needContextRows = minV < maxV;
+    return true;
+}
+
+// Copies the tables needed to decode a band into layout.header, up to and including SOS.
+static bool ParseHeaders(const uint8_t *data, uint32_t size, RestartJpegLayout &layout, uint32_t &scanStart)
+{
+    bool cond = (size < MARKER_SIZE) || (data[0] != MARKER_PREFIX) || (data[1] != MARKER_SOI);
+    CHECK_ERROR_RETURN_RET(cond, false);
+    layout.header.assign(data, data + MARKER_SIZE);
+    uint32_t pos = MARKER_SIZE;
+    bool hasFrame = false;
+    while (pos + DRI_SIZE <= size) {
+        CHECK_ERROR_RETURN_RET(data[pos] != MARKER_PREFIX, false);
+        uint8_t marker = data[pos + 1];
+        if (marker == MARKER_PREFIX) {
+            pos++;
+            continue;
+        }
+        CHECK_ERROR_RETURN_RET(marker >= MARKER_RST0 && marker <= MARKER_EOI, false);
+        uint32_t length = ReadBe16(data + pos + MARKER_SIZE);
+        cond = (length < MARKER_SIZE) || (pos + MARKER_SIZE + length > size);
+        CHECK_ERROR_RETURN_RET(cond, false);
+        const uint8_t *segment = data + pos;
+        uint32_t segmentEnd = pos + MARKER_SIZE + length;
+        pos = segmentEnd;
+        if (marker == MARKER_SOF0 || marker == MARKER_SOF1) {
+            CHECK_ERROR_RETURN_RET(hasFrame || !ParseFrameHeader(segment, length, layout), false);
+            hasFrame = true;
+            layout.headerHeightPos = layout.header.size() + SOF_HEIGHT_OFFSET;
+        } else if (marker > MARKER_SOF1 && marker <= MARKER_SOF15 && marker != MARKER_DHT) {
+            // Progressive, lossless, hierarchical and arithmetic coded frames stay on the other paths
+            return false;
+        } else if (marker == MARKER_DRI) {
+            CHECK_ERROR_RETURN_RET(length != DRI_SIZE, false);
+            layout.restartInterval = ReadBe16(segment + DRI_SIZE);
+        } else if ((marker > MARKER_APP0 && marker <= MARKER_APP15 && marker != MARKER_APP14) ||
+            marker == MARKER_COM) {
+            // Exif, ICC and comments do not take part in decoding
+            continue;
+        }
+        layout.header.insert(layout.header.end(), segment, data + segmentEnd);
+        if (marker == MARKER_SOS) {
+            CHECK_ERROR_RETURN_RET(!hasFrame || length <= MARKER_SIZE, false);
+            // All components must be interleaved in this one scan
+            scanStart = segmentEnd;
+            return segment[SOS_COMPONENTS_OFFSET] == layout.components;
+        }
+    }
+    return false;
+}
+
+// Records where every restart interval's entropy-coded data begins and ends, RSTn markers excluded.
+static bool IndexRestartIntervals(const uint8_t *data, uint32_t size, uint32_t scanStart, RestartJpegLayout &layout)
+{
+    uint32_t intervalStart = scanStart;
+    uint32_t pos = scanStart;
+    while (pos + 1 < size) {
+        if (data[pos] != MARKER_PREFIX) {
+            pos++;
+            continue;
+        }
+        uint8_t marker = data[pos + 1];
+        if (marker == STUFFED_ZERO) {
+            pos += MARKER_SIZE;
+        } else if (marker == MARKER_PREFIX) {
+            pos++;
+        } else if (marker >= MARKER_RST0 && marker <= MARKER_RST7) {
+            uint32_t expected = MARKER_RST0 + layout.intervalStarts.size() % RST_COUNT;
+            CHECK_ERROR_RETURN_RET(marker != expected, false);
+            layout.intervalStarts.push_back(intervalStart);
+            layout.intervalEnds.push_back(pos);
+            pos += MARKER_SIZE;
+            intervalStart = pos;
+        } else {
+            // EOI, or another scan we do not handle, ends the banded part
+            CHECK_ERROR_RETURN_RET(marker != MARKER_EOI, false);
+            layout.intervalStarts.push_back(intervalStart);
+            layout.intervalEnds.push_back(pos);
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool ParseLayout(const uint8_t *data, uint32_t size, RestartJpegLayout &layout)
+{
+    uint32_t scanStart = 0;
+    CHECK_ERROR_RETURN_RET(!ParseHeaders(data, size, layout, scanStart), false);
+    CHECK_ERROR_RETURN_RET(layout.restartInterval == 0, false);
+    CHECK_ERROR_RETURN_RET(!IndexRestartIntervals(data, size, scanStart, layout), false);
+    uint64_t mcusPerRow = (layout.width + layout.mcuWidth - 1) / layout.mcuWidth;
+    uint64_t mcuRows = (layout.height + layout.mcuHeight - 1) / layout.mcuHeight;
+    uint64_t intervals = (mcusPerRow * mcuRows + layout.restartInterval - 1) / layout.restartInterval;
+    return layout.intervalStarts.size() == intervals;
+}
+
+static void BandErrorExit(j_common_ptr cinfo)
+{
+    auto *err = reinterpret_cast<BandErrorMgr *>(cinfo->err);
+    longjmp(err->setjmpBuffer, 1);
+}
+
+static void BandOutputMessage(j_common_ptr cinfo)
+{
+    char buffer[JMSG_LENGTH_MAX];
+    (*cinfo->err->format_message)(cinfo, buffer);
+    IMAGE_LOGD("restart jpeg band: %{public}s", buffer);
+}
+
+struct BandRequest {
+    const std::vector<uint8_t> *stream = nullptr;
+    J_COLOR_SPACE colorSpace = JCS_EXT_RGBA;
+    uint32_t skipRows = 0;
+    uint32_t rows = 0;
+    uint8_t *dst = nullptr;
+    size_t dstStride = 0;
+    uint8_t *scratchRow = nullptr;
+};
+
+// Decodes a synthetic band stream, drops the context rows above the band and stops after its last row.
+static bool DecodeBandStream(const BandRequest &request)
+{
+    jpeg_decompress_struct dinfo;
+    BandErrorMgr jerr;
+    dinfo.err = jpeg_std_error(&jerr.pub);
+    jerr.pub.error_exit = BandErrorExit;
+    jerr.pub.output_message = BandOutputMessage;
+    if (setjmp(jerr.setjmpBuffer)) {
+        jpeg_destroy_decompress(&dinfo);
+        return false;
+    }
+    jpeg_create_decompress(&dinfo);
+    jpeg_mem_src(&dinfo, const_cast<uint8_t *>(request.stream->data()),
+        static_cast<unsigned long>(request.stream->size()));
+    jpeg_read_header(&dinfo, TRUE);
+    dinfo.out_color_space = request.colorSpace;
+    jpeg_start_decompress(&dinfo);
+    JSAMPROW row = request.scratchRow;
+    while (dinfo.output_scanline < request.skipRows) {
+        jpeg_read_scanlines(&dinfo, &row, 1);
+    }
+    bool success = true;
+    for (uint32_t i = 0; i < request.rows && success; i++) {
+        row = request.dst + i * request.dstStride;
+        success = jpeg_read_scanlines(&dinfo, &row, 1) == 1;
+    }
+    // Corrupt data only warns in libjpeg, leave such files to the sequential decoder
+    success = success && jerr.pub.num_warnings == 0;
+    jpeg_abort_decompress(&dinfo);
+    jpeg_destroy_decompress(&dinfo);
+    return success;
+}
+
+// Builds a stream holding intervals [first, last) as a complete image of the given height.
+static void BuildBandStream(const RestartJpegLayout &layout, const uint8_t *data, uint32_t first, uint32_t last,
+    uint32_t height, std::vector<uint8_t> &stream)
+{
+    size_t size = layout.header.size() + MARKER_SIZE * (last - first);
+    for (uint32_t i = first; i < last; i++) {
+        size += layout.intervalEnds[i] - layout.intervalStarts[i];
+    }
+    stream.reserve(size);
+    stream.assign(layout.header.begin(), layout.header.end());
+    WriteBe16(stream.data() + layout.headerHeightPos, height);
+    for (uint32_t i = first; i < last; i++) {
+        if (i != first) {
+            stream.push_back(MARKER_PREFIX);
+            stream.push_back(static_cast<uint8_t>(MARKER_RST0 + (i - first - 1) % RST_COUNT));
+        }
+        stream.insert(stream.end(), data + layout.intervalStarts[i], data + layout.intervalEnds[i]);
+    }
+    stream.push_back(MARKER_PREFIX);
+    stream.push_back(MARKER_EOI);
+}
+
+static J_COLOR_SPACE GetOutputColorSpace(PixelFormat format, int32_t &components)
+{
+    components = RGBA_COMPONENTS;
+    if (format == PixelFormat::BGRA_8888) {
+        return JCS_EXT_BGRA;
+    }
+    if (format == PixelFormat::RGB_888) {
+        components = RGB_COMPONENTS;
+        return JCS_RGB;
+    }
+    return JCS_EXT_RGBA;
+}
+
+bool RestartJpegDecoder::CanDecode(const jpeg_decompress_struct *dinfo, PixelFormat format)
+{
+#if !defined(CROSS_PLATFORM)
+    bool cond = (dinfo == nullptr) || (dinfo->progressive_mode) || (dinfo->arith_code) ||
+        (dinfo->restart_interval == 0) || (dinfo->comps_in_scan != dinfo->num_components);
+    CHECK_ERROR_RETURN_RET(cond, false);
+    cond = !((dinfo->jpeg_color_space == JCS_YCbCr && dinfo->num_components == RGB_COMPONENTS) ||
+        (dinfo->jpeg_color_space == JCS_GRAYSCALE && dinfo->num_components == 1));
+    CHECK_ERROR_RETURN_RET(cond, false);
+    cond = (format != PixelFormat::RGBA_8888) && (format != PixelFormat::BGRA_8888) &&
+        (format != PixelFormat::RGB_888);
+    CHECK_ERROR_RETURN_RET(cond, false);
+    return ImageTaskScheduler::GetWorkerCount() > 1;
+#else
+    return false;
+#endif
+}
+
+uint32_t RestartJpegDecoder::Decode(const uint8_t *data, uint32_t size, PixelFormat format,
+    uint8_t *dstPixels, size_t dstStride)
+{
+#if !defined(CROSS_PLATFORM)
+    CHECK_ERROR_RETURN_RET(data == nullptr || size == 0 || dstPixels == nullptr, ERR_IMAGE_DATA_UNSUPPORT);
+    RestartJpegLayout layout;
+    CHECK_ERROR_RETURN_RET_LOG(!ParseLayout(data, size, layout), ERR_IMAGE_DATA_UNSUPPORT,
+        "restart jpeg decode fallback, restart markers do not cover the scan");
+    // Bands may only start at MCU rows that also start a restart interval
+    uint32_t mcusPerRow = (layout.width + layout.mcuWidth - 1) / layout.mcuWidth;
+    uint32_t mcuRows = (layout.height + layout.mcuHeight - 1) / layout.mcuHeight;
+    uint32_t unitMcuRows = layout.restartInterval / std::gcd(layout.restartInterval, mcusPerRow);
+    uint32_t intervalsPerUnit = static_cast<uint32_t>(static_cast<uint64_t>(unitMcuRows) * mcusPerRow /
+        layout.restartInterval);
+    uint32_t units = (mcuRows + unitMcuRows - 1) / unitMcuRows;
+    uint32_t bandCount = std::min(units, static_cast<uint32_t>(ImageTaskScheduler::GetWorkerCount()));
+    CHECK_ERROR_RETURN_RET_LOG(bandCount < 2, ERR_IMAGE_DATA_UNSUPPORT,
+        "restart jpeg decode fallback, %{public}u band units", units);
+    uint32_t unitsPerBand = (units + bandCount - 1) / bandCount;
+    bandCount = (units + unitsPerBand - 1) / unitsPerBand;
+    uint32_t unitRows = unitMcuRows * layout.mcuHeight;
+    uint32_t contextUnits = layout.needContextRows ? 1 : 0;
+    uint32_t intervalCount = static_cast<uint32_t>(layout.intervalStarts.size());
+    int32_t components = RGBA_COMPONENTS;
+    J_COLOR_SPACE colorSpace = GetOutputColorSpace(format, components);
+
+    std::vector<uint8_t> results(bandCount, 0);
+    int64_t costPerBand = static_cast<int64_t>(layout.width) * unitRows * unitsPerBand;
+    ImageTaskScheduler::ParallelForRows(static_cast<int32_t>(bandCount), costPerBand,
+        [&](int32_t start, int32_t end) {
+            std::vector<uint8_t> stream;
+            std::vector<uint8_t> scratchRow(static_cast<size_t>(layout.width) * components);
+            for (int32_t band = start; band < end; band++) {
+                uint32_t firstUnit = static_cast<uint32_t>(band) * unitsPerBand;
+                uint32_t lastUnit = std::min(firstUnit + unitsPerBand, units);
+                uint32_t decodeFirst = firstUnit - std::min(firstUnit, contextUnits);
+                uint32_t decodeLast = std::min(lastUnit + contextUnits, units);
+                uint32_t decodeTop = decodeFirst * unitRows;
+                uint32_t firstRow = firstUnit * unitRows;
+                uint32_t lastRow = std::min(lastUnit * unitRows, layout.height);
+                BuildBandStream(layout, data, decodeFirst * intervalsPerUnit,
+                    std::min(decodeLast * intervalsPerUnit, intervalCount),
+                    std::min(decodeLast * unitRows, layout.height) - decodeTop, stream);
+                BandRequest request = { &stream, colorSpace, firstRow - decodeTop, lastRow - firstRow,
+                    dstPixels + firstRow * dstStride, dstStride, scratchRow.data() };
+                results[band] = DecodeBandStream(request) ? 1 : 0;
+            }
+        });
+    bool cond = std::find(results.begin(), results.end(), 0) != results.end();
+    CHECK_ERROR_RETURN_RET_LOG(cond, ERR_IMAGE_DATA_UNSUPPORT, "restart jpeg decode fallback, band decode failed");
+    IMAGE_LOGI("restart jpeg decode success, %{public}u bands", bandCount);
+    return SUCCESS;
+#else
+    return ERR_IMAGE_DATA_UNSUPPORT;
+#endif
+}
+} // namespace ImagePlugin
+} // namespace OHOS
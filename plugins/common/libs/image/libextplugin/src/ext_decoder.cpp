@@ -16,6 +16,8 @@
 #include "ext_decoder.h"
 
 #include <algorithm>
+#include <cstdlib>
+#include <iterator>
 #include <map>
 #include <sstream>
 #if !defined(IOS_PLATFORM) && !defined(ANDROID_PLATFORM)
@@ -532,6 +534,7 @@ void ExtDecoder::SetSource(InputDataStream &sourceStream)
 {
     stream_ = &sourceStream;
     streamOff_ = sourceStream.Tell();
+    ClearGifCheckpoints();
     if (streamOff_ >= sourceStream.GetStreamSize()) {
         streamOff_ = ZERO;
     }
@@ -548,6 +551,7 @@ void ExtDecoder::Reset()
     rawEncodedFormat_.clear();
     gifMetadataParsed_ = false;
     gifHasGlobalColorMap_ = false;
+    ClearGifCheckpoints();
 }
 
 static inline float Max(float a, float b)
@@ -917,6 +921,11 @@ uint32_t ExtDecoder::SetDecodeOptions(uint32_t index, const PixelDecodeOptions &
     cond = opts.sampleSize != DEFAULT_SAMPLE_SIZE;
     CHECK_ERROR_RETURN_RET_LOG(cond, ERR_IMAGE_INVALID_PARAMETER, "Do not support sample size now!");
     cropAndScaleStrategy_ = opts.cropAndScaleStrategy;
+    if (gifCheckpointBudget_ != opts.animationCacheBudget) {
+        ClearGifCheckpoints();
+    }
+    gifCheckpointBudget_ = opts.animationCacheBudget;
+    SkImageInfo lastDstInfo = dstInfo_;
     auto desireColor = ConvertToColorType(opts.desiredPixelFormat, info.pixelFormat);
     auto desireAlpha = ConvertToAlphaType(opts.desireAlphaType, info.alphaType);
 #if !defined(IOS_PLATFORM) && !defined(ANDROID_PLATFORM)
@@ -994,6 +1003,10 @@ uint32_t ExtDecoder::SetDecodeOptions(uint32_t index, const PixelDecodeOptions &
     info.size.width = dstInfo_.width();
     info.size.height = dstInfo_.height();
     reusePixelmap_ = opts.plReusePixelmap;
+    if (dstInfo_ != lastDstInfo) {
+        // checkpoints hold composited canvases in the previous destination layout
+        ClearGifCheckpoints();
+    }
     return SUCCESS;
 }
 
@@ -2224,7 +2237,7 @@ uint32_t ExtDecoder::ApplyDesiredColorSpaceIfNeeded(DecodeContext &context)
         IMAGE_LOGE("ApplyDesiredColorSpace failed, err=%{public}u", csRet);
         return ERR_IMAGE_COLOR_CONVERT;
     }
-    return SUCCESS;
+    return SUCCESS;
 }
 
 void ExtDecoder::UpdateHardWareDecodeInfo(DecodeContext &context, const SkImageInfo& info)
@@ -2360,12 +2373,102 @@ uint32_t ExtDecoder::GetFramePixels(SkImageInfo& info, uint8_t* buffer, uint64_t
     return SUCCESS;
 }
 
+int ExtDecoder::GetGifCheckpointInterval()
+{
+    bool cond = gifCheckpointBudget_ == 0 || frameCacheInfo_.byteCount == 0 || frameCount_ <= 0;
+    CHECK_ERROR_RETURN_RET(cond, 0);
+    uint64_t maxCheckpoints = gifCheckpointBudget_ / frameCacheInfo_.byteCount;
+    CHECK_ERROR_RETURN_RET(maxCheckpoints == 0, 0);
+    uint64_t frameCount = static_cast<uint64_t>(frameCount_);
+    return static_cast<int>(std::max<uint64_t>(1, (frameCount + maxCheckpoints - 1) / maxCheckpoints));
+}
+
+void ExtDecoder::ClearGifCheckpoints()
+{
+    gifCheckpoints_.clear();
+    gifCheckpointBudgetLogged_ = false;
+}
+
+void ExtDecoder::SaveGifCheckpoint(int index)
+{
+    int interval = GetGifCheckpointInterval();
+    bool cond = interval == 0 || gifCache_ == nullptr || index % interval != 0 ||
+        gifCheckpoints_.find(index) != gifCheckpoints_.end();
+    CHECK_ERROR_RETURN(cond);
+    // keep the checkpoints closest to where playback is, dropping the one farthest from this frame
+    while (!gifCheckpoints_.empty() &&
+        (gifCheckpoints_.size() + 1) * frameCacheInfo_.byteCount > gifCheckpointBudget_) {
+        if (!gifCheckpointBudgetLogged_) {
+            IMAGE_LOGD("gif checkpoint budget reached at frame %{public}d", index);
+            gifCheckpointBudgetLogged_ = true;
+        }
+        auto first = gifCheckpoints_.begin();
+        auto last = std::prev(gifCheckpoints_.end());
+        gifCheckpoints_.erase(std::abs(index - first->first) >= std::abs(last->first - index) ? first : last);
+    }
+    gifCheckpoints_[index].assign(gifCache_, gifCache_ + frameCacheInfo_.byteCount);
+}
+
+uint32_t ExtDecoder::RestoreGifCheckpoint(int index, const uint64_t rowStride)
+{
+    CHECK_ERROR_RETURN_RET(GetGifCheckpointInterval() == 0, SUCCESS);
+    // the canvas frame N builds on is the last frame before N that is not restored to previous
+    int target = index - 1;
+    SkCodec::FrameInfo frameInfo {};
+    while (target >= 0 && codec_->getFrameInfo(target, &frameInfo) &&
+        frameInfo.fDisposalMethod == SkCodecAnimation::DisposalMethod::kRestorePrevious) {
+        target--;
+    }
+    bool cond = target < 0 || gifCacheIndex_ == target;
+    CHECK_ERROR_RETURN_RET(cond, SUCCESS);
+
+    int start = SkCodec::kNoFrame;
+    auto checkpoint = gifCheckpoints_.upper_bound(target);
+    if (checkpoint != gifCheckpoints_.begin()) {
+        --checkpoint;
+        start = checkpoint->first;
+    }
+    if (gifCacheIndex_ < target && gifCacheIndex_ >= start) {
+        start = gifCacheIndex_;
+    } else if (start != SkCodec::kNoFrame) {
+        errno_t err = memcpy_s(gifCache_, frameCacheInfo_.byteCount, checkpoint->second.data(),
+            checkpoint->second.size());
+        CHECK_ERROR_RETURN_RET_LOG(err != EOK, ERR_IMAGE_DECODE_ABNORMAL,
+            "restore gif checkpoint failed. errno:%{public}d", err);
+        gifCacheIndex_ = start;
+    }
+    IMAGE_LOGD("gif roll forward from %{public}d to %{public}d", start, target);
+    SkCodec::Options options = dstOptions_;
+    bool hasCanvas = start != SkCodec::kNoFrame;
+    for (int frame = start + 1; frame <= target; frame++) {
+        codec_->getFrameInfo(frame, &frameInfo);
+        if (frameInfo.fDisposalMethod == SkCodecAnimation::DisposalMethod::kRestorePrevious) {
+            continue;
+        }
+        options.fPriorFrame = hasCanvas ? gifCacheIndex_ : SkCodec::kNoFrame;
+        hasCanvas = true;
+        uint32_t ret = GetFramePixels(dstInfo_, gifCache_, rowStride, options);
+        if (ret != SUCCESS) {
+            gifCacheIndex_ = SkCodec::kNoFrame;
+            return ret;
+        }
+        gifCacheIndex_ = frame;
+        SaveGifCheckpoint(frame);
+    }
+    return SUCCESS;
+}
+
 uint32_t ExtDecoder::GifDecode(uint32_t index, DecodeContext &context, const uint64_t rowStride)
 {
     IMAGE_LOGD("In GifDecoder, frame index %{public}d", index);
     SkCodec::FrameInfo curInfo {};
     int signedIndex = static_cast<int>(index);
     codec_->getFrameInfo(signedIndex, &curInfo);
+    ExtDecoder::FrameCacheInfo dstFrameCacheInfo = InitFrameCacheInfo(rowStride, dstInfo_);
+    if (signedIndex != 0 && gifCache_ != nullptr && FrameCacheInfoIsEqual(frameCacheInfo_, dstFrameCacheInfo)) {
+        uint32_t ret = RestoreGifCheckpoint(signedIndex, rowStride);
+        CHECK_ERROR_RETURN_RET(ret != SUCCESS, ret);
+    }
     if (signedIndex == 0 || gifCache_ == nullptr) {
         dstOptions_.fPriorFrame = SkCodec::kNoFrame;
     } else {
@@ -2378,7 +2481,6 @@ uint32_t ExtDecoder::GifDecode(uint32_t index, DecodeContext &context, const uin
             dstOptions_.fPriorFrame = gifCacheIndex_ == preIndex ? preIndex : SkCodec::kNoFrame;
         }
     }
-    ExtDecoder::FrameCacheInfo dstFrameCacheInfo = InitFrameCacheInfo(rowStride, dstInfo_);
     uint8_t* dstBuffer = static_cast<uint8_t *>(context.pixelsBuffer.buffer);
     if (curInfo.fDisposalMethod != SkCodecAnimation::DisposalMethod::kRestorePrevious) {
         if (gifCache_ == nullptr) {
@@ -2396,6 +2498,7 @@ uint32_t ExtDecoder::GifDecode(uint32_t index, DecodeContext &context, const uin
         cond = ret != SUCCESS;
         CHECK_ERROR_RETURN_RET(cond, ret);
         gifCacheIndex_ = signedIndex;
+        SaveGifCheckpoint(signedIndex);
         return HandleGifCache(gifCache_, dstBuffer, dstFrameCacheInfo.rowStride, dstFrameCacheInfo.height);
     }
     if (gifCache_ != nullptr && FrameCacheInfoIsEqual(frameCacheInfo_, dstFrameCacheInfo)) {
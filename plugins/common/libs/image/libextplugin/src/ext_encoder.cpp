@@ -292,12 +292,14 @@ uint32_t ExtEncoder::StartEncode(OutputDataStream &outputStream, PlEncodeOptions
 {
     output_ = &outputStream;
     opts_ = option;
+    pixelmapCount_ = 0;
     return SUCCESS;
 }
 
 uint32_t ExtEncoder::AddImage(PixelMap &pixelMap)
 {
     pixelmap_ = &pixelMap;
+    pixelmapCount_++;
     return SUCCESS;
 }
 
@@ -551,6 +553,10 @@ uint32_t ExtEncoder::FinalizeEncode()
         return astcEncoder.ASTCEncode();
     }
 #endif
+    // Animated webp is left to the webp plugin encoder.
+    bool isAnimatedWebp = pixelmapCount_ > 1 && LowerStr(opts_.format) == IMAGE_WEBP_FORMAT;
+    CHECK_ERROR_RETURN_RET_LOG(isAnimatedWebp, ERR_IMAGE_INVALID_PARAMETER,
+        "ExtEncoder::FinalizeEncode %{public}u webp frames, skip", pixelmapCount_);
     auto iter = FORMAT_NAME.find(LowerStr(opts_.format));
     if (iter == FORMAT_NAME.end()) {
         IMAGE_LOGE("ExtEncoder::FinalizeEncode unsupported format %{public}s", opts_.format.c_str());
@@ -15,12 +15,14 @@
 
 #include "AvifDecoderImpl.h"
 
+#include <algorithm>
 #include <cmath>
 #include <dlfcn.h>
 #include <sys/timerfd.h>
 #include <sys/mman.h>
 #include <sstream>
 #include <limits>
+#include <thread>
 #include "image_func_timer.h"
 #include "image_system_properties.h"
 #include "image_trace.h"
@@ -62,10 +64,9 @@ static constexpr uint32_t V_PLANE_INDEX = 2;
 static constexpr uint32_t Y_STRIDE_INDEX = 0;
 static constexpr uint32_t U_STRIDE_INDEX = 1;
 static constexpr uint32_t V_STRIDE_INDEX = 1;
-static constexpr uint32_t MIN_GROUP_NUM = 1;
-static constexpr uint32_t GROUP_DIVIDE_NUM = 2;
-// To ensure synchronous calls
-static constexpr int DEFAULT_THREAD_NUM = 1;
+static constexpr int AVIS_AUTO_THREADS_MAX = 4;
+static constexpr int AVIS_FRAME_DELAY_MAX = 2;
+static constexpr uint64_t AVIS_FRAME_CACHE_BUDGET = 64 * 1024 * 1024;
 static constexpr uint32_t PRIMARY_IMAGE_INDEX = std::numeric_limits<uint32_t>::max();
 static constexpr uint32_t DAV1D_SIZE_ALIGNMENT = 128;
 static constexpr uint32_t MAX_IMAGE_SIZE = 20000;
@@ -202,12 +203,13 @@ bool Dav1dDecoder::ConvertWithFFmpeg(uint32_t index, ConvertInfo &info)
     return ret;
 }
 
-bool Dav1dDecoder::CreateDecoder()
+bool Dav1dDecoder::CreateDecoder(int threads, int frameDelay)
 {
     CHECK_ERROR_RETURN_RET(ctx_, true);
-    IMAGE_LOGD("%{public}s IN.", __func__);
+    IMAGE_LOGD("%{public}s IN, threads %{public}d, frame delay %{public}d.", __func__, threads, frameDelay);
     dav1d_default_settings(&settings_);
-    settings_.n_threads = DEFAULT_THREAD_NUM;
+    settings_.n_threads = std::max(threads, 1);
+    settings_.max_frame_delay = std::max(frameDelay, 1);
     return dav1d_open(&ctx_, &settings_) == 0;
 }
 
@@ -224,41 +226,142 @@ void Dav1dDecoder::ClearPicMap()
     decltype(picMap_){}.swap(picMap_);
 }
 
+void Dav1dDecoder::TrimPicMap(uint32_t current, size_t maxCount)
+{
+    while (picMap_.size() > maxCount) {
+        auto victim = picMap_.begin()->first < current ? picMap_.begin() : std::prev(picMap_.end());
+        if (victim->first == current) {
+            return;
+        }
+        picMap_.erase(victim);
+    }
+}
+
+void Dav1dDecoder::Flush()
+{
+    CHECK_ERROR_RETURN(!ctx_);
+    dav1d_flush(ctx_);
+    pendingIndices_.clear();
+}
+
 std::shared_ptr<Dav1dPicture> Dav1dDecoder::GetOccurDecodeFrame(uint32_t index)
 {
     auto resIt = picMap_.find(index);
     return resIt != picMap_.end() ? resIt->second : nullptr;
 }
 
-bool Dav1dDecoder::DecodeFrame(uint32_t index, const std::vector<uint8_t> &frameData)
+bool Dav1dDecoder::SendFrame(uint32_t index, const uint8_t *frameData, size_t frameSize, bool borrowed)
 {
-    Dav1dData data;
-    int wrapRet = dav1d_data_wrap(&data, frameData.data(), frameData.size(), Dav1dFreeCallback, nullptr);
-    CHECK_ERROR_RETURN_RET_LOG(wrapRet != 0, false,
-        "%{public}s dav1d_data_wrap failed ret:%{public}d.", __func__, wrapRet);
     CHECK_ERROR_RETURN_RET_LOG(!ctx_, false, "ctx_ is nullptr.");
-    int sendRet = dav1d_send_data(ctx_, &data);
-    CHECK_ERROR_RETURN_RET_LOG(sendRet < 0, false,
-        "%{public}s dav1d_send_data failed ret:%{public}d.", __func__, sendRet);
+    CHECK_ERROR_RETURN_RET_LOG(frameData == nullptr || frameSize == 0, false,
+        "%{public}s frame %{public}u has no data.", __func__, index);
+    Dav1dData data;
+    if (borrowed) {
+        int wrapRet = dav1d_data_wrap(&data, frameData, frameSize, Dav1dFreeCallback, nullptr);
+        CHECK_ERROR_RETURN_RET_LOG(wrapRet != 0, false,
+            "%{public}s dav1d_data_wrap failed ret:%{public}d.", __func__, wrapRet);
+    } else {
+        uint8_t *buffer = dav1d_data_create(&data, frameSize);
+        CHECK_ERROR_RETURN_RET_LOG(buffer == nullptr, false, "%{public}s dav1d_data_create failed.", __func__);
+        if (memcpy_s(buffer, frameSize, frameData, frameSize) != EOK) {
+            dav1d_data_unref(&data);
+            return false;
+        }
+    }
+    pendingIndices_.push_back(index);
+    while (data.sz > 0) {
+        int sendRet = dav1d_send_data(ctx_, &data);
+        if (sendRet == DAV1D_ERR(EAGAIN)) {
+            // The output queue is full, pictures have to be taken out before the rest of the data fits
+            size_t pending = pendingIndices_.size();
+            if (ReceivePictures(true) && pendingIndices_.size() < pending) {
+                continue;
+            }
+        }
+        if (sendRet < 0) {
+            IMAGE_LOGE("%{public}s dav1d_send_data failed ret:%{public}d.", __func__, sendRet);
+            dav1d_data_unref(&data);
+            return false;
+        }
+    }
+    return true;
+}
+
+int Dav1dDecoder::ReceivePicture()
+{
     std::unique_ptr<Dav1dPicture> pic = std::make_unique<Dav1dPicture>();
-    CHECK_ERROR_RETURN_RET_LOG(!pic, false, "%{public}s new Dav1dPicture failed.", __func__);
-    CHECK_ERROR_RETURN_RET_LOG(memset_s(pic.get(), sizeof(*pic), 0, sizeof(*pic)) != EOK, false,
-        "%{public}s dav1d_data_wrap failed.", __func__);
+    CHECK_ERROR_RETURN_RET_LOG(!pic, DAV1D_ERR(ENOMEM), "%{public}s new Dav1dPicture failed.", __func__);
+    CHECK_ERROR_RETURN_RET_LOG(memset_s(pic.get(), sizeof(*pic), 0, sizeof(*pic)) != EOK, DAV1D_ERR(EINVAL),
+        "%{public}s memset_s failed.", __func__);
     int getRet = dav1d_get_picture(ctx_, pic.get());
-    CHECK_ERROR_RETURN_RET_LOG(getRet < 0, false,
+    if (getRet == DAV1D_ERR(EAGAIN)) {
+        return getRet;
+    }
+    CHECK_ERROR_RETURN_RET_LOG(getRet < 0, getRet,
         "%{public}s dav1d_get_picture failed. ret:%{public}d", __func__, getRet);
-
     IMAGE_LOGD("size(%{public}d, %{public}d) stride(%{public}zu, %{public}zu) layout(%{public}d) bpc(%{public}d)",
         pic->p.w, pic->p.h, static_cast<size_t>(pic->stride[Y_STRIDE_INDEX]),
         static_cast<size_t>(pic->stride[U_STRIDE_INDEX]), pic->p.layout, pic->p.bpc);
-
     auto picDeleter = [](Dav1dPicture *p) {
         if (p) {
             dav1d_picture_unref(p);
             delete p;
         }
     };
-    picMap_[index] = std::shared_ptr<Dav1dPicture>(pic.release(), picDeleter);
+    picMap_[pendingIndices_.front()] = std::shared_ptr<Dav1dPicture>(pic.release(), picDeleter);
+    pendingIndices_.pop_front();
+    return 0;
+}
+
+bool Dav1dDecoder::ReceivePictures(bool drain)
+{
+    CHECK_ERROR_RETURN_RET_LOG(!ctx_, false, "ctx_ is nullptr.");
+    bool retried = false;
+    while (!pendingIndices_.empty()) {
+        int getRet = ReceivePicture();
+        if (getRet == DAV1D_ERR(EAGAIN)) {
+            // dav1d only waits for the frame threads on the second call in a row without new data
+            if (!drain || retried) {
+                return true;
+            }
+            retried = true;
+            continue;
+        }
+        CHECK_ERROR_RETURN_RET(getRet < 0, false);
+    }
+    return true;
+}
+
+bool Dav1dDecoder::IsPending(uint32_t index) const
+{
+    return std::find(pendingIndices_.begin(), pendingIndices_.end(), index) != pendingIndices_.end();
+}
+
+bool Dav1dDecoder::WaitForPicture(uint32_t index)
+{
+    CHECK_ERROR_RETURN_RET_LOG(!ctx_, false, "ctx_ is nullptr.");
+    bool retried = false;
+    while (IsPending(index)) {
+        int getRet = ReceivePicture();
+        if (getRet == DAV1D_ERR(EAGAIN)) {
+            // Pictures come out in sending order, the draining call returns the oldest frame in flight
+            CHECK_ERROR_RETURN_RET_LOG(retried, false, "%{public}s frame %{public}u produced no picture.",
+                __func__, index);
+            retried = true;
+            continue;
+        }
+        CHECK_ERROR_RETURN_RET(getRet < 0, false);
+        retried = false;
+    }
+    return true;
+}
+
+bool Dav1dDecoder::DecodeFrame(uint32_t index, const uint8_t *frameData, size_t frameSize)
+{
+    Flush();
+    CHECK_ERROR_RETURN_RET(!SendFrame(index, frameData, frameSize, true) || !ReceivePictures(true), false);
+    CHECK_ERROR_RETURN_RET_LOG(!GetOccurDecodeFrame(index), false,
+        "%{public}s frame %{public}u produced no picture.", __func__, index);
     return true;
 }
 #endif
@@ -503,7 +606,18 @@ bool AvifDecoderImpl::InitDecoder()
     }
     decoder_ = std::make_unique<Dav1dDecoder>();
     CHECK_ERROR_RETURN_RET_LOG(!decoder_, false, "InitDecoder make failed.");
-    return decoder_->CreateDecoder();
+    // Still images keep the synchronous single thread setup, animations decode frames in parallel
+    int threads = 1;
+    int frameDelay = 1;
+    if (IsAvisImage()) {
+        threads = ImageSystemProperties::GetAvisDecodeThreads();
+        if (threads <= 0) {
+            threads = std::min(static_cast<int>(std::thread::hardware_concurrency()), AVIS_AUTO_THREADS_MAX);
+        }
+        threads = std::max(threads, 1);
+        frameDelay = std::min(threads, AVIS_FRAME_DELAY_MAX);
+    }
+    return decoder_->CreateDecoder(threads, frameDelay);
 }
 
 bool AvifDecoderImpl::DecodeFrame()
@@ -520,53 +634,46 @@ bool AvifDecoderImpl::DecodeFrame()
         auto ret = parser_->GetItemData(primaryImage_->GetItemId(), &data);
         CHECK_ERROR_RETURN_RET_LOG(ret != heif_error_ok, false,
             "decode get avif item data failed, ret = %{public}d.", ret);
-        CHECK_ERROR_RETURN_RET(!decoder_->DecodeFrame(PRIMARY_IMAGE_INDEX, data), false);
+        // The primary image resets the reference state the animation was continuing from
+        nextFrameIndex_ = std::numeric_limits<uint32_t>::max();
+        CHECK_ERROR_RETURN_RET(!decoder_->DecodeFrame(PRIMARY_IMAGE_INDEX, data.data(), data.size()), false);
     }
     return decoder_->ConvertWithFFmpeg(PRIMARY_IMAGE_INDEX, info);
 }
 
-bool AvifDecoderImpl::IsMemoryExceed(uint32_t groupNum)
+size_t AvifDecoderImpl::GetFrameCacheCount()
 {
-    uint64_t groupMemorySize = 0;
-    int32_t perPicMemorySize = 0;
+    size_t minCount = static_cast<size_t>(decoder_->GetFrameDelay()) + 1;
     AVPixelFormat format = HeifPixelFormatToAVPixelFormat(GetAvifPixelFormat(true),
         static_cast<int32_t>(GetAvifBitDepth(true)));
-    CHECK_ERROR_RETURN_RET_LOG(format == AVPixelFormat::AV_PIX_FMT_NONE, true,
-        "%{public}s unsupport format.", __func__);
-    CHECK_ERROR_RETURN_RET_LOG(animationImageInfo_.mWidth > MAX_IMAGE_SIZE ||
-        animationImageInfo_.mHeight > MAX_IMAGE_SIZE, true,
-        "%{public}s image size too large.", __func__);
+    bool cond = format == AVPixelFormat::AV_PIX_FMT_NONE || animationImageInfo_.mWidth > MAX_IMAGE_SIZE ||
+        animationImageInfo_.mHeight > MAX_IMAGE_SIZE;
+    CHECK_ERROR_RETURN_RET(cond, minCount);
     uint32_t w = FFALIGN(animationImageInfo_.mWidth, DAV1D_SIZE_ALIGNMENT);
     uint32_t h = FFALIGN(animationImageInfo_.mHeight, DAV1D_SIZE_ALIGNMENT);
-    perPicMemorySize = av_image_get_buffer_size(format, w, h, DAV1D_PICTURE_ALIGNMENT);
-    CHECK_ERROR_RETURN_RET_LOG(perPicMemorySize <= 0, true,
-        "%{public}s av_image_get_buffer_size failed.", __func__);
-    CHECK_DEBUG_RETURN_RET_LOG(ImageUtils::CheckMulOverflow<uint64_t>(groupNum, perPicMemorySize), true,
-        "%{public}s group memory size is exceed.", __func__);
-    groupMemorySize = groupNum * static_cast<uint64_t>(perPicMemorySize);
-    return ImageUtils::HasOverflowed64(groupMemorySize, dstMemorySize_);
+    int32_t perPicMemorySize = av_image_get_buffer_size(format, w, h, DAV1D_PICTURE_ALIGNMENT);
+    CHECK_ERROR_RETURN_RET(perPicMemorySize <= 0, minCount);
+    return std::max(static_cast<size_t>(AVIS_FRAME_CACHE_BUDGET / static_cast<uint64_t>(perPicMemorySize)),
+        minCount);
 }
 
-std::vector<std::vector<uint32_t>> AvifDecoderImpl::CalculateMiniGroup(uint32_t index, HeifsFrameGroup groupInfo)
+bool AvifDecoderImpl::SendMovieFrames(uint32_t begin, uint32_t end, uint32_t target)
 {
-    std::vector<std::vector<uint32_t>> result;
-    uint32_t begin = groupInfo.beginFrameIndex;
-    uint32_t end = groupInfo.endFrameIndex;
-    CHECK_ERROR_RETURN_RET_LOG(begin >= end || index < begin || index >= end, result,
-        "%{public}s Incorrect group information.", __func__);
-    uint32_t groupNum = end - begin;
-    while (IsMemoryExceed(groupNum)) {
-        CHECK_ERROR_RETURN_RET(groupNum <= MIN_GROUP_NUM, result);
-        groupNum /= GROUP_DIVIDE_NUM;
-    }
-    for (uint32_t i = begin; i <= index; i += groupNum) {
-        std::vector<uint32_t> tmp;
-        for (uint32_t j = i; (j < groupNum + i) && j < end; j++) {
-            tmp.emplace_back(j);
-        }
-        result.emplace_back(std::move(tmp));
+    size_t cacheCount = GetFrameCacheCount();
+    for (uint32_t i = begin; i < end; i++) {
+        HeifDataView data;
+        auto ret = parser_->GetAvisFrameDataView(i, data);
+        CHECK_ERROR_RETURN_RET_LOG(ret != heif_error_ok, false,
+            "GetAvisFrameData failed, ret = %{public}d.", ret);
+        // A copied sample dies with the view, dav1d has to keep its own copy
+        CHECK_ERROR_RETURN_RET(!decoder_->SendFrame(i, data.Data(), data.Size(), !data.IsCopied()), false);
+        CHECK_ERROR_RETURN_RET(!decoder_->ReceivePictures(false), false);
+        decoder_->TrimPicMap(target, cacheCount);
     }
-    return result;
+    // Only the target is waited for, frames sent after it keep decoding until the next call
+    CHECK_ERROR_RETURN_RET(!decoder_->WaitForPicture(target), false);
+    decoder_->TrimPicMap(target, cacheCount);
+    return true;
 }
 
 bool AvifDecoderImpl::DecodeMovieFrame(uint32_t index)
@@ -584,18 +691,27 @@ bool AvifDecoderImpl::DecodeMovieFrame(uint32_t index)
     auto ret = parser_->GetHeifsGroupFrameInfo(index, groupInfo);
     CHECK_ERROR_RETURN_RET_LOG(ret != heif_error_ok, false,
                                "GetHeifsGroupFrameInfo failed, ret = %{public}d.", ret);
-    auto group = CalculateMiniGroup(index, groupInfo);
-    CHECK_ERROR_RETURN_RET_LOG(group.empty(), false, "%{public}s empty group.", __func__);
-    for (const auto &miniGroup : group) {
-        decoder_->ClearPicMap();
-        for (const auto i : miniGroup) {
-            std::vector<uint8_t> data;
-            ret = parser_->GetAvisFrameData(i, data);
-            CHECK_ERROR_RETURN_RET_LOG(ret != heif_error_ok, false,
-                "GetAvisFrameData failed, ret = %{public}d.", ret);
-            CHECK_ERROR_RETURN_RET(!decoder_->DecodeFrame(i, data), false);
-        }
+    uint32_t begin = groupInfo.beginFrameIndex;
+    uint32_t end = groupInfo.endFrameIndex;
+    CHECK_ERROR_RETURN_RET_LOG(begin >= end || index < begin || index >= end, false,
+        "%{public}s Incorrect group information.", __func__);
+    // Sequential playback continues from the decoder's references instead of the group start. A frame still in
+    // flight from the previous call's look-ahead continues as well.
+    bool canContinue = (nextFrameIndex_ >= begin && nextFrameIndex_ <= index) || decoder_->IsPending(index);
+    if (!canContinue) {
+        decoder_->Flush();
+        nextFrameIndex_ = begin;
+    }
+    // Frames after index are sent too and left in flight, so the frame threads already work on the next calls
+    uint32_t sendEnd = static_cast<uint32_t>(std::min(static_cast<uint64_t>(index) + decoder_->GetFrameDelay(),
+        static_cast<uint64_t>(end)));
+    sendEnd = std::max(sendEnd, nextFrameIndex_);
+    if (!SendMovieFrames(nextFrameIndex_, sendEnd, index)) {
+        decoder_->Flush();
+        nextFrameIndex_ = std::numeric_limits<uint32_t>::max();
+        return false;
     }
+    nextFrameIndex_ = sendEnd < end ? sendEnd : std::numeric_limits<uint32_t>::max();
     return decoder_->ConvertWithFFmpeg(index, info);
 }
 #endif
@@ -461,21 +461,26 @@ bool HeifDecoderImpl::setOutputColor(SkHeifColorFormat heifColor)
     return outPixelFormat_ != PixelFormat::UNKNOWN;
 }
 
-bool HeifDecoderImpl::copyToAshmem(std::vector<std::vector<uint8_t>> &inputs, std::vector<sptr<Ashmem>> &hwInputs)
+bool HeifDecoderImpl::copyToAshmem(std::vector<HeifDataView> &inputs, std::vector<sptr<Ashmem>> &hwInputs)
 {
     ImageTrace trace("HeifDecoderImpl::copyToAshmem, total size: %d", inputs.size());
     hwInputs.clear();
     hwInputs.reserve(inputs.size());
     for (auto& input : inputs) {
-        size_t size = input.size();
+        size_t size = input.Size();
         sptr<Ashmem> mem = Ashmem::CreateAshmem(HEIF_SHAREMEM_NAME.c_str(), size);
         CHECK_ERROR_RETURN_RET_LOG(!mem, false, "AshmemCreate failed");
         CHECK_ERROR_RETURN_RET_LOG(!mem->MapAshmem(PROT_READ | PROT_WRITE), false, "Ashmem map failed");
-        if (!mem->WriteToAshmem(input.data(), size, 0)) {
+        if (!mem->WriteToAshmem(input.Data(), size, 0)) {
             IMAGE_LOGE("memcpy_s failed with error");
             hwInputs.clear();
             return false;
         }
+        // Views may refer to the source file, so the start codes are only written into the ashmem copy
+        auto mapped = static_cast<uint8_t *>(const_cast<void *>(mem->ReadFromAshmem(size, 0)));
+        if (mapped != nullptr) {
+            ProcessChunkHead(mapped, size);
+        }
         hwInputs.push_back(mem);
     }
     return true;
@@ -680,21 +685,19 @@ bool HeifDecoderImpl::HwDecodeImage(std::shared_ptr<HeifImage> &image, GridInfo
 }
 
 void HeifDecoderImpl::DoRegionDecodeForUnpacked(std::vector<std::shared_ptr<HeifImage>> tileImages,
-    uint32_t decodeIndex, std::vector<std::vector<uint8_t>> &unPackedInput, std::shared_ptr<HeifImage> &tileImage)
+    uint32_t decodeIndex, std::vector<HeifDataView> &unPackedInput, std::shared_ptr<HeifImage> &tileImage)
 {
     for (uint32_t indexRow = 0; indexRow < regionInfo_.rowCount; indexRow++) {
         for (uint32_t indexCol = 0; indexCol < regionInfo_.colCount; indexCol++) {
             tileImage = tileImages[indexRow * gridInfo_.cols + decodeIndex + indexCol];
-            parser_->GetItemData(tileImage->GetItemId(),
-                &unPackedInput[indexCol + indexRow * regionInfo_.colCount + 1], heif_no_header);
-            ProcessChunkHead(unPackedInput[indexCol + indexRow * regionInfo_.colCount + 1].data(),
-                unPackedInput[indexCol + indexRow * regionInfo_.colCount + 1].size());
+            parser_->GetItemDataView(tileImage->GetItemId(),
+                unPackedInput[indexCol + indexRow * regionInfo_.colCount + 1]);
         }
     }
 }
 
 void HeifDecoderImpl::HwRegionDecodeForUnPacked(std::vector<std::shared_ptr<HeifImage>> tileImages,
-    std::vector<std::vector<uint8_t>> &unPackedInput, size_t gridCount)
+    std::vector<HeifDataView> &unPackedInput, size_t gridCount)
 {
     unPackedInput.resize(regionInfo_.colCount * regionInfo_.rowCount + 1);
     uint32_t rowIndex = regionInfo_.top / gridInfo_.tileHeight;
@@ -703,8 +706,7 @@ void HeifDecoderImpl::HwRegionDecodeForUnPacked(std::vector<std::shared_ptr<Heif
     for (uint32_t index = 0; index < gridCount; ++index) {
         std::shared_ptr<HeifImage> &tileImage = tileImages[index];
         if (index == 0) {
-            parser_->GetItemData(tileImage->GetItemId(), &unPackedInput[index], heif_only_header);
-            ProcessChunkHead(unPackedInput[index].data(), unPackedInput[index].size());
+            parser_->GetItemData(tileImage->GetItemId(), &unPackedInput[index].ResetCopy(), heif_only_header);
         }
         if (index == decodeIndex) {
             DoRegionDecodeForUnpacked(tileImages, decodeIndex, unPackedInput, tileImage);
@@ -713,23 +715,22 @@ void HeifDecoderImpl::HwRegionDecodeForUnPacked(std::vector<std::shared_ptr<Heif
 }
 
 void HeifDecoderImpl::HwPrepareUnPackedInput(std::vector<std::shared_ptr<HeifImage>> tileImages,
-    std::vector<std::vector<uint8_t>> &unPackedInput, size_t gridCount)
+    std::vector<HeifDataView> &unPackedInput, size_t gridCount)
 {
     unPackedInput.resize(gridCount + 1);
     for (size_t index = 0; index < gridCount; ++index) {
         std::shared_ptr<HeifImage> &tileImage = tileImages[index];
         if (index == 0) {
             // get hvcc header
-            parser_->GetItemData(tileImage->GetItemId(), &unPackedInput[index], heif_only_header);
-            ProcessChunkHead(unPackedInput[index].data(), unPackedInput[index].size());
+            parser_->GetItemData(tileImage->GetItemId(), &unPackedInput[index].ResetCopy(), heif_only_header);
         }
-        parser_->GetItemData(tileImage->GetItemId(), &unPackedInput[index + 1], heif_no_header);
-        ProcessChunkHead(unPackedInput[index + 1].data(), unPackedInput[index + 1].size());
+        // tiles refer to the source memory, copyToAshmem makes their only copy
+        parser_->GetItemDataView(tileImage->GetItemId(), unPackedInput[index + 1]);
     }
 }
 
 void HeifDecoderImpl::PrepareInput(std::vector<std::shared_ptr<HeifImage>> tileImages,
-    std::vector<std::vector<uint8_t>> &inputs, size_t gridCount)
+    std::vector<HeifDataView> &inputs, size_t gridCount)
 {
     if (IsRegionDecode()) {
         HwRegionDecodeForUnPacked(tileImages, inputs, gridCount);
@@ -776,7 +777,7 @@ bool HeifDecoderImpl::HwDecodeGrids(std::shared_ptr<HeifImage> &image,
     size_t gridCount = tileImages.size();
     cond = gridCount != (gridInfo.cols * gridInfo.rows);
     CHECK_ERROR_RETURN_RET_LOG(cond, false, "grid count not equal actual decode quantity");
-    std::vector<std::vector<uint8_t>> inputs;
+    std::vector<HeifDataView> inputs;
     PrepareInput(tileImages, inputs, gridCount);
     GridInfo tempGridInfo = gridInfo;
     std::vector<sptr<Ashmem>> hwInputs;
@@ -797,7 +798,7 @@ bool HeifDecoderImpl::HwDecodeGrids(std::shared_ptr<HeifImage> &image,
             " imageType: grid, inPixelFormat: %{public}d, colNum: %{public}d, rowNum: %{public}d,"
             " tileWidth: %{public}d, tileHeight: %{public}d, hvccLen: %{public}zu",
             result, gridInfo.displayWidth, gridInfo.displayHeight, hwBuffer->GetFormat(), gridInfo.cols,
-            gridInfo.rows, gridInfo.tileWidth, gridInfo.tileHeight, inputs[0].size());
+            gridInfo.rows, gridInfo.tileWidth, gridInfo.tileHeight, inputs[0].Size());
         SetHardwareDecodeErrMsg(gridInfo.tileWidth, gridInfo.tileHeight);
         if (IsRegionDecode()) {
             ReinitGridinfo(gridInfo, tempGridInfo);
@@ -828,11 +829,9 @@ bool HeifDecoderImpl::HwDecodeSingleImage(std::shared_ptr<HeifImage> &image,
     GridInfo &gridInfo, sptr<SurfaceBuffer> &hwBuffer)
 {
     CHECK_ERROR_RETURN_RET_LOG(!image, false, "HeifDecoderImpl::DecodeSingleImage image is nullptr");
-    std::vector<std::vector<uint8_t>> inputs(GRID_NUM_2);
-    parser_->GetItemData(image->GetItemId(), &inputs[0], heif_only_header);
-    ProcessChunkHead(inputs[0].data(), inputs[0].size());
-    parser_->GetItemData(image->GetItemId(), &inputs[1], heif_no_header);
-    ProcessChunkHead(inputs[1].data(), inputs[1].size());
+    std::vector<HeifDataView> inputs(GRID_NUM_2);
+    parser_->GetItemData(image->GetItemId(), &inputs[0].ResetCopy(), heif_only_header);
+    parser_->GetItemDataView(image->GetItemId(), inputs[1]);
     std::vector<sptr<Ashmem>> hwInputs;
     if (!copyToAshmem(inputs, hwInputs)) {
         return false;
@@ -851,7 +850,7 @@ bool HeifDecoderImpl::HwDecodeSingleImage(std::shared_ptr<HeifImage> &image,
             " imageType: hvc1, inPixelFormat: %{public}d, colNum: %{public}d, rowNum: %{public}d,"
             " tileWidth: %{public}d, tileHeight: %{public}d, hvccLen: %{public}zu, dataLen: %{public}zu",
             result, gridInfo.displayWidth, gridInfo.displayHeight, hwBuffer->GetFormat(), gridInfo.cols,
-            gridInfo.rows, gridInfo.tileWidth, gridInfo.tileHeight, inputs[0].size(), inputs[1].size());
+            gridInfo.rows, gridInfo.tileWidth, gridInfo.tileHeight, inputs[0].Size(), inputs[1].Size());
         SetHardwareDecodeErrMsg(gridInfo.tileWidth, gridInfo.tileHeight);
         return false;
     }
@@ -140,22 +140,29 @@ heif_error HeifIlocBox::GetIlocDataLength(const Item &item, size_t &length)
     return heif_error_ok;
 }
 
+heif_error HeifIlocBox::CheckExtentReadSize(const Item &item, const Extent &extent, size_t &totalSize) const
+{
+    CHECK_ERROR_RETURN_RET(HasOverflowed64(extent.offset, item.baseOffset), heif_error_eof);
+    if (extent.length > MAX_HEIF_IMAGE_GRID_SIZE) {
+        return heif_error_grid_too_large;
+    }
+    totalSize += extent.length;
+    CHECK_ERROR_RETURN_RET(totalSize > MAX_HEIF_IMAGE_GRID_SIZE, heif_error_grid_too_large);
+    CHECK_ERROR_RETURN_RET_LOG(HasOverflowed64(totalReadDataSize_, extent.length) ||
+        totalReadDataSize_ + extent.length > MAX_HEIF_GRID_TOTAL_INPUT_SIZE,
+        heif_error_grid_too_large,
+        "%{public}s total overflow or exceed, cur=%{public}zu", __func__, totalReadDataSize_);
+    return heif_error_ok;
+}
+
 heif_error HeifIlocBox::ReadData(const Item &item, const std::shared_ptr<HeifInputStream> &stream,
     const std::shared_ptr<HeifIdatBox> &idat, std::vector<uint8_t> *dest) const
 {
     CHECK_ERROR_RETURN_RET(!stream || !dest, heif_error_eof);
     size_t totalSize = 0;
     for (const auto &extent: item.extents) {
-        CHECK_ERROR_RETURN_RET(HasOverflowed64(extent.offset, item.baseOffset), heif_error_eof);
-        if (extent.length > MAX_HEIF_IMAGE_GRID_SIZE) {
-            return heif_error_grid_too_large;
-        }
-        totalSize += extent.length;
-        CHECK_ERROR_RETURN_RET(totalSize > MAX_HEIF_IMAGE_GRID_SIZE, heif_error_grid_too_large);
-        CHECK_ERROR_RETURN_RET_LOG(HasOverflowed64(totalReadDataSize_, extent.length) ||
-            totalReadDataSize_ + extent.length > MAX_HEIF_GRID_TOTAL_INPUT_SIZE,
-            heif_error_grid_too_large,
-            "%{public}s total overflow or exceed, cur=%{public}zu", __func__, totalReadDataSize_);
+        heif_error checkErr = CheckExtentReadSize(item, extent, totalSize);
+        CHECK_ERROR_RETURN_RET(checkErr != heif_error_ok, checkErr);
 
         if (item.constructionMethod == CONSTRUCTION_METHOD_FILE_OFFSET) {
             bool ret = stream->Seek(extent.offset + item.baseOffset);
@@ -191,6 +198,28 @@ heif_error HeifIlocBox::ReadData(const Item &item, const std::shared_ptr<HeifInp
     return heif_error_ok;
 }
 
+heif_error HeifIlocBox::ReadDataView(const Item &item, const std::shared_ptr<HeifInputStream> &stream,
+    const std::shared_ptr<HeifIdatBox> &idat, HeifDataView &view) const
+{
+    CHECK_ERROR_RETURN_RET(!stream, heif_error_eof);
+    if (item.constructionMethod == CONSTRUCTION_METHOD_FILE_OFFSET && item.extents.size() == 1) {
+        const Extent &extent = item.extents[0];
+        size_t totalSize = 0;
+        heif_error checkErr = CheckExtentReadSize(item, extent, totalSize);
+        CHECK_ERROR_RETURN_RET(checkErr != heif_error_ok, checkErr);
+        uint64_t position = extent.offset + item.baseOffset;
+        const uint8_t *data = position > static_cast<uint64_t>(INT64_MAX) ? nullptr :
+            stream->PeekData(static_cast<int64_t>(position), static_cast<size_t>(extent.length));
+        if (data != nullptr) {
+            view.Refer(data, static_cast<size_t>(extent.length));
+            totalReadDataSize_ += extent.length;
+            return heif_error_ok;
+        }
+    }
+    // split items and idat data are gathered into the view's own copy
+    return ReadData(item, stream, idat, &view.ResetCopy());
+}
+
 heif_error HeifIlocBox::AppendData(heif_item_id itemId, const std::vector<uint8_t> &data, uint8_t constructionMethod)
 {
     size_t idx;
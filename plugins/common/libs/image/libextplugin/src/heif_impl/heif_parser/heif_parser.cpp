@@ -39,6 +39,11 @@ const static uint32_t HEIF_MAX_SAMPLE_SIZE = 20 * 1024 * 1024;
 const static uint32_t FRAME_INDEX_DELTA = 1;
 const static uint32_t MS_PER_SECOND = 1000;
 const static uint32_t MAX_TOP_LEVEL_BOXES = 1000;
+const static uint8_t CONSTRUCTION_METHOD_FILE_OFFSET = 0;
+const static uint8_t CONSTRUCTION_METHOD_IDAT_OFFSET = 1;
+const auto EXIF_ITEM_TYPE = "Exif";
+const auto MIME_ITEM_TYPE = "mime";
+const auto XMP_CONTENT_TYPE = "application/rdf+xml";
 
 static bool HasOverflowed(uint32_t num1, uint32_t num2)
 {
@@ -85,6 +90,130 @@ heif_error HeifParser::MakeFromStream(const std::shared_ptr<HeifInputStream> &st
     return errorBox;
 }
 
+static bool SkipBox(const std::shared_ptr<HeifInputStream> &stream, int64_t boxStart, uint64_t boxSize)
+{
+    CHECK_ERROR_RETURN_RET(boxStart < 0 || boxSize > static_cast<uint64_t>(INT64_MAX - boxStart), false);
+    return stream->Seek(boxStart + static_cast<int64_t>(boxSize));
+}
+
+// Parses iinf, iloc and idat and only skips over the other children of meta, item properties included.
+static heif_error ScanMetaChildren(HeifStreamReader &reader, std::shared_ptr<HeifIinfBox> &iinfBox,
+    std::shared_ptr<HeifIlocBox> &ilocBox, std::shared_ptr<HeifIdatBox> &idatBox)
+{
+    auto stream = reader.GetStream();
+    uint32_t childCount = 0;
+    while (!reader.IsAtEnd() && !reader.HasError()) {
+        CHECK_ERROR_RETURN_RET(++childCount > MAX_TOP_LEVEL_BOXES, heif_error_too_many_boxes);
+        int64_t childStart = stream->Tell();
+        HeifBox header;
+        heif_error err = header.ParseHeader(reader);
+        CHECK_ERROR_RETURN_RET(err != heif_error_ok, err);
+        CHECK_ERROR_RETURN_RET(header.GetBoxSize() < header.GetHeaderSize(), heif_error_invalid_box_size);
+        uint32_t boxType = header.GetBoxType();
+        if (boxType != BOX_TYPE_IINF && boxType != BOX_TYPE_ILOC && boxType != BOX_TYPE_IDAT) {
+            CHECK_ERROR_RETURN_RET(!reader.CheckSize(header.GetBoxSize() - header.GetHeaderSize()), heif_error_eof);
+            CHECK_ERROR_RETURN_RET(!SkipBox(stream, childStart, header.GetBoxSize()), heif_error_eof);
+            continue;
+        }
+        CHECK_ERROR_RETURN_RET(!stream->Seek(childStart), heif_error_eof);
+        std::shared_ptr<HeifBox> box;
+        uint32_t recursionCount = 1;
+        err = HeifBox::MakeFromReader(reader, &box, recursionCount);
+        CHECK_ERROR_RETURN_RET(err != heif_error_ok, err);
+        if (boxType == BOX_TYPE_IINF) {
+            iinfBox = std::dynamic_pointer_cast<HeifIinfBox>(box);
+        } else if (boxType == BOX_TYPE_ILOC) {
+            ilocBox = std::dynamic_pointer_cast<HeifIlocBox>(box);
+        } else {
+            idatBox = std::dynamic_pointer_cast<HeifIdatBox>(box);
+        }
+    }
+    return reader.GetError();
+}
+
+static bool GetItemStreamExtents(const HeifIlocBox::Item &item, const std::shared_ptr<HeifIdatBox> &idatBox,
+    std::vector<std::pair<uint64_t, uint64_t>> &extents)
+{
+    uint64_t base = item.baseOffset;
+    uint64_t limit = std::numeric_limits<uint64_t>::max();
+    if (item.constructionMethod == CONSTRUCTION_METHOD_IDAT_OFFSET) {
+        CHECK_ERROR_RETURN_RET(!idatBox, false);
+        uint64_t idatStart = idatBox->GetStartPos();
+        uint64_t idatSize = idatBox->GetBoxSize() - idatBox->GetHeaderSize();
+        CHECK_ERROR_RETURN_RET(base > limit - idatStart || idatSize > limit - idatStart, false);
+        base += idatStart;
+        limit = idatStart + idatSize;
+    } else if (item.constructionMethod != CONSTRUCTION_METHOD_FILE_OFFSET) {
+        return false;
+    }
+    for (const auto &extent : item.extents) {
+        // A zero length reaches to the end of the file, leave that to the full parser
+        bool cond = extent.length == 0 || extent.offset > limit - base ||
+            extent.length > limit - base - extent.offset;
+        CHECK_ERROR_RETURN_RET(cond, false);
+        extents.emplace_back(base + extent.offset, extent.length);
+    }
+    return !extents.empty();
+}
+
+heif_error HeifParser::ScanMetadataItems(const std::shared_ptr<HeifInputStream> &stream,
+    std::vector<HeifMetadataLocation> &locations)
+{
+    CHECK_ERROR_RETURN_RET(!stream, heif_error_no_data);
+    auto maxSize = static_cast<uint64_t>(std::numeric_limits<int64_t>::max());
+    HeifStreamReader reader(stream, 0, maxSize);
+    bool hasFtyp = false;
+    std::shared_ptr<HeifIinfBox> iinfBox;
+    std::shared_ptr<HeifIlocBox> ilocBox;
+    std::shared_ptr<HeifIdatBox> idatBox;
+    for (uint32_t boxCount = 0;; boxCount++) {
+        CHECK_ERROR_RETURN_RET(boxCount >= MAX_TOP_LEVEL_BOXES, heif_error_too_many_boxes);
+        int64_t boxStart = stream->Tell();
+        HeifBox header;
+        CHECK_ERROR_RETURN_RET(header.ParseHeader(reader) != heif_error_ok,
+            hasFtyp ? heif_error_no_meta : heif_error_no_ftyp);
+        CHECK_ERROR_RETURN_RET(header.GetBoxSize() < header.GetHeaderSize(), heif_error_invalid_box_size);
+        uint64_t contentSize = header.GetBoxSize() - header.GetHeaderSize();
+        if (header.GetBoxType() == BOX_TYPE_FTYP) {
+            hasFtyp = true;
+        } else if (header.GetBoxType() == BOX_TYPE_META) {
+            CHECK_ERROR_RETURN_RET(!hasFtyp, heif_error_no_ftyp);
+            CHECK_ERROR_RETURN_RET(!reader.CheckSize(contentSize), heif_error_eof);
+            HeifStreamReader metaReader(stream, stream->Tell(), contentSize);
+            // version and flags of the full box
+            metaReader.Read32();
+            heif_error err = ScanMetaChildren(metaReader, iinfBox, ilocBox, idatBox);
+            CHECK_ERROR_RETURN_RET(err != heif_error_ok, err);
+            CHECK_ERROR_RETURN_RET(!iinfBox, heif_error_no_iinf);
+            CHECK_ERROR_RETURN_RET(!ilocBox, heif_error_no_iloc);
+            break;
+        }
+        // Items are addressed through iloc, so the boxes behind meta and the mdat contents are never read
+        CHECK_ERROR_RETURN_RET(!SkipBox(stream, boxStart, header.GetBoxSize()), heif_error_eof);
+    }
+
+    const auto &items = ilocBox->GetItems();
+    for (const auto &infe : iinfBox->GetChildren<HeifInfeBox>(BOX_TYPE_INFE)) {
+        bool isMetadata = infe && (infe->GetItemType() == EXIF_ITEM_TYPE ||
+            (infe->GetItemType() == MIME_ITEM_TYPE && infe->GetContentType() == XMP_CONTENT_TYPE));
+        if (!isMetadata) {
+            continue;
+        }
+        auto iter = std::find_if(items.begin(), items.end(), [&infe](const HeifIlocBox::Item &item) {
+            return item.itemId == infe->GetItemId();
+        });
+        HeifMetadataLocation location;
+        if (iter == items.end() || !GetItemStreamExtents(*iter, idatBox, location.extents)) {
+            continue;
+        }
+        location.itemId = infe->GetItemId();
+        location.itemType = infe->GetItemType();
+        location.contentType = infe->GetContentType();
+        locations.push_back(std::move(location));
+    }
+    return heif_error_ok;
+}
+
 void HeifParser::Write(HeifStreamWriter &writer)
 {
     CheckExtentData();
@@ -283,6 +412,25 @@ heif_error HeifParser::GetItemData(heif_item_id itemId, std::vector<uint8_t> *ou
     return heif_error_ok;
 }
 
+heif_error HeifParser::GetItemDataView(heif_item_id itemId, HeifDataView &view) const
+{
+    auto infeBox = GetInfeBox(itemId);
+    CHECK_ERROR_RETURN_RET(!HasItemId(itemId) || !infeBox, heif_error_item_not_found);
+    CHECK_ERROR_RETURN_RET(!ilocBox_, heif_error_no_iloc);
+    std::string itemType = infeBox->GetItemType();
+    if (itemType == "av01") {
+        // the decoder header goes in front of the payload, so av01 data is always assembled
+        return GetItemData(itemId, &view.ResetCopy());
+    }
+    CHECK_ERROR_RETURN_RET(itemType == "hvc1" && !GetProperty<HeifHvccBox>(itemId), heif_error_no_hvcc);
+    const auto &items = ilocBox_->GetItems();
+    auto iter = std::find_if(items.begin(), items.end(), [&itemId](const auto &item) {
+        return item.itemId == itemId;
+    });
+    CHECK_ERROR_RETURN_RET(iter == items.end(), heif_error_item_data_not_found);
+    return ilocBox_->ReadDataView(*iter, inputStream_, idatBox_, view);
+}
+
 void HeifParser::GetTileImages(heif_item_id gridItemId, std::vector<std::shared_ptr<HeifImage>> &out)
 {
     auto infe = GetInfeBox(gridItemId);
@@ -1067,6 +1215,10 @@ void HeifParser::SetTiffOffset()
     if (!ilocItem->extents.empty()) {
         tiffOffset_ += ilocItem->extents[0].offset;
     }
+    // idat offsets are relative to the idat payload, the tiff offset is a file position like for mdat items
+    if (ilocItem->constructionMethod == CONSTRUCTION_METHOD_IDAT_OFFSET && idatBox_) {
+        tiffOffset_ += static_cast<long>(idatBox_->GetStartPos());
+    }
 }
 
 heif_error HeifParser::AssembleMovieBoxes()
@@ -1171,7 +1323,7 @@ heif_error HeifParser::GetHeifsMovieFrameData(uint32_t index, std::vector<uint8_
     return GetHeifsFrameData(index, dest);
 }
 
-heif_error HeifParser::GetHeifsFrameData(uint32_t index, std::vector<uint8_t> &dest)
+heif_error HeifParser::GetHeifsSampleRange(uint32_t index, uint32_t &sampleOffset, uint32_t &sampleSize)
 {
     uint32_t chunkOffset = 0;
     CHECK_ERROR_RETURN_RET(!stcoBox_, heif_error_no_stco);
@@ -1180,35 +1332,64 @@ heif_error HeifParser::GetHeifsFrameData(uint32_t index, std::vector<uint8_t> &d
         return res;
     }
     CHECK_ERROR_RETURN_RET(!stszBox_, heif_error_no_stsz);
-    uint32_t sampleSize = 0;
     res = stszBox_->GetSampleSize(index, sampleSize);
     if (res != heif_error_ok) {
         return res;
     }
-    size_t oldSize = dest.size();
-    CHECK_ERROR_RETURN_RET(HasOverflowedSizeT(static_cast<size_t>(sampleSize), oldSize), heif_error_add_overflow);
-    size_t newSize = static_cast<size_t>(sampleSize) + oldSize;
-    if (newSize > HEIF_MAX_SAMPLE_SIZE) {
-        return heif_error_sample_size_too_large;
-    }
-    dest.resize(newSize);
     uint32_t preSampleSize = 0;
     res = GetPreSampleSize(index, preSampleSize);
     if (res != heif_error_ok) {
         return res;
     }
-    if (!inputStream_) {
-        return heif_error_eof;
+    CHECK_ERROR_RETURN_RET(HasOverflowed(chunkOffset, preSampleSize), heif_error_eof);
+    sampleOffset = chunkOffset + preSampleSize;
+    return heif_error_ok;
+}
+
+heif_error HeifParser::GetHeifsFrameData(uint32_t index, std::vector<uint8_t> &dest)
+{
+    uint32_t sampleOffset = 0;
+    uint32_t sampleSize = 0;
+    heif_error res = GetHeifsSampleRange(index, sampleOffset, sampleSize);
+    if (res != heif_error_ok) {
+        return res;
+    }
+    size_t oldSize = dest.size();
+    CHECK_ERROR_RETURN_RET(HasOverflowedSizeT(static_cast<size_t>(sampleSize), oldSize), heif_error_add_overflow);
+    size_t newSize = static_cast<size_t>(sampleSize) + oldSize;
+    if (newSize > HEIF_MAX_SAMPLE_SIZE) {
+        return heif_error_sample_size_too_large;
     }
-    if (HasOverflowed(chunkOffset, preSampleSize) || !inputStream_->Seek(chunkOffset + preSampleSize)) {
+    if (!inputStream_ || !inputStream_->Seek(sampleOffset)) {
         return heif_error_eof;
     }
+    dest.resize(newSize);
     if (!inputStream_->Read(reinterpret_cast<char*>(dest.data()) + oldSize, static_cast<size_t>(sampleSize))) {
         return heif_error_eof;
     }
     return heif_error_ok;
 }
 
+heif_error HeifParser::GetHeifsFrameDataView(uint32_t index, HeifDataView &view)
+{
+    uint32_t sampleOffset = 0;
+    uint32_t sampleSize = 0;
+    heif_error res = GetHeifsSampleRange(index, sampleOffset, sampleSize);
+    if (res != heif_error_ok) {
+        return res;
+    }
+    if (sampleSize > HEIF_MAX_SAMPLE_SIZE) {
+        return heif_error_sample_size_too_large;
+    }
+    CHECK_ERROR_RETURN_RET(!inputStream_, heif_error_eof);
+    const uint8_t *data = inputStream_->PeekData(sampleOffset, sampleSize);
+    if (data != nullptr) {
+        view.Refer(data, sampleSize);
+        return heif_error_ok;
+    }
+    return GetHeifsFrameData(index, view.ResetCopy());
+}
+
 heif_error HeifParser::GetHeifsDelayTime(uint32_t index, int32_t &value) const
 {
     CHECK_ERROR_RETURN_RET(!sttsBox_, heif_error_no_stts);
@@ -1339,6 +1520,14 @@ heif_error HeifParser::GetAvisFrameData(uint32_t index, std::vector<uint8_t> &de
     return GetHeifsFrameData(index, dest);
 }
 
+heif_error HeifParser::GetAvisFrameDataView(uint32_t index, HeifDataView &view)
+{
+    CHECK_ERROR_RETURN_RET(!stsdBox_, heif_error_no_stsd);
+    auto av1c = std::dynamic_pointer_cast<HeifAv1CBox>(stsdBox_->GetAv1cBox());
+    CHECK_ERROR_RETURN_RET(!av1c, heif_error_no_av1c);
+    return GetHeifsFrameDataView(index, view);
+}
+
 bool HeifParser::isSequenceMajorBrand() const
 {
     CHECK_ERROR_RETURN_RET(!ftypBox_, false);
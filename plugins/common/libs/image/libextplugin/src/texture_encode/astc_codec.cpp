@@ -13,11 +13,15 @@
  * limitations under the License.
  */
 
+#include <algorithm>
 #include <charconv>
 #include <dlfcn.h>
 #include <atomic>
+#include <map>
 #include <mutex>
 #include <thread>
+#include <tuple>
+#include <vector>
 #ifdef USE_M133_SKIA
 #include <unistd.h>
 #endif
@@ -32,6 +36,9 @@
 #include "image_trace.h"
 #include "securec.h"
 #include "media_errors.h"
+#if !defined(CROSS_PLATFORM)
+#include "image_task_scheduler.h"
+#endif
 #if !defined(_WIN32) && !defined(_APPLE) && !defined(IOS_PLATFORM) && !defined(ANDROID_PLATFORM)
 #include "v1_0/buffer_handle_meta_key_type.h"
 #include "vpe_utils.h"
@@ -77,6 +84,8 @@ std::mutex g_astcClCompileMutex;
 #endif
 constexpr int32_t WIDTH_MAX_ASTC = 8192;
 constexpr int32_t HEIGHT_MAX_ASTC = 8192;
+constexpr size_t ASTC_CONTEXT_IDLE_MAX = 4;
+constexpr int32_t ASTC_BLOCKS_PER_THREAD_MIN = 4096;
 
 #ifdef SUT_ENCODE_ENABLE
 static bool CheckClBinIsExist(const std::string &name)
@@ -265,6 +274,107 @@ uint32_t GenAstcHeader(uint8_t *header, astcenc_image img, TextureEncodeOptions
     return SUCCESS;
 }
 
+/*
+ * Allocating a context builds the block mode and partition tables, which costs more than encoding a
+ * thumbnail. Idle contexts are kept per (profile, block size, quality profile) and reused. Every context is
+ * allocated for the largest thread count, an encode may run on fewer of its thread indices.
+ */
+class AstcContextPool {
+public:
+    static AstcContextPool &GetInstance()
+    {
+        static AstcContextPool pool;
+        return pool;
+    }
+
+    unsigned int GetThreadCount() const
+    {
+        return threadCount_;
+    }
+
+    astcenc_context *Acquire(const astcenc_config &config)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto iter = idle_.find(MakeKey(config));
+            if (iter != idle_.end() && !iter->second.empty()) {
+                astcenc_context *context = iter->second.back();
+                iter->second.pop_back();
+                idleCount_--;
+                return context;
+            }
+        }
+        astcenc_context *context = nullptr;
+        if (astcenc_context_alloc(&config, threadCount_, &context) != ASTCENC_SUCCESS) {
+            return nullptr;
+        }
+        return context;
+    }
+
+    // A context that failed mid compression is dropped, it may be left with unfinished tasks. At most
+    // ASTC_CONTEXT_IDLE_MAX contexts stay idle over all keys, each one holds working buffers for every thread.
+    void Release(const astcenc_config &config, astcenc_context *context, bool reusable)
+    {
+        if (context == nullptr) {
+            return;
+        }
+        if (reusable && astcenc_compress_reset(context) == ASTCENC_SUCCESS) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (idleCount_ < ASTC_CONTEXT_IDLE_MAX) {
+                idle_[MakeKey(config)].push_back(context);
+                idleCount_++;
+                return;
+            }
+        }
+        astcenc_context_free(context);
+    }
+
+private:
+    using Key = std::tuple<int, unsigned int, unsigned int, int>;
+
+    AstcContextPool()
+    {
+#if !defined(CROSS_PLATFORM)
+        threadCount_ = static_cast<unsigned int>(std::max(ImageTaskScheduler::GetWorkerCount(), 1));
+#endif
+    }
+
+    ~AstcContextPool()
+    {
+        for (auto &entry : idle_) {
+            for (astcenc_context *context : entry.second) {
+                astcenc_context_free(context);
+            }
+        }
+    }
+
+    static Key MakeKey(const astcenc_config &config)
+    {
+        return Key(static_cast<int>(config.profile), config.block_x, config.block_y,
+            static_cast<int>(config.privateProfile));
+    }
+
+    std::mutex mutex_;
+    std::map<Key, std::vector<astcenc_context *>> idle_;
+    size_t idleCount_ = 0;
+    unsigned int threadCount_ = 1;
+};
+
+// Small images are not worth waking workers for, they run on thread index 0 of the context only.
+static unsigned int GetAstcEncodeThreadCount(const TextureEncodeOptions &param)
+{
+#if !defined(CROSS_PLATFORM)
+    int32_t blocksX = (param.width_ + param.blockX_ - 1) / param.blockX_;
+    int32_t blocksY = (param.height_ + param.blockY_ - 1) / param.blockY_;
+    int64_t blocks = static_cast<int64_t>(blocksX) * blocksY;
+    int64_t threads = std::min(static_cast<int64_t>(AstcContextPool::GetInstance().GetThreadCount()),
+        blocks / ASTC_BLOCKS_PER_THREAD_MIN);
+    return threads > 1 ? static_cast<unsigned int>(threads) : 1;
+#else
+    return 1;
+#endif
+}
+
 uint32_t InitAstcencConfig(AstcEncoder* work, TextureEncodeOptions* option)
 {
     bool invaildInput = (work == nullptr) || (option == nullptr);
@@ -290,7 +400,12 @@ uint32_t InitAstcencConfig(AstcEncoder* work, TextureEncodeOptions* option)
         work->config.tune_candidate_limit = 1;
         work->config.tune_partition_count_limit = 1;
     }
-    if (astcenc_context_alloc(&work->config, 1, &work->codec_context) != ASTCENC_SUCCESS) {
+    if (work->pooledContext) {
+        work->codec_context = AstcContextPool::GetInstance().Acquire(work->config);
+    } else if (astcenc_context_alloc(&work->config, work->threadCount, &work->codec_context) != ASTCENC_SUCCESS) {
+        work->codec_context = nullptr;
+    }
+    if (work->codec_context == nullptr) {
         return ERROR;
     }
     return SUCCESS;
@@ -385,14 +500,16 @@ static void FreeMem(AstcEncoder *work)
         free(work->image_.data);
         work->image_.data = nullptr;
     }
-    if (work->codec_context != nullptr) {
+    if (work->codec_context != nullptr && work->pooledContext) {
+        AstcContextPool::GetInstance().Release(work->config, work->codec_context, work->error_ == ASTCENC_SUCCESS);
+    } else if (work->codec_context != nullptr) {
         astcenc_context_free(work->codec_context);
-        work->codec_context = nullptr;
     }
+    work->codec_context = nullptr;
     work->data_out_ = nullptr;
 }
 
-static bool InitMem(AstcEncoder *work, TextureEncodeOptions param)
+static bool InitMem(AstcEncoder *work, TextureEncodeOptions param, bool pooled)
 {
     if (!work) {
         return false;
@@ -408,6 +525,9 @@ static bool InitMem(AstcEncoder *work, TextureEncodeOptions param)
     }
     work->image_.dim_stride = static_cast<unsigned int>(param.stride_);
     work->codec_context = nullptr;
+    work->pooledContext = pooled;
+    work->threadCount = pooled ? GetAstcEncodeThreadCount(param) : 1;
+    work->error_ = ASTCENC_SUCCESS;
     work->image_.data = nullptr;
     work->profile = ASTCENC_PRF_LDR_SRGB;
 #if defined(QUALITY_CONTROL) && (QUALITY_CONTROL == 1)
@@ -434,7 +554,42 @@ static bool InitMem(AstcEncoder *work, TextureEncodeOptions param)
     return true;
 }
 
-bool AstcCodec::AstcSoftwareEncodeCore(TextureEncodeOptions &param, uint8_t *pixmapIn, uint8_t *astcBuffer)
+// Every thread index of the context takes part; blocks go to whichever thread claims them first.
+static astcenc_error CompressAstcImage(AstcEncoder &work, TextureEncodeOptions &param)
+{
+    uint8_t *dataOut = work.data_out_ + TEXTURE_HEAD_BYTES;
+    size_t dataLen = static_cast<size_t>(param.astcBytes - TEXTURE_HEAD_BYTES);
+#if !defined(CROSS_PLATFORM)
+    if (work.threadCount > 1) {
+        std::vector<astcenc_error> results(work.threadCount, ASTCENC_SUCCESS);
+        int64_t costPerThread = static_cast<int64_t>(param.width_) * param.height_ / work.threadCount;
+        ImageTaskScheduler::ParallelForRows(static_cast<int32_t>(work.threadCount), costPerThread,
+            [&](int32_t start, int32_t end) {
+                for (int32_t index = start; index < end; index++) {
+                    results[index] = astcenc_compress_image(work.codec_context, &work.image_, &work.swizzle_,
+                        dataOut, dataLen,
+#if defined(QUALITY_CONTROL) && (QUALITY_CONTROL == 1)
+                        work.calQualityEnable, work.mse,
+#endif
+                        static_cast<unsigned int>(index));
+                }
+            });
+        for (astcenc_error result : results) {
+            if (result != ASTCENC_SUCCESS) {
+                return result;
+            }
+        }
+        return ASTCENC_SUCCESS;
+    }
+#endif
+    return astcenc_compress_image(work.codec_context, &work.image_, &work.swizzle_, dataOut, dataLen,
+#if defined(QUALITY_CONTROL) && (QUALITY_CONTROL == 1)
+        work.calQualityEnable, work.mse,
+#endif
+        0);
+}
+
+static bool SoftwareEncodeAstc(TextureEncodeOptions &param, uint8_t *pixmapIn, uint8_t *astcBuffer, bool pooled)
 {
     if ((pixmapIn == nullptr) || (astcBuffer == nullptr)) {
         IMAGE_LOGE("pixmapIn or astcBuffer is nullptr");
@@ -446,7 +601,7 @@ bool AstcCodec::AstcSoftwareEncodeCore(TextureEncodeOptions &param, uint8_t *pix
         return false;
     }
     AstcEncoder work;
-    if (!InitMem(&work, param)) {
+    if (!InitMem(&work, param, pooled)) {
         FreeMem(&work);
         return false;
     }
@@ -462,12 +617,7 @@ bool AstcCodec::AstcSoftwareEncodeCore(TextureEncodeOptions &param, uint8_t *pix
         FreeMem(&work);
         return false;
     }
-    work.error_ = astcenc_compress_image(work.codec_context, &work.image_, &work.swizzle_,
-        work.data_out_ + TEXTURE_HEAD_BYTES, param.astcBytes - TEXTURE_HEAD_BYTES,
-#if defined(QUALITY_CONTROL) && (QUALITY_CONTROL == 1)
-        work.calQualityEnable, work.mse,
-#endif
-        0);
+    work.error_ = CompressAstcImage(work, param);
 #if defined(QUALITY_CONTROL) && (QUALITY_CONTROL == 1)
     if ((ASTCENC_SUCCESS != work.error_) ||
         (work.calQualityEnable && !CheckQuality(work.mse, param.blocksNum, param.blockX_ * param.blockY_))) {
@@ -482,6 +632,17 @@ bool AstcCodec::AstcSoftwareEncodeCore(TextureEncodeOptions &param, uint8_t *pix
     return true;
 }
 
+bool AstcCodec::AstcSoftwareEncodeCore(TextureEncodeOptions &param, uint8_t *pixmapIn, uint8_t *astcBuffer)
+{
+    return SoftwareEncodeAstc(param, pixmapIn, astcBuffer, true);
+}
+
+// Without the pool the encode runs on a context of its own with a single thread, a reference for the pooled path.
+bool AstcCodec::AstcSoftwareEncodeCoreUnpooled(TextureEncodeOptions &param, uint8_t *pixmapIn, uint8_t *astcBuffer)
+{
+    return SoftwareEncodeAstc(param, pixmapIn, astcBuffer, false);
+}
+
 static QualityProfile GetAstcQuality(int32_t quality)
 {
     QualityProfile privateProfile;
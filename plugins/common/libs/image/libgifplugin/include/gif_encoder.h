@@ -44,6 +44,23 @@ typedef struct ColorSubdivMap {
     ColorCoordinate *coordinate;
 } ColorSubdivMap;
 
+typedef struct GifFrame {
+    uint16_t width = 0;
+    uint16_t height = 0;
+    // Rectangle of the frame that is actually written.
+    uint16_t left = 0;
+    uint16_t top = 0;
+    uint16_t rectWidth = 0;
+    uint16_t rectHeight = 0;
+    // Pixels equal to the previous frame are written transparent and show through.
+    bool isDelta = false;
+    bool hasLocalColorMap = false;
+    std::vector<uint32_t> argb;
+    std::vector<ColorType> colorMap;
+    std::vector<uint8_t> indices;
+    std::vector<uint8_t> data;
+} GifFrame;
+
 class GifEncoder : public AbsImageEncoder, public OHOS::MultimediaPlugin::PluginClassBase {
 public:
     GifEncoder();
@@ -57,13 +74,16 @@ public:
 private:
     DISALLOW_COPY_AND_MOVE(GifEncoder);
     uint32_t DoEncode();
-    uint32_t WriteFileInfo();
-    uint32_t WriteFrameInfo(int index);
-    uint32_t processFrame(int index);
-    uint32_t colorQuantize(int index, uint16_t width, uint16_t height,
-                           uint8_t *outputBuffer, ColorType *outputColorMap);
-    uint32_t separateRGBA(int index, uint16_t width, uint16_t height,
-                          uint8_t *redBuffer, uint8_t *greenBuffer, uint8_t *blueBuffer, uint8_t *alphaBuffer);
+    uint32_t EncodeFrameBatch(size_t start, size_t end, std::vector<GifFrame> &frames, GifFrame &previous,
+                              std::vector<ColorType> &globalColorMap);
+    uint32_t WriteFileInfo(const std::vector<ColorType> &globalColorMap);
+    uint32_t WriteFrameInfo(int index, const GifFrame &frame);
+    uint32_t ReadFrame(int index, GifFrame &frame);
+    void PlanFrameRect(int index, const GifFrame &previous, GifFrame &frame);
+    uint32_t QuantizeFrame(int index, const GifFrame *previous, GifFrame &frame);
+    bool MapToColorMap(int index, const GifFrame *previous, const std::vector<ColorType> &colorMap, GifFrame &frame);
+    uint32_t EncodeFrameData(GifFrame &frame);
+    uint8_t GetDisposalType(int index) const;
     uint32_t doColorQuantize(uint16_t width, uint16_t height,
                              const uint8_t *redInput, const uint8_t *greenInput,
                              const uint8_t *blueInput, const uint8_t *alphaInput,
@@ -92,6 +112,8 @@ private:
     uint32_t crntShiftDWord_ = 0;
     uint32_t dictionary_[DICTIONARY_SIZE] = {0};
     uint8_t outputLZWBuffer_[256] = {0};
+    // When set, Write appends here instead of the output stream.
+    std::vector<uint8_t> *frameOutput_ {nullptr};
 };
 
 } // namespace ImagePlugin
@@ -17,8 +17,13 @@
 #include "image_trace.h"
 #include "media_errors.h"
 #include "securec.h"
+#include <algorithm>
+#include <cstring>
 #include <iostream>
 #include <memory>
+#if !defined(_WIN32) && !defined(_APPLE) && !defined(IOS_PLATFORM) && !defined(ANDROID_PLATFORM)
+#include "ffrt.h"
+#endif
 #undef LOG_DOMAIN
 #define LOG_DOMAIN LOG_TAG_DOMAIN_ID_PLUGIN
 
@@ -53,13 +58,49 @@ const int FIRST_CODE = 4097;
 const int DISPOSAL_METHOD_SHIFT_BIT = 2;
 const uint32_t DEFAULT_DELAY_TIME = 100;
 const uint32_t DEFAULT_DISPOSAL_TYPE = 1;
+const uint8_t DISPOSAL_UNSPECIFIED = 0;
+const uint8_t DISPOSAL_NONE = 1;
+const uint8_t TRANSPARENT_INDEX = 0xFF;
+const uint8_t GLOBAL_COLOR_TABLE_FIELDS = 0xF7;
+const uint8_t LOCAL_COLOR_TABLE_FIELDS = 0x87;
+const int ARGB_ALPHA_SHIFT = 24;
+const int ARGB_RED_SHIFT = 16;
+const int ARGB_GREEN_SHIFT = 8;
+const size_t FRAME_BATCH_SIZE = 8;
+// Squared RGB distances: one 5 bit quantizer step per channel on average, four at most.
+const uint64_t PALETTE_REUSE_MEAN_ERROR = 3 * 8 * 8;
+const uint32_t PALETTE_REUSE_MAX_ERROR = 3 * 32 * 32;
+const int16_t KD_TREE_NONE = -1;
+const uint32_t INVERSE_MAP_UNSET = UINT32_MAX;
+const int INVERSE_MAP_DISTANCE_SHIFT = 8;
+const int MAX_CHANNEL_VALUE = 255;
+const int ORDERED_DITHER_SIZE = 8;
+const int ORDERED_DITHER_LEVELS = ORDERED_DITHER_SIZE * ORDERED_DITHER_SIZE;
+// Peak to peak amplitude of the ordered dither, four steps of the 5 bit color cube.
+const int ORDERED_DITHER_SPREAD = 32;
+const int FS_WEIGHT_SUM = 16;
+const int FS_RIGHT_WEIGHT = 7;
+const int FS_DOWN_LEFT_WEIGHT = 3;
+const int FS_DOWN_WEIGHT = 5;
+const int FS_DOWN_RIGHT_WEIGHT = 1;
+
+const uint8_t BAYER_MATRIX[ORDERED_DITHER_SIZE][ORDERED_DITHER_SIZE] = {
+    {0, 32, 8, 40, 2, 34, 10, 42},
+    {48, 16, 56, 24, 50, 18, 58, 26},
+    {12, 44, 4, 36, 14, 46, 6, 38},
+    {60, 28, 52, 20, 62, 30, 54, 22},
+    {3, 35, 11, 43, 1, 33, 9, 41},
+    {51, 19, 59, 27, 49, 17, 57, 25},
+    {15, 47, 7, 39, 13, 45, 5, 37},
+    {63, 31, 55, 23, 61, 29, 53, 21},
+};
 
 const uint8_t GIF89_STAMP[] = {0x47, 0x49, 0x46, 0x38, 0x39, 0x61};
 const uint8_t APPLICATION_IDENTIFIER[] = {0x4E, 0x45, 0x54, 0x53, 0x43, 0x41, 0x50, 0x45};
 const uint8_t APPLICATION_AUTENTICATION_CODE[] = {0x32, 0x2E, 0x30};
 const uint8_t GIF_TRAILER[] = {0x3B};
 
-static int g_sortRGBAxis = 0;
+static thread_local int g_sortRGBAxis = 0;
 
 #pragma pack(1)
 typedef struct LogicalScreenDescriptor {
@@ -177,21 +218,339 @@ uint32_t GifEncoder::FinalizeEncode()
     return errorCode;
 }
 
+static inline uint32_t MakeArgb(uint8_t alpha, uint8_t red, uint8_t green, uint8_t blue)
+{
+    return (static_cast<uint32_t>(alpha) << ARGB_ALPHA_SHIFT) | (static_cast<uint32_t>(red) << ARGB_RED_SHIFT) |
+        (static_cast<uint32_t>(green) << ARGB_GREEN_SHIFT) | blue;
+}
+
+static inline uint32_t ToColorCubeIndex(uint32_t argb)
+{
+    const int shift = BITS_IN_BYTE - BITS_PER_PRIM_COLOR;
+    return ((((argb >> ARGB_RED_SHIFT) & 0xFF) >> shift) << RED_COORDINATE) +
+        ((((argb >> ARGB_GREEN_SHIFT) & 0xFF) >> shift) << GREEN_COORDINATE) +
+        (((argb & 0xFF) >> shift) << BLUE_COORDINATE);
+}
+
+static inline uint32_t ToColorCubeIndex(const int rgb[NUM_OF_RGB])
+{
+    const int shift = BITS_IN_BYTE - BITS_PER_PRIM_COLOR;
+    return (static_cast<uint32_t>(rgb[R_IN_RGB] >> shift) << RED_COORDINATE) +
+        (static_cast<uint32_t>(rgb[G_IN_RGB] >> shift) << GREEN_COORDINATE) +
+        (static_cast<uint32_t>(rgb[B_IN_RGB] >> shift) << BLUE_COORDINATE);
+}
+
+static inline int GetChannel(const ColorType &color, int axis)
+{
+    return (axis == R_IN_RGB) ? color.red : ((axis == G_IN_RGB) ? color.green : color.blue);
+}
+
+// A pixel is written unless it is transparent or shows the previous frame through a delta.
+static inline bool IsPixelWritten(const GifFrame &frame, const GifFrame *previous, size_t pos)
+{
+    uint32_t color = frame.argb[pos];
+    if ((color >> ARGB_ALPHA_SHIFT) == 0) {
+        return false;
+    }
+    return !(frame.isDelta && previous != nullptr && previous->argb[pos] == color);
+}
+
+namespace {
+// k-d tree over the opaque palette entries, split on the widest channel at every level.
+class PaletteKdTree {
+public:
+    explicit PaletteKdTree(const std::vector<ColorType> &colorMap) : colorMap_(colorMap)
+    {
+        std::vector<uint8_t> entries;
+        for (int i = 0; i < TRANSPARENT_INDEX && i < static_cast<int>(colorMap_.size()); i++) {
+            entries.push_back(static_cast<uint8_t>(i));
+        }
+        nodes_.reserve(entries.size());
+        root_ = Build(entries, 0, entries.size());
+    }
+
+    uint8_t FindNearest(const int rgb[NUM_OF_RGB], uint32_t &distance) const
+    {
+        uint8_t nearest = 0;
+        distance = UINT32_MAX;
+        Search(root_, rgb, distance, nearest);
+        return nearest;
+    }
+
+private:
+    struct Node {
+        uint8_t index;
+        uint8_t axis;
+        int16_t left;
+        int16_t right;
+    };
+
+    int16_t Build(std::vector<uint8_t> &entries, size_t begin, size_t end)
+    {
+        if (begin >= end) {
+            return KD_TREE_NONE;
+        }
+        int axis = R_IN_RGB;
+        int widest = -1;
+        for (int channel = 0; channel < NUM_OF_RGB; channel++) {
+            auto range = std::minmax_element(entries.begin() + begin, entries.begin() + end,
+                [this, channel](uint8_t a, uint8_t b) {
+                    return GetChannel(colorMap_[a], channel) < GetChannel(colorMap_[b], channel);
+                });
+            int width = GetChannel(colorMap_[*range.second], channel) - GetChannel(colorMap_[*range.first], channel);
+            if (width > widest) {
+                widest = width;
+                axis = channel;
+            }
+        }
+        size_t middle = begin + (end - begin) / 2;
+        std::nth_element(entries.begin() + begin, entries.begin() + middle, entries.begin() + end,
+            [this, axis](uint8_t a, uint8_t b) {
+                return GetChannel(colorMap_[a], axis) < GetChannel(colorMap_[b], axis);
+            });
+        int16_t node = static_cast<int16_t>(nodes_.size());
+        nodes_.push_back({entries[middle], static_cast<uint8_t>(axis), KD_TREE_NONE, KD_TREE_NONE});
+        int16_t left = Build(entries, begin, middle);
+        int16_t right = Build(entries, middle + 1, end);
+        nodes_[node].left = left;
+        nodes_[node].right = right;
+        return node;
+    }
+
+    void Search(int16_t node, const int rgb[NUM_OF_RGB], uint32_t &best, uint8_t &nearest) const
+    {
+        if (node == KD_TREE_NONE || best == 0) {
+            return;
+        }
+        const Node &current = nodes_[node];
+        const ColorType &color = colorMap_[current.index];
+        int dr = color.red - rgb[R_IN_RGB];
+        int dg = color.green - rgb[G_IN_RGB];
+        int db = color.blue - rgb[B_IN_RGB];
+        uint32_t distance = static_cast<uint32_t>(dr * dr + dg * dg + db * db);
+        if (distance < best) {
+            best = distance;
+            nearest = current.index;
+        }
+        int diff = rgb[current.axis] - GetChannel(color, current.axis);
+        Search((diff < 0) ? current.left : current.right, rgb, best, nearest);
+        if (static_cast<uint32_t>(diff * diff) < best) {
+            Search((diff < 0) ? current.right : current.left, rgb, best, nearest);
+        }
+    }
+
+    const std::vector<ColorType> &colorMap_;
+    std::vector<Node> nodes_;
+    int16_t root_ = KD_TREE_NONE;
+};
+
+// Nearest palette entry for every cell of the 5 bit per channel color cube, filled on first use.
+class InverseColorMap {
+public:
+    explicit InverseColorMap(const std::vector<ColorType> &colorMap)
+        : tree_(colorMap), cells_(COLOR_ARRAY_SIZE, INVERSE_MAP_UNSET) {}
+
+    uint8_t Lookup(uint32_t cube, uint32_t *distance = nullptr)
+    {
+        uint32_t &cell = cells_[cube];
+        if (cell == INVERSE_MAP_UNSET) {
+            // The cell is looked up by its center, its lowest corner would pull every color towards black.
+            const int shift = BITS_IN_BYTE - BITS_PER_PRIM_COLOR;
+            const int halfCell = 1 << (shift - 1);
+            int rgb[NUM_OF_RGB] = {
+                (static_cast<int>((cube >> RED_COORDINATE) & 0x1F) << shift) + halfCell,
+                (static_cast<int>((cube >> GREEN_COORDINATE) & 0x1F) << shift) + halfCell,
+                (static_cast<int>((cube >> BLUE_COORDINATE) & 0x1F) << shift) + halfCell,
+            };
+            uint32_t nearestDistance = 0;
+            uint8_t nearest = tree_.FindNearest(rgb, nearestDistance);
+            cell = (nearestDistance << INVERSE_MAP_DISTANCE_SHIFT) | nearest;
+        }
+        if (distance != nullptr) {
+            *distance = cell >> INVERSE_MAP_DISTANCE_SHIFT;
+        }
+        return static_cast<uint8_t>(cell);
+    }
+
+private:
+    PaletteKdTree tree_;
+    std::vector<uint32_t> cells_;
+};
+} // namespace
+
+static inline int ClampChannel(int value)
+{
+    return std::min(std::max(value, 0), MAX_CHANNEL_VALUE);
+}
+
+static inline void SplitChannels(uint32_t color, int rgb[NUM_OF_RGB])
+{
+    rgb[R_IN_RGB] = static_cast<int>((color >> ARGB_RED_SHIFT) & 0xFF);
+    rgb[G_IN_RGB] = static_cast<int>((color >> ARGB_GREEN_SHIFT) & 0xFF);
+    rgb[B_IN_RGB] = static_cast<int>(color & 0xFF);
+}
+
+// Floyd-Steinberg: the quantization error is pushed right and down in sixteenths.
+// Errors are not carried across transparent pixels, so unchanged areas of a delta frame stay untouched.
+static void DiffuseFrameError(const GifFrame *previous, const std::vector<ColorType> &colorMap,
+                              InverseColorMap &inverseMap, GifFrame &frame)
+{
+    size_t rowLength = (static_cast<size_t>(frame.rectWidth) + 2) * NUM_OF_RGB;
+    std::vector<int32_t> currentErrors(rowLength, 0);
+    std::vector<int32_t> nextErrors(rowLength, 0);
+    size_t i = 0;
+    for (int y = frame.top; y < frame.top + frame.rectHeight; y++) {
+        std::fill(nextErrors.begin(), nextErrors.end(), 0);
+        for (size_t x = 0; x < frame.rectWidth; x++, i++) {
+            size_t pos = static_cast<size_t>(y) * frame.width + frame.left + x;
+            if (!IsPixelWritten(frame, previous, pos)) {
+                frame.indices[i] = TRANSPARENT_INDEX;
+                continue;
+            }
+            int rgb[NUM_OF_RGB];
+            SplitChannels(frame.argb[pos], rgb);
+            int32_t *error = &currentErrors[(x + 1) * NUM_OF_RGB];
+            for (int c = 0; c < NUM_OF_RGB; c++) {
+                rgb[c] = ClampChannel(rgb[c] + error[c] / FS_WEIGHT_SUM);
+            }
+            uint8_t index = inverseMap.Lookup(ToColorCubeIndex(rgb));
+            frame.indices[i] = index;
+            for (int c = 0; c < NUM_OF_RGB; c++) {
+                int32_t residual = rgb[c] - GetChannel(colorMap[index], c);
+                currentErrors[(x + 2) * NUM_OF_RGB + c] += residual * FS_RIGHT_WEIGHT;
+                nextErrors[x * NUM_OF_RGB + c] += residual * FS_DOWN_LEFT_WEIGHT;
+                nextErrors[(x + 1) * NUM_OF_RGB + c] += residual * FS_DOWN_WEIGHT;
+                nextErrors[(x + 2) * NUM_OF_RGB + c] += residual * FS_DOWN_RIGHT_WEIGHT;
+            }
+        }
+        currentErrors.swap(nextErrors);
+    }
+}
+
+// Maps the written rectangle of a frame onto colorMap. The ordered threshold is anchored to canvas
+// coordinates, so a pixel that does not change keeps the same index from one frame to the next.
+static void MapFramePixels(const GifFrame *previous, const std::vector<ColorType> &colorMap,
+                           InverseColorMap &inverseMap, DitherType ditherType, GifFrame &frame)
+{
+    frame.indices.resize(static_cast<size_t>(frame.rectWidth) * frame.rectHeight);
+    if (ditherType == DitherType::FLOYD_STEINBERG) {
+        DiffuseFrameError(previous, colorMap, inverseMap, frame);
+        return;
+    }
+    bool ordered = ditherType == DitherType::ORDERED;
+    size_t i = 0;
+    for (int y = frame.top; y < frame.top + frame.rectHeight; y++) {
+        for (int x = frame.left; x < frame.left + frame.rectWidth; x++, i++) {
+            size_t pos = static_cast<size_t>(y) * frame.width + x;
+            if (!IsPixelWritten(frame, previous, pos)) {
+                frame.indices[i] = TRANSPARENT_INDEX;
+                continue;
+            }
+            if (!ordered) {
+                frame.indices[i] = inverseMap.Lookup(ToColorCubeIndex(frame.argb[pos]));
+                continue;
+            }
+            int rgb[NUM_OF_RGB];
+            SplitChannels(frame.argb[pos], rgb);
+            int threshold = BAYER_MATRIX[y % ORDERED_DITHER_SIZE][x % ORDERED_DITHER_SIZE];
+            int bias = (2 * threshold + 1 - ORDERED_DITHER_LEVELS) * ORDERED_DITHER_SPREAD /
+                (2 * ORDERED_DITHER_LEVELS);
+            for (int c = 0; c < NUM_OF_RGB; c++) {
+                rgb[c] = ClampChannel(rgb[c] + bias);
+            }
+            frame.indices[i] = inverseMap.Lookup(ToColorCubeIndex(rgb));
+        }
+    }
+}
+
+template <typename Task>
+static void RunFrameTasks(size_t count, const Task &task)
+{
+#if !defined(_WIN32) && !defined(_APPLE) && !defined(IOS_PLATFORM) && !defined(ANDROID_PLATFORM)
+    std::vector<ffrt::dependence> handles;
+    for (size_t index = 1; index < count; index++) {
+        handles.emplace_back(ffrt::submit_h([&task, index] { task(index); }));
+    }
+    if (count > 0) {
+        task(0);
+    }
+    ffrt::wait(handles);
+#else
+    for (size_t index = 0; index < count; index++) {
+        task(index);
+    }
+#endif
+}
+
 uint32_t GifEncoder::DoEncode()
 {
     IMAGE_LOGD("DoEncode IN");
-    WriteFileInfo();
-    for (int index = 0; index < static_cast<int>(pixelMaps_.size()); index++) {
-        InitDictionary();
-        WriteFrameInfo(index);
-        processFrame(index);
+    // Frames go through in batches so only a bounded number of decoded frames is alive at once.
+    // Within a batch frames are read, quantized and LZW encoded in parallel, then written in order.
+    std::vector<ColorType> globalColorMap;
+    GifFrame previous;
+    std::vector<GifFrame> frames;
+    for (size_t start = 0; start < pixelMaps_.size(); start += FRAME_BATCH_SIZE) {
+        size_t end = std::min(start + FRAME_BATCH_SIZE, pixelMaps_.size());
+        uint32_t ret = EncodeFrameBatch(start, end, frames, previous, globalColorMap);
+        CHECK_ERROR_RETURN_RET(ret != SUCCESS, ret);
     }
-    Write(GIF_TRAILER, sizeof(GIF_TRAILER));
+    CHECK_ERROR_RETURN_RET_LOG(!Write(GIF_TRAILER, sizeof(GIF_TRAILER)), ERR_IMAGE_ENCODE_FAILED,
+        "Write to buffer error.");
     IMAGE_LOGD("DoEncode OUT");
     return SUCCESS;
 }
 
-uint32_t GifEncoder::WriteFileInfo()
+uint32_t GifEncoder::EncodeFrameBatch(size_t start, size_t end, std::vector<GifFrame> &frames, GifFrame &previous,
+                                      std::vector<ColorType> &globalColorMap)
+{
+    size_t count = end - start;
+    frames.clear();
+    frames.resize(count);
+    std::vector<uint32_t> errors(count, SUCCESS);
+    RunFrameTasks(count, [this, start, &frames, &errors](size_t i) {
+        errors[i] = ReadFrame(static_cast<int>(start + i), frames[i]);
+    });
+    for (size_t i = 0; i < count; i++) {
+        CHECK_ERROR_RETURN_RET(errors[i] != SUCCESS, errors[i]);
+        const GifFrame *prev = (i > 0) ? &frames[i - 1] : (start > 0 ? &previous : nullptr);
+        if (prev != nullptr) {
+            PlanFrameRect(static_cast<int>(start + i), *prev, frames[i]);
+        }
+    }
+
+    // The first frame's palette becomes the global color table that later frames try to reuse.
+    if (start == 0) {
+        CHECK_ERROR_RETURN_RET(QuantizeFrame(0, nullptr, frames[0]) != SUCCESS, ERR_IMAGE_ENCODE_FAILED);
+        globalColorMap = std::move(frames[0].colorMap);
+        frames[0].hasLocalColorMap = false;
+        CHECK_ERROR_RETURN_RET(WriteFileInfo(globalColorMap) != SUCCESS, ERR_IMAGE_ENCODE_FAILED);
+    }
+    RunFrameTasks(count, [this, start, &frames, &previous, &globalColorMap, &errors](size_t i) {
+        int index = static_cast<int>(start + i);
+        if (index > 0) {
+            const GifFrame *prev = (i > 0) ? &frames[i - 1] : &previous;
+            if (!MapToColorMap(index, prev, globalColorMap, frames[i])) {
+                errors[i] = QuantizeFrame(index, prev, frames[i]);
+            }
+        }
+        if (errors[i] == SUCCESS) {
+            errors[i] = EncodeFrameData(frames[i]);
+        }
+    });
+    for (size_t i = 0; i < count; i++) {
+        CHECK_ERROR_RETURN_RET_LOG(errors[i] != SUCCESS, ERR_IMAGE_ENCODE_FAILED,
+            "Failed to encode frame %{public}zu.", start + i);
+        CHECK_ERROR_RETURN_RET(WriteFrameInfo(static_cast<int>(start + i), frames[i]) != SUCCESS,
+            ERR_IMAGE_ENCODE_FAILED);
+        CHECK_ERROR_RETURN_RET_LOG(!Write(frames[i].data.data(), frames[i].data.size()), ERR_IMAGE_ENCODE_FAILED,
+            "Write to buffer error.");
+    }
+    previous = std::move(frames[count - 1]);
+    return SUCCESS;
+}
+
+uint32_t GifEncoder::WriteFileInfo(const std::vector<ColorType> &globalColorMap)
 {
     if (!Write(GIF89_STAMP, sizeof(GIF89_STAMP))) {
         IMAGE_LOGE("Write to buffer error.");
@@ -208,7 +567,9 @@ uint32_t GifEncoder::WriteFileInfo()
             lsd.logicalScreenHeight = static_cast<uint16_t>(pixelMap->GetHeight());
         }
     }
-    if (!Write((const uint8_t*)&lsd, sizeof(LogicalScreenDescriptor))) {
+    lsd.packedFields = GLOBAL_COLOR_TABLE_FIELDS;
+    if (!Write((const uint8_t*)&lsd, sizeof(LogicalScreenDescriptor)) ||
+        !Write((const uint8_t*)globalColorMap.data(), sizeof(ColorType) * COLOR_MAP_SIZE)) {
         IMAGE_LOGE("Write to buffer error.");
         return ERR_IMAGE_ENCODE_FAILED;
     }
@@ -234,7 +595,7 @@ uint32_t GifEncoder::WriteFileInfo()
     return SUCCESS;
 }
 
-uint32_t GifEncoder::WriteFrameInfo(int index)
+uint32_t GifEncoder::WriteFrameInfo(int index, const GifFrame &frame)
 {
     GraphicControlExtension gce;
     memset_s(&gce, sizeof(GraphicControlExtension), 0, sizeof(GraphicControlExtension));
@@ -242,11 +603,10 @@ uint32_t GifEncoder::WriteFrameInfo(int index)
     gce.graphicControlLabel = GRAPHIC_CONTROL_LABEL;
     gce.blockSize = 0x04;
     gce.packedFields = 0x01;
-    gce.packedFields |= (((index < static_cast<int>(encodeOpts_.disposalTypes.size()) ?
-        encodeOpts_.disposalTypes[index] : DEFAULT_DISPOSAL_TYPE) & 0x07) << DISPOSAL_METHOD_SHIFT_BIT);
+    gce.packedFields |= ((GetDisposalType(index) & 0x07) << DISPOSAL_METHOD_SHIFT_BIT);
     gce.delayTime = index < static_cast<int>(encodeOpts_.delayTimes.size()) ?
         encodeOpts_.delayTimes[index] : DEFAULT_DELAY_TIME;
-    gce.transparentColorIndex = 0xFF;
+    gce.transparentColorIndex = TRANSPARENT_INDEX;
     gce.blockTerminator = 0x00;
     if (!Write((const uint8_t*)&gce, sizeof(GraphicControlExtension))) {
         IMAGE_LOGE("Write to buffer error.");
@@ -256,87 +616,191 @@ uint32_t GifEncoder::WriteFrameInfo(int index)
     ImageDescriptor id;
     memset_s(&id, sizeof(ImageDescriptor), 0, sizeof(ImageDescriptor));
     id.imageSeparator = IMAGE_SEPARATOR;
-    id.imageLeftPosition = 0x0000;
-    id.imageTopPosition = 0x0000;
-    id.imageWidth = static_cast<uint16_t>(pixelMaps_[index]->GetWidth());
-    id.imageHeight = static_cast<uint16_t>(pixelMaps_[index]->GetHeight());
-    id.packedFields = 0x87;
+    id.imageLeftPosition = frame.left;
+    id.imageTopPosition = frame.top;
+    id.imageWidth = frame.rectWidth;
+    id.imageHeight = frame.rectHeight;
+    id.packedFields = frame.hasLocalColorMap ? LOCAL_COLOR_TABLE_FIELDS : 0x00;
     if (!Write((const uint8_t*)&id, sizeof(ImageDescriptor))) {
         IMAGE_LOGE("Write to buffer error.");
         return ERR_IMAGE_ENCODE_FAILED;
     }
+    if (frame.hasLocalColorMap &&
+        !Write((const uint8_t*)frame.colorMap.data(), sizeof(ColorType) * COLOR_MAP_SIZE)) {
+        IMAGE_LOGE("Write to buffer error.");
+        return ERR_IMAGE_ENCODE_FAILED;
+    }
 
     return SUCCESS;
 }
 
-uint32_t GifEncoder::processFrame(int index)
+uint8_t GifEncoder::GetDisposalType(int index) const
 {
-    int32_t originalWidth = pixelMaps_[index]->GetWidth();
-    int32_t originalHeight = pixelMaps_[index]->GetHeight();
+    return index < static_cast<int>(encodeOpts_.disposalTypes.size()) ?
+        encodeOpts_.disposalTypes[index] : DEFAULT_DISPOSAL_TYPE;
+}
+
+uint32_t GifEncoder::ReadFrame(int index, GifFrame &frame)
+{
+    CHECK_ERROR_RETURN_RET(index < 0 || static_cast<size_t>(index) >= pixelMaps_.size(), ERR_IMAGE_ENCODE_FAILED);
+    Media::PixelMap *pixelMap = pixelMaps_[index];
+    int32_t originalWidth = pixelMap->GetWidth();
+    int32_t originalHeight = pixelMap->GetHeight();
     bool cond = originalWidth <= 0 || originalHeight <= 0 ||
         originalWidth > UINT16_MAX || originalHeight > UINT16_MAX;
     CHECK_ERROR_RETURN_RET_LOG(cond, ERR_IMAGE_ENCODE_FAILED,
         "Invalid image dimensions: width=%{public}d, height=%{public}d", originalWidth, originalHeight);
-    uint16_t width = static_cast<uint16_t>(originalWidth);
-    uint16_t height = static_cast<uint16_t>(originalHeight);
+    uint64_t frameSize = static_cast<uint64_t>(originalWidth) * originalHeight;
+    CHECK_ERROR_RETURN_RET_LOG(frameSize > INT32_MAX, ERR_IMAGE_ENCODE_FAILED, "Image frame is too large.");
 
-    auto colorMap = std::make_unique<ColorType[]>(COLOR_MAP_SIZE);
+    frame.width = static_cast<uint16_t>(originalWidth);
+    frame.height = static_cast<uint16_t>(originalHeight);
+    frame.rectWidth = frame.width;
+    frame.rectHeight = frame.height;
+    frame.argb.resize(frameSize);
+    for (int y = 0; y < frame.height; y++) {
+        for (int x = 0; x < frame.width; x++) {
+            uint32_t pixelColor;
+            CHECK_ERROR_RETURN_RET_LOG(!pixelMap->GetARGB32Color(x, y, pixelColor), ERR_IMAGE_ENCODE_FAILED,
+                "Failed to get rgb value.");
+            frame.argb[y * frame.width + x] = MakeArgb(pixelMap->GetARGB32ColorA(pixelColor),
+                pixelMap->GetARGB32ColorR(pixelColor), pixelMap->GetARGB32ColorG(pixelColor),
+                pixelMap->GetARGB32ColorB(pixelColor));
+        }
+    }
+    return SUCCESS;
+}
 
-    uint64_t frameSize = static_cast<uint64_t>(width) * height;
-    CHECK_ERROR_RETURN_RET_LOG(frameSize > INT32_MAX, ERR_IMAGE_ENCODE_FAILED, "Image frame is too large.");
-    auto colorBuffer = std::make_unique<uint8_t[]>(frameSize);
-    if (colorQuantize(index, width, height, colorBuffer.get(), colorMap.get())) {
-        IMAGE_LOGE("Failed to quantize color.");
-        return ERR_IMAGE_ENCODE_FAILED;
+void GifEncoder::PlanFrameRect(int index, const GifFrame &previous, GifFrame &frame)
+{
+    // Only write what changed when the previous frame stays on screen underneath this one.
+    uint8_t previousDisposal = GetDisposalType(index - 1);
+    if (previous.width != frame.width || previous.height != frame.height ||
+        (previousDisposal != DISPOSAL_UNSPECIFIED && previousDisposal != DISPOSAL_NONE)) {
+        return;
     }
-    for (int j = 0; j < COLOR_MAP_SIZE; j++) {
-        Write(&(colorMap[j].red), 1);
-        Write(&(colorMap[j].green), 1);
-        Write(&(colorMap[j].blue), 1);
+    int minX = frame.width;
+    int maxX = -1;
+    int minY = -1;
+    int maxY = -1;
+    for (int y = 0; y < frame.height; y++) {
+        const uint32_t *cur = frame.argb.data() + y * frame.width;
+        const uint32_t *prev = previous.argb.data() + y * frame.width;
+        if (memcmp(cur, prev, frame.width * sizeof(uint32_t)) == 0) {
+            continue;
+        }
+        int left = 0;
+        while (cur[left] == prev[left]) {
+            left++;
+        }
+        int right = frame.width - 1;
+        while (cur[right] == prev[right]) {
+            right--;
+        }
+        minX = std::min(minX, left);
+        maxX = std::max(maxX, right);
+        minY = (minY < 0) ? y : minY;
+        maxY = y;
     }
-    if (LZWEncodeFrame(colorBuffer.get(), width, height)) {
-        IMAGE_LOGE("Failed to encode frame.");
-        return ERR_IMAGE_ENCODE_FAILED;
+    frame.isDelta = true;
+    if (maxY < 0) {
+        // Nothing changed: keep the frame for its delay with a single transparent pixel.
+        frame.left = 0;
+        frame.top = 0;
+        frame.rectWidth = 1;
+        frame.rectHeight = 1;
+        return;
     }
-    return SUCCESS;
+    frame.left = static_cast<uint16_t>(minX);
+    frame.top = static_cast<uint16_t>(minY);
+    frame.rectWidth = static_cast<uint16_t>(maxX - minX + 1);
+    frame.rectHeight = static_cast<uint16_t>(maxY - minY + 1);
 }
 
-uint32_t GifEncoder::colorQuantize(int index, uint16_t width, uint16_t height,
-                                   uint8_t *outputBuffer, ColorType *outputColorMap)
+uint32_t GifEncoder::QuantizeFrame(int index, const GifFrame *previous, GifFrame &frame)
 {
-    uint64_t frameSize = static_cast<uint64_t>(width) * height;
-    auto redBuffer = std::make_unique<uint8_t[]>(frameSize);
-    auto greenBuffer = std::make_unique<uint8_t[]>(frameSize);
-    auto blueBuffer = std::make_unique<uint8_t[]>(frameSize);
-    auto alphaBuffer = std::make_unique<uint8_t[]>(frameSize);
-    if (separateRGBA(index, width, height, redBuffer.get(), greenBuffer.get(),
-        blueBuffer.get(), alphaBuffer.get())) {
-        IMAGE_LOGE("Failed to separate RGB, aborted.");
-        return ERR_IMAGE_ENCODE_FAILED;
+    size_t rectSize = static_cast<size_t>(frame.rectWidth) * frame.rectHeight;
+    auto redBuffer = std::make_unique<uint8_t[]>(rectSize);
+    auto greenBuffer = std::make_unique<uint8_t[]>(rectSize);
+    auto blueBuffer = std::make_unique<uint8_t[]>(rectSize);
+    auto alphaBuffer = std::make_unique<uint8_t[]>(rectSize);
+    size_t i = 0;
+    for (int y = frame.top; y < frame.top + frame.rectHeight; y++) {
+        for (int x = frame.left; x < frame.left + frame.rectWidth; x++, i++) {
+            size_t pos = static_cast<size_t>(y) * frame.width + x;
+            uint32_t color = frame.argb[pos];
+            redBuffer[i] = static_cast<uint8_t>(color >> ARGB_RED_SHIFT);
+            greenBuffer[i] = static_cast<uint8_t>(color >> ARGB_GREEN_SHIFT);
+            blueBuffer[i] = static_cast<uint8_t>(color);
+            alphaBuffer[i] = IsPixelWritten(frame, previous, pos) ? static_cast<uint8_t>(color >> ARGB_ALPHA_SHIFT) : 0;
+        }
     }
-
-    bool cond = doColorQuantize(width, height, redBuffer.get(), greenBuffer.get(),
-        blueBuffer.get(), alphaBuffer.get(), outputBuffer, outputColorMap);
-    CHECK_ERROR_RETURN_RET_LOG(cond, ERR_IMAGE_ENCODE_FAILED, "Failed to quantize buffer, aborted.");
+    frame.colorMap.resize(COLOR_MAP_SIZE);
+    // Without dithering the median-cut boxes map the pixels as they always did.
+    bool undithered = encodeOpts_.ditherType == DitherType::NONE;
+    if (undithered) {
+        frame.indices.resize(rectSize);
+    }
+    bool cond = doColorQuantize(frame.rectWidth, frame.rectHeight, redBuffer.get(), greenBuffer.get(),
+        blueBuffer.get(), alphaBuffer.get(), undithered ? frame.indices.data() : nullptr, frame.colorMap.data());
+    CHECK_ERROR_RETURN_RET_LOG(cond, ERR_IMAGE_ENCODE_FAILED, "Failed to quantize frame %{public}d.", index);
+    if (!undithered) {
+        InverseColorMap inverseMap(frame.colorMap);
+        MapFramePixels(previous, frame.colorMap, inverseMap, encodeOpts_.ditherType, frame);
+    }
+    frame.hasLocalColorMap = true;
     return SUCCESS;
 }
 
-uint32_t GifEncoder::separateRGBA(int index, uint16_t width, uint16_t height,
-                                  uint8_t *redBuffer, uint8_t *greenBuffer, uint8_t *blueBuffer, uint8_t *alphaBuffer)
+bool GifEncoder::MapToColorMap(int index, const GifFrame *previous, const std::vector<ColorType> &colorMap,
+                               GifFrame &frame)
 {
-    CHECK_ERROR_RETURN_RET(index < 0 || static_cast<size_t>(index) >= pixelMaps_.size(), ERR_IMAGE_ENCODE_FAILED);
-    for (int y = 0; y < height; y++) {
-        for (int x = 0; x < width; x++) {
-            uint32_t pixelColor;
-            CHECK_ERROR_RETURN_RET_LOG(!pixelMaps_[index]->GetARGB32Color(x, y, pixelColor), ERR_IMAGE_ENCODE_FAILED,
-                "Failed to get rgb value.");
-            redBuffer[y * width + x] = pixelMaps_[index]->GetARGB32ColorR(pixelColor);
-            greenBuffer[y * width + x] = pixelMaps_[index]->GetARGB32ColorG(pixelColor);
-            blueBuffer[y * width + x] = pixelMaps_[index]->GetARGB32ColorB(pixelColor);
-            alphaBuffer[y * width + x] = pixelMaps_[index]->GetARGB32ColorA(pixelColor);
+    // Histogram of the written pixels on the same 15 bit grid the quantizer uses.
+    std::vector<uint32_t> histogram(COLOR_ARRAY_SIZE, 0);
+    for (int y = frame.top; y < frame.top + frame.rectHeight; y++) {
+        for (int x = frame.left; x < frame.left + frame.rectWidth; x++) {
+            size_t pos = static_cast<size_t>(y) * frame.width + x;
+            if (IsPixelWritten(frame, previous, pos)) {
+                histogram[ToColorCubeIndex(frame.argb[pos])]++;
+            }
+        }
+    }
+    // Reuse the palette when every color has a close entry and the average drift stays small.
+    InverseColorMap inverseMap(colorMap);
+    uint64_t totalError = 0;
+    uint64_t totalPixels = 0;
+    for (uint32_t cube = 0; cube < COLOR_ARRAY_SIZE; cube++) {
+        if (histogram[cube] == 0) {
+            continue;
+        }
+        uint32_t error = 0;
+        inverseMap.Lookup(cube, &error);
+        if (error > PALETTE_REUSE_MAX_ERROR) {
+            return false;
         }
+        totalError += static_cast<uint64_t>(error) * histogram[cube];
+        totalPixels += histogram[cube];
     }
+    if (totalPixels > 0 && totalError > PALETTE_REUSE_MEAN_ERROR * totalPixels) {
+        return false;
+    }
+    IMAGE_LOGD("MapToColorMap, frame %{public}d reuses the global color table", index);
+    MapFramePixels(previous, colorMap, inverseMap, encodeOpts_.ditherType, frame);
+    frame.hasLocalColorMap = false;
+    return true;
+}
 
+uint32_t GifEncoder::EncodeFrameData(GifFrame &frame)
+{
+    // The LZW state lives in the encoder, so every frame gets its own and writes into its own buffer.
+    auto lzwEncoder = std::make_unique<GifEncoder>();
+    lzwEncoder->frameOutput_ = &frame.data;
+    lzwEncoder->InitDictionary();
+    if (lzwEncoder->LZWEncodeFrame(frame.indices.data(), frame.rectWidth, frame.rectHeight)) {
+        IMAGE_LOGE("Failed to encode frame.");
+        return ERR_IMAGE_ENCODE_FAILED;
+    }
+    std::vector<uint8_t>().swap(frame.indices);
     return SUCCESS;
 }
 
@@ -464,6 +928,11 @@ uint32_t GifEncoder::doColorQuantize(uint16_t width, uint16_t height,
         memset_s(outputColorMap, sizeof(ColorType) * COLOR_MAP_SIZE, 0, sizeof(ColorType) * COLOR_MAP_SIZE);
     }
     buildOutputColorMap(colorSubdivMap, colorSubdivMapSize, outputColorMap);
+    if (outputBuffer == nullptr) {
+        // Only the palette is wanted, pixels are mapped by the caller.
+        free(colorCoordinate);
+        return SUCCESS;
+    }
     size_t pixelCount = static_cast<size_t>(width) * height;
     for (size_t i = 0; i < pixelCount; i++) {
         uint32_t index = ((redInput[i] >> (BITS_IN_BYTE - BITS_PER_PRIM_COLOR)) << RED_COORDINATE) +
@@ -741,6 +1210,10 @@ uint32_t GifEncoder::LZWBufferOutput(int character)
 
 bool GifEncoder::Write(const uint8_t* data, size_t data_size)
 {
+    if (frameOutput_ != nullptr) {
+        frameOutput_->insert(frameOutput_->end(), data, data + data_size);
+        return true;
+    }
     return outputStream_->Write(data, data_size);
 }
 
@@ -43,6 +43,12 @@ private:
     uint32_t SetCommonConfig();
     void SetYuv420spExtraConfig();
     uint32_t SequenceEncoder(const uint8_t *data);
+    uint32_t PackIccProfile(j_compress_ptr cinfo);
+    bool CanEncodeInBands(uint32_t &bandRows, uint32_t &restartInterval);
+    uint32_t BandEncoder(const uint8_t *data, uint32_t bandRows, uint32_t restartInterval);
+    uint32_t EncodeBand(const uint8_t *data, uint32_t firstRow, uint32_t rows, bool packIcc,
+                        std::vector<uint8_t> &output);
+    uint32_t WriteBands(std::vector<std::vector<uint8_t>> &bands, uint32_t restartInterval);
     uint32_t Yuv420spEncoder(const uint8_t *data);
     uint32_t RGBAF16Encoder(const uint8_t *data);
     uint32_t RGB565Encoder(const uint8_t *data);
@@ -52,6 +58,8 @@ private:
     std::vector<Media::PixelMap *> pixelMaps_;
     PlEncodeOptions encodeOpts_;
     ICCProfileInfo iccProfileInfo_;
+    // cleared to force a single pass encode regardless of the image size
+    bool bandEncodeEnabled_ = true;
 };
 } // namespace ImagePlugin
 } // namespace OHOS
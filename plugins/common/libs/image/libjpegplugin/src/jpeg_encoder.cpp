@@ -14,10 +14,12 @@
  */
 
 #include "jpeg_encoder.h"
+#include <algorithm>
 #ifdef IMAGE_COLORSPACE_FLAG
 #include "color_space.h"
 #endif
 #include "image_log.h"
+#include "image_task_scheduler.h"
 #include "image_trace.h"
 #include "include/core/SkColorSpace.h"
 #include "include/core/SkImageInfo.h"
@@ -59,6 +61,68 @@ constexpr uint8_t INDEX_ZERO = 0;
 constexpr uint8_t INDEX_ONE = 1;
 constexpr uint8_t INDEX_TWO = 2;
 constexpr uint8_t SHIFT_MASK = 1;
+// band encoding
+constexpr uint64_t BAND_ENCODE_MIN_PIXELS = 2048 * 2048;
+constexpr uint32_t BANDS_PER_WORKER = 2;
+constexpr uint32_t MAX_RESTART_INTERVAL = 0xFFFF;
+constexpr uint8_t MARKER_PREFIX = 0xFF;
+constexpr uint8_t MARKER_SOF0 = 0xC0;
+constexpr uint8_t MARKER_SOF1 = 0xC1;
+constexpr uint8_t MARKER_RST0 = 0xD0;
+constexpr uint8_t MARKER_EOI = 0xD9;
+constexpr uint8_t MARKER_SOS = 0xDA;
+constexpr uint8_t MARKER_DRI = 0xDD;
+constexpr uint32_t RST_MARKER_COUNT = 8;
+constexpr uint32_t MARKER_SIZE = 2;
+constexpr uint32_t SEGMENT_HEADER_SIZE = 4;
+constexpr uint32_t SOF_HEIGHT_OFFSET = 5;
+constexpr uint32_t DRI_SEGMENT_LENGTH = 4;
+constexpr uint32_t BYTE_SHIFT = 8;
+constexpr uint32_t BYTE_MASK = 0xFF;
+
+namespace {
+// Collects the bitstream of one band in memory.
+class BandOutputStream : public OutputDataStream {
+public:
+    explicit BandOutputStream(std::vector<uint8_t> &data) : data_(data) {}
+    ~BandOutputStream() override = default;
+
+    bool Write(const uint8_t *buffer, uint32_t size) override
+    {
+        data_.insert(data_.end(), buffer, buffer + size);
+        return true;
+    }
+
+private:
+    std::vector<uint8_t> &data_;
+};
+
+// Finds the SOS segment of a single scan stream and, when height is not zero, rewrites the SOF height.
+bool LocateScan(std::vector<uint8_t> &stream, uint32_t height, size_t &sosOffset, size_t &scanOffset)
+{
+    size_t size = stream.size();
+    if (size < MARKER_SIZE * 2 || stream[size - MARKER_SIZE] != MARKER_PREFIX || stream[size - 1] != MARKER_EOI) {
+        return false;
+    }
+    size_t pos = MARKER_SIZE;
+    while (pos + SEGMENT_HEADER_SIZE <= size && stream[pos] == MARKER_PREFIX) {
+        uint8_t marker = stream[pos + 1];
+        size_t length = (static_cast<size_t>(stream[pos + MARKER_SIZE]) << BYTE_SHIFT) | stream[pos + MARKER_SIZE + 1];
+        if ((marker == MARKER_SOF0 || marker == MARKER_SOF1) && height != 0 &&
+            pos + SOF_HEIGHT_OFFSET + 1 < size) {
+            stream[pos + SOF_HEIGHT_OFFSET] = static_cast<uint8_t>(height >> BYTE_SHIFT);
+            stream[pos + SOF_HEIGHT_OFFSET + 1] = static_cast<uint8_t>(height & BYTE_MASK);
+        }
+        if (marker == MARKER_SOS) {
+            sosOffset = pos;
+            scanOffset = pos + MARKER_SIZE + length;
+            return scanOffset <= size - MARKER_SIZE;
+        }
+        pos += MARKER_SIZE + length;
+    }
+    return false;
+}
+} // namespace
 
 JpegDstMgr::JpegDstMgr(OutputDataStream *stream) : outputStream(stream)
 {
@@ -211,14 +275,8 @@ uint32_t JpegEncoder::SetCommonConfig()
     return SUCCESS;
 }
 
-uint32_t JpegEncoder::SequenceEncoder(const uint8_t *data)
+uint32_t JpegEncoder::PackIccProfile(j_compress_ptr cinfo)
 {
-    if (setjmp(jerr_.setjmp_buffer)) {
-        IMAGE_LOGE("encode image error.");
-        return ERR_IMAGE_ENCODE_FAILED;
-    }
-    jpeg_start_compress(&encodeInfo_, TRUE);
-
 #ifdef IMAGE_COLORSPACE_FLAG
     // packing icc profile.
     SkImageInfo skImageInfo;
@@ -232,11 +290,30 @@ uint32_t JpegEncoder::SequenceEncoder(const uint8_t *data)
         SkColorType ct = SkColorType::kUnknown_SkColorType;
         SkAlphaType at = SkAlphaType::kUnknown_SkAlphaType;
         skImageInfo = SkImageInfo::Make(width, height, ct, at, skColorSpace);
-        uint32_t iccPackedresult = iccProfileInfo_.PackingICCProfile(&encodeInfo_, skImageInfo);
+        uint32_t iccPackedresult = iccProfileInfo_.PackingICCProfile(cinfo, skImageInfo);
         CHECK_ERROR_RETURN_RET_LOG(iccPackedresult == OHOS::Media::ERR_IMAGE_ENCODE_ICC_FAILED, iccPackedresult,
             "encode image icc error.");
     }
 #endif
+    return SUCCESS;
+}
+
+uint32_t JpegEncoder::SequenceEncoder(const uint8_t *data)
+{
+    uint32_t bandRows = 0;
+    uint32_t restartInterval = 0;
+    if (CanEncodeInBands(bandRows, restartInterval)) {
+        return BandEncoder(data, bandRows, restartInterval);
+    }
+    if (setjmp(jerr_.setjmp_buffer)) {
+        IMAGE_LOGE("encode image error.");
+        return ERR_IMAGE_ENCODE_FAILED;
+    }
+    jpeg_start_compress(&encodeInfo_, TRUE);
+    uint32_t iccPackedresult = PackIccProfile(&encodeInfo_);
+    if (iccPackedresult != SUCCESS) {
+        return iccPackedresult;
+    }
 
     uint8_t *base = const_cast<uint8_t *>(data);
     uint32_t rowStride = encodeInfo_.image_width * static_cast<uint32_t>(encodeInfo_.input_components);
@@ -249,6 +326,136 @@ uint32_t JpegEncoder::SequenceEncoder(const uint8_t *data)
     return SUCCESS;
 }
 
+// Large images are cut into bands of whole MCU rows. Every band is one restart interval, so the bands can be
+// entropy coded independently and the stitched stream decodes exactly like a sequential one with DRI set.
+bool JpegEncoder::CanEncodeInBands(uint32_t &bandRows, uint32_t &restartInterval)
+{
+    uint32_t width = encodeInfo_.image_width;
+    uint32_t height = encodeInfo_.image_height;
+    int32_t workers = ImageTaskScheduler::GetWorkerCount();
+    if (!bandEncodeEnabled_ || static_cast<uint64_t>(width) * height < BAND_ENCODE_MIN_PIXELS || workers <= 1 ||
+        height > JPEG_MAX_DIMENSION) {
+        return false;
+    }
+    int maxHSampFactor = 1;
+    int maxVSampFactor = 1;
+    if (encodeInfo_.num_components > 1) {
+        for (int i = 0; i < encodeInfo_.num_components; i++) {
+            maxHSampFactor = std::max(maxHSampFactor, encodeInfo_.comp_info[i].h_samp_factor);
+            maxVSampFactor = std::max(maxVSampFactor, encodeInfo_.comp_info[i].v_samp_factor);
+        }
+    }
+    uint32_t mcuWidth = static_cast<uint32_t>(DCTSIZE * maxHSampFactor);
+    uint32_t mcuHeight = static_cast<uint32_t>(DCTSIZE * maxVSampFactor);
+    uint32_t mcusPerRow = (width + mcuWidth - 1) / mcuWidth;
+    uint32_t mcuRows = (height + mcuHeight - 1) / mcuHeight;
+    uint32_t bandCount = static_cast<uint32_t>(workers) * BANDS_PER_WORKER;
+    uint32_t bandMcuRows = std::min((mcuRows + bandCount - 1) / bandCount, MAX_RESTART_INTERVAL / mcusPerRow);
+    if (bandMcuRows == 0 || bandMcuRows >= mcuRows) {
+        return false;
+    }
+    bandRows = bandMcuRows * mcuHeight;
+    restartInterval = bandMcuRows * mcusPerRow;
+    return true;
+}
+
+uint32_t JpegEncoder::BandEncoder(const uint8_t *data, uint32_t bandRows, uint32_t restartInterval)
+{
+    ImageTrace imageTrace("JpegEncoder::BandEncoder");
+    uint32_t height = encodeInfo_.image_height;
+    uint32_t bandCount = (height + bandRows - 1) / bandRows;
+    std::vector<std::vector<uint8_t>> bands(bandCount);
+    std::vector<uint32_t> results(bandCount, ERR_IMAGE_ENCODE_FAILED);
+    int64_t costPerBand = static_cast<int64_t>(encodeInfo_.image_width) * bandRows;
+    ImageTaskScheduler::ParallelForRows(static_cast<int32_t>(bandCount), costPerBand,
+        [this, data, bandRows, height, &bands, &results](int32_t start, int32_t end) {
+            for (int32_t i = start; i < end; i++) {
+                uint32_t firstRow = static_cast<uint32_t>(i) * bandRows;
+                uint32_t rows = std::min(bandRows, height - firstRow);
+                results[i] = EncodeBand(data, firstRow, rows, i == 0, bands[i]);
+            }
+        });
+    for (uint32_t i = 0; i < bandCount; i++) {
+        CHECK_ERROR_RETURN_RET_LOG(results[i] != SUCCESS, results[i], "encode band %{public}u failed.", i);
+    }
+    return WriteBands(bands, restartInterval);
+}
+
+uint32_t JpegEncoder::EncodeBand(const uint8_t *data, uint32_t firstRow, uint32_t rows, bool packIcc,
+                                 std::vector<uint8_t> &output)
+{
+    BandOutputStream stream(output);
+    JpegDstMgr dstMgr(&stream);
+    ErrorMgr jerr;
+    jpeg_compress_struct bandInfo;
+    bandInfo.err = jpeg_std_error(&jerr);
+    jerr.error_exit = ErrorExit;
+    jerr.output_message = &OutputErrorMessage;
+    jpeg_create_compress(&bandInfo);
+    if (setjmp(jerr.setjmp_buffer)) {
+        jpeg_destroy_compress(&bandInfo);
+        IMAGE_LOGE("encode band error.");
+        return ERR_IMAGE_ENCODE_FAILED;
+    }
+    bandInfo.dest = &dstMgr;
+    bandInfo.image_width = encodeInfo_.image_width;
+    bandInfo.image_height = rows;
+    bandInfo.input_components = encodeInfo_.input_components;
+    bandInfo.in_color_space = encodeInfo_.in_color_space;
+    jpeg_set_defaults(&bandInfo);
+    jpeg_set_quality(&bandInfo, encodeOpts_.quality, TRUE);
+    jpeg_start_compress(&bandInfo, TRUE);
+    uint32_t errorCode = packIcc ? PackIccProfile(&bandInfo) : SUCCESS;
+    if (errorCode != SUCCESS) {
+        jpeg_destroy_compress(&bandInfo);
+        return errorCode;
+    }
+    uint8_t *base = const_cast<uint8_t *>(data);
+    uint32_t rowStride = encodeInfo_.image_width * static_cast<uint32_t>(encodeInfo_.input_components);
+    uint8_t *buffer = nullptr;
+    while (bandInfo.next_scanline < rows) {
+        buffer = base + static_cast<size_t>(firstRow + bandInfo.next_scanline) * rowStride;
+        jpeg_write_scanlines(&bandInfo, &buffer, RW_LINE_NUM);
+    }
+    jpeg_finish_compress(&bandInfo);
+    jpeg_destroy_compress(&bandInfo);
+    return SUCCESS;
+}
+
+// The first band supplies the headers, with the full height and a DRI segment added; the entropy coded
+// data of the bands follows, separated by RSTn markers.
+uint32_t JpegEncoder::WriteBands(std::vector<std::vector<uint8_t>> &bands, uint32_t restartInterval)
+{
+    OutputDataStream *outputStream = dstMgr_.outputStream;
+    CHECK_ERROR_RETURN_RET_LOG(outputStream == nullptr, ERR_IMAGE_ENCODE_FAILED, "output stream is null.");
+    std::vector<size_t> scanOffsets(bands.size(), 0);
+    size_t headerSize = 0;
+    for (size_t i = 0; i < bands.size(); i++) {
+        size_t sosOffset = 0;
+        bool located = LocateScan(bands[i], (i == 0) ? encodeInfo_.image_height : 0, sosOffset, scanOffsets[i]);
+        CHECK_ERROR_RETURN_RET_LOG(!located, ERR_IMAGE_ENCODE_FAILED, "band %{public}zu has no scan.", i);
+        if (i == 0) {
+            headerSize = sosOffset;
+        }
+    }
+    const uint8_t dri[] = {
+        MARKER_PREFIX, MARKER_DRI, 0, DRI_SEGMENT_LENGTH,
+        static_cast<uint8_t>(restartInterval >> BYTE_SHIFT), static_cast<uint8_t>(restartInterval & BYTE_MASK),
+    };
+    bool written = outputStream->Write(bands[0].data(), headerSize) && outputStream->Write(dri, sizeof(dri)) &&
+        outputStream->Write(bands[0].data() + headerSize, bands[0].size() - MARKER_SIZE - headerSize);
+    for (size_t i = 1; i < bands.size() && written; i++) {
+        const uint8_t restart[] = { MARKER_PREFIX, static_cast<uint8_t>(MARKER_RST0 + (i - 1) % RST_MARKER_COUNT) };
+        written = outputStream->Write(restart, sizeof(restart)) &&
+            outputStream->Write(bands[i].data() + scanOffsets[i], bands[i].size() - MARKER_SIZE - scanOffsets[i]);
+    }
+    const uint8_t eoi[] = { MARKER_PREFIX, MARKER_EOI };
+    written = written && outputStream->Write(eoi, sizeof(eoi));
+    CHECK_ERROR_RETURN_RET_LOG(!written, ERR_IMAGE_ENCODE_FAILED, "write jpeg bands failed.");
+    outputStream->Flush();
+    return SUCCESS;
+}
+
 void JpegEncoder::SetYuv420spExtraConfig()
 {
     encodeInfo_.raw_data_in = TRUE;
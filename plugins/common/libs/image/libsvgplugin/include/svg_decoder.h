@@ -18,6 +18,7 @@
 #include "abs_image_decoder.h"
 #include "nocopyable.h"
 #include "plugin_class_base.h"
+#include "include/core/SkData.h"
 #include "include/core/SkStream.h"
 #include "include/core/SkSize.h"
 
@@ -50,6 +51,7 @@ private:
     bool AllocBuffer(DecodeContext &context);
     bool BuildStream();
     bool BuildDom();
+    void ReleaseDom();
     uint32_t DoDecodeHeader();
     uint32_t DoSetDecodeOptions(uint32_t index, const PixelDecodeOptions &opts, PlImageInfo &info);
     uint32_t DoGetImageSize(uint32_t index, Size &size);
@@ -73,6 +75,10 @@ private:
     std::unique_ptr<SkMemoryStream> svgStream_;
     sk_sp<SkSVGDOM> svgDom_;
     SkSize svgSize_ {0, 0};
+    // source svgDom_ was parsed from, set when svgDom_ may go back to the shared DOM cache
+    sk_sp<SkData> svgSource_;
+    // fill or stroke colors were written into svgDom_, it no longer matches its source
+    bool svgDomDirty_ {false};
 
     PixelDecodeOptions opts_;
 };
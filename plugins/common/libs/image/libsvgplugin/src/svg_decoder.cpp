@@ -15,7 +15,11 @@
 
 #include "svg_decoder.h"
 
+#include <cstring>
+#include <list>
+#include <mutex>
 #include <sstream>
+#include <string_view>
 #include <thread>
 #include "include/core/SkBitmap.h"
 #include "include/core/SkCanvas.h"
@@ -50,12 +54,87 @@ const std::string SVG_FILL_COLOR_ATTR = "fill";
 const std::string SVG_STROKE_COLOR_ATTR = "stroke";
 static constexpr uint32_t DEFAULT_RESIZE_PERCENTAGE = 100;
 static constexpr float FLOAT_HALF = 0.5f;
+constexpr size_t SVG_DOM_CACHE_MAX_COUNT = 256;
+constexpr size_t SVG_DOM_CACHE_MAX_BYTES = 4 * 1024 * 1024;
+constexpr size_t SVG_DOM_CACHE_SOURCE_MAX = 256 * 1024;
 
 static inline uint32_t Float2UInt32(float val)
 {
     return static_cast<uint32_t>(val + FLOAT_HALF);
 }
 
+/*
+ * Parsed DOMs shared by all decoders, keyed by the source content. A DOM keeps per decode state such as
+ * its container size, so a decoder takes one out exclusively and hands it back once done with it.
+ * The cache is bounded by entry count and by source bytes, which stand in for the DOM's memory.
+ */
+class SvgDomCache {
+public:
+    static SvgDomCache &GetInstance()
+    {
+        static SvgDomCache instance;
+        return instance;
+    }
+
+    static bool IsCacheable(size_t size)
+    {
+        return size > 0 && size <= SVG_DOM_CACHE_SOURCE_MAX;
+    }
+
+    // On a hit source is set to the cached copy of the data, so handing the DOM back needs no copy.
+    sk_sp<SkSVGDOM> Acquire(const void *data, size_t size, sk_sp<SkData> &source, SkSize &svgSize)
+    {
+        CHECK_ERROR_RETURN_RET(data == nullptr || !IsCacheable(size), nullptr);
+        size_t hash = Hash(data, size);
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto iter = entries_.begin(); iter != entries_.end(); ++iter) {
+            bool match = iter->hash == hash && iter->source->size() == size &&
+                memcmp(iter->source->data(), data, size) == 0;
+            if (match) {
+                sk_sp<SkSVGDOM> dom = std::move(iter->dom);
+                source = std::move(iter->source);
+                svgSize = iter->svgSize;
+                sourceBytes_ -= size;
+                entries_.erase(iter);
+                return dom;
+            }
+        }
+        return nullptr;
+    }
+
+    void Release(sk_sp<SkData> source, sk_sp<SkSVGDOM> dom, const SkSize &svgSize)
+    {
+        CHECK_ERROR_RETURN(source == nullptr || dom == nullptr);
+        size_t size = source->size();
+        Entry entry = { Hash(source->data(), size), std::move(source), std::move(dom), svgSize };
+        std::lock_guard<std::mutex> lock(mutex_);
+        entries_.push_front(std::move(entry));
+        sourceBytes_ += size;
+        while (entries_.size() > SVG_DOM_CACHE_MAX_COUNT || sourceBytes_ > SVG_DOM_CACHE_MAX_BYTES) {
+            sourceBytes_ -= entries_.back().source->size();
+            entries_.pop_back();
+        }
+    }
+
+private:
+    struct Entry {
+        size_t hash;
+        sk_sp<SkData> source;
+        sk_sp<SkSVGDOM> dom;
+        SkSize svgSize;
+    };
+
+    static size_t Hash(const void *data, size_t size)
+    {
+        return std::hash<std::string_view>{}(std::string_view(static_cast<const char *>(data), size));
+    }
+
+    std::mutex mutex_;
+    // most recently released first
+    std::list<Entry> entries_;
+    size_t sourceBytes_ = 0;
+};
+
 #if !defined(_WIN32) && !defined(_APPLE) && !defined(ANDROID_PLATFORM) && !defined(IOS_PLATFORM)
 bool AllocShareBufferInner(DecodeContext &context, uint64_t byteCount)
 {
@@ -238,11 +317,7 @@ void SvgDecoder::Reset()
 
     state_ = SvgDecodingState::UNDECIDED;
 
-    if (svgDom_) {
-        svgDom_->setContainerSize(svgSize_);
-    }
-
-    svgDom_ = nullptr;
+    ReleaseDom();
     svgStream_ = nullptr;
     inputStreamPtr_ = nullptr;
 
@@ -270,7 +345,9 @@ uint32_t SvgDecoder::SetDecodeOptions(uint32_t index, const PixelDecodeOptions &
         "[SetDecodeOptions] set decode options failed for state %{public}d.", state_);
 
     if (state_ >= SvgDecodingState::IMAGE_DECODING) {
-        state_ = SvgDecodingState::SOURCE_INITED;
+        // An unmodified DOM renders again at another size without parsing the source again
+        state_ = (svgDom_ != nullptr && !svgDomDirty_) ? SvgDecodingState::BASE_INFO_PARSED :
+            SvgDecodingState::SOURCE_INITED;
     }
 
     if (state_ < SvgDecodingState::BASE_INFO_PARSED) {
@@ -458,11 +535,21 @@ bool SvgDecoder::BuildDom()
     bool cond = (svgStream_ == nullptr);
     CHECK_ERROR_RETURN_RET_LOG(cond, false, "[BuildDom] Stream is null.");
 
-    svgDom_ = SkSVGDOM::MakeFromStream(*(svgStream_.get()));
-    cond = (svgDom_ == nullptr);
-    CHECK_ERROR_RETURN_RET_LOG(cond, false, "[BuildDom] DOM is null.");
-
-    svgSize_ = svgDom_->containerSize();
+    const void *data = svgStream_->getMemoryBase();
+    size_t length = svgStream_->getLength();
+    svgSource_ = nullptr;
+    svgDomDirty_ = false;
+    svgDom_ = SvgDomCache::GetInstance().Acquire(data, length, svgSource_, svgSize_);
+    if (svgDom_ == nullptr) {
+        svgDom_ = SkSVGDOM::MakeFromStream(*(svgStream_.get()));
+        cond = (svgDom_ == nullptr);
+        CHECK_ERROR_RETURN_RET_LOG(cond, false, "[BuildDom] DOM is null.");
+        svgSize_ = svgDom_->containerSize();
+        // The stream may borrow the caller's buffer, the cache needs a copy that outlives it
+        if (data != nullptr && SvgDomCache::IsCacheable(length)) {
+            svgSource_ = SkData::MakeWithCopy(data, length);
+        }
+    }
     cond = svgSize_.isEmpty();
     CHECK_ERROR_RETURN_RET_LOG(cond, false, "[BuildDom] size is empty.");
 
@@ -473,9 +560,23 @@ bool SvgDecoder::BuildDom()
     return true;
 }
 
+void SvgDecoder::ReleaseDom()
+{
+    if (svgDom_ != nullptr) {
+        svgDom_->setContainerSize(svgSize_);
+        if (svgSource_ != nullptr && !svgDomDirty_ && !svgSize_.isEmpty()) {
+            SvgDomCache::GetInstance().Release(std::move(svgSource_), std::move(svgDom_), svgSize_);
+        }
+    }
+    svgDom_ = nullptr;
+    svgSource_ = nullptr;
+    svgDomDirty_ = false;
+}
+
 uint32_t SvgDecoder::DoDecodeHeader()
 {
     IMAGE_LOGD("[DoDecodeHeader] IN");
+    ReleaseDom();
     bool cond = BuildStream();
     CHECK_ERROR_RETURN_RET_LOG(!cond, Media::ERR_IMAGE_TOO_LARGE, "[DoDecodeHeader] Build Stream failed");
 
@@ -521,6 +622,10 @@ uint32_t SvgDecoder::DoSetDecodeOptions(uint32_t index, const PixelDecodeOptions
 
     opts_ = opts;
 
+    // Start from the intrinsic size, the DOM may still carry the size of an earlier decode
+    if (!svgSize_.isEmpty()) {
+        svgDom_->setContainerSize(svgSize_);
+    }
     auto svgSize = svgDom_->containerSize();
     cond = (svgSize.isEmpty());
     CHECK_ERROR_RETURN_RET_LOG(cond, Media::ERROR, "[DoSetDecodeOptions] size is empty.");
@@ -582,10 +687,12 @@ uint32_t SvgDecoder::DoDecode(uint32_t index, DecodeContext &context)
 
     if (opts_.plFillColor.isValidColor) {
         SetSVGColor(svgDom_->getRoot(), opts_.plFillColor.color, SVG_FILL_COLOR_ATTR);
+        svgDomDirty_ = true;
     }
 
     if (opts_.plStrokeColor.isValidColor) {
         SetSVGColor(svgDom_->getRoot(), opts_.plStrokeColor.color, SVG_STROKE_COLOR_ATTR);
+        svgDomDirty_ = true;
     }
 
     cond = AllocBuffer(context);
@@ -51,6 +51,22 @@ public:
 #endif
 
 private:
+    enum class TiffPixelKind {
+        GRAY,
+        GRAY_INVERTED,
+        RGB,
+        RGBA_ASSOCIATED,
+        RGBA_UNASSOCIATED,
+    };
+    // Sample layout of images whose strips or tiles can be converted to RGBA without libtiff's RGBA interface.
+    struct TiffDirectLayout {
+        TiffPixelKind kind = TiffPixelKind::RGB;
+        uint16_t samplesPerPixel = 0;
+        bool tiled = false;
+        uint32_t unitWidth = 0;
+        uint32_t unitHeight = 0;
+    };
+
     static tmsize_t ReadProc(thandle_t handle, void* data, tmsize_t size);
     static tmsize_t WriteProc(thandle_t handle, void* data, tmsize_t size);
     static toff_t SeekProc(thandle_t handle, toff_t off, int whence);
@@ -67,7 +83,16 @@ private:
 
     bool CheckTiffIndex(uint32_t index);
     bool CheckTiffSizeIsOverflow();
+    static void ConvertRow(const TiffDirectLayout &layout, const uint8_t *src, uint8_t *dst, uint32_t count);
+    bool GetDirectLayout(TiffDirectLayout &layout);
+    Rect GetDecodeRegion();
+    bool DecodeDirect(const TiffDirectLayout &layout, uint8_t *pixels, uint64_t rowStride);
+    bool DecodeUnitRows(const TiffDirectLayout &layout, const Rect &region, uint32_t unitRowStart,
+        uint32_t unitRowEnd, uint8_t *pixels, uint64_t rowStride);
+    uint32_t DecodeRGBAImage(DecodeContext &context, size_t bufferSize);
     InputDataStream* inputStream_{nullptr};
+    const uint8_t *sourceData_ = nullptr;
+    size_t sourceSize_ = 0;
     PixelDecodeOptions opts_;
     PlImageInfo info_;
     Size tiffSize_;
@@ -14,6 +14,8 @@
  */
 #include "tiff_decoder.h"
 #include "tiff_utils.h"
+#include <algorithm>
+#include <atomic>
 #include <cstring>
 #include <sstream>
 #include <thread>
@@ -22,6 +24,7 @@
 #include "surface_buffer.h"
 #include "color_utils.h"
 #include "image_log.h"
+#include "image_task_scheduler.h"
 #include "image_trace.h"
 #include "image_utils.h"
 #include "include/core/SkImage.h"
@@ -37,6 +40,72 @@ constexpr tmsize_t TIFF_MAX_SINGLE_MEMORY_ALLOCATION =
     static_cast<tmsize_t>(1024) * 1024 * 1024;
 constexpr tmsize_t TIFF_MAX_CUMULATED_MEMORY_ALLOCATION =
     static_cast<tmsize_t>(2) * 1024 * 1024 * 1024;
+constexpr uint32_t RGBA_BYTES = 4;
+constexpr uint16_t DIRECT_BITS_PER_SAMPLE = 8;
+constexpr uint16_t GRAY_SAMPLES = 1;
+constexpr uint16_t RGB_SAMPLES = 3;
+constexpr uint16_t RGBA_SAMPLES = 4;
+constexpr uint8_t ALPHA_OPAQUE = 255;
+constexpr uint32_t PREMUL_ROUNDING = 127;
+constexpr uint32_t R_INDEX = 0;
+constexpr uint32_t G_INDEX = 1;
+constexpr uint32_t B_INDEX = 2;
+constexpr uint32_t A_INDEX = 3;
+
+// Read-only view of the encoded file, each decoding worker opens its own TIFF handle on one.
+struct TiffMemorySource {
+    const uint8_t *data = nullptr;
+    toff_t size = 0;
+    toff_t offset = 0;
+};
+
+tmsize_t MemoryReadProc(thandle_t handle, void* data, tmsize_t size)
+{
+    TiffMemorySource *source = static_cast<TiffMemorySource *>(handle);
+    bool cond = source == nullptr || data == nullptr || size <= 0 || source->offset >= source->size;
+    CHECK_ERROR_RETURN_RET(cond, 0);
+    toff_t count = std::min(static_cast<toff_t>(size), source->size - source->offset);
+    CHECK_ERROR_RETURN_RET(memcpy_s(data, size, source->data + source->offset, count) != EOK, 0);
+    source->offset += count;
+    return static_cast<tmsize_t>(count);
+}
+
+toff_t MemorySeekProc(thandle_t handle, toff_t off, int whence)
+{
+    TiffMemorySource *source = static_cast<TiffMemorySource *>(handle);
+    CHECK_ERROR_RETURN_RET(source == nullptr, static_cast<toff_t>(-1));
+    toff_t base = 0;
+    if (whence == SEEK_CUR) {
+        base = source->offset;
+    } else if (whence == SEEK_END) {
+        base = source->size;
+    } else if (whence != SEEK_SET) {
+        return static_cast<toff_t>(-1);
+    }
+    // Negative offsets arrive wrapped around, unsigned addition restores them.
+    toff_t position = base + off;
+    CHECK_ERROR_RETURN_RET(position > source->size, static_cast<toff_t>(-1));
+    source->offset = position;
+    return position;
+}
+
+toff_t MemorySizeProc(thandle_t handle)
+{
+    TiffMemorySource *source = static_cast<TiffMemorySource *>(handle);
+    return source != nullptr ? source->size : 0;
+}
+
+TIFF *OpenMemoryCodec(TiffMemorySource &source, TIFFReadWriteProc writeProc, TIFFCloseProc closeProc)
+{
+    TIFFOpenOptions* options = TIFFOpenOptionsAlloc();
+    CHECK_ERROR_RETURN_RET_LOG(options == nullptr, nullptr, "TIFFOpenOptionsAlloc failed");
+    TIFFOpenOptionsSetMaxSingleMemAlloc(options, TIFF_MAX_SINGLE_MEMORY_ALLOCATION);
+    TIFFOpenOptionsSetMaxCumulatedMemAlloc(options, TIFF_MAX_CUMULATED_MEMORY_ALLOCATION);
+    TIFF *codec = TIFFClientOpenExt("mem", "r", static_cast<thandle_t>(&source), MemoryReadProc, writeProc,
+        MemorySeekProc, closeProc, MemorySizeProc, nullptr, nullptr, options);
+    TIFFOpenOptionsFree(options);
+    return codec;
+}
 }
 
 TiffDecoder::TiffDecoder()
@@ -119,6 +188,8 @@ void TiffDecoder::SetSource(InputDataStream& sourceStream)
     size_t len = inputStream_->GetStreamSize();
     bool cond = !buf || len == 0;
     CHECK_ERROR_RETURN(cond);
+    sourceData_ = buf;
+    sourceSize_ = len;
 
     TIFFOpenOptions* options = TIFFOpenOptionsAlloc();
     CHECK_ERROR_RETURN_LOG(options == nullptr, "TIFFOpenOptionsAlloc failed");
@@ -132,6 +203,8 @@ void TiffDecoder::SetSource(InputDataStream& sourceStream)
 void TiffDecoder::Reset()
 {
     inputStream_ = nullptr;
+    sourceData_ = nullptr;
+    sourceSize_ = 0;
     opts_ = PixelDecodeOptions();
     tiffSize_ = {0, 0};
     if (tifCodec_ != nullptr) {
@@ -210,6 +283,27 @@ uint32_t TiffDecoder::Decode(uint32_t index, DecodeContext& context)
         IMAGE_LOGE("AllocBuffer failed or buffer is too small");
         return ERR_IMAGE_MALLOC_ABNORMAL;
     }
+    uint8_t* pixels = static_cast<uint8_t*>(context.pixelsBuffer.buffer);
+    CHECK_ERROR_RETURN_RET_LOG(pixels == nullptr, ERR_IMAGE_MALLOC_ABNORMAL, "AllocBuffer failed");
+    uint64_t rowStride = static_cast<uint64_t>(tiffSize_.width) * RGBA_BYTES;
+    if (context.allocatorType == AllocatorType::DMA_ALLOC && static_cast<uint64_t>(dmaStride_) > rowStride) {
+        rowStride = static_cast<uint64_t>(dmaStride_);
+    }
+
+    TiffDirectLayout layout;
+    if (!GetDirectLayout(layout) || !DecodeDirect(layout, pixels, rowStride)) {
+        uint32_t ret = DecodeRGBAImage(context, bufferSize);
+        CHECK_ERROR_RETURN_RET(ret != SUCCESS, ret);
+    }
+
+#ifdef IMAGE_COLORSPACE_FLAG
+        ParseICCProfile();
+#endif
+    return SUCCESS;
+}
+
+uint32_t TiffDecoder::DecodeRGBAImage(DecodeContext &context, size_t bufferSize)
+{
     uint32_t* raster = static_cast<uint32_t*>(context.pixelsBuffer.buffer);
     std::unique_ptr<uint32_t[]> dmaTmpBuffer;
     if (context.allocatorType == AllocatorType::DMA_ALLOC && dmaStride_ > tiffSize_.width) {
@@ -217,7 +311,8 @@ uint32_t TiffDecoder::Decode(uint32_t index, DecodeContext& context)
         raster = dmaTmpBuffer.get();
     }
     CHECK_ERROR_RETURN_RET_LOG(raster == nullptr, ERR_IMAGE_MALLOC_ABNORMAL, "AllocBuffer failed");
-    cond = !TIFFReadRGBAImageOriented(tifCodec_, tiffSize_.width, tiffSize_.height, raster, ORIENTATION_TOPLEFT, 0);
+    bool cond = !TIFFReadRGBAImageOriented(tifCodec_, tiffSize_.width, tiffSize_.height, raster,
+        ORIENTATION_TOPLEFT, 0);
     CHECK_ERROR_RETURN_RET_LOG(cond, ERR_IMAGE_DECODE_FAILED, "[TiffDecoder] TIFFReadRGBAImageOriented decode failed");
     if (context.allocatorType == AllocatorType::DMA_ALLOC && dmaStride_ > tiffSize_.width) {
         for (int32_t row = 0; row < tiffSize_.height; row++) {
@@ -228,13 +323,179 @@ uint32_t TiffDecoder::Decode(uint32_t index, DecodeContext& context)
             CHECK_ERROR_RETURN_RET_LOG(err != EOK, ERR_IMAGE_DECODE_FAILED, "memcpy is failed");
         }
     }
-
-#ifdef IMAGE_COLORSPACE_FLAG
-        ParseICCProfile();
-#endif
     return SUCCESS;
 }
 
+bool TiffDecoder::GetDirectLayout(TiffDirectLayout &layout)
+{
+    uint16_t bitsPerSample = 0;
+    uint16_t samplesPerPixel = 0;
+    uint16_t photometric = 0;
+    uint16_t planarConfig = 0;
+    uint16_t orientation = 0;
+    uint16_t sampleFormat = 0;
+    bool cond = !TIFFGetFieldDefaulted(tifCodec_, TIFFTAG_BITSPERSAMPLE, &bitsPerSample) ||
+        !TIFFGetFieldDefaulted(tifCodec_, TIFFTAG_SAMPLESPERPIXEL, &samplesPerPixel) ||
+        !TIFFGetField(tifCodec_, TIFFTAG_PHOTOMETRIC, &photometric) ||
+        !TIFFGetFieldDefaulted(tifCodec_, TIFFTAG_PLANARCONFIG, &planarConfig) ||
+        !TIFFGetFieldDefaulted(tifCodec_, TIFFTAG_ORIENTATION, &orientation) ||
+        !TIFFGetFieldDefaulted(tifCodec_, TIFFTAG_SAMPLEFORMAT, &sampleFormat);
+    CHECK_ERROR_RETURN_RET(cond, false);
+    cond = bitsPerSample != DIRECT_BITS_PER_SAMPLE || planarConfig != PLANARCONFIG_CONTIG ||
+        orientation != ORIENTATION_TOPLEFT || sampleFormat != SAMPLEFORMAT_UINT;
+    CHECK_ERROR_RETURN_RET(cond, false);
+
+    uint16_t extraCount = 0;
+    uint16_t *extraInfo = nullptr;
+    TIFFGetFieldDefaulted(tifCodec_, TIFFTAG_EXTRASAMPLES, &extraCount, &extraInfo);
+    if ((photometric == PHOTOMETRIC_MINISBLACK || photometric == PHOTOMETRIC_MINISWHITE) &&
+        samplesPerPixel == GRAY_SAMPLES) {
+        layout.kind = photometric == PHOTOMETRIC_MINISBLACK ? TiffPixelKind::GRAY : TiffPixelKind::GRAY_INVERTED;
+    } else if (photometric == PHOTOMETRIC_RGB && samplesPerPixel == RGB_SAMPLES) {
+        layout.kind = TiffPixelKind::RGB;
+    } else if (photometric == PHOTOMETRIC_RGB && samplesPerPixel == RGBA_SAMPLES && extraCount == 1 &&
+        extraInfo != nullptr) {
+        layout.kind = extraInfo[0] == EXTRASAMPLE_UNASSALPHA ? TiffPixelKind::RGBA_UNASSOCIATED :
+            TiffPixelKind::RGBA_ASSOCIATED;
+    } else {
+        return false;
+    }
+    layout.samplesPerPixel = samplesPerPixel;
+    layout.tiled = TIFFIsTiled(tifCodec_);
+    if (layout.tiled) {
+        cond = !TIFFGetField(tifCodec_, TIFFTAG_TILEWIDTH, &layout.unitWidth) ||
+            !TIFFGetField(tifCodec_, TIFFTAG_TILELENGTH, &layout.unitHeight);
+        CHECK_ERROR_RETURN_RET(cond, false);
+    } else {
+        uint32_t rowsPerStrip = 0;
+        CHECK_ERROR_RETURN_RET(!TIFFGetFieldDefaulted(tifCodec_, TIFFTAG_ROWSPERSTRIP, &rowsPerStrip), false);
+        layout.unitWidth = static_cast<uint32_t>(tiffSize_.width);
+        layout.unitHeight = std::min(rowsPerStrip, static_cast<uint32_t>(tiffSize_.height));
+    }
+    return layout.unitWidth > 0 && layout.unitHeight > 0;
+}
+
+void TiffDecoder::ConvertRow(const TiffDirectLayout &layout, const uint8_t *src, uint8_t *dst, uint32_t count)
+{
+    const uint16_t samples = layout.samplesPerPixel;
+    for (uint32_t i = 0; i < count; i++, src += samples, dst += RGBA_BYTES) {
+        switch (layout.kind) {
+            case TiffPixelKind::GRAY:
+            case TiffPixelKind::GRAY_INVERTED: {
+                uint8_t gray = layout.kind == TiffPixelKind::GRAY ? src[0] :
+                    static_cast<uint8_t>(ALPHA_OPAQUE - src[0]);
+                dst[R_INDEX] = gray;
+                dst[G_INDEX] = gray;
+                dst[B_INDEX] = gray;
+                dst[A_INDEX] = ALPHA_OPAQUE;
+                break;
+            }
+            case TiffPixelKind::RGB:
+                dst[R_INDEX] = src[R_INDEX];
+                dst[G_INDEX] = src[G_INDEX];
+                dst[B_INDEX] = src[B_INDEX];
+                dst[A_INDEX] = ALPHA_OPAQUE;
+                break;
+            case TiffPixelKind::RGBA_ASSOCIATED:
+                dst[R_INDEX] = src[R_INDEX];
+                dst[G_INDEX] = src[G_INDEX];
+                dst[B_INDEX] = src[B_INDEX];
+                dst[A_INDEX] = src[A_INDEX];
+                break;
+            case TiffPixelKind::RGBA_UNASSOCIATED: {
+                uint32_t alpha = src[A_INDEX];
+                dst[R_INDEX] = static_cast<uint8_t>((src[R_INDEX] * alpha + PREMUL_ROUNDING) / ALPHA_OPAQUE);
+                dst[G_INDEX] = static_cast<uint8_t>((src[G_INDEX] * alpha + PREMUL_ROUNDING) / ALPHA_OPAQUE);
+                dst[B_INDEX] = static_cast<uint8_t>((src[B_INDEX] * alpha + PREMUL_ROUNDING) / ALPHA_OPAQUE);
+                dst[A_INDEX] = static_cast<uint8_t>(alpha);
+                break;
+            }
+        }
+    }
+}
+
+Rect TiffDecoder::GetDecodeRegion()
+{
+    Rect region = {0, 0, tiffSize_.width, tiffSize_.height};
+    // With the default strategy the post processing keeps only the crop, so units outside it are not decoded.
+    const Rect &crop = opts_.CropRect;
+    bool cond = opts_.cropAndScaleStrategy != CropAndScaleStrategy::DEFAULT || crop.left < 0 || crop.top < 0 ||
+        crop.width <= 0 || crop.height <= 0 || crop.left >= tiffSize_.width || crop.top >= tiffSize_.height;
+    CHECK_ERROR_RETURN_RET(cond, region);
+    region.left = crop.left;
+    region.top = crop.top;
+    region.width = static_cast<int32_t>(std::min<int64_t>(static_cast<int64_t>(crop.left) + crop.width,
+        tiffSize_.width) - crop.left);
+    region.height = static_cast<int32_t>(std::min<int64_t>(static_cast<int64_t>(crop.top) + crop.height,
+        tiffSize_.height) - crop.top);
+    return region;
+}
+
+bool TiffDecoder::DecodeUnitRows(const TiffDirectLayout &layout, const Rect &region, uint32_t unitRowStart,
+    uint32_t unitRowEnd, uint8_t *pixels, uint64_t rowStride)
+{
+    TiffMemorySource source = { sourceData_, static_cast<toff_t>(sourceSize_), 0 };
+    TIFF *codec = OpenMemoryCodec(source, WriteProc, CloseProc);
+    CHECK_ERROR_RETURN_RET_LOG(codec == nullptr, false, "[TiffDecoder] open worker codec failed");
+    tmsize_t unitSize = layout.tiled ? TIFFTileSize(codec) : TIFFStripSize(codec);
+    tmsize_t unitRowBytes = layout.tiled ? TIFFTileRowSize(codec) : TIFFScanlineSize(codec);
+    std::unique_ptr<uint8_t[]> unit = unitSize > 0 ? std::make_unique<uint8_t[]>(unitSize) : nullptr;
+    bool success = unit != nullptr && unitRowBytes >= static_cast<tmsize_t>(layout.unitWidth) * layout.samplesPerPixel;
+    const uint32_t regionRight = static_cast<uint32_t>(region.left + region.width);
+    const uint32_t regionBottom = static_cast<uint32_t>(region.top + region.height);
+    const uint32_t columnStart = layout.tiled ? static_cast<uint32_t>(region.left) / layout.unitWidth : 0;
+    for (uint32_t unitRow = unitRowStart; success && unitRow < unitRowEnd; unitRow++) {
+        uint32_t y0 = unitRow * layout.unitHeight;
+        uint32_t rowFirst = std::max(y0, static_cast<uint32_t>(region.top));
+        uint32_t rowEnd = std::min(y0 + layout.unitHeight, regionBottom);
+        for (uint32_t x0 = columnStart * layout.unitWidth; success && x0 < regionRight; x0 += layout.unitWidth) {
+            tmsize_t read = layout.tiled ?
+                TIFFReadEncodedTile(codec, TIFFComputeTile(codec, x0, y0, 0, 0), unit.get(), unitSize) :
+                TIFFReadEncodedStrip(codec, unitRow, unit.get(), unitSize);
+            if (read < static_cast<tmsize_t>(rowEnd - y0) * unitRowBytes) {
+                IMAGE_LOGE("[TiffDecoder] read unit at (%{public}u, %{public}u) failed", x0, y0);
+                success = false;
+                break;
+            }
+            uint32_t columnFirst = std::max(x0, static_cast<uint32_t>(region.left));
+            uint32_t columnEnd = std::min(x0 + layout.unitWidth, regionRight);
+            for (uint32_t row = rowFirst; row < rowEnd; row++) {
+                const uint8_t *src = unit.get() + static_cast<uint64_t>(row - y0) * unitRowBytes +
+                    static_cast<uint64_t>(columnFirst - x0) * layout.samplesPerPixel;
+                uint8_t *dst = pixels + row * rowStride + static_cast<uint64_t>(columnFirst) * RGBA_BYTES;
+                ConvertRow(layout, src, dst, columnEnd - columnFirst);
+            }
+        }
+    }
+    TIFFClose(codec);
+    return success;
+}
+
+bool TiffDecoder::DecodeDirect(const TiffDirectLayout &layout, uint8_t *pixels, uint64_t rowStride)
+{
+    CHECK_ERROR_RETURN_RET(sourceData_ == nullptr || sourceSize_ == 0, false);
+    Rect region = GetDecodeRegion();
+    uint32_t unitRowStart = static_cast<uint32_t>(region.top) / layout.unitHeight;
+    uint32_t unitRowEnd = (static_cast<uint32_t>(region.top + region.height) + layout.unitHeight - 1) /
+        layout.unitHeight;
+    ImageTrace imageTrace("TiffDecoder::DecodeDirect, region:(%d, %d, %d, %d)", region.left, region.top,
+        region.width, region.height);
+    // Strips, or rows of tiles, are independent; each band of them is decoded by its own TIFF handle.
+    std::atomic<bool> failed(false);
+    int64_t costPerUnitRow = static_cast<int64_t>(region.width) * layout.unitHeight;
+    bool finished = ImageTaskScheduler::ParallelForRows(static_cast<int32_t>(unitRowEnd - unitRowStart),
+        costPerUnitRow, [&](int32_t start, int32_t end) {
+            if (!DecodeUnitRows(layout, region, unitRowStart + start, unitRowStart + end, pixels, rowStride)) {
+                failed.store(true, std::memory_order_relaxed);
+            }
+        }, &failed);
+    if (!finished || failed.load()) {
+        IMAGE_LOGI("[TiffDecoder] direct decode failed, fall back to RGBA decoding");
+        return false;
+    }
+    return true;
+}
+
 uint32_t TiffDecoder::PromoteIncrementalDecode(uint32_t index, ProgDecodeContext& progContext)
 {
     return SUCCESS;
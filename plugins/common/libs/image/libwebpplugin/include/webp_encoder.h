@@ -18,6 +18,7 @@
 #include "abs_image_encoder.h"
 #include "plugin_class_base.h"
 #include "webp/encode.h"
+#include "webp/mux.h"
 #ifdef USE_M133_SKIA
 #include "src/encode/SkImageEncoderFns.h"
 #else
@@ -43,6 +44,13 @@ private:
     uint32_t DoEncode(Media::PixelMap &pixelMap, WebPConfig &webpConfig, WebPPicture &webpPicture);
     uint32_t DoEncodeForICC(Media::PixelMap &pixelMap);
     bool DoTransform(Media::PixelMap &pixelMap, char* dst, int componentsNum);
+    uint32_t ImportPixels(Media::PixelMap &pixelMap, WebPPicture &webpPicture);
+    uint32_t DoEncodeAnimation();
+    uint32_t AddAnimationFrame(size_t index, WebPMux *mux, std::vector<uint32_t> &canvas,
+        WebPMuxFrameInfo &pendingInfo, WebPMemoryWriter &pendingData);
+    uint32_t AssembleAnimation(WebPMux *mux, int width, int height);
+    int GetFrameDuration(size_t index) const;
+    WebPMuxAnimDispose GetFrameDispose(size_t index) const;
 
 private:
     Media::ColorSpace GetColorSpace(Media::PixelMap &pixelMap);
@@ -16,7 +16,6 @@
 #include "plugin_export.h"
 #include "image_log.h"
 #include "plugin_utils.h"
-#include "webp_decoder.h"
 #include "webp_encoder.h"
 
 #undef LOG_DOMAIN
@@ -32,7 +31,6 @@ namespace {
 
 // register implement classes of this plugin.
 PLUGIN_EXPORT_REGISTER_CLASS_BEGIN
-PLUGIN_EXPORT_REGISTER_CLASS(OHOS::ImagePlugin::WebpDecoder)
 PLUGIN_EXPORT_REGISTER_CLASS(OHOS::ImagePlugin::WebpEncoder)
 PLUGIN_EXPORT_REGISTER_CLASS_END
 
@@ -13,7 +13,8 @@
  * limitations under the License.
  */
 #include "webp_encoder.h"
-#include "webp/mux.h"
+#include <algorithm>
+#include <cstring>
 #include "image_log.h"
 #include "image_trace.h"
 #include "media_errors.h"
@@ -30,9 +31,88 @@ namespace ImagePlugin {
 using namespace MultimediaPlugin;
 using namespace Media;
 namespace {
-constexpr uint32_t WEBP_IMAGE_NUM = 1;
 constexpr uint32_t COMPONENT_NUM_3 = 3;
 constexpr uint32_t COMPONENT_NUM_4 = 4;
+// Delay times share the GIF unit of 10 ms.
+constexpr int DELAY_TIME_UNIT_MS = 10;
+constexpr int DEFAULT_DELAY_TIME = 100;
+constexpr int MAX_FRAME_DURATION = 0xFFFFFF;
+constexpr uint8_t DISPOSAL_TYPE_BACKGROUND = 2;
+constexpr uint32_t TRANSPARENT_PIXEL = 0;
+
+using WebpImportProc = int (*)(WebPPicture*, const uint8_t*, int);
+
+struct FrameRect {
+    int x = 0;
+    int y = 0;
+    int width = 1;
+    int height = 1;
+};
+
+// Bounding box of the pixels that differ from the canvas. ANMF offsets are stored halved,
+// so the origin is snapped down to even coordinates.
+bool GetChangedRect(const WebPPicture &picture, const std::vector<uint32_t> &canvas, FrameRect &rect)
+{
+    const int width = picture.width;
+    int minX = width;
+    int maxX = -1;
+    int minY = -1;
+    int maxY = -1;
+    for (int y = 0; y < picture.height; y++) {
+        const uint32_t *src = picture.argb + static_cast<size_t>(y) * picture.argb_stride;
+        const uint32_t *dst = canvas.data() + static_cast<size_t>(y) * width;
+        if (memcmp(src, dst, width * sizeof(uint32_t)) == 0) {
+            continue;
+        }
+        int left = 0;
+        while (src[left] == dst[left]) {
+            left++;
+        }
+        int right = width - 1;
+        while (src[right] == dst[right]) {
+            right--;
+        }
+        minX = std::min(minX, left);
+        maxX = std::max(maxX, right);
+        minY = (minY < 0) ? y : minY;
+        maxY = y;
+    }
+    if (maxY < 0) {
+        return false;
+    }
+    rect.x = minX & ~1;
+    rect.y = minY & ~1;
+    rect.width = maxX + 1 - rect.x;
+    rect.height = maxY + 1 - rect.y;
+    return true;
+}
+
+// Mirrors what a decoder shows once the frame has been displayed and disposed.
+void UpdateCanvas(const WebPPicture &picture, const FrameRect &rect, WebPMuxAnimDispose dispose,
+    std::vector<uint32_t> &canvas)
+{
+    for (int y = rect.y; y < rect.y + rect.height; y++) {
+        uint32_t *dst = canvas.data() + static_cast<size_t>(y) * picture.width + rect.x;
+        if (dispose == WEBP_MUX_DISPOSE_BACKGROUND) {
+            std::fill_n(dst, rect.width, TRANSPARENT_PIXEL);
+        } else {
+            const uint32_t *src = picture.argb + static_cast<size_t>(y) * picture.argb_stride + rect.x;
+            std::copy_n(src, rect.width, dst);
+        }
+    }
+}
+
+bool FlushAnimationFrame(WebPMux *mux, WebPMuxFrameInfo &pendingInfo, WebPMemoryWriter &pendingData)
+{
+    if (pendingData.size == 0) {
+        return true;
+    }
+    pendingInfo.bitstream.bytes = pendingData.mem;
+    pendingInfo.bitstream.size = pendingData.size;
+    bool ret = (WebPMuxPushFrame(mux, &pendingInfo, 1) == WEBP_MUX_OK);
+    WebPMemoryWriterClear(&pendingData);
+    return ret;
+}
 } // namespace
 
 static int StreamWriter(const uint8_t* data, size_t data_size, const WebPPicture* const picture)
@@ -79,8 +159,8 @@ uint32_t WebpEncoder::AddImage(Media::PixelMap &pixelMap)
     ImageTrace imageTrace("WebpEncoder::AddImage");
     IMAGE_LOGD("AddImage IN");
 
-    if (pixelMaps_.size() >= WEBP_IMAGE_NUM) {
-        IMAGE_LOGE("AddImage, add pixel map out of range=%{public}u.", WEBP_IMAGE_NUM);
+    if (pixelMap.GetPixels() == nullptr) {
+        IMAGE_LOGE("AddImage, invalid pixel map.");
         return ERR_IMAGE_ADD_PIXEL_MAP_FAILED;
     }
 
@@ -106,8 +186,16 @@ uint32_t WebpEncoder::FinalizeEncode()
         return ERR_IMAGE_INVALID_PARAMETER;
     }
 
-    IMAGE_LOGD("FinalizeEncode, quality=%{public}u, numberHint=%{public}u",
-        encodeOpts_.quality, encodeOpts_.numberHint);
+    IMAGE_LOGD("FinalizeEncode, quality=%{public}u, numberHint=%{public}u, frames=%{public}zu",
+        encodeOpts_.quality, encodeOpts_.numberHint, pixelMaps_.size());
+
+    if (pixelMaps_.size() > 1) {
+        uint32_t animationRet = DoEncodeAnimation();
+        if (animationRet != SUCCESS) {
+            IMAGE_LOGE("FinalizeEncode, encode animation failed=%{public}u.", animationRet);
+        }
+        return animationRet;
+    }
 
     uint32_t errorCode = ERROR;
 
@@ -288,49 +376,220 @@ uint32_t WebpEncoder::DoEncode(Media::PixelMap &pixelMap, WebPConfig &webpConfig
 {
     IMAGE_LOGD("DoEncode IN");
 
+    uint32_t errorCode = ImportPixels(pixelMap, webpPicture);
+    if (errorCode != SUCCESS) {
+        IMAGE_LOGE("DoEncode, import issue.");
+        return errorCode;
+    }
+
+    IMAGE_LOGD("DoEncode, WebPEncode");
+    if (!WebPEncode(&webpConfig, &webpPicture)) {
+        IMAGE_LOGE("DoEncode, encode issue.");
+        return ERROR;
+    }
+
+    IMAGE_LOGD("DoEncode, iccValid=%{public}d", iccValid_);
+    if (iccValid_) {
+        auto res = DoEncodeForICC(pixelMap);
+        if (res != SUCCESS) {
+            IMAGE_LOGE("DoEncode, encode for icc issue.");
+            return res;
+        }
+    }
+
+    IMAGE_LOGD("DoEncode OUT");
+    return SUCCESS;
+}
+
+uint32_t WebpEncoder::ImportPixels(Media::PixelMap &pixelMap, WebPPicture &webpPicture)
+    __attribute__((no_sanitize("cfi")))
+{
+    // 8888 layouts libwebp understands are imported straight from the pixel map rows.
+    WebpImportProc importProc = nullptr;
+    PixelFormat pixelFormat = GetPixelFormat(pixelMap);
+    AlphaType alphaType = GetAlphaType(pixelMap);
+    if (pixelFormat == PixelFormat::RGBA_8888 && alphaType == AlphaType::IMAGE_ALPHA_TYPE_OPAQUE) {
+        importProc = WebPPictureImportRGBX;
+    } else if (pixelFormat == PixelFormat::RGBA_8888 && alphaType == AlphaType::IMAGE_ALPHA_TYPE_UNPREMUL) {
+        importProc = WebPPictureImportRGBA;
+    } else if (pixelFormat == PixelFormat::BGRA_8888 && alphaType == AlphaType::IMAGE_ALPHA_TYPE_OPAQUE) {
+        importProc = WebPPictureImportBGRX;
+    } else if (pixelFormat == PixelFormat::BGRA_8888 && alphaType == AlphaType::IMAGE_ALPHA_TYPE_UNPREMUL) {
+        importProc = WebPPictureImportBGRA;
+    } else if (pixelFormat == PixelFormat::RGB_888) {
+        importProc = WebPPictureImportRGB;
+    }
+    if (importProc != nullptr) {
+        IMAGE_LOGD("ImportPixels, direct, rowStride=%{public}d", pixelMap.GetRowStride());
+        return importProc(&webpPicture, pixelMap.GetPixels(), pixelMap.GetRowStride()) ? SUCCESS : ERROR;
+    }
+
     const int width = pixelMap.GetWidth();
     const int height = webpPicture.height;
     const int rgbStride = width * componentsNum_;
     const int rgbSize = rgbStride * height;
-    IMAGE_LOGD("DoEncode, width=%{public}d, height=%{public}d, componentsNum=%{public}d,"
+    IMAGE_LOGD("ImportPixels, width=%{public}d, height=%{public}d, componentsNum=%{public}d,"
         " rgbStride=%{public}d, rgbSize=%{public}d", width, height, componentsNum_, rgbStride, rgbSize);
 
     std::unique_ptr<uint8_t[]> rgb = std::make_unique<uint8_t[]>(rgbSize);
     if (!DoTransform(pixelMap, reinterpret_cast<char*>(&rgb[0]), componentsNum_)) {
-        IMAGE_LOGE("DoEncode, transform issue.");
+        IMAGE_LOGE("ImportPixels, transform issue.");
         return ERROR;
     }
 
-    auto importProc = WebPPictureImportRGB;
+    importProc = WebPPictureImportRGB;
     if (componentsNum_ != COMPONENT_NUM_3) {
         importProc = (IsOpaque(pixelMap)) ? WebPPictureImportRGBX : WebPPictureImportRGBA;
     }
-
-    IMAGE_LOGD("DoEncode, importProc");
     if (!importProc(&webpPicture, &rgb[0], rgbStride)) {
-        IMAGE_LOGE("DoEncode, import issue.");
+        IMAGE_LOGE("ImportPixels, import issue.");
         return ERROR;
     }
+    return SUCCESS;
+}
 
-    IMAGE_LOGD("DoEncode, WebPEncode");
-    if (!WebPEncode(&webpConfig, &webpPicture)) {
-        IMAGE_LOGE("DoEncode, encode issue.");
-        return ERROR;
+uint32_t WebpEncoder::DoEncodeAnimation()
+{
+    ImageTrace imageTrace("WebpEncoder::DoEncodeAnimation");
+    const int width = pixelMaps_[0]->GetWidth();
+    const int height = pixelMaps_[0]->GetHeight();
+    if (width <= 0 || height <= 0) {
+        IMAGE_LOGE("DoEncodeAnimation, invalid size %{public}dx%{public}d.", width, height);
+        return ERR_IMAGE_INVALID_PARAMETER;
     }
 
-    IMAGE_LOGD("DoEncode, iccValid=%{public}d", iccValid_);
-    if (iccValid_) {
-        auto res = DoEncodeForICC(pixelMap);
-        if (res != SUCCESS) {
-            IMAGE_LOGE("DoEncode, encode for icc issue.");
-            return res;
-        }
+    WebPMux *mux = WebPMuxNew();
+    if (mux == nullptr) {
+        IMAGE_LOGE("DoEncodeAnimation, create mux failed.");
+        return ERR_IMAGE_MALLOC_ABNORMAL;
     }
 
-    IMAGE_LOGD("DoEncode OUT");
+    // Each frame is diffed against what the decoder shows before it, so only the
+    // changed rectangle is encoded. A frame is held back until the next one is known,
+    // which lets identical frames just extend its duration.
+    std::vector<uint32_t> canvas(static_cast<size_t>(width) * height, TRANSPARENT_PIXEL);
+    WebPMuxFrameInfo pendingInfo = {};
+    WebPMemoryWriter pendingData;
+    WebPMemoryWriterInit(&pendingData);
+    uint32_t errorCode = SUCCESS;
+    for (size_t index = 0; index < pixelMaps_.size() && errorCode == SUCCESS; index++) {
+        errorCode = AddAnimationFrame(index, mux, canvas, pendingInfo, pendingData);
+    }
+    if (errorCode == SUCCESS && !FlushAnimationFrame(mux, pendingInfo, pendingData)) {
+        IMAGE_LOGE("DoEncodeAnimation, push frame failed.");
+        errorCode = ERROR;
+    }
+    if (errorCode == SUCCESS) {
+        errorCode = AssembleAnimation(mux, width, height);
+    }
+    WebPMemoryWriterClear(&pendingData);
+    WebPMuxDelete(mux);
+    return errorCode;
+}
+
+uint32_t WebpEncoder::AddAnimationFrame(size_t index, WebPMux *mux, std::vector<uint32_t> &canvas,
+    WebPMuxFrameInfo &pendingInfo, WebPMemoryWriter &pendingData)
+{
+    Media::PixelMap &pixelMap = *(pixelMaps_[index]);
+    if (pixelMap.GetWidth() != pixelMaps_[0]->GetWidth() || pixelMap.GetHeight() != pixelMaps_[0]->GetHeight()) {
+        IMAGE_LOGE("AddAnimationFrame, frame %{public}zu size mismatch.", index);
+        return ERR_IMAGE_INVALID_PARAMETER;
+    }
+
+    WebPConfig webpConfig;
+    WebPPicture webpPicture;
+    WebPPictureInit(&webpPicture);
+    uint32_t errorCode = SetEncodeConfig(pixelMap, webpConfig, webpPicture);
+    if (errorCode == SUCCESS) {
+        errorCode = ImportPixels(pixelMap, webpPicture);
+    }
+    if (errorCode != SUCCESS) {
+        IMAGE_LOGE("AddAnimationFrame, prepare frame %{public}zu failed=%{public}u.", index, errorCode);
+        WebPPictureFree(&webpPicture);
+        return errorCode;
+    }
+    // Keep the RGB under transparent pixels so the canvas tracks the decoder exactly.
+    webpConfig.exact = 1;
+
+    const int duration = GetFrameDuration(index);
+    const WebPMuxAnimDispose dispose = GetFrameDispose(index);
+    FrameRect rect;
+    bool changed = GetChangedRect(webpPicture, canvas, rect);
+    if (!changed && pendingData.size > 0 && pendingInfo.dispose_method == WEBP_MUX_DISPOSE_NONE &&
+        dispose == WEBP_MUX_DISPOSE_NONE) {
+        pendingInfo.duration = std::min(pendingInfo.duration + duration, MAX_FRAME_DURATION);
+        WebPPictureFree(&webpPicture);
+        return SUCCESS;
+    }
+    if (!FlushAnimationFrame(mux, pendingInfo, pendingData)) {
+        IMAGE_LOGE("AddAnimationFrame, push frame failed.");
+        WebPPictureFree(&webpPicture);
+        return ERROR;
+    }
+
+    WebPPicture subPicture;
+    if (!WebPPictureView(&webpPicture, rect.x, rect.y, rect.width, rect.height, &subPicture)) {
+        IMAGE_LOGE("AddAnimationFrame, view frame %{public}zu failed.", index);
+        WebPPictureFree(&webpPicture);
+        return ERROR;
+    }
+    subPicture.writer = WebPMemoryWrite;
+    subPicture.custom_ptr = &pendingData;
+    if (!WebPEncode(&webpConfig, &subPicture)) {
+        IMAGE_LOGE("AddAnimationFrame, encode frame %{public}zu failed=%{public}d.", index, subPicture.error_code);
+        WebPPictureFree(&webpPicture);
+        return ERROR;
+    }
+    IMAGE_LOGD("AddAnimationFrame, frame %{public}zu rect (%{public}d, %{public}d, %{public}d, %{public}d)",
+        index, rect.x, rect.y, rect.width, rect.height);
+
+    pendingInfo.id = WEBP_CHUNK_ANMF;
+    pendingInfo.x_offset = rect.x;
+    pendingInfo.y_offset = rect.y;
+    pendingInfo.duration = duration;
+    pendingInfo.dispose_method = dispose;
+    pendingInfo.blend_method = WEBP_MUX_NO_BLEND;
+    UpdateCanvas(webpPicture, rect, dispose, canvas);
+    WebPPictureFree(&webpPicture);
     return SUCCESS;
 }
 
+uint32_t WebpEncoder::AssembleAnimation(WebPMux *mux, int width, int height)
+{
+    WebPMuxAnimParams animParams;
+    animParams.bgcolor = TRANSPARENT_PIXEL;
+    animParams.loop_count = encodeOpts_.loop;
+    if (WebPMuxSetAnimationParams(mux, &animParams) != WEBP_MUX_OK ||
+        WebPMuxSetCanvasSize(mux, width, height) != WEBP_MUX_OK) {
+        IMAGE_LOGE("AssembleAnimation, set params failed.");
+        return ERROR;
+    }
+
+    WebPData webpAssembled;
+    WebPDataInit(&webpAssembled);
+    if (WebPMuxAssemble(mux, &webpAssembled) != WEBP_MUX_OK) {
+        IMAGE_LOGE("AssembleAnimation, assemble issue.");
+        return ERROR;
+    }
+    bool ret = outputStream_->Write(webpAssembled.bytes, webpAssembled.size);
+    WebPDataClear(&webpAssembled);
+    return ret ? SUCCESS : ERR_IMAGE_ENCODE_FAILED;
+}
+
+int WebpEncoder::GetFrameDuration(size_t index) const
+{
+    int delayTime = (index < encodeOpts_.delayTimes.size()) ? encodeOpts_.delayTimes[index] : DEFAULT_DELAY_TIME;
+    return std::min(delayTime * DELAY_TIME_UNIT_MS, MAX_FRAME_DURATION);
+}
+
+WebPMuxAnimDispose WebpEncoder::GetFrameDispose(size_t index) const
+{
+    // WebP has no "restore to previous"; anything but background keeps the frame.
+    bool isBackground = (index < encodeOpts_.disposalTypes.size()) &&
+        (encodeOpts_.disposalTypes[index] == DISPOSAL_TYPE_BACKGROUND);
+    return isBackground ? WEBP_MUX_DISPOSE_BACKGROUND : WEBP_MUX_DISPOSE_NONE;
+}
+
 uint32_t WebpEncoder::DoEncodeForICC(Media::PixelMap &pixelMap)
 {
     IMAGE_LOGD("DoEncodeForICC IN");
@@ -409,7 +668,7 @@ bool WebpEncoder::DoTransformMemcpy(Media::PixelMap &pixelMap, char* dst, int co
 
     const int32_t width = pixelMap.GetWidth();
     const int32_t height = pixelMap.GetHeight();
-    const uint32_t rowBytes = pixelMap.GetRowBytes();
+    const uint32_t rowBytes = pixelMap.GetRowStride();
     const int stride = pixelMap.GetWidth() * componentsNum;
 
     IMAGE_LOGD("width=%{public}u, height=%{public}u, rowBytes=%{public}u, stride=%{public}d, componentsNum=%{public}d",
@@ -430,7 +689,7 @@ bool WebpEncoder::DoTransformRGBX(Media::PixelMap &pixelMap, char* dst, int comp
     IMAGE_LOGD("DoTransformRGBX IN");
 
     const void *srcPixels = pixelMap.GetPixels();
-    uint32_t srcRowBytes = pixelMap.GetRowBytes();
+    uint32_t srcRowBytes = pixelMap.GetRowStride();
     const ImageInfo srcInfo = MakeImageInfo(pixelMap.GetWidth(), pixelMap.GetHeight(),
         PixelFormat::RGBA_8888, AlphaType::IMAGE_ALPHA_TYPE_OPAQUE);
 
@@ -462,7 +721,7 @@ bool WebpEncoder::DoTransformRgbA(Media::PixelMap &pixelMap, char* dst, int comp
     IMAGE_LOGD("DoTransformRgbA IN");
 
     const void *srcPixels = pixelMap.GetPixels();
-    uint32_t srcRowBytes = pixelMap.GetRowBytes();
+    uint32_t srcRowBytes = pixelMap.GetRowStride();
     const ImageInfo srcInfo = MakeImageInfo(pixelMap.GetWidth(), pixelMap.GetHeight(),
         PixelFormat::RGBA_8888, AlphaType::IMAGE_ALPHA_TYPE_PREMUL);
 
@@ -494,7 +753,7 @@ bool WebpEncoder::DoTransformBGRX(Media::PixelMap &pixelMap, char* dst, int comp
     IMAGE_LOGD("DoTransformBGRX IN");
 
     const void *srcPixels = pixelMap.GetPixels();
-    uint32_t srcRowBytes = pixelMap.GetRowBytes();
+    uint32_t srcRowBytes = pixelMap.GetRowStride();
     const ImageInfo srcInfo = MakeImageInfo(pixelMap.GetWidth(), pixelMap.GetHeight(),
         PixelFormat::BGRA_8888, AlphaType::IMAGE_ALPHA_TYPE_UNPREMUL);
 
@@ -526,7 +785,7 @@ bool WebpEncoder::DoTransformBGRA(Media::PixelMap &pixelMap, char* dst, int comp
     IMAGE_LOGD("DoTransformBGRA IN");
 
     const void *srcPixels = pixelMap.GetPixels();
-    uint32_t srcRowBytes = pixelMap.GetRowBytes();
+    uint32_t srcRowBytes = pixelMap.GetRowStride();
     const ImageInfo srcInfo = MakeImageInfo(pixelMap.GetWidth(), pixelMap.GetHeight(),
         PixelFormat::BGRA_8888, AlphaType::IMAGE_ALPHA_TYPE_UNPREMUL);
 
@@ -558,7 +817,7 @@ bool WebpEncoder::DoTransformBgrA(Media::PixelMap &pixelMap, char* dst, int comp
     IMAGE_LOGD("DoTransformBgrA IN");
 
     const void *srcPixels = pixelMap.GetPixels();
-    uint32_t srcRowBytes = pixelMap.GetRowBytes();
+    uint32_t srcRowBytes = pixelMap.GetRowStride();
     const ImageInfo srcInfo = MakeImageInfo(pixelMap.GetWidth(), pixelMap.GetHeight(),
         PixelFormat::BGRA_8888, AlphaType::IMAGE_ALPHA_TYPE_PREMUL);
 
@@ -590,7 +849,7 @@ bool WebpEncoder::DoTransformF16To8888(Media::PixelMap &pixelMap, char* dst, int
     IMAGE_LOGD("DoTransformF16To8888 IN");
 
     const void *srcPixels = pixelMap.GetPixels();
-    uint32_t srcRowBytes = pixelMap.GetRowBytes();
+    uint32_t srcRowBytes = pixelMap.GetRowStride();
     const ImageInfo srcInfo = MakeImageInfo(pixelMap.GetWidth(), pixelMap.GetHeight(),
         PixelFormat::RGBA_F16, AlphaType::IMAGE_ALPHA_TYPE_UNPREMUL);
 
@@ -622,7 +881,7 @@ bool WebpEncoder::DoTransformF16pTo8888(Media::PixelMap &pixelMap, char* dst, in
     IMAGE_LOGD("DoTransformF16pTo8888 IN");
 
     const void *srcPixels = pixelMap.GetPixels();
-    uint32_t srcRowBytes = pixelMap.GetRowBytes();
+    uint32_t srcRowBytes = pixelMap.GetRowStride();
     const ImageInfo srcInfo = MakeImageInfo(pixelMap.GetWidth(), pixelMap.GetHeight(),
         PixelFormat::RGBA_F16, AlphaType::IMAGE_ALPHA_TYPE_PREMUL);
 
@@ -654,7 +913,7 @@ bool WebpEncoder::DoTransformArgbToRgb(Media::PixelMap &pixelMap, char* dst, int
     IMAGE_LOGD("DoTransformArgbToRgb IN");
 
     const void *srcPixels = pixelMap.GetPixels();
-    uint32_t srcRowBytes = pixelMap.GetRowBytes();
+    uint32_t srcRowBytes = pixelMap.GetRowStride();
     const ImageInfo srcInfo = MakeImageInfo(pixelMap.GetWidth(), pixelMap.GetHeight(),
         PixelFormat::ARGB_8888, AlphaType::IMAGE_ALPHA_TYPE_OPAQUE);
 
@@ -686,7 +945,7 @@ bool WebpEncoder::DoTransformArgbToRgba(Media::PixelMap &pixelMap, char* dst, in
     IMAGE_LOGD("DoTransformArgbToRgba IN");
 
     const void *srcPixels = pixelMap.GetPixels();
-    uint32_t srcRowBytes = pixelMap.GetRowBytes();
+    uint32_t srcRowBytes = pixelMap.GetRowStride();
     const ImageInfo srcInfo = MakeImageInfo(pixelMap.GetWidth(), pixelMap.GetHeight(),
         PixelFormat::ARGB_8888, pixelMap.GetAlphaType());
 
@@ -718,7 +977,7 @@ bool WebpEncoder::DoTransformRGB565(Media::PixelMap &pixelMap, char* dst, int co
     IMAGE_LOGD("DoTransformRGB565 IN");
 
     const void *srcPixels = pixelMap.GetPixels();
-    uint32_t srcRowBytes = pixelMap.GetRowBytes();
+    uint32_t srcRowBytes = pixelMap.GetRowStride();
     const ImageInfo srcInfo = MakeImageInfo(pixelMap.GetWidth(), pixelMap.GetHeight(),
         PixelFormat::RGB_565, AlphaType::IMAGE_ALPHA_TYPE_UNPREMUL);
 
@@ -750,7 +1009,7 @@ bool WebpEncoder::DoTransformGray(Media::PixelMap &pixelMap, char* dst, int comp
     IMAGE_LOGD("DoTransformGray IN");
 
     const void *srcPixels = pixelMap.GetPixels();
-    uint32_t srcRowBytes = pixelMap.GetRowBytes();
+    uint32_t srcRowBytes = pixelMap.GetRowStride();
     const ImageInfo srcInfo = MakeImageInfo(pixelMap.GetWidth(), pixelMap.GetHeight(),
         PixelFormat::ALPHA_8, AlphaType::IMAGE_ALPHA_TYPE_UNPREMUL);
 
@@ -132,6 +132,8 @@ struct PixelDecodeOptions {
     std::shared_ptr<Media::PixelMap> plReusePixelmap = nullptr;
     OHOS::Media::CropAndScaleStrategy cropAndScaleStrategy = OHOS::Media::CropAndScaleStrategy::DEFAULT;
     bool isAnimationDecode = false;
+    // bytes the decoder may spend on composited animation frames kept for random access, 0 disables it
+    uint64_t animationCacheBudget = 0;
 };
 
 class AbsImageDecoder {
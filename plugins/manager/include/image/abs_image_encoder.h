@@ -63,6 +63,7 @@ struct PlEncodeOptions {
     bool needsPackGPS = true;
     PlPackingOptionsForTiff tiffPackingOption;
     PlPackingOptionsForAstc astcPackingOption;
+    DitherType ditherType = DitherType::NONE;
 };
 
 class AbsImageEncoder {